@@ -19,13 +19,24 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #define JO_TOSDB_CLIENT
 
 #include "tos_databridge.h"
+#include "concurrency.hpp"
 #include <mutex>
 #include <chrono>
 
-/* sync access to blocks in client_get/client_admin */
-extern std::recursive_mutex global_rmutex;
+/* sync access to blocks in client_get/client_admin 
 
-#define GLOBAL_RLOCK_GUARD std::lock_guard<std::recursive_mutex> global_rlock_guard_(global_rmutex)
+   READ(shared) for anything that only looks up blocks, including getting 
+   and setting their data/settings (the block and its streams have their own 
+   locks); WRITE(exclusive) to create/close blocks, change their items/topics, 
+   or anything else that touches the block map or pre-caches. 
+
+   Calls that talk to the engine (add/remove/close) serialize on a separate 
+   admin lock in client_admin and only take the global lock before/after the 
+   round-trip, never during it. */
+extern RecursiveSharedMutex global_rwmutex;
+
+#define GLOBAL_RLOCK_GUARD SharedLockGuard global_rlock_guard_(global_rwmutex)
+#define GLOBAL_WLOCK_GUARD std::lock_guard<RecursiveSharedMutex> global_wlock_guard_(global_rwmutex)
 
 /* forward decl - raw_data_block.hpp / raw_data_block.tpp */
 template<typename T,typename T2> class RawDataBlock; 
@@ -52,4 +63,12 @@ GetBlockPtr(std::string id, bool log=true);
 const TOSDBlock*   
 GetBlockOrThrow(std::string id);
 
+/* drop the stream handles (client_get) into streams of 'db' that are going 
+   away: those of 'item' (all items if empty) and 'topic' (all topics if 
+   NULL_TOPIC); CALLING CODE MUST HOLD GLOBAL_WLOCK */
+void
+InvalidateStreamHandles(const TOSDBlock* db, 
+                        std::string item = std::string(), 
+                        TOS_Topics::TOPICS topic = TOS_Topics::TOPICS::NULL_TOPIC);
+
 #endif
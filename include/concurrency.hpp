@@ -22,6 +22,14 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <map>
 #include <set>
 #include <string>
+#include <list>
+#include <unordered_map>
+#include <functional>
+
+/* SignalManager: waits on acks keyed by an id string. set_signal_ID() 
+   registers a slot for the calling thread, wait()/wait_for() block on that 
+   slot only and signal() wakes the oldest un-signaled slot for the id. Ids 
+   hash to one of NSHARDS independently locked tables. */
 
 #ifdef CPP_COND_VAR
 
@@ -32,13 +40,40 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <thread>
 
 class SignalManager {      
-    typedef std::pair<volatile bool, volatile bool> _flag_pair_ty;
-    typedef std::pair<std::string,_flag_pair_ty> _sig_pair_ty;
-
-    std::mutex _mtx;
-    std::condition_variable _cnd; 
+    static const size_t NSHARDS = 16;
+
+    struct _slot_ty{
+        std::thread::id owner;
+        bool signaled;
+        bool secondary;
+        std::condition_variable cnd;
+
+        explicit _slot_ty(std::thread::id owner)
+            : 
+                owner(owner), 
+                signaled(false), 
+                secondary(true) 
+            {
+            }
+    };
+
+    typedef std::list<_slot_ty> _slots_ty;
+
+    struct _shard_ty{
+        std::mutex mtx;
+        std::unordered_map<std::string, _slots_ty> slots;
+    };
+
+    _shard_ty _shards[NSHARDS];
+
+    inline _shard_ty&
+    _shard(const std::string& unq_id)
+    {
+        return _shards[std::hash<std::string>()(unq_id) % NSHARDS];
+    }
 
-    std::multimap<std::string, _flag_pair_ty> _unq_flags; 
+    bool
+    _wait(const std::string& unq_id, size_t timeout, bool use_timeout);
 
     SignalManager(const SignalManager&);
     SignalManager(SignalManager&&);
@@ -101,6 +136,13 @@ public:
     { 
         LeaveCriticalSection(&_cs); 
     }  
+
+    /* for SleepConditionVariableCS */
+    inline CRITICAL_SECTION*
+    native_handle()
+    {
+        return &_cs;
+    }
 };
 
 
@@ -125,6 +167,105 @@ public:
 };
 
 
+/* reader/writer lock (SRW) that the holding thread can re-enter: shared 
+   inside shared or exclusive, exclusive inside exclusive. A thread that 
+   holds it shared must NOT ask for it exclusively (deadlock). The shared 
+   count of each thread is kept in a TLS slot so use only a few of these */
+class RecursiveSharedMutex{
+    SRWLOCK _srw;
+    DWORD _tls;
+    volatile DWORD _owner; /* thread holding it exclusively, or 0 */
+    unsigned long _depth; /* exclusive (and nested shared) re-entries */
+
+    RecursiveSharedMutex(const RecursiveSharedMutex&);
+    RecursiveSharedMutex& operator=(const RecursiveSharedMutex&);
+
+public:
+    RecursiveSharedMutex()
+        :
+            _tls(TlsAlloc()),
+            _owner(0),
+            _depth(0)
+        {
+            InitializeSRWLock(&_srw);
+        }
+
+    ~RecursiveSharedMutex()
+        {
+            TlsFree(_tls);
+        }
+
+    inline void
+    lock()
+    {
+        DWORD tid = GetCurrentThreadId();
+        if(_owner == tid){
+            ++_depth;
+            return;
+        }
+        AcquireSRWLockExclusive(&_srw);
+        _owner = tid;
+        _depth = 1;
+    }
+
+    inline void
+    unlock()
+    {
+        if(--_depth == 0){
+            _owner = 0;
+            ReleaseSRWLockExclusive(&_srw);
+        }
+    }
+
+    inline void
+    lock_shared()
+    {
+        if(_owner == GetCurrentThreadId()){ /* already have it exclusively */
+            ++_depth;
+            return;
+        }
+        size_t n = (size_t)TlsGetValue(_tls);
+        if(!n)
+            AcquireSRWLockShared(&_srw);
+        TlsSetValue(_tls, (LPVOID)(n + 1));
+    }
+
+    inline void
+    unlock_shared()
+    {
+        if(_owner == GetCurrentThreadId()){
+            --_depth;
+            return;
+        }
+        size_t n = (size_t)TlsGetValue(_tls) - 1;
+        TlsSetValue(_tls, (LPVOID)n);
+        if(!n)
+            ReleaseSRWLockShared(&_srw);
+    }
+};
+
+
+class SharedLockGuard{  
+    RecursiveSharedMutex& _mtx;
+
+    SharedLockGuard(const SharedLockGuard&);
+    SharedLockGuard& operator=(const SharedLockGuard&); 
+
+public:
+    SharedLockGuard(RecursiveSharedMutex& mutex)
+        : 
+            _mtx(mutex) 
+        { 
+            _mtx.lock_shared(); 
+        }
+
+    ~SharedLockGuard() 
+        { 
+            _mtx.unlock_shared(); 
+        }
+};
+
+
 class IPCNamedMutexClient{
     HANDLE _mtx;   
     std::string _name;
@@ -176,25 +317,50 @@ public:
 
 
 class SignalManager {    
-    std::multimap<std::string, volatile bool> _unq_flags; 
-    LightWeightMutex _mtx;
-    HANDLE _event;    
+    static const size_t NSHARDS = 16;
+
+    struct _slot_ty{
+        DWORD owner;
+        bool signaled;
+        bool secondary;
+        CONDITION_VARIABLE cnd;
+
+        explicit _slot_ty(DWORD owner)
+            : 
+                owner(owner), 
+                signaled(false), 
+                secondary(true) 
+            {
+                InitializeConditionVariable(&cnd);
+            }
+    };
+
+    typedef std::list<_slot_ty> _slots_ty;
+
+    struct _shard_ty{
+        LightWeightMutex mtx;
+        std::unordered_map<std::string, _slots_ty> slots;
+    };
+
+    _shard_ty _shards[NSHARDS];
+
+    inline _shard_ty&
+    _shard(const std::string& unq_id)
+    {
+        return _shards[std::hash<std::string>()(unq_id) % NSHARDS];
+    }
+
+    bool
+    _wait(const std::string& unq_id, DWORD timeout);
 
     SignalManager(const SignalManager&);
     SignalManager& operator=(const SignalManager&);  
 
 public:
     SignalManager()
-        : 
-            _event(CreateEvent(NULL, FALSE, FALSE, NULL)) 
         {
         }
 
-    ~SignalManager() 
-        { 
-            CloseHandle(_event); 
-        }
-
     void 
     set_signal_ID(std::string unq_id);
 
@@ -26,7 +26,11 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <deque>
 #include <string>
 #include <vector>
+#include <map>
 #include <mutex>  
+#include <memory>
+#include <type_traits>
+#include <cstdint>
 
 /* implemented in src/data_stream.tpp */
 
@@ -77,6 +81,761 @@ BuildThrowTypeError(const char* method)
 
 };
 
+
+/* rolling statistics over the current contents of a stream */
+struct DataStreamStats{
+    double min;
+    double max;
+    double mean;
+    double variance; /* population */
+    double vwap; /* weighted mean; == mean if weight never set */
+    size_t count;
+};
+
+
+/* opt-in tracker DataStream updates on push and eviction so stats are O(1):
+   monotonic deques (of <seq,val>) for min/max, shifted running sums for 
+   mean/variance and a parallel deque of weights for vwap */
+template<typename Ty, bool IsNumeric = std::is_arithmetic<Ty>::value>
+class DataStreamStatsTracker{
+    typedef std::pair<unsigned long long, double> _seq_val_ty;
+
+    std::deque<_seq_val_ty> _min_q; /* increasing, front to back */
+    std::deque<_seq_val_ty> _max_q; /* decreasing, front to back */
+    std::deque<double> _weights; /* front == newest, like the stream */
+
+    unsigned long long _seq; /* seq of the next push */
+    size_t _count;
+    double _shift;
+    double _sum;
+    double _sum_sq;
+    double _wsum;
+    double _wsum_val;
+    double _weight;
+
+public:
+    static const bool supported = true;
+
+    DataStreamStatsTracker()
+        :
+            _seq(0),
+            _count(0),
+            _shift(0),
+            _sum(0),
+            _sum_sq(0),
+            _wsum(0),
+            _wsum_val(0),
+            _weight(1.0)
+        {
+        }
+
+    /* v is being pushed to the front of the stream */
+    void
+    push(const Ty& v);
+
+    /* v is the oldest elem (back of the stream) and is being removed */
+    void
+    evict(const Ty& v);
+
+    inline void
+    weight(double w)
+    {
+        _weight = w;
+    }
+
+    DataStreamStats
+    get() const;
+};
+
+
+template<typename Ty>
+class DataStreamStatsTracker<Ty, false>{
+public:
+    static const bool supported = false;
+
+    inline void 
+    push(const Ty& v) 
+    {
+    }
+
+    inline void 
+    evict(const Ty& v) 
+    {
+    }
+
+    inline void 
+    weight(double w) 
+    {
+    }
+
+    inline DataStreamStats 
+    get() const 
+    { 
+        return DataStreamStats(); 
+    }
+};
+
+
+/* where a DataStreamDeque keeps the elems that don't fit in its hot tier:
+   fixed capacity, newest at the front; when full push_front drops the oldest.
+   References returned by [] and back() are only good until the next call. */
+template<typename Ty>
+class DataStreamColdTier{
+public:
+    virtual
+    ~DataStreamColdTier()
+        {
+        }
+
+    virtual size_t
+    size() const = 0;
+
+    virtual size_t
+    capacity() const = 0;
+
+    /* bytes used to store the elems */
+    virtual size_t
+    footprint() const = 0;
+
+    virtual const Ty&
+    operator[](size_t indx) const = 0;
+
+    virtual const Ty&
+    back() const = 0;
+
+    virtual void
+    push_front(const Ty& v) = 0;
+
+    virtual void
+    pop_back() = 0;
+
+    virtual void
+    clear() = 0;
+
+    /* grow or shrink in place (shrinking drops the oldest); throws 
+       DataStreamError before anything is changed if it can't grow */
+    virtual void
+    capacity(size_t cap) = 0;
+
+    /* copies [beg, end) to dest; returns # copied */
+    virtual size_t
+    copy(size_t beg, size_t end, Ty *dest) const = 0;
+
+    /* a new tier of the same kind/capacity holding the same elems */
+    virtual DataStreamColdTier*
+    clone() const = 0;
+};
+
+
+/* cold tier in a file mapping (a temp file that's deleted when closed) so 
+   deep history doesn't count against the heap; the OS pages it in/out. 
+   Only for POD types, they're just copied in/out of the view. One per 
+   spilling deque (2 handles each) - see TOSDB_SetBlockHotSize */
+template<typename Ty>
+class DataStreamMappedRing
+        : public DataStreamColdTier<Ty> {
+    HANDLE _file;
+    HANDLE _mapping;
+    Ty *_data;
+    size_t _cap;
+    size_t _head; /* newest */
+    size_t _count;
+
+    DataStreamMappedRing(const DataStreamMappedRing&);
+
+    DataStreamMappedRing&
+    operator=(const DataStreamMappedRing&);
+
+    void
+    _close();
+
+    inline size_t
+    _pos(size_t indx) const
+    {
+        indx += _head;
+        return (indx < _cap) ? indx : (indx - _cap);
+    }
+
+public:
+    /* throws DataStreamError if the file/mapping can't be created */
+    explicit 
+    DataStreamMappedRing(size_t cap);
+
+    ~DataStreamMappedRing()
+        {
+            _close();
+        }
+
+    inline size_t
+    size() const
+    {
+        return _count;
+    }
+
+    inline size_t
+    capacity() const
+    {
+        return _cap;
+    }
+
+    /* grows the file under the view; a shrink keeps the file as is */
+    void
+    capacity(size_t cap);
+
+    inline size_t
+    footprint() const
+    {
+        return _cap * sizeof(Ty);
+    }
+
+    inline const Ty&
+    operator[](size_t indx) const
+    {
+        return _data[_pos(indx)];
+    }
+
+    inline const Ty&
+    back() const
+    {
+        return _data[_pos(_count - 1)];
+    }
+
+    inline void
+    push_front(const Ty& v)
+    {
+        _head = _head ? (_head - 1) : (_cap - 1);
+        _data[_head] = v;
+        if(_count < _cap)
+            ++_count;
+    }
+
+    inline void
+    pop_back()
+    {
+        if(_count)
+            --_count;
+    }
+
+    inline void
+    clear()
+    {
+        _count = 0;
+    }
+
+    /* at most two contiguous runs of the view */
+    size_t
+    copy(size_t beg, size_t end, Ty *dest) const;
+
+    /* copies view to view, nothing goes through the heap */
+    DataStreamMappedRing*
+    clone() const;
+};
+
+
+#define DATASTREAM_CODEC_NONE 0
+#define DATASTREAM_CODEC_XOR 1 /* floating point */
+#define DATASTREAM_CODEC_DELTA 2 /* integers */
+#define DATASTREAM_CODEC_LANES 3 /* POD structs (e.g DateTimeStamp) */
+
+/* encodes/decodes a block of elems, oldest first:
+
+   XOR - if every value in the block has <= 6 decimal places (e.g prices 
+         parsed from text) the values are scaled to integers and DELTA 
+         encoded; otherwise each value's bits are XOR'd w/ the previous and 
+         only the run of meaningful bits is stored, reusing the previous 
+         leading/trailing zero counts when they fit
+   DELTA - zig-zag varint of the difference from the previous value
+   LANES - the elem as 4-byte lanes (# of lanes <= 32); a varint bitmask of 
+           lanes whose delta-of-delta is non-zero followed by those (zig-zag 
+           varint) values, so a timestamp that moves steadily costs ~1 byte */
+template<typename Ty, 
+         int Kind = std::is_floating_point<Ty>::value 
+                  ? DATASTREAM_CODEC_XOR 
+                  : (std::is_integral<Ty>::value 
+                      ? DATASTREAM_CODEC_DELTA
+                      : ((std::is_pod<Ty>::value && !(sizeof(Ty) % 4) && sizeof(Ty) <= 128)
+                          ? DATASTREAM_CODEC_LANES 
+                          : DATASTREAM_CODEC_NONE))>
+class DataStreamCodec{
+public:
+    static const bool supported = false;
+
+    static void
+    encode(const Ty *src, size_t n, std::vector<unsigned char>& out)
+    {
+    }
+
+    static void
+    decode(const unsigned char *in, size_t n, Ty *dest)
+    {
+    }
+};
+
+
+class DataStreamCodecBase{
+protected:
+    class _bit_writer{
+        std::vector<unsigned char>& _out;
+        unsigned int _cur;
+        unsigned int _used;
+
+        _bit_writer& 
+        operator=(const _bit_writer&);
+
+    public:
+        _bit_writer(std::vector<unsigned char>& out)
+            :
+                _out(out),
+                _cur(0),
+                _used(0)
+            {
+            }
+
+        /* low 'n' (<= 64) bits of v, MSB first */
+        void
+        put(unsigned long long v, unsigned int n);
+
+        void
+        flush();
+    };
+
+    class _bit_reader{
+        const unsigned char *_in;
+        unsigned int _used;
+
+    public:
+        _bit_reader(const unsigned char *in)
+            :
+                _in(in),
+                _used(0)
+            {
+            }
+
+        unsigned long long
+        get(unsigned int n);
+    };
+
+    static inline void
+    _put_varint(std::vector<unsigned char>& out, unsigned long long v)
+    {
+        while(v >= 0x80){
+            out.push_back((unsigned char)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((unsigned char)v);
+    }
+
+    static inline unsigned long long
+    _get_varint(const unsigned char*& in)
+    {
+        unsigned long long v = 0;
+        unsigned int shift = 0;
+        unsigned char b;
+
+        do{
+            b = *in++;
+            v |= (unsigned long long)(b & 0x7F) << shift;
+            shift += 7;
+        }while(b & 0x80);
+
+        return v;
+    }
+
+    template<typename U>
+    static inline U
+    _zigzag(U d)
+    {
+        return (U)(d << 1) ^ (U)(0 - (d >> (sizeof(U) * 8 - 1)));
+    }
+
+    template<typename U>
+    static inline U
+    _unzigzag(U z)
+    {
+        return (U)(z >> 1) ^ (U)(0 - (z & 1));
+    }
+
+    /* x != 0 */
+    static unsigned int
+    _clz64(unsigned long long x);
+
+    static unsigned int
+    _ctz64(unsigned long long x);
+};
+
+
+template<typename Ty>
+class DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>
+        : protected DataStreamCodecBase {
+    typedef typename std::conditional<sizeof(Ty) == 8, 
+                                      unsigned long long, 
+                                      unsigned int>::type _my_word_ty;
+
+    static const unsigned int _bits = sizeof(_my_word_ty) * 8;
+    static const unsigned char _XOR_MODE = 0xFF; /* else # of decimals */
+    static const int _MAX_DECIMALS = 6;
+
+    static double
+    _pow10(int d);
+
+    /* fewest decimals (<= _MAX_DECIMALS) all values can be scaled by and 
+       come back bit-for-bit; -1 if none */
+    static int
+    _decimals(const Ty *src, size_t n);
+
+    static void
+    _encode_xor(const Ty *src, size_t n, std::vector<unsigned char>& out);
+
+public:
+    static const bool supported = true;
+
+    static void
+    encode(const Ty *src, size_t n, std::vector<unsigned char>& out);
+
+    static void
+    decode(const unsigned char *in, size_t n, Ty *dest);
+};
+
+
+template<typename Ty>
+class DataStreamCodec<Ty, DATASTREAM_CODEC_DELTA>
+        : protected DataStreamCodecBase {
+    typedef typename std::make_unsigned<Ty>::type _my_word_ty;
+
+public:
+    static const bool supported = true;
+
+    static void
+    encode(const Ty *src, size_t n, std::vector<unsigned char>& out);
+
+    static void
+    decode(const unsigned char *in, size_t n, Ty *dest);
+};
+
+
+template<typename Ty>
+class DataStreamCodec<Ty, DATASTREAM_CODEC_LANES>
+        : protected DataStreamCodecBase {
+    static const size_t _nlanes = sizeof(Ty) / 4;
+
+public:
+    static const bool supported = true;
+
+    static void
+    encode(const Ty *src, size_t n, std::vector<unsigned char>& out);
+
+    static void
+    decode(const unsigned char *in, size_t n, Ty *dest);
+};
+
+
+/* cold tier on the heap as sealed, encoded blocks of BLOCK_SZ elems plus an 
+   open (raw) block still being filled. Random access decodes one block (the
+   last one decoded is cached); copy decodes each block it touches once. */
+template<typename Ty>
+class DataStreamPackedRing
+        : public DataStreamColdTier<Ty> {
+    typedef DataStreamCodec<Ty> _my_codec_ty;
+    typedef std::vector<unsigned char> _my_block_ty;
+
+    static const size_t BLOCK_SZ = 256;
+
+    std::deque<_my_block_ty> _blocks; /* front == newest; oldest first inside */
+    std::vector<Ty> _open; /* oldest first */
+    size_t _cap;
+    size_t _count; /* oldest block may be partly dropped */
+    unsigned long long _front_seq; /* seq # of _blocks.front() */
+
+    mutable std::vector<Ty> _decoded;
+    mutable unsigned long long _decoded_seq; /* -1 if none */
+
+    DataStreamPackedRing(const DataStreamPackedRing& r)
+        :
+            _blocks(r._blocks),
+            _open(r._open),
+            _cap(r._cap),
+            _count(r._count),
+            _front_seq(r._front_seq),
+            _decoded(),
+            _decoded_seq((unsigned long long)-1)
+        {
+        }
+
+    DataStreamPackedRing&
+    operator=(const DataStreamPackedRing&);
+
+    /* decodes the block 'bindx' from the front; returns elems oldest first */
+    const Ty*
+    _decode(size_t bindx) const;
+
+    void
+    _drop_dead_blocks();
+
+public:
+    explicit
+    DataStreamPackedRing(size_t cap)
+        :
+            _cap(std::max<size_t>(cap,1)),
+            _count(0),
+            _front_seq(0),
+            _decoded_seq((unsigned long long)-1)
+        {
+        }
+
+    inline size_t
+    size() const
+    {
+        return _count;
+    }
+
+    inline size_t
+    capacity() const
+    {
+        return _cap;
+    }
+
+    inline void
+    capacity(size_t cap)
+    {
+        _cap = std::max<size_t>(cap,1);
+        if(_count > _cap){
+            _count = _cap;
+            _drop_dead_blocks();
+        }
+    }
+
+    size_t
+    footprint() const;
+
+    const Ty&
+    operator[](size_t indx) const;
+
+    inline const Ty&
+    back() const
+    {
+        return (*this)[_count - 1];
+    }
+
+    void
+    push_front(const Ty& v);
+
+    inline void
+    pop_back()
+    {
+        if(_count){
+            --_count;
+            _drop_dead_blocks();
+        }
+    }
+
+    inline void
+    clear()
+    {
+        _blocks.clear();
+        _open.clear();
+        _count = 0;
+        _decoded_seq = (unsigned long long)-1;
+    }
+
+    size_t
+    copy(size_t beg, size_t end, Ty *dest) const;
+
+    /* copies the encoded blocks as is */
+    inline DataStreamPackedRing*
+    clone() const
+    {
+        return new DataStreamPackedRing(*this);
+    }
+};
+
+
+/* what DataStream stores its data in: a deque (newest at the front) that, 
+   if spilling, only holds the newest 'hot_sz' elems on the heap; older elems 
+   (up to the stream's bound) are moved to a DataStreamColdTier - a file 
+   mapping or, if 'compress', encoded blocks on the heap. Indexing spans both
+   tiers so the stream doesn't care where the data lives. */
+template<typename Ty, typename Allocator>
+class DataStreamDeque{
+    typedef DataStreamColdTier<Ty> _my_cold_ty;
+
+    std::deque<Ty,Allocator> _hot;
+    std::unique_ptr<_my_cold_ty> _cold; /* null if not spilling */
+    size_t _hot_sz; /* 0 if not spilling */
+    size_t _hot_req; /* last hot_sz asked for; only in effect if spilling */
+    bool _compress;
+
+    DataStreamDeque&
+    operator=(const DataStreamDeque&);
+
+    /* only instantiate the tiers Ty supports */
+    static inline _my_cold_ty*
+    _new_mapped(size_t cap, std::true_type)
+    {
+        return new DataStreamMappedRing<Ty>(cap);
+    }
+
+    static inline _my_cold_ty*
+    _new_mapped(size_t cap, std::false_type)
+    {
+        return nullptr;
+    }
+
+    static inline _my_cold_ty*
+    _new_packed(size_t cap, std::true_type)
+    {
+        return new DataStreamPackedRing<Ty>(cap);
+    }
+
+    static inline _my_cold_ty*
+    _new_packed(size_t cap, std::false_type)
+    {
+        return nullptr;
+    }
+
+public:
+    static const bool spill_supported = std::is_pod<Ty>::value;
+    static const bool compress_supported = DataStreamCodec<Ty>::supported;
+
+    DataStreamDeque()
+        :
+            _hot(),
+            _cold(),
+            _hot_sz(0),
+            _hot_req(0),
+            _compress(false)
+        {
+        }
+
+    DataStreamDeque(const DataStreamDeque& d)
+        :
+            _hot(d._hot),
+            _cold(d._cold ? d._cold->clone() : nullptr),
+            _hot_sz(d._hot_sz),
+            _hot_req(d._hot_req),
+            _compress(d._compress)
+        {
+        }
+
+    DataStreamDeque(DataStreamDeque&& d)
+        :
+            _hot(std::move(d._hot)),
+            _cold(std::move(d._cold)),
+            _hot_sz(d._hot_sz),
+            _hot_req(d._hot_req),
+            _compress(d._compress)
+        {
+        }
+
+    inline size_t
+    size() const
+    {
+        return _cold ? (_hot.size() + _cold->size()) : _hot.size();
+    }
+
+    inline bool
+    empty() const
+    {
+        return _hot.empty(); /* cold tier only gets data when hot is full */
+    }
+
+    /* the spill threshold in effect; 0 if not spilling */
+    inline size_t
+    hot_size() const
+    {
+        return _hot_sz;
+    }
+
+    /* what to re-spill with when the bound changes; can be != hot_size() 
+       if the bound was too small to spill at the time */
+    inline size_t
+    hot_size_requested() const
+    {
+        return _hot_req;
+    }
+
+    inline bool
+    compressed() const
+    {
+        return _compress;
+    }
+
+    /* bytes used by the cold tier */
+    inline size_t
+    cold_footprint() const
+    {
+        return _cold ? _cold->footprint() : 0;
+    }
+
+    inline const Ty&
+    operator[](size_t indx) const
+    {
+        return (indx < _hot.size()) ? _hot[indx] : (*_cold)[indx - _hot.size()];
+    }
+
+    inline const Ty&
+    back() const
+    {
+        return (_cold && _cold->size()) ? _cold->back() : _hot.back();
+    }
+
+    inline void
+    push_front(const Ty& v)
+    {
+        _hot.push_front(v);
+        if(_cold && _hot.size() > _hot_sz){
+            _cold->push_front(_hot.back());
+            _hot.pop_back();
+        }
+    }
+
+    inline void
+    pop_back()
+    {
+        if(_cold && _cold->size())
+            _cold->pop_back();
+        else
+            _hot.pop_back();
+    }
+
+    /* only shrinks */
+    void
+    resize(size_t sz);
+
+    inline void
+    shrink_to_fit()
+    {
+        _hot.shrink_to_fit();
+    }
+
+    /* keep the newest 'hot_sz' elems on the heap and spill older ones to a 
+       new cold tier big enough for 'bound' elems in total; 0 (or >= bound) 
+       brings everything back to the heap. If the tier can't be created this
+       throws before anything is changed. */
+    void
+    spill(size_t hot_sz, size_t bound, bool compress);
+
+    /* the stream's bound changed (trim first if it shrank): resizes the cold
+       tier in place, only re-spills if that changes whether we spill */
+    void
+    rebound(size_t bound);
+
+    /* copies [beg, end) to dest, hot tier first; returns # copied */
+    size_t
+    copy(size_t beg, size_t end, Ty *dest) const;
+
+    /* as above, w/ each elem passed through conv on the way to dest */
+    template<typename OutTy, typename Conv>
+    size_t
+    copy(size_t beg, size_t end, OutTy *dest, Conv& conv) const;
+
+    /* first indx in [beg, size()) for which pred is false, assuming pred is 
+       true for every elem before it (like std::partition_point) */
+    template<typename Pred>
+    size_t
+    partition_point(size_t beg, Pred pred) const;
+};
+
+
 template<typename SecTy, typename GenTy>      
 class DataStreamInterface {
 public:
@@ -89,18 +848,94 @@ public:
     /* hard-coded 4 BYTE SIGNED MAX to avoid some of the corner cases. */
     static const size_t MAX_BOUND_SIZE = ((65536LL * 65536 / 2) - 1);
 
+    /* converts secondary elems as they're copied out, for callers that want
+       a numeric key (e.g epoch micro-seconds) rather than the elem itself */
+    class secondary_converter {
+    public:
+        virtual 
+        ~secondary_converter() 
+            {
+            }
+
+        virtual long long
+        operator()(const secondary_ty& sec) = 0;
+    };
+
+    /* where the copy calls put secondary elems: a secondary_ty array, or a 
+       long long array by way of a secondary_converter; implicit from a 
+       secondary_ty* so callers can keep passing one (or nullptr for none) */
+    class secondary_dest {
+        secondary_ty *_sec;
+        long long *_conv_dest;
+        secondary_converter *_conv;
+
+    public:
+        secondary_dest(secondary_ty *sec = nullptr)
+            : 
+                _sec(sec),
+                _conv_dest(nullptr),
+                _conv(nullptr)
+            {
+            }
+
+        secondary_dest(long long *dest, secondary_converter& conv)
+            : 
+                _sec(nullptr),
+                _conv_dest(dest),
+                _conv(dest ? &conv : nullptr)
+            {
+            }
+
+        inline bool
+        empty() const
+        {
+            return !_sec && !_conv_dest;
+        }
+
+        inline secondary_dest
+        operator+(size_t off) const
+        {
+            secondary_dest d(*this);
+            if(d._sec)
+                d._sec += off;
+            if(d._conv_dest)
+                d._conv_dest += off;
+            return d;
+        }
+
+        inline void
+        assign(size_t indx, const secondary_ty& sec) const
+        {
+            if(_conv_dest)
+                _conv_dest[indx] = (*_conv)(sec);
+            else if(_sec)
+                _sec[indx] = sec;
+        }
+
+        /* copies [beg, end) of a DataStreamDeque; returns # copied */
+        template<typename DequeTy>
+        size_t
+        copy_from(const DequeTy& d, size_t beg, size_t end) const
+        {
+            if(_conv_dest)
+                return d.copy(beg, end, _conv_dest, *_conv);
+
+            return _sec ? d.copy(beg, end, _sec) : 0;
+        }
+    };
+
 private:
     template<typename InTy, typename OutTy>
     size_t 
-    _copy(OutTy *dest, size_t sz, int end, int beg, secondary_ty *sec) const; 
+    _copy(OutTy *dest, size_t sz, int end, int beg, secondary_dest sec) const; 
    
     template<typename InTy, typename OutTy>
     long long 
-    _copy_using_atomic_marker(OutTy *dest, size_t sz, int beg, secondary_ty *sec) const;
+    _copy_using_atomic_marker(OutTy *dest, size_t sz, int beg, secondary_dest sec) const;
 
     template<typename InTy, typename OutTy>
     long long 
-    _ncopy_using_atomic_marker(OutTy *dest, size_t sz, secondary_ty *sec) const;
+    _ncopy_using_atomic_marker(OutTy *dest, size_t sz, secondary_dest sec) const;
 
 protected:
     unsigned int _str_push_count;
@@ -111,7 +946,75 @@ protected:
         {
         }
 
+    /* locks the stream and routes marker reads/updates to a named marker;
+       throws DataStreamInvalidArgument (unlocked) if it doesn't exist. 
+       Selections nest (e.g a named marker call inside a marker_scope) */
+    virtual void
+    _select_marker(const std::string& name) const = 0;
+
+    /* restores the previously selected marker and unlocks the stream */
+    virtual void
+    _unselect_marker() const = 0;
+
+    virtual void
+    _lock() const = 0;
+
+    virtual void
+    _unlock() const = 0;
+
+    class _named_marker_scope {
+        const DataStreamInterface *_stream;
+
+        _named_marker_scope(const _named_marker_scope&);
+
+        _named_marker_scope& 
+        operator=(const _named_marker_scope&);
+
+    public:
+        _named_marker_scope(const DataStreamInterface *stream, const std::string& name)
+            : 
+                _stream(stream) 
+            { 
+                _stream->_select_marker(name); 
+            }
+
+        _named_marker_scope(_named_marker_scope&& scope)
+            : 
+                _stream(scope._stream) 
+            { 
+                scope._stream = nullptr; 
+            }
+
+        ~_named_marker_scope() 
+            { 
+                if(_stream)
+                    _stream->_unselect_marker(); 
+            }
+    };
+
 public:
+    /* holds the stream's lock and uses a named marker in place of the 
+       default marker for every call made while in scope */
+    typedef _named_marker_scope marker_scope;
+
+    /* holds the stream's (recursive) lock so a sequence of calls, e.g 
+       secondary_range then copy, doesn't see any pushes in between */
+    class lock_scope {
+        const DataStreamInterface *_stream;
+    public:
+        lock_scope(const DataStreamInterface *stream)
+            : 
+                _stream(stream) 
+            { 
+                _stream->_lock(); 
+            }
+
+        ~lock_scope() 
+            { 
+                _stream->_unlock(); 
+            }
+    };
+
     virtual 
     ~DataStreamInterface() 
         {
@@ -123,6 +1026,24 @@ public:
     virtual size_t      
     bound_size(size_t) = 0;
 
+    /* keep only the newest 'hot_sz' elems on the heap and spill older ones 
+       (up to bound_size) to a file-backed ring; 0 keeps everything on the 
+       heap (default). Throws DataStreamTypeError for string streams */
+    virtual size_t
+    hot_size() const = 0;
+
+    virtual size_t
+    hot_size(size_t hot_sz) = 0;
+
+    /* store the spilled (cold) elems as delta/XOR encoded blocks on the heap
+       instead of in a file mapping (see DataStreamCodec); throws 
+       DataStreamTypeError for streams that can't be encoded (strings) */
+    virtual bool
+    cold_compressed() const = 0;
+
+    virtual void
+    cold_compressed(bool on) = 0;
+
     virtual size_t      
     size() const = 0;
 
@@ -135,6 +1056,80 @@ public:
     virtual bool        
     is_marker_dirty() const = 0;
 
+    /* named markers let independent consumers share a stream: each has its 
+       own position and dirty flag, all are advanced on push. Like the default 
+       marker they're reader state so they can be managed through a const stream.
+
+       add/remove return false if the marker already exists/doesn't exist; 
+       "" is reserved for the default marker (DataStreamInvalidArgument) */
+    virtual bool
+    add_marker(const std::string& name) const = 0;
+
+    virtual bool
+    remove_marker(const std::string& name) const = 0;
+
+    virtual bool
+    has_marker(const std::string& name) const = 0;
+
+    virtual long long   
+    marker_position(const std::string& name) const = 0;
+
+    virtual bool        
+    is_marker_dirty(const std::string& name) const = 0;
+
+    /* removes the named markers that don't start with 'prefix', e.g other 
+       consumers' markers that came along w/ a copy of the stream */
+    virtual void
+    retain_markers(const std::string& prefix) const = 0;
+
+    /* (n)copy_from_marker using a named marker; all other calls that move 
+       the marker (copy, vector etc.) only move the default marker */
+    template<typename T>
+    long long
+    copy_from_named_marker(const std::string& name, 
+                           T *dest, 
+                           size_t sz, 
+                           int beg = 0, 
+                           secondary_dest sec = nullptr) const
+    {
+        _named_marker_scope scope(this, name);
+        return copy_from_marker(dest, sz, beg, sec);
+    }
+
+    long long
+    copy_from_named_marker(const std::string& name, 
+                           char **dest, 
+                           size_t dest_sz, 
+                           size_t str_sz, 
+                           int beg = 0, 
+                           secondary_dest sec = nullptr) const
+    {
+        _named_marker_scope scope(this, name);
+        return copy_from_marker(dest, dest_sz, str_sz, beg, sec);
+    }
+
+    template<typename T>
+    long long
+    ncopy_from_named_marker(const std::string& name, 
+                            T *dest, 
+                            size_t sz, 
+                            secondary_dest sec = nullptr) const
+    {
+        _named_marker_scope scope(this, name);
+        return ncopy_from_marker(dest, sz, sec);
+    }
+
+    long long
+    ncopy_from_named_marker(const std::string& name, 
+                            char **dest, 
+                            size_t dest_sz, 
+                            size_t str_sz, 
+                            secondary_dest sec = nullptr) const
+    {
+        _named_marker_scope scope(this, name);
+        return ncopy_from_marker(dest, dest_sz, str_sz, sec);
+    }
+
     virtual generic_ty  
     operator[](int) const = 0;
 
@@ -158,6 +1153,21 @@ public:
     virtual void 
     push(const generic_ty& gen, secondary_ty sec = secondary_ty()) = 0;   
 
+    /* rolling stats are opt-in; throws DataStreamTypeError for non-numeric 
+       streams and DataStreamInvalidArgument on stats() if not enabled */
+    virtual void
+    stats_enable(bool on) = 0;
+
+    virtual bool
+    stats_enabled() const = 0;
+
+    /* weight applied to subsequent pushes (for vwap) */
+    virtual void
+    stats_weight(double w) = 0;
+
+    virtual DataStreamStats
+    stats() const = 0;
+
 /* MACROS that help avoid constructing GenTy for push/copy calls if possible 
 
    they create an implicit, safe(hopefully) casting mechanism between the
@@ -181,14 +1191,14 @@ push(const InTy v, secondary_ty sec = secondary_ty()) \
     
 #define VIRTUAL_VOID_COPY_2ARG_DROP(InTy, OutTy) \
 virtual size_t \
-copy(InTy *dest, size_t sz, int end = -1, int beg = 0, secondary_ty *sec = nullptr) const \
+copy(InTy *dest, size_t sz, int end = -1, int beg = 0, secondary_dest sec = nullptr) const \
 { \
     return this->_copy<OutTy>(dest, sz, end, beg, sec); \
 } 
     
 #define VIRTUAL_VOID_COPY_2ARG_BREAK(InTy, DropBool) \
 virtual size_t \
-copy(InTy *dest, size_t sz, int end = -1, int beg = 0, secondary_ty *sec = nullptr) const \
+copy(InTy *dest, size_t sz, int end = -1, int beg = 0, secondary_dest sec = nullptr) const \
 { \
     BuildThrowTypeError<InTy*,DropBool>("copy()"); \
     return 0; \
@@ -196,14 +1206,14 @@ copy(InTy *dest, size_t sz, int end = -1, int beg = 0, secondary_ty *sec = nullp
 
 #define VIRTUAL_VOID_MARKER_COPY_2ARG_DROP(InTy, OutTy) \
 virtual long long \
-copy_from_marker(InTy *dest, size_t sz, int beg = 0, secondary_ty *sec = nullptr) const \
+copy_from_marker(InTy *dest, size_t sz, int beg = 0, secondary_dest sec = nullptr) const \
 { \
     return this->_copy_using_atomic_marker< OutTy >(dest, sz, beg, sec); \
 } 
     
 #define VIRTUAL_VOID_MARKER_COPY_2ARG_BREAK(InTy, DropBool) \
 virtual long long \
-copy_from_marker(InTy *dest, size_t sz, int beg = 0, secondary_ty *sec = nullptr) const \
+copy_from_marker(InTy *dest, size_t sz, int beg = 0, secondary_dest sec = nullptr) const \
 { \
     BuildThrowTypeError<InTy*,DropBool>("copy_from_marker()"); \
     return 0; \
@@ -211,14 +1221,14 @@ copy_from_marker(InTy *dest, size_t sz, int beg = 0, secondary_ty *sec = nullptr
 
 #define VIRTUAL_VOID_MARKER_N_COPY_2ARG_DROP(InTy, OutTy) \
 virtual long long \
-ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
+ncopy_from_marker(InTy *dest, size_t sz, secondary_dest sec = nullptr) const \
 { \
     return this->_ncopy_using_atomic_marker< OutTy >(dest, sz, sec); \
 } 
     
 #define VIRTUAL_VOID_MARKER_N_COPY_2ARG_BREAK(InTy, DropBool) \
 virtual long long \
-ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
+ncopy_from_marker(InTy *dest, size_t sz, secondary_dest sec = nullptr) const \
 { \
     BuildThrowTypeError<InTy*,DropBool>("ncopy_from_marker()"); \
     return 0; \
@@ -276,14 +1286,28 @@ ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
          size_t str_sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
 
     virtual size_t 
     copy(std::string *dest, 
          size_t sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
+
+    /* [beg, end] as strings packed into one buffer: each null-terminated, 
+       back to back, in 'dest' (dest_sz bytes). 'offsets' (sz + 1 elems) gets 
+       where each string starts and, after the last one copied, the bytes 
+       used. Stops at 'sz' strings or the first that doesn't fit; returns 
+       the # copied */
+    virtual size_t
+    copy_packed(char *dest, 
+                size_t dest_sz, 
+                uint32_t *offsets, 
+                size_t sz, 
+                int end = -1, 
+                int beg = 0, 
+                secondary_dest sec = nullptr) const = 0;
 
     VIRTUAL_VOID_MARKER_COPY_2ARG_DROP(long long, long)
     VIRTUAL_VOID_MARKER_COPY_2ARG_DROP(long, int)
@@ -303,13 +1327,13 @@ ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
                      size_t dest_sz,   
                      size_t str_sz,             
                      int beg = 0, 
-                     secondary_ty *sec = nullptr) const;
+                     secondary_dest sec = nullptr) const;
 
     virtual long long 
     copy_from_marker(std::string *dest, 
                      size_t sz,                     
                      int beg = 0, 
-                     secondary_ty *sec = nullptr) const;
+                     secondary_dest sec = nullptr) const;
 
     VIRTUAL_VOID_MARKER_N_COPY_2ARG_DROP(long long, long)
     VIRTUAL_VOID_MARKER_N_COPY_2ARG_DROP(long, int)
@@ -328,12 +1352,12 @@ ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
     ncopy_from_marker(char **dest, 
                       size_t dest_sz,   
                       size_t str_sz,                                
-                      secondary_ty *sec = nullptr) const;
+                      secondary_dest sec = nullptr) const;
 
     virtual long long 
     ncopy_from_marker(std::string *dest, 
                       size_t sz,                                        
-                      secondary_ty *sec = nullptr) const;
+                      secondary_dest sec = nullptr) const;
 
     virtual void /* SHOULD WE THROW? */ 
     secondary(secondary_ty *dest, int indx) const 
@@ -341,6 +1365,15 @@ ncopy_from_marker(InTy *dest, size_t sz, secondary_ty *sec = nullptr) const \
         dest = nullptr; 
     }
 
+    /* sets [beg, end] to the range of data w/ from <= secondary < to; 
+       secondary values must increase w/ each push (e.g DateTimeStamp) 
+       so we can binary search; end < beg if there is no data in range */
+    virtual void
+    secondary_range(const secondary_ty& from, 
+                    const secondary_ty& to, 
+                    int *end, 
+                    int *beg) const = 0;
+
 }; /* class DataStreamInterface */
 
 
@@ -358,6 +1391,7 @@ class DataStream /* CONTAINS A PRIMARY DEQUE */
        : public DataStreamInterface<SecTy, GenTy>{  
     typedef DataStream<Ty,SecTy,GenTy,UseSecondary,Allocator> _my_ty;
     typedef DataStreamInterface<SecTy,GenTy> _my_base_ty;  
+    typedef DataStreamStatsTracker<Ty> _my_stats_ty;
 
     class{
         static const bool valid = GenTy::TypeCheck<Ty>::value;  
@@ -372,19 +1406,30 @@ class DataStream /* CONTAINS A PRIMARY DEQUE */
 
 protected:
     typedef std::lock_guard<std::recursive_mutex> _my_lock_guard_type;
-     
-    std::deque<Ty,Allocator> _deque_primary;
+
+    /* grows on push until it reaches _qbound (d.size() == _qcount) */ 
+    DataStreamDeque<Ty,Allocator> _deque_primary;
 
     size_t _qbound;
     size_t _qcount;
 
-    long long *const _mark_count;
-    bool *const _mark_is_dirty;     
+    typedef std::pair<long long, bool> _my_marker_ty; /* position, is dirty */
+    typedef std::map<std::string, _my_marker_ty> _my_markers_ty;
+
+    _my_markers_ty *_markers; /* default marker is stored under "" */
+    _my_marker_ty *_default_marker;
+
+    /* the active marker; only points at a named marker while _mtx is held */
+    mutable long long *_mark_count;
+    mutable bool *_mark_is_dirty;     
+    mutable std::vector<std::pair<long long*, bool*>> _prev_markers; /* see _select_marker */
 
     volatile bool _push_has_priority;
 
     std::recursive_mutex *const _mtx;
 
+    std::unique_ptr<_my_stats_ty> _stats; /* null if not enabled */
+
     inline void 
     _yld_to_push() const
     {  
@@ -394,11 +1439,44 @@ protected:
 
     template<typename T>
     bool
-    _check_adj(int& end, int& beg, const std::deque<T,Allocator>& d) const;
+    _check_adj(int& end, int& beg, const DataStreamDeque<T,Allocator>& d) const;
+
+    template<typename T>
+    T
+    _at_or_default(const DataStreamDeque<T,Allocator>& d, int indx) const;
 
     void
     _incr_internal_counts();
 
+    void
+    _select_marker(const std::string& name) const;
+
+    void
+    _unselect_marker() const;
+
+    inline void
+    _lock() const
+    {
+        _mtx->lock();
+    }
+
+    inline void
+    _unlock() const
+    {
+        _mtx->unlock();
+    }
+
+    /* call BEFORE v is pushed to the front of the deque */
+    inline void
+    _stats_on_push(const Ty& v)
+    {
+        if(!_stats)
+            return;
+        if(_deque_primary.size() >= _qbound)
+            _stats->evict(_deque_primary.back());
+        _stats->push(v);
+    }
+
     template<typename DequeTy, typename DestTy> 
     size_t 
     _copy_to_ptr(DequeTy& d, 
@@ -407,6 +1485,34 @@ protected:
                  unsigned int end, 
                  unsigned int beg) const;
 
+    /* secondary elems, possibly converted on the way out */
+    template<typename DequeTy>
+    size_t
+    _copy_to_ptr(DequeTy& d,
+                 const secondary_dest& dest,
+                 size_t sz,
+                 unsigned int end,
+                 unsigned int beg) const;
+
+    /* for copy_packed: 'v' + '\0' into 'dest' if it fits in dest_sz; 
+       returns the bytes written, 0 if it doesn't fit. Strings are copied 
+       straight from the deque, other types go thru generic_ty */
+    static inline size_t
+    _pack_str(const std::string& v, char *dest, size_t dest_sz)
+    {
+        if(v.size() >= dest_sz)
+            return 0;
+        memcpy(dest, v.c_str(), v.size() + 1);
+        return v.size() + 1;
+    }
+
+    template<typename T>
+    static inline size_t
+    _pack_str(const T& v, char *dest, size_t dest_sz)
+    {
+        return _pack_str(generic_ty(v).as_string(), dest, dest_sz);
+    }
+
 public:
     typedef _my_base_ty interface_type;
     typedef Ty value_type;
@@ -432,16 +1538,36 @@ public:
 
     inline bool      
     is_marker_dirty() const 
-    { 
+    { /* default marker unless one is selected (we already hold _mtx then) */
+        _my_lock_guard_type lock(*_mtx);
         return *_mark_is_dirty; 
     }
 
     inline long long 
     marker_position() const 
     { 
+        _my_lock_guard_type lock(*_mtx);
         return *_mark_count; 
     }   
 
+    bool
+    add_marker(const std::string& name) const;
+
+    bool
+    remove_marker(const std::string& name) const;
+
+    bool
+    has_marker(const std::string& name) const;
+
+    long long   
+    marker_position(const std::string& name) const;
+
+    bool        
+    is_marker_dirty(const std::string& name) const;
+
+    void
+    retain_markers(const std::string& prefix) const;
+
     inline size_t    
     bound_size() const 
     { 
@@ -450,6 +1576,39 @@ public:
      
     size_t 
     bound_size(size_t sz);
+
+    inline size_t
+    hot_size() const
+    {
+        return _deque_primary.hot_size();
+    }
+
+    size_t
+    hot_size(size_t hot_sz);
+
+    inline bool
+    cold_compressed() const
+    {
+        return _deque_primary.compressed();
+    }
+
+    void
+    cold_compressed(bool on);
+
+    void
+    stats_enable(bool on);
+
+    inline bool
+    stats_enabled() const
+    {
+        return (bool)_stats;
+    }
+
+    void
+    stats_weight(double w);
+
+    DataStreamStats
+    stats() const;
       
     inline void 
     push(const Ty v, secondary_ty sec = secondary_ty())
@@ -468,33 +1627,33 @@ public:
     long long 
     ncopy_from_marker(Ty *dest, 
                       size_t sz,                   
-                      secondary_ty *sec = nullptr) const;
+                      secondary_dest sec = nullptr) const;
     
     long long 
     ncopy_from_marker(char **dest, 
                       size_t dest_sz, 
                       size_t str_sz,                                   
-                      secondary_ty *sec = nullptr) const;
+                      secondary_dest sec = nullptr) const;
 
     long long 
     copy_from_marker(Ty *dest, 
                      size_t sz,              
                      int beg = 0, 
-                     secondary_ty *sec = nullptr) const;
+                     secondary_dest sec = nullptr) const;
     
     long long 
     copy_from_marker(char **dest, 
                      size_t dest_sz, 
                      size_t str_sz,                
                      int beg = 0, 
-                     secondary_ty *sec = nullptr) const;
+                     secondary_dest sec = nullptr) const;
       
     size_t 
     copy(Ty *dest, 
          size_t sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
       
     size_t 
     copy(char **dest, 
@@ -502,7 +1661,16 @@ public:
          size_t str_sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
+
+    size_t
+    copy_packed(char *dest, 
+                size_t dest_sz, 
+                uint32_t *offsets, 
+                size_t sz, 
+                int end = -1, 
+                int beg = 0, 
+                secondary_dest sec = nullptr) const;
 
     generic_ty 
     operator[](int indx) const;
@@ -516,6 +1684,12 @@ public:
     secondary_vector_ty 
     secondary_vector(int end = -1, int beg = 0) const;
 
+    void
+    secondary_range(const secondary_ty& from, 
+                    const secondary_ty& to, 
+                    int *end, 
+                    int *beg) const;
+
     // BUG-FIX: allow frame calls not to move marker Dec 8 2017
     generic_ty
     get_leave_marker(int indx) const;
@@ -523,6 +1697,12 @@ public:
     // BUG-FIX: allow frame calls not to move marker Dec 8 2017
     both_ty
     both_leave_marker(int indx) const;
+
+    /* most recent elem (or default) w/o moving any marker or building a 
+       generic_ty; not virtual, for callers that know the concrete stream 
+       type (e.g RawDataBlock frame columns) */
+    Ty
+    front_leave_marker() const;
 };
 
              
@@ -535,7 +1715,7 @@ class DataStream<Ty, SecTy, GenTy, true, Allocator> /* CONTAINS PRIMARY AND SECO
     typedef DataStream<Ty,SecTy,GenTy,true,Allocator> _my_ty;
     typedef DataStream<Ty,SecTy,GenTy,false,Allocator> _my_base_ty;
         
-    std::deque<SecTy,Allocator> _deque_secondary;  
+    DataStreamDeque<SecTy,Allocator> _deque_secondary;  
     
     void 
     _push(const Ty v, const secondary_ty sec);
@@ -550,6 +1730,24 @@ public:
     size_t 
     bound_size(size_t sz);
 
+    size_t
+    hot_size(size_t hot_sz);
+
+    inline size_t
+    hot_size() const
+    {
+        return _my_base_ty::hot_size();
+    }
+
+    void
+    cold_compressed(bool on);
+
+    inline bool
+    cold_compressed() const
+    {
+        return _my_base_ty::cold_compressed();
+    }
+
     inline void 
     push(const Ty v, secondary_ty sec = secondary_ty())
     {    
@@ -569,7 +1767,7 @@ public:
          size_t sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
 
     size_t 
     copy(char **dest, 
@@ -577,7 +1775,16 @@ public:
          size_t str_sz, 
          int end = -1, 
          int beg = 0, 
-         secondary_ty *sec = nullptr) const;
+         secondary_dest sec = nullptr) const;
+
+    size_t
+    copy_packed(char *dest, 
+                size_t dest_sz, 
+                uint32_t *offsets, 
+                size_t sz, 
+                int end = -1, 
+                int beg = 0, 
+                secondary_dest sec = nullptr) const;
     
     both_ty 
     both(int indx) const;
@@ -588,9 +1795,19 @@ public:
     secondary_vector_ty 
     secondary_vector(int end = -1, int beg = 0) const;
 
+    void
+    secondary_range(const secondary_ty& from, 
+                    const secondary_ty& to, 
+                    int *end, 
+                    int *beg) const;
+
     // BUG-FIX: allow frame calls not to move marker Dec 8 2017
     both_ty
     both_leave_marker(int indx) const;
+
+    /* as above, w/ the most recent secondary elem copied into 'sec' */
+    Ty
+    front_leave_marker(secondary_dest sec) const;
 };  
 
 
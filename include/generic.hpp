@@ -26,6 +26,18 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <limits.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <vector>
+
+/* VS2012 CRT lacks the C99 strtoll/strtof */
+#if defined(_MSC_VER) && (_MSC_VER < 1800)
+#define GENERIC_STRTOLL(s,e) _strtoi64(s,e,10)
+#define GENERIC_STRTOF(s,e) ((float)strtod(s,e))
+#else
+#define GENERIC_STRTOLL(s,e) strtoll(s,e,10)
+#define GENERIC_STRTOF(s,e) strtof(s,e)
+#endif
 
 /* why can't we just forward decl in tos_databridge.h ? */
 #if defined(THIS_EXPORTS_INTERFACE)
@@ -40,10 +52,6 @@ template<typename T> /* forward decl */
 inline T
 CastGenericFromString(std::string& str);
 
-/* 
-    TODO: optimize move semantics 
-*/
-
 class DLL_SPEC_IFACE TOSDB_Generic{  
 
   /* The types we support. Because the biggest object we hold is 8-bytes, we 
@@ -56,7 +64,13 @@ class DLL_SPEC_IFACE TOSDB_Generic{
 
      note: we don't hold a 'void' object per-se; when an object holding a string 
            is 'moved' we set the _type_val to TYVAL_VOID so the destructor knows 
-           not to free the junk _sub then points at                           */
+           not to free the junk _sub then points at                           
+
+     strings short enough to fit in _sub (all strings the engine produces: 
+     STR_DATA_SZ is 40 bytes) are stored inline, null-terminated, so creating,
+     copying and moving them never touches the heap; longer strings (up to 
+     STR_MAX) fall back to an owned std::string* held in _sub. _str_len 
+     tells the two apart.                                                     */
 
     static const int TYVAL_VOID      = 0;
     static const int TYVAL_LONG      = 1;
@@ -68,36 +82,116 @@ class DLL_SPEC_IFACE TOSDB_Generic{
   /* max string length we support is 255 chars (why?) */
     static const int STR_MAX = UCHAR_MAX - 1;
 
-  /* the (max) byte size of our internal representation */
-    static const int SUB_SZ  = 8;
+  /* the (max) byte size of our internal representation; large enough to 
+     hold engine strings (+ null) inline */
+    static const int SUB_SZ  = 48;
+
+  /* longest string we store inline (leave room for the null) */
+    static const int STR_INLINE_MAX = SUB_SZ - 1;
 
   /* raw mem holding our 'object' - 
-     an array of byte objects seems the logical way to represent this */
-    uint8_t _sub[SUB_SZ];
+     an array of byte objects seems the logical way to represent this; 
+     8-byte aligned so the scalar casts below are safe */
+    union{
+        uint8_t _sub[SUB_SZ];
+        long long _align;
+    };
 
   /* the type of our 'object' - 
      we can expand this to 64 bits because of alignment*/
     unsigned char _type_val;
 
-  /* _val_switch handles casts internally and supports most of the public 
-    interface; should be fast, comprehensive, and safe (in that order, i think) */
+  /* string length (if TYVAL_STRING); > STR_INLINE_MAX means heap */
+    unsigned char _str_len;
+
+    inline bool
+    _str_is_inline() const 
+    { 
+        return (_str_len <= STR_INLINE_MAX); 
+    }
+
+    inline const char*
+    _str_data() const 
+    { 
+        return _str_is_inline() ? (const char*)_sub 
+                                : (*(std::string**)_sub)->c_str(); 
+    }
+
+    void
+    _set_string(const char* str, size_t len);
+
+    void
+    _release();
+
+  /* string -> scalar parsing for _try_val_switch; same leniency as the 
+     std::sto* calls in CastGenericFromString (leading whitespace, trailing 
+     junk ignored) but report failure instead of throwing */
+    static inline bool
+    _parse(const char* str, long long* out)
+    {
+        char *end;
+        errno = 0;
+        *out = GENERIC_STRTOLL(str, &end);
+        return (end != str) && (errno != ERANGE);
+    }
+
+    static inline bool
+    _parse(const char* str, long* out)
+    {
+        char *end;
+        errno = 0;
+        *out = strtol(str, &end, 10);
+        return (end != str) && (errno != ERANGE);
+    }
+
+    static inline bool
+    _parse(const char* str, double* out)
+    {
+        char *end;
+        errno = 0;
+        *out = strtod(str, &end);
+        return (end != str) && (errno != ERANGE);
+    }
+
+    static inline bool
+    _parse(const char* str, float* out)
+    {
+        char *end;
+        errno = 0;
+        *out = GENERIC_STRTOF(str, &end);
+        return (end != str) && (errno != ERANGE);
+    }
+
+  /* _try_val_switch handles casts internally and supports most of the public 
+     interface; no exception machinery on any path - returns false if we are 
+     VOID or hold a string that doesn't parse as T (*out is then undefined) */
+    template< typename T >  
+    inline bool     
+    _try_val_switch(T* out) const
+    {
+        switch(_type_val){
+        case TYVAL_LONG:            
+        case TYVAL_LONG_LONG: 
+            *out = (T)(*(long long*)(_sub)); 
+            return true;
+        case TYVAL_FLOAT:                
+        case TYVAL_DOUBLE:    
+            *out = (T)(*(double*)(_sub)); 
+            return true;
+        case TYVAL_STRING:  
+            return _parse(_str_data(), out);
+        default: 
+            return false;
+        }
+    }
+
+  /* _val_switch is the throwing version; the exception is only built on failure */
     template< typename T >  
-    T     
+    inline T     
     _val_switch() const
     {
-        try{
-            switch(_type_val){
-            case TYVAL_LONG:            
-            case TYVAL_LONG_LONG: 
-                return (T)(*(long long*)(_sub)); 
-            case TYVAL_FLOAT:                
-            case TYVAL_DOUBLE:    
-                return (T)(*(double*)(_sub)); 
-            case TYVAL_STRING:    
-                return (T)CastGenericFromString<T>(**(std::string**)(_sub));                      
-            default: throw;
-            }
-        }catch(...){
+        T val;
+        if( !_try_val_switch(&val) ){
             std::ostringstream s;
             s << "error casting generic to < " << typeid(T).name() << " >";
 #ifdef __GNUC__
@@ -105,8 +199,9 @@ class DLL_SPEC_IFACE TOSDB_Generic{
 #else /* GNU doesn't like */
             throw std::bad_cast(s.str().c_str());
 #endif
-       }
-   }
+        }
+        return val;
+    }
 
 public:  
     template<typename T>
@@ -121,37 +216,48 @@ public:
 
     explicit TOSDB_Generic(long val)
         :           
-            _type_val( TYVAL_LONG )
+            _type_val( TYVAL_LONG ),
+            _str_len( 0 )
         {     
             *(long long*)_sub = val;
         }
 
     explicit TOSDB_Generic(long long val)
         :
-            _type_val( TYVAL_LONG_LONG )
+            _type_val( TYVAL_LONG_LONG ),
+            _str_len( 0 )
         {      
             *(long long*)_sub = val;
         }
 
     explicit TOSDB_Generic(float val)
         :
-            _type_val( TYVAL_FLOAT )
+            _type_val( TYVAL_FLOAT ),
+            _str_len( 0 )
         {      
             *(double*)_sub = val;
         }
 
     explicit TOSDB_Generic(double val)
         :
-            _type_val( TYVAL_DOUBLE )
+            _type_val( TYVAL_DOUBLE ),
+            _str_len( 0 )
         {      
             *(double*)_sub = val;
         }
 
-    explicit TOSDB_Generic(std::string str)
-        : /* ! must be able to delete (std::string*)_sub at ANY TIME !*/                         
+    explicit TOSDB_Generic(const std::string& str)
+        : /* ! must be able to _release() at ANY TIME ! */                         
             _type_val( TYVAL_STRING )  
-        { /* let string do all the heavy lifting */            
-            *(std::string**)_sub = new std::string(str.substr(0,STR_MAX)); 
+        { 
+            _set_string(str.c_str(), str.size()); 
+        } 
+
+    explicit TOSDB_Generic(const char* str)
+        :                     
+            _type_val( TYVAL_STRING )  
+        { 
+            _set_string(str, strlen(str)); 
         } 
 
     TOSDB_Generic(const TOSDB_Generic& gen);
@@ -166,14 +272,20 @@ public:
 
     ~TOSDB_Generic() 
         { 
-            if( is_string() ) 
-                delete *(std::string**)_sub; 
+            _release();
         }
 
     inline bool /* same type AND value */
     operator==(const TOSDB_Generic& gen) const
     {
-        return (_type_val == gen._type_val ) && ( as_string() == gen.as_string());
+        if(_type_val != gen._type_val)
+            return false;
+
+        if(is_string()) /* avoid building std::strings just to compare */
+            return (_str_len == gen._str_len) 
+                   && (memcmp(_str_data(), gen._str_data(), _str_len) == 0);
+
+        return (as_string() == gen.as_string());
     }
 
     inline bool /* different type OR value */
@@ -254,6 +366,49 @@ public:
     std::string      
     as_string() const; 
 
+  /* exception-free versions of the above: return false (and leave *val 
+     unspecified) if we're VOID or hold a string that doesn't parse */
+    inline bool
+    try_as_long(long *val) const 
+    { 
+        return _try_val_switch<long>(val); 
+    }
+
+    inline bool
+    try_as_long_long(long long *val) const 
+    { 
+        return _try_val_switch<long long>(val); 
+    }
+
+    inline bool
+    try_as_float(float *val) const 
+    { 
+        return _try_val_switch<float>(val); 
+    }
+
+    inline bool
+    try_as_double(double *val) const 
+    { 
+        return _try_val_switch<double>(val); 
+    }
+
+    template<typename T>
+    inline bool
+    try_as(T *val) const 
+    { 
+        static_assert(TypeCheck<T>::value && !std::is_same<T,std::string>::value,
+                      "try_as<T> only supports long, long long, float, double");
+        return _try_val_switch<T>(val); 
+    }
+
+  /* null-terminated view of a string generic (nullptr otherwise); 
+     valid for the life of the object, or until it's assigned to */
+    inline const char*
+    as_c_string() const 
+    { 
+        return is_string() ? _str_data() : nullptr; 
+    }
+
     inline operator  
     long() const 
     { 
@@ -286,6 +441,46 @@ public:
 };  
 
 
+/* bulk conversion of generics into a typed array (e.g. a generic frame or 
+   vector into doubles) without per-element exceptions; elements that can't 
+   be converted are set to 'bad_val'. Returns the number of elements that 
+   failed; if 'ok' is not null ok[i] flags each element.                    */
+template<typename T>
+size_t
+GenericsToArray(const TOSDB_Generic *src, 
+                size_t n, 
+                T *dest, 
+                T bad_val = T(), 
+                bool *ok = nullptr)
+{
+    size_t nbad = 0;
+
+    for(size_t i = 0; i < n; ++i){
+        bool good = src[i].try_as<T>(dest + i);
+        if(!good){
+            dest[i] = bad_val;
+            ++nbad;
+        }
+        if(ok)
+            ok[i] = good;
+    }
+    return nbad;
+}
+
+template<typename T>
+inline size_t
+GenericsToArray(const std::vector<TOSDB_Generic>& src, 
+                T *dest, 
+                size_t dest_len, 
+                T bad_val = T(), 
+                bool *ok = nullptr)
+{
+    return GenericsToArray<T>(src.empty() ? nullptr : &src[0], 
+                              (src.size() < dest_len) ? src.size() : dest_len, 
+                              dest, bad_val, ok);
+}
+
+
 template<typename T>
 inline T
 CastGenericFromString(std::string& str) 
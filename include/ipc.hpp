@@ -25,62 +25,146 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <vector>
 #include <memory>
 #include <future>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <windows.h>
 
 #include "concurrency.hpp"
+#include "ipc_protocol.hpp"
+#include "ipc_channel.hpp"
+
+
+/* named pipe transports for the main channel; frames (see ipc_protocol.hpp) 
+   are sent as single pipe messages. Handles are opened for overlapped I/O so
+   one thread can read while another writes (synchronous I/O on the same 
+   handle is serialized by the system) */
+class NamedPipeConnection
+        : public IPCConnection{
+    /* how often a blocked read/write checks if we've been closed */
+    static const DWORD CLOSE_POLL_MSEC = 100;
+
+    HANDLE _hndl;
+    HANDLE _read_event;
+    HANDLE _write_event;
+    std::atomic<bool> _closed;
+
+    DWORD
+    _io(bool read, char *buf, DWORD n, DWORD *done);
+
+    NamedPipeConnection(const NamedPipeConnection&);
+    NamedPipeConnection& operator=(const NamedPipeConnection&);
+
+public:
+    /* takes ownership of a connected pipe handle (either end) */
+    explicit NamedPipeConnection(HANDLE hndl);
+
+    ~NamedPipeConnection();
+
+    bool
+    read_frame(std::string *frame);
+
+    bool
+    write_frame(const std::string& frame);
+
+    void
+    close();
+};
+
+
+class NamedPipeServerTransport
+        : public IPCServerTransport{
+    std::string _name;
+    SECURITY_ATTRIBUTES *_sec_attr;
+
+    /* the instance waiting for the next client; we always keep one around 
+       so clients never see the pipe as missing between connections */
+    HANDLE _next_hndl;
+    HANDLE _connect_event;
+    HANDLE _stop_event;
+
+    HANDLE
+    _create_instance(bool first);
+
+    NamedPipeServerTransport(const NamedPipeServerTransport&);
+    NamedPipeServerTransport& operator=(const NamedPipeServerTransport&);
+
+public:
+    /* throws std::runtime_error if the first instance can't be created 
+       (e.g another engine owns the name) */
+    NamedPipeServerTransport(std::string name, SECURITY_ATTRIBUTES *sec_attr);
+
+    ~NamedPipeServerTransport();
+
+    IPCConnection*
+    accept();
+
+    void
+    interrupt();
+};
+
+
+class NamedPipeClientTransport
+        : public IPCClientTransport{
+    std::string _name;
+
+public:
+    explicit NamedPipeClientTransport(std::string name)
+        :
+            _name(name)
+        {
+        }
+
+    IPCConnection*
+    connect(unsigned long timeout);
+};
+
+
+/* the slave publishes this in a small shared segment and keeps it current 
+   from its own thread; masters check the connection by reading it, so a 
+   check costs no syscall and the slave has nothing to answer */
+struct IPCHeartbeat{
+    static const uint32_t MAGIC = 0x54424854; /* "THBT" */
+    static const DWORD INTERVAL_MSEC = 250;
+
+    volatile uint32_t magic;
+    volatile uint32_t build; /* IPCBase::BUILD_WORD of the slave */
+    volatile uint32_t pid;   /* 0 once the slave has stopped */
+    volatile uint32_t count; /* incremented each beat */
+    volatile DWORD tick;     /* GetTickCount() of the last beat */
+};
 
 
 class IPCBase{
 public:
-    /* we limit message size to make the implemenation much easier/safer; 
-       a more robust mechanism could manually write/read to/from the pipe server 
-       and loop on the read calls until ERROR_MORE_DATA isn't returned */
-    static const int MAX_MESSAGE_SZ = 511; // 2**9 excluding \0 
+    /* the largest (binary) message either side will send/accept */
+    static const int MAX_MESSAGE_SZ = IPCMessage::MAX_FRAME_SZ; 
 
-    /* arbitrary value the 'probe' channel sends/recieves to confirm connection */
+    /* arch (bits) and protocol version; master and slave have to match */
 #ifdef BUILD64BIT
-    static const uint8_t PROBE_BYTE = 64;
-    static const uint8_t PROBE_BYTE_WRONG_ARCH = 32;
+    static const uint32_t BUILD_WORD = (64 << 16) | IPCMessage::VERSION;
+    static const uint32_t BUILD_WORD_WRONG_ARCH = (32 << 16) | IPCMessage::VERSION;
 #else
-    static const uint8_t PROBE_BYTE = 32;
-    static const uint8_t PROBE_BYTE_WRONG_ARCH = 64;
+    static const uint32_t BUILD_WORD = (32 << 16) | IPCMessage::VERSION;
+    static const uint32_t BUILD_WORD_WRONG_ARCH = (64 << 16) | IPCMessage::VERSION;
 #endif
 
-    bool
-    connected(unsigned long timeout);
-
 protected:
     std::string _main_channel_pipe_name;
-    std::string _probe_channel_pipe_name; 
-
-    HANDLE _main_channel_pipe_hndl;       
-    HANDLE _probe_channel_pipe_hndl;
+    std::string _heartbeat_name; 
 
-    bool
-    send(std::string msg) const;
-   
-    bool
-    recv(std::string *msg) const;
-
-    template<typename T>
-    bool 
-    _call_pipe( std::string name,
-                T* in,
-                DWORD in_sz,
-                T* out, 
-                DWORD out_sz,
-                unsigned long timeout, 
-                std::function<bool(T*,DWORD)> handle_good_call,
-                std::function<void(void)> handle_file_not_found = nullptr ); 
+    HANDLE _heartbeat_hndl;
 
     IPCBase(std::string name)
         :    
             _main_channel_pipe_name(std::string("\\\\.\\pipe\\")
                 .append(name).append("_main_channel_pipe")),
-            _probe_channel_pipe_name(std::string("\\\\.\\pipe\\")
-                .append(name).append("_probe_channel_pipe")),        
-            _main_channel_pipe_hndl(INVALID_HANDLE_VALUE),
-            _probe_channel_pipe_hndl(INVALID_HANDLE_VALUE)          
+#ifdef NO_KGBLNS
+            _heartbeat_name(std::string(name).append("_heartbeat")),
+#else
+            _heartbeat_name(std::string("Global\\").append(name).append("_heartbeat")),
+#endif
+            _heartbeat_hndl(NULL)          
         {
         }
      
@@ -99,17 +183,20 @@ class IPCSlave
     SmartBuffer<SID> _sec_sid;      
     SmartBuffer<ACL> _sec_acl;   
 
-    std::thread _probe_channel_thread;
-    bool _probe_channel_run_flag;
+    std::unique_ptr<IPCServerChannel> _main_channel;
+
+    IPCHeartbeat *_heartbeat;
+    HANDLE _heartbeat_stop_event;
+    std::thread _heartbeat_thread;
 
     void    
     _init_security_objects();
 
-    HANDLE
-    _create_pipe(std::string name);
- 
     void
-    _listen_for_probes();
+    _init_heartbeat();
+
+    void
+    _beat();
 
 public:
     IPCSlave(std::string name)
@@ -119,60 +206,97 @@ public:
             _sec_desc(SECURITY_DESCRIPTOR()),
             _sec_sid(SECURITY_MAX_SID_SIZE),
             _sec_acl(ACL_SIZE),
-            _probe_channel_run_flag(true)
+            _heartbeat(nullptr),
+            _heartbeat_stop_event(NULL)
         {           
             _init_security_objects();    
         
-            _main_channel_pipe_hndl = _create_pipe(_main_channel_pipe_name);
-            _probe_channel_pipe_hndl = _create_pipe(_probe_channel_pipe_name); 
-
-            /* launch our probe channel so master can asynchronously check connection status*/
-            _probe_channel_thread = std::thread( std::bind(&IPCSlave::_listen_for_probes,this) );       
+            _main_channel.reset( 
+                new IPCServerChannel( 
+                    new NamedPipeServerTransport(_main_channel_pipe_name, &_sec_attr)
+                ) 
+            );
+
+            /* publish our heartbeat so masters can cheaply check connection status */
+            _init_heartbeat();
+            _heartbeat_thread = std::thread( std::bind(&IPCSlave::_beat,this) );       
         }    
 
     ~IPCSlave()
         {          
-            CloseHandle(_main_channel_pipe_hndl);         
-
-            _probe_channel_run_flag = false;            
-            connected(TOSDB_DEF_TIMEOUT); /* force evaluation of the run flag */
+            _main_channel.reset();
 
-            if(_probe_channel_thread.joinable())
-                _probe_channel_thread.join();
+            SetEvent(_heartbeat_stop_event);
+            if(_heartbeat_thread.joinable())
+                _heartbeat_thread.join();
 
-            CloseHandle(_probe_channel_pipe_hndl);
+            _heartbeat->pid = 0; /* masters see us as gone right away */
+            UnmapViewOfFile((LPCVOID)_heartbeat);
+            CloseHandle(_heartbeat_hndl);
+            CloseHandle(_heartbeat_stop_event);
         }
     
-    bool 
-    wait_for_master();
+    typedef IPCServerChannel::client_ty master_ty;
 
-    void 
-    drop_master()
+    /* BLOCK until a request arrives from any master; false if the channel 
+       fails (can't accept connections) */
+    bool
+    recv(IPCMessage *msg, master_ty *from)
     {
-        FlushFileBuffers(_main_channel_pipe_hndl);
-        DisconnectNamedPipe(_main_channel_pipe_hndl);    
+        return _main_channel->recv(msg, from);
     }
 
-    using IPCBase::send;
-    using IPCBase::recv;  
+    /* reply to the master 'from' recv() */
+    bool
+    send(const master_ty& to, const IPCMessage& msg)
+    {
+        return _main_channel->send(to, msg);
+    }
 };
 
 
 class IPCMaster
         : public IPCBase{
+    /* one persistent connection to the engine, shared by all threads */
+    IPCClientChannel _main_channel;
+
+    /* slave's heartbeat (read-only view), mapped on first use */
+    std::atomic<const IPCHeartbeat*> _heartbeat;
+    std::mutex _heartbeat_mtx;
+    std::atomic<bool> _logged_build_mismatch;
+
+    const IPCHeartbeat*
+    _open_heartbeat();
+
 public:
     IPCMaster(std::string name)
         :
-            IPCBase(name)
+            IPCBase(name),
+            _main_channel( new NamedPipeClientTransport(_main_channel_pipe_name) ),
+            _heartbeat(nullptr),
+            _logged_build_mismatch(false)
         {
         }
 
     ~IPCMaster()
         {                      
+            const IPCHeartbeat *hb = _heartbeat.load();
+            if(hb){
+                UnmapViewOfFile((LPCVOID)hb);
+                CloseHandle(_heartbeat_hndl);
+            }
         }
 
+    /* true if the slave is running (and the same build) and has beat in 
+       the last 'timeout' msec; only reads shared memory once mapped */
+    bool
+    connected(unsigned long timeout);
+
+    /* send request 'msg' and replace it with the engine's reply; false if 
+       the call fails or the reply is malformed/doesn't match the request.
+       Thread-safe: concurrent calls share the connection */
     bool
-    call(std::string *msg, unsigned long timeout);
+    call(IPCMessage *msg, unsigned long timeout);
 };
 
 
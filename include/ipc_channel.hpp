@@ -0,0 +1,166 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_TOSDB_IPC_CHANNEL
+#define JO_TOSDB_IPC_CHANNEL
+
+#include <map>
+#include <list>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+#include "ipc_protocol.hpp"
+
+/* 
+   Persistent, multiplexed control channel built on the transports in 
+   ipc_protocol.hpp (OS independent).
+
+   IPCClientChannel (master side) keeps one long-lived connection and lets 
+   any number of threads have requests outstanding on it at once; replies 
+   are matched to callers by request id so they can come back in any order. 
+   There is no background thread (we live in a DLL): whichever caller isn't 
+   yet answered reads replies for everyone - handing the job to another 
+   waiter when its own reply shows up.
+
+   IPCServerChannel (engine side) accepts any number of connections, reads 
+   each on its own thread and queues complete requests for the consumer 
+   (recv) to answer (send) in whatever order it chooses.
+*/
+
+class IPCClientChannel{
+    struct _waiter{
+        std::condition_variable cond;
+        IPCMessage *msg;
+        bool done;
+        bool ok;
+    };
+
+    std::unique_ptr<IPCClientTransport> _transport;
+    std::shared_ptr<IPCConnection> _conn;
+
+    /* protects _conn, _pending, _reading, _next_id */
+    std::mutex _mtx; 
+    std::mutex _write_mtx;
+
+    std::map<uint32_t, _waiter*> _pending;
+    bool _reading;
+    uint32_t _next_id;
+
+    void
+    _fail_connection(std::shared_ptr<IPCConnection> conn);
+
+    IPCClientChannel(const IPCClientChannel&);
+    IPCClientChannel& operator=(const IPCClientChannel&);
+
+public:
+    /* takes ownership of 'transport' */
+    explicit IPCClientChannel(IPCClientTransport *transport)
+        :
+            _transport(transport),
+            _reading(false),
+            _next_id(1)
+        {
+        }
+
+    ~IPCClientChannel()
+        {
+            close();
+        }
+
+    /* send request 'msg' and replace it with its reply; (re)connects if 
+       necessary, waiting up to 'timeout' msec for the server. False if we 
+       can't connect, the connection fails before the reply, or the reply 
+       can't be decoded (the connection is dropped; next call reconnects) */
+    bool
+    call(IPCMessage *msg, unsigned long timeout);
+
+    /* drop the connection; outstanding calls fail */
+    void
+    close();
+};
+
+
+class IPCServerChannel{
+    struct _client{
+        std::unique_ptr<IPCConnection> conn;
+        std::mutex write_mtx;
+        std::thread reader;
+        std::atomic<bool> finished;
+
+        explicit _client(IPCConnection *c)
+            : 
+                conn(c), 
+                finished(false)
+            {
+            }
+    };
+
+public:
+    typedef std::shared_ptr<_client> client_ty;
+
+    /* takes ownership of 'transport' and starts accepting */
+    explicit IPCServerChannel(IPCServerTransport *transport);
+
+    ~IPCServerChannel()
+        {
+            stop();
+        }
+
+    /* BLOCK until a request arrives from any client; false once stop()'d 
+       or if the transport fails to accept */
+    bool
+    recv(IPCMessage *msg, client_ty *from);
+
+    /* reply to the client a request came from */
+    bool
+    send(const client_ty& to, const IPCMessage& msg);
+
+    /* stop accepting, close all connections, wake recv */
+    void
+    stop();
+
+private:
+    std::unique_ptr<IPCServerTransport> _transport;
+
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    std::deque<std::pair<IPCMessage, client_ty>> _requests;
+    std::list<client_ty> _clients;
+    bool _stopped;
+    bool _failed;
+
+    std::thread _accept_thread;
+
+    void
+    _accept_loop();
+
+    void
+    _read_loop(client_ty c);
+
+    void
+    _reap(bool all);
+
+    IPCServerChannel(const IPCServerChannel&);
+    IPCServerChannel& operator=(const IPCServerChannel&);
+};
+
+#endif
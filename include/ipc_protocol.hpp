@@ -0,0 +1,329 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_TOSDB_IPC_PROTOCOL
+#define JO_TOSDB_IPC_PROTOCOL
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/* 
+   Binary, length-prefixed framing for the control channel between client 
+   library/service (master) and engine (slave). Nothing in here is OS 
+   specific; the bytes are moved by an IPCServerTransport/IPCClientTransport 
+   (named pipes on windows, unix domain sockets elsewhere - for testing).
+
+   frame (all integers little-endian):
+
+     | magic(4) | version(2) | flags(2) | request id(4) | nrecords(4) | body len(4) | body |
+
+   body: 'nrecords' records back-to-back, each a count of typed fields:
+
+     | nfields(2) | field | field | ... |
+
+   field: a type tag followed by its payload
+
+     FIELD_U32 | tag(1) | value(4)          |
+     FIELD_I32 | tag(1) | value(4)          |
+     FIELD_STR | tag(1) | len(2) | bytes    |  (no null terminator)
+
+   Each opcode defines the layout of its request record; a reply carries one 
+   record per request record, in order (see the layouts below).
+*/
+
+class IPCRecord{
+public:
+    static const uint8_t FIELD_U32 = 1;
+    static const uint8_t FIELD_I32 = 2;
+    static const uint8_t FIELD_STR = 3;
+
+    IPCRecord&
+    add_u32(uint32_t val);
+
+    IPCRecord&
+    add_i32(int32_t val);
+
+    IPCRecord&
+    add_string(const std::string& val);
+
+    inline size_t
+    size() const 
+    { 
+        return _fields.size(); 
+    }
+
+    /* return false if field 'i' doesn't exist or is of a different type */
+    bool
+    get_u32(size_t i, uint32_t *val) const;
+
+    bool
+    get_i32(size_t i, int32_t *val) const;
+
+    bool
+    get_string(size_t i, std::string *val) const;
+
+private:
+    friend class IPCMessage;
+
+    struct _field{
+        uint8_t type;
+        uint32_t val; /* FIELD_U32 and FIELD_I32 (bits) */
+        std::string str;
+    };
+
+    std::vector<_field> _fields;
+};
+
+
+class IPCMessage{
+public:
+    static const uint32_t MAGIC = 0x42534F54; /* "TOSB" */
+    static const uint16_t VERSION = 1;
+
+    static const uint16_t FLAG_REPLY = 0x01;
+    static const uint16_t FLAG_ERROR = 0x02; /* frame couldn't be handled */
+
+    static const size_t HEADER_SZ = 20;
+
+    /* the largest frame we'll build or accept (header included) */
+    static const size_t MAX_FRAME_SZ = 65536;
+
+    /* a single string field can't exceed this (len is 2 bytes) */
+    static const size_t MAX_STRING_SZ = 0xFFFF;
+
+    explicit IPCMessage(uint32_t request_id = 0, uint16_t flags = 0)
+        :
+            _request_id(request_id),
+            _flags(flags)
+        {
+        }
+
+    /* append a new (empty) record and return it for the caller to fill */
+    IPCRecord&
+    add_record();
+
+    inline size_t
+    size() const 
+    { 
+        return _records.size(); 
+    }
+
+    inline bool
+    empty() const 
+    { 
+        return _records.empty(); 
+    }
+
+    inline const IPCRecord&
+    operator[](size_t i) const 
+    { 
+        return _records[i]; 
+    }
+
+    inline uint32_t
+    request_id() const 
+    { 
+        return _request_id; 
+    }
+
+    inline void
+    request_id(uint32_t id) 
+    { 
+        _request_id = id; 
+    }
+
+    inline uint16_t
+    flags() const 
+    { 
+        return _flags; 
+    }
+
+    inline void
+    flags(uint16_t f) 
+    { 
+        _flags = f; 
+    }
+
+    /* serialize into 'frame'; false if the result would exceed MAX_FRAME_SZ */
+    bool
+    encode(std::string *frame) const;
+
+    /* parse a complete frame; false (and *msg untouched) if malformed, the 
+       wrong version, or not exactly one frame long */
+    static bool
+    decode(const char *frame, size_t len, IPCMessage *msg);
+
+    /* given at least HEADER_SZ bytes, the full length of the frame they start; 
+       0 if the header is bad. Lets stream transports read exactly one frame */
+    static size_t
+    frame_size(const char *header, size_t len);
+
+    /* request id from the header of a frame that may not decode (0 if too 
+       short); lets a server answer a malformed request with FLAG_ERROR */
+    static uint32_t
+    request_id_of(const char *frame, size_t len);
+
+private:
+    uint32_t _request_id;
+    uint16_t _flags;
+    std::vector<IPCRecord> _records;
+};
+
+
+/* 
+   Record layouts used by client/engine:
+
+   stream ops (TOSDB_SIG_ADD, TOSDB_SIG_REMOVE, TOSDB_SIG_TEST):
+       request: | u32 opcode | str topic | str item | u32 timeout |
+
+   control ops (TOSDB_SIG_PAUSE, TOSDB_SIG_CONTINUE, TOSDB_SIG_STOP, TOSDB_SIG_DUMP):
+       request: | u32 opcode |
+
+   reply (one per request record):
+       | i32 return code |
+*/
+
+
+/* 
+   How frames are moved. A connection is a persistent, full-duplex channel 
+   that preserves frame boundaries (read_frame returns exactly one frame); 
+   one thread may read while another writes. The engine accepts connections 
+   from a server transport, master objects make them with a client transport.
+*/
+
+class IPCConnection{
+public:
+    virtual 
+    ~IPCConnection() 
+        {
+        }
+
+    virtual bool
+    read_frame(std::string *frame) = 0;
+
+    virtual bool
+    write_frame(const std::string& frame) = 0;
+
+    /* fail any read/write blocked in another thread, and all that follow */
+    virtual void
+    close() = 0;
+};
+
+
+class IPCServerTransport{
+public:
+    virtual 
+    ~IPCServerTransport() 
+        {
+        }
+
+    /* BLOCK until a client connects; NULL on failure or after interrupt() */
+    virtual IPCConnection*
+    accept() = 0;
+
+    /* unblock accept() in another thread (for shutdown) */
+    virtual void
+    interrupt() = 0;
+};
+
+
+class IPCClientTransport{
+public:
+    virtual 
+    ~IPCClientTransport() 
+        {
+        }
+
+    /* wait up to 'timeout' msec for the server; NULL on failure */
+    virtual IPCConnection*
+    connect(unsigned long timeout) = 0;
+};
+
+
+#ifndef _WIN32
+
+/* unix domain socket versions; let us run the protocol (and test it) off windows */
+
+class UnixSocketConnection
+        : public IPCConnection{
+    int _fd;
+
+public:
+    explicit UnixSocketConnection(int fd)
+        :
+            _fd(fd)
+        {
+        }
+
+    ~UnixSocketConnection();
+
+    bool
+    read_frame(std::string *frame);
+
+    bool
+    write_frame(const std::string& frame);
+
+    void
+    close();
+};
+
+
+class UnixSocketServerTransport
+        : public IPCServerTransport{
+    std::string _path;
+    int _listen_fd;
+
+public:
+    /* binds/listens on 'path'; throws std::runtime_error on failure */
+    explicit UnixSocketServerTransport(std::string path);
+
+    ~UnixSocketServerTransport();
+
+    IPCConnection*
+    accept();
+
+    void
+    interrupt();
+};
+
+
+class UnixSocketClientTransport
+        : public IPCClientTransport{
+    std::string _path;
+
+public:
+    explicit UnixSocketClientTransport(std::string path)
+        :
+            _path(path)
+        {
+        }
+
+    IPCConnection*
+    connect(unsigned long timeout);
+};
+
+/* read/write exactly one frame on a connected stream socket */
+bool
+IPCReadFrameFD(int fd, std::string *frame);
+
+bool
+IPCWriteFrameFD(int fd, const std::string& frame);
+
+#endif /* _WIN32 */
+
+#endif
@@ -0,0 +1,31 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+#ifndef JO_TOSDB_LOGGING
+#define JO_TOSDB_LOGGING
+
+/* 
+   Internal to the core DLL (logging.cpp, main.cpp); NOT part of the API - 
+   the public logging calls are in tos_databridge.h 
+*/
+
+/* hands the calling thread's log ring (see LogRing in logging.cpp) back to 
+   the pool; called on DLL_THREAD_DETACH */
+void
+ReleaseThreadLogRing();
+
+#endif
@@ -21,30 +21,99 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include "data_stream.hpp"
 #include "client.hpp"
 #include <memory>
+#include <tuple>
 
 /* implemented in src/raw_data_block.tpp */
 
 #define RAW_DATA_BLOCK_TEMPLATE template<typename GenericTy, typename DateTimeTy>
 #define RAW_DATA_BLOCK_CLASS RawDataBlock<GenericTy, DateTimeTy>
-#define MAX_BLOCK_COUNT 10
+#define MAX_BLOCK_COUNT 1000
 
 template<typename GenericTy, typename DateTimeTy>
 class RawDataBlock {        
     static size_type _block_count_;
     static size_type _max_block_count_;
 
+    typedef std::shared_ptr<DataStreamInterface<DateTimeTy, GenericTy>> _my_stream_ptr_ty;
+
+    /* DateTimeTy* or a long long* w/ a converter (e.g epoch micro-seconds) */
+    typedef typename DataStreamInterface<DateTimeTy, GenericTy>::secondary_dest _my_datetime_dest_ty;
+
+    /* blocks that add the same item/topic w/ the same stream settings share 
+       one stream (so it's only pushed to once) instead of each creating its 
+       own. The registry maps ((item, topic), (block size, hot size, 
+       compressed, datetime)) to that stream; it doesn't own it, the blocks 
+       do. Each block reads a shared stream through its cursor - a named 
+       marker unique to the block - and its named markers are prefixed w/ 
+       the cursor (see stream_view). Changing a setting (or enabling stats) 
+       gives the block its own copy of any stream it shares. 
+
+       Whether a stream is shared is decided by _owners_ - the # of blocks 
+       holding it - not its use_count; views/typed refs hold it too */
+    typedef std::pair<std::pair<std::string, TOS_Topics::TOPICS>,
+                      std::tuple<size_type, size_type, bool, bool>> _my_registry_key_ty;
+
+    typedef std::map<_my_registry_key_ty, 
+                     std::weak_ptr<DataStreamInterface<DateTimeTy, GenericTy>>> _my_registry_ty;
+
+    typedef std::map<const DataStreamInterface<DateTimeTy, GenericTy>*, 
+                     size_type> _my_owners_ty;
+
+    static _my_registry_ty _registry_;
+    static _my_owners_ty _owners_; /* every stream a block holds */
+    static std::mutex _registry_mtx_; /* guards _registry_ and _owners_ */
+    static size_type _block_serial_;
+
+    /* streams are kept in a dense (item id x topic id) matrix, row-major w/ 
+       _ncols columns; ids are assigned when an item/topic is added and 
+       recycled when it's removed. The name -> id indices are only used at 
+       the edge of the interface, everything else is array indexing */
+    typedef std::vector<_my_stream_ptr_ty> _my_matrix_ty;
+    typedef std::unordered_map<std::string, size_type> _my_item_ids_ty;
     typedef std::map<const TOS_Topics::TOPICS, 
-                     std::unique_ptr<DataStreamInterface<DateTimeTy, GenericTy>>, 
-                     TOS_Topics::top_less> _my_row_ty;  
+                     size_type, 
+                     TOS_Topics::top_less> _my_topic_ids_ty;
 
-    typedef std::unordered_map<std::string, std::unique_ptr<_my_row_ty>> _my_block_ty;
+    /* (item id, topic id) of stream w/ stats enabled -> topic id used for its 
+       vwap weight */
+    typedef std::map<std::pair<size_type, size_type>, size_type> _my_stats_weights_ty;
         
-    _my_block_ty _block;
+    _my_matrix_ty _streams;
+    _my_item_ids_ty _item_ids;
+    _my_topic_ids_ty _topic_ids;
+    std::vector<size_type> _free_item_ids;
+    std::vector<size_type> _free_topic_ids;
+    std::vector<size_type> _item_order; /* ids in subscription order */
+    std::vector<size_type> _topic_order;
+    size_type _nrows;
+    size_type _ncols;
+    _my_stats_weights_ty _stats_weights;
+    str_set_type _marker_names; /* named markers added to every stream */
+    std::string _cursor; /* see _my_registry_ty */
     size_type _block_sz;
+    size_type _hot_sz; /* 0 if streams aren't spilling */
+    bool _cold_compressed;
     str_set_type _item_names;  
     topic_set_type _topic_enums;
     bool _datetime;  
+    /* guards the block's structure (ids, matrix, settings); stream data is 
+       synchronized by each stream, views/refs hold the stream not this */
     std::recursive_mutex *const _mtx;
+    /* serializes block_size/hot_size/cold_compressed; they only take _mtx 
+       to switch settings, the streams are changed outside of it */
+    std::mutex *const _settings_mtx;
+
+    /* one of the block's streams whose settings are being changed w/o the 
+       block's lock (see _begin_change); if it's shared the change is made 
+       to 'copy', which _end_change puts in its place */
+    struct _my_change_ty {
+        size_type item_id;
+        size_type topic_id;
+        TOS_Topics::TOPICS topic;
+        bool shared;
+        _my_stream_ptr_ty stream;
+        _my_stream_ptr_ty copy;
+    };
 
     RawDataBlock(str_set_type items, 
                  topic_set_type topics_t, 
@@ -55,14 +124,16 @@ class RawDataBlock {
 
     RawDataBlock(const RawDataBlock& block)
         : 
-            _mtx(new std::recursive_mutex) 
+            _mtx(new std::recursive_mutex),
+            _settings_mtx(new std::mutex)
         { 
             /* ++_block_count_; */ 
         }
 
     RawDataBlock(RawDataBlock&& block)
         :
-            _mtx(new std::recursive_mutex) 
+            _mtx(new std::recursive_mutex),
+            _settings_mtx(new std::mutex)
         { 
             /* */ 
         }
@@ -76,17 +147,257 @@ class RawDataBlock {
     void 
     _init();
 
-    _my_row_ty*     
-    _insert_topic(_my_row_ty*, TOS_Topics::TOPICS topic);
+    inline DataStreamInterface<DateTimeTy, GenericTy>*
+    _cell(size_type item_id, size_type topic_id) const
+    {
+        return _streams[item_id * _ncols + topic_id].get();
+    }
+
+    /* throws std::out_of_range if the stream couldn't be created */
+    inline DataStreamInterface<DateTimeTy, GenericTy>*
+    _cell_at(size_type item_id, size_type topic_id) const
+    {
+        DataStreamInterface<DateTimeTy, GenericTy> *stream = _cell(item_id, topic_id);
+        if(!stream)
+            throw std::out_of_range("stream not in block");
+        return stream;
+    }
+
+    /* null if the item/topic isn't in the block */
+    DataStreamInterface<DateTimeTy, GenericTy>*
+    _find_stream(const std::string& item, TOS_Topics::TOPICS topic) const;
+
+    size_type
+    _add_item_id(const std::string& item);
+
+    size_type
+    _add_topic_id(TOS_Topics::TOPICS topic);
+
+    /* fill a frame column from streams created as DataStream<StoreTy,...> */
+    template<typename StoreTy, typename T>
+    size_type
+    _front_column(size_type topic_id, 
+                  T *dest, 
+                  size_type n, 
+                  _my_datetime_dest_ty datetime, 
+                  size_type *item_ids) const;
+
+    _my_registry_key_ty
+    _registry_key(const std::string& item, TOS_Topics::TOPICS topic) const;
+
+    DataStreamInterface<DateTimeTy, GenericTy>*
+    _new_stream(TOS_Topics::TOPICS topic) const;
+
+    /* copy of a stream created by _new_stream(topic) */
+    DataStreamInterface<DateTimeTy, GenericTy>*
+    _clone_stream(TOS_Topics::TOPICS topic, 
+                  const DataStreamInterface<DateTimeTy, GenericTy>& stream) const;
+
+    /* attach to the registered stream for (item, topic) or create one */
+    void
+    _insert_topic(size_type item_id, 
+                  size_type topic_id, 
+                  const std::string& item, 
+                  TOS_Topics::TOPICS topic);
+
+    /* remove the block's markers from the stream and let go of it */
+    void
+    _release_topic(size_type item_id, 
+                   size_type topic_id, 
+                   const std::string& item, 
+                   TOS_Topics::TOPICS topic);
+
+    /* true if other blocks hold the stream; if not it's unregistered so no
+       block attaches to it while its settings change */
+    bool
+    _unshare(const _my_stream_ptr_ty& stream, 
+             const std::string& item, 
+             TOS_Topics::TOPICS topic);
+
+    /* marker _copy_stream leaves on the stream it copied, to tell _swap_in 
+       what was pushed since; no cursor is a prefix of it */
+    inline std::string
+    _sync_marker() const
+    {
+        return '\x02' + _cursor;
+    }
+
+    /* the block's own copy of a shared stream; only its markers come along */
+    _my_stream_ptr_ty
+    _copy_stream(TOS_Topics::TOPICS topic, const _my_stream_ptr_ty& stream) const;
+
+    /* put the copy of a shared stream in its place (pushing what the stream
+       got since it was copied) and let go of it. A push made after this thru
+       a typed ref taken before it still goes to the old stream */
+    void
+    _swap_in(size_type item_id, 
+             size_type topic_id, 
+             const _my_stream_ptr_ty& stream, 
+             const _my_stream_ptr_ty& copy);
+
+    /* copy the stream if it's shared and unregister it, so its settings can 
+       change; call _register_all w/ the new settings once they have */
+    void
+    _make_exclusive(size_type item_id, 
+                    size_type topic_id, 
+                    const std::string& item, 
+                    TOS_Topics::TOPICS topic);
+
+    /* register the block's streams that don't have stats enabled under the 
+       current settings (unless another stream already is) */
+    void
+    _register_all();
+
+    /* _unshare the streams whose settings are about to change (all but the
+       strings if 'skip_strings'); call w/ _mtx held, then switch settings */
+    std::vector<_my_change_ty>
+    _begin_change(bool skip_strings);
+
+    /* w/o _mtx: apply(stream_type*) to each stream, or a copy if it's shared,
+       then _end_change; if apply throws the changes made so far are kept */
+    template<typename F>
+    void
+    _change_streams(std::vector<_my_change_ty>& changes, F apply);
+
+    /* swap in the copies of the streams that are still in the block; w/ _mtx */
+    void
+    _end_change(std::vector<_my_change_ty>& changes);
+
+    /* type bits of the topics whose streams hold T (see _insert_topic) */
+    static inline type_bits_type 
+    _type_bits(const std::string*) 
+    { 
+        return TOSDB_STRING_BIT; 
+    }
+
+    static inline type_bits_type 
+    _type_bits(const long*) 
+    { 
+        return TOSDB_INTGR_BIT; 
+    }
 
-    std::unique_ptr<_my_row_ty> 
-    _populate_tblock(std::unique_ptr<_my_row_ty> tblock);
+    static inline type_bits_type 
+    _type_bits(const double*) 
+    { 
+        return TOSDB_QUAD_BIT; 
+    }
+
+    static inline type_bits_type 
+    _type_bits(const long long*) 
+    { 
+        return TOSDB_INTGR_BIT | TOSDB_QUAD_BIT; 
+    }
+
+    static inline type_bits_type 
+    _type_bits(const float*) 
+    { 
+        return 0; 
+    }
 
 public:
     typedef GenericTy generic_type;
     typedef DateTimeTy datetime_type;
     typedef DataStreamInterface<DateTimeTy, GenericTy> stream_type;
-    typedef const DataStreamInterface<DateTimeTy, GenericTy>* stream_const_ptr_type;
+    typedef _my_datetime_dest_ty datetime_dest_type;
+
+    /* a block's handle to one of its (possibly shared) streams; calls made 
+       through -> use the block's cursor in place of the stream's default 
+       marker. Named marker calls need the stream's name for the block's 
+       marker, i.e dat->marker_position( dat.marker_name(name) ) 
+
+       The view shares ownership of the stream, so it stays usable w/o the 
+       block's lock even if the block lets go of it (e.g remove_topic); 
+       access is synchronized by the stream itself */
+    class stream_view {
+        std::shared_ptr<const stream_type> _stream;
+        std::string _cursor;
+
+        /* selects the cursor until the end of the full expression */
+        class _cursor_scope {
+            const stream_type *_stream;
+            typename stream_type::marker_scope _scope;
+
+            _cursor_scope(const _cursor_scope&);
+
+            _cursor_scope& 
+            operator=(const _cursor_scope&);
+
+        public:
+            _cursor_scope(const stream_type *stream, const std::string& cursor)
+                :
+                    _stream(stream),
+                    _scope(stream, cursor)
+                {
+                }
+
+            _cursor_scope(_cursor_scope&& scope)
+                :
+                    _stream(scope._stream),
+                    _scope(std::move(scope._scope))
+                {
+                }
+
+            inline const stream_type*
+            operator->() const
+            {
+                return _stream;
+            }
+        };
+
+    public:
+        stream_view()
+            {
+            }
+
+        stream_view(std::shared_ptr<const stream_type> stream, const std::string& cursor)
+            :
+                _stream(std::move(stream)),
+                _cursor(cursor)
+            {
+            }
+
+        stream_view(stream_view&& view)
+            :
+                _stream(std::move(view._stream)),
+                _cursor(std::move(view._cursor))
+            {
+            }
+
+        stream_view(const stream_view& view)
+            :
+                _stream(view._stream),
+                _cursor(view._cursor)
+            {
+            }
+
+        stream_view&
+        operator=(stream_view view)
+        {
+            _stream.swap(view._stream);
+            _cursor.swap(view._cursor);
+            return *this;
+        }
+
+        inline _cursor_scope
+        operator->() const
+        {
+            return _cursor_scope(_stream.get(), _cursor);
+        }
+
+        /* the raw stream, e.g for lock_scope */
+        inline operator const stream_type*() const
+        {
+            return _stream.get();
+        }
+
+        inline std::string
+        marker_name(const std::string& name) const
+        {
+            return _cursor + name;
+        }
+    };
+
+    typedef stream_view stream_const_ptr_type;
     
     typedef std::vector<generic_type> vector_type; 
     typedef std::pair<std::string, generic_type> pair_type; 
@@ -101,6 +412,93 @@ public:
 
     typedef std::map<std::string, map_datetime_type> matrix_datetime_type; 
 
+    /* typed handle to a stream whose value type is T: calls go straight to the
+       concrete DataStream (no virtual dispatch or type-check exceptions) so 
+       the extract and get paths can inline. Like stream_view it shares 
+       ownership of the stream (and the vwap weight stream) instead of 
+       holding the block's lock, and copy() uses the block's cursor; 
+       valid() is false if T isn't the stream's type. */
+    template<typename T>
+    class TypedStreamRef {
+        typedef DataStream<T, DateTimeTy, GenericTy, false> _my_primary_ty;
+        typedef DataStream<T, DateTimeTy, GenericTy, true> _my_secondary_ty;
+
+        _my_stream_ptr_ty _stream;
+        _my_stream_ptr_ty _weight; /* stats (vwap) weight stream, if any */
+        std::string _cursor;
+        _my_primary_ty *_primary; 
+        _my_secondary_ty *_secondary; /* null if block doesn't use datetime */
+
+        TypedStreamRef(const TypedStreamRef&);
+        
+        TypedStreamRef& 
+        operator=(const TypedStreamRef&);
+
+        TypedStreamRef()
+            :
+                _primary(nullptr),
+                _secondary(nullptr)
+            {
+            }
+
+        friend class RawDataBlock;
+
+    public:
+        TypedStreamRef(TypedStreamRef&& ref)
+            :
+                _stream(std::move(ref._stream)),
+                _weight(std::move(ref._weight)),
+                _cursor(std::move(ref._cursor)),
+                _primary(ref._primary),
+                _secondary(ref._secondary)
+            {
+                ref._primary = nullptr;
+                ref._secondary = nullptr;
+            }
+
+        inline bool
+        valid() const
+        {
+            return (_primary != nullptr);
+        }
+
+        /* the underlying stream (even if !valid); equal for blocks that 
+           share it, so a push can be done once for all of them */
+        inline const void*
+        stream_id() const
+        {
+            return _stream.get();
+        }
+
+        inline size_t
+        size() const
+        {
+            return _primary->_my_primary_ty::size();
+        }
+
+        inline void
+        push(const T& val, DateTimeTy datetime = DateTimeTy())
+        {
+            if(_weight && !_weight->empty())
+                _primary->_my_primary_ty::stats_weight( _weight->get_leave_marker(0).as_double() );
+
+            if(_secondary)
+                _secondary->_my_secondary_ty::push(val, std::move(datetime));
+            else
+                _primary->_my_primary_ty::push(val);
+        }
+
+        inline size_t
+        copy(T *dest, size_t sz, int end = -1, int beg = 0, datetime_dest_type datetime = nullptr) const
+        {
+            typename stream_type::marker_scope scope(_primary, _cursor);
+
+            return _secondary 
+                ? _secondary->_my_secondary_ty::copy(dest, sz, end, beg, datetime)
+                : _primary->_my_primary_ty::copy(dest, sz, end, beg, datetime);
+        }
+    };
+
     static RawDataBlock* const 
     CreateBlock(const str_set_type items, 
                 const topic_set_type topics_t,               
@@ -128,6 +526,8 @@ public:
         return (m >= _block_count_) ? (_max_block_count_ = m) : _max_block_count_; 
     }
     
+    /* streams are resized one at a time, each atomically under its own lock;
+       the block itself isn't locked for the duration */
     size_type 
     block_size(size_type b);
 
@@ -137,6 +537,27 @@ public:
         return _block_sz; 
     }  
 
+    /* keep the newest 'h' elems of each (non-string) stream on the heap and 
+       spill the rest to file-backed memory; 0 keeps everything on the heap */
+    size_type
+    hot_size(size_type h);
+
+    inline size_type
+    hot_size() const
+    {
+        return _hot_sz;
+    }
+
+    /* encode spilled data on the heap instead of using file-backed memory */
+    void
+    cold_compressed(bool on);
+
+    inline bool
+    cold_compressed() const
+    {
+        return _cold_compressed;
+    }
+
     inline size_type 
     item_count() const 
     { 
@@ -165,9 +586,55 @@ public:
     void 
     insert_data(TOS_Topics::TOPICS topic,std::string item,Val val,DT datetime); 
 
-    const DataStreamInterface<DateTimeTy, GenericTy>* 
+    /* throws if the stream doesn't exist; see stream_view */
+    stream_view
     raw_stream_ptr(std::string item, TOS_Topics::TOPICS topic) const;
 
+    /* throws if the stream doesn't exist; see TypedStreamRef */
+    template<typename T>
+    TypedStreamRef<T>
+    typed_stream_ref(std::string item, TOS_Topics::TOPICS topic);
+
+    /* resolve a stream to its (item id, topic id) once, so callers that hold
+       on to it (stream handles) can skip the name lookups below; the ids are
+       recycled when the item/topic is removed, callers have to drop them
+       first. Throws if the stream doesn't exist */
+    void
+    stream_ids(const std::string& item,
+               TOS_Topics::TOPICS topic,
+               size_type *item_id,
+               size_type *topic_id) const;
+
+    stream_view
+    raw_stream_ptr(size_type item_id, size_type topic_id) const;
+
+    template<typename T>
+    TypedStreamRef<T>
+    typed_stream_ref(size_type item_id, size_type topic_id, TOS_Topics::TOPICS topic);
+
+    /* weight_topic (e.g LAST_SIZE) is optional; its most recent value is used as 
+       the weight for each value pushed to the stream (e.g LAST) for vwap */
+    void
+    stream_stats(std::string item, 
+                 TOS_Topics::TOPICS topic, 
+                 bool enable, 
+                 TOS_Topics::TOPICS weight_topic = TOS_Topics::TOPICS::NULL_TOPIC);
+
+    /* named markers are added to every stream in the block, including those 
+       of items/topics added later; throws if the marker already exists */
+    void
+    add_marker(std::string name);
+
+    /* throws if the marker doesn't exist */
+    void
+    remove_marker(std::string name);
+
+    inline bool
+    has_marker(std::string name) const
+    {
+        return (_marker_names.find(name) != _marker_names.cend());
+    }
+
     map_type 
     map_of_frame_items(TOS_Topics::TOPICS topic) const;
 
@@ -185,6 +652,36 @@ public:
 
     matrix_datetime_type 
     pair_matrix_of_frame() const ;
+
+    /* item frame w/o building maps: the most recent value of 'topic' for 
+       the first 'n' items, in subscription order (see item_labels), written 
+       to caller columns; 'datetime' and 'item_ids' are optional. Returns the 
+       number of rows written */
+    template<typename T>
+    size_type
+    item_frame_columns(TOS_Topics::TOPICS topic, 
+                       T *dest, 
+                       size_type n, 
+                       datetime_dest_type datetime = nullptr, 
+                       size_type *item_ids = nullptr) const;
+
+    /* strings are truncated to str_len - 1 chars */
+    size_type
+    item_frame_columns(TOS_Topics::TOPICS topic, 
+                       char **dest, 
+                       size_type n, 
+                       size_type str_len,
+                       datetime_dest_type datetime = nullptr, 
+                       size_type *item_ids = nullptr) const;
+
+    /* (item id, item) in subscription order, i.e the row order of frame 
+       columns; an item's id is stable for as long as it's in the block */
+    std::vector<std::pair<size_type, std::string>>
+    item_labels() const;
+
+    /* (topic id, topic) in subscription order */
+    std::vector<std::pair<size_type, TOS_Topics::TOPICS>>
+    topic_labels() const;
     
     inline topic_set_type 
     topics() const 
@@ -217,8 +714,13 @@ public:
     }
 
     ~RawDataBlock() 
-    {   /* all other deallocs are handled by unique_ptr destructors */  
+    {   /* all other deallocs are handled by smart ptr destructors */  
+        for(auto & i : _item_ids){
+            for(auto & t : _topic_ids)
+                _release_topic(i.second, t.second, i.first, t.first);
+        }
         delete _mtx;        
+        delete _settings_mtx;
         --_block_count_;
     }
 }; 
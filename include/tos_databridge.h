@@ -86,6 +86,7 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <chrono>
 #include <thread>
 #include <memory>
+#include <future>
 
 #include "containers.hpp"/*custom client-facing containers */
 #include "generic.hpp" /* our 'generic' type */
@@ -180,6 +181,41 @@ typedef struct{
     long       micro_second;
 } DateTimeStamp, *pDateTimeStamp;
 
+#ifdef __cplusplus
+/* chronological ordering; lets streams binary search by datetime */
+inline bool
+operator<(const DateTimeStamp& left, const DateTimeStamp& right)
+{
+    const struct tm& l = left.ctime_struct;
+    const struct tm& r = right.ctime_struct;
+
+    if(l.tm_year != r.tm_year) return l.tm_year < r.tm_year;
+    if(l.tm_mon != r.tm_mon) return l.tm_mon < r.tm_mon;
+    if(l.tm_mday != r.tm_mday) return l.tm_mday < r.tm_mday;
+    if(l.tm_hour != r.tm_hour) return l.tm_hour < r.tm_hour;
+    if(l.tm_min != r.tm_min) return l.tm_min < r.tm_min;
+    if(l.tm_sec != r.tm_sec) return l.tm_sec < r.tm_sec;
+    return left.micro_second < right.micro_second;
+}
+#endif
+
+/* rolling statistics over the contents of a stream; see TOSDB_GetStreamStats */
+typedef struct{
+    double     min;
+    double     max;
+    double     mean;
+    double     variance; /* population */
+    double     vwap;     /* == mean if no weight topic */
+    size_type  count;
+} StreamStats, *pStreamStats;
+
+/* opaque handle to one stream (item, topic) of a block; see TOSDB_OpenStreamHandle */
+typedef unsigned long long StreamHandle;
+
+/* completion callback for the *Async admin calls: gets what the synchronous 
+   version would have returned; called on the library's admin thread */
+typedef void (*AsyncAdminCallback)(int ret, void* arg);
+
 /* reserve a block name for the implementation */
 #define TOSDB_RESERVED_BLOCK_NAME "___RESERVED_BLOCK_NAME___"
 
@@ -346,6 +382,20 @@ TOSDB_LogRaw_(Severity, LPCSTR , LPCSTR);
 #define TOSDB_LogRawH(tag,desc) TOSDB_LogRaw_(high, tag, desc)
 #define TOSDB_LogRaw(tag,desc) TOSDB_LogRaw_(low, tag, desc)
 
+/* 'Limited' versions are for paths that can fire in storms (bad feed data, 
+   a lost engine): messages are deduplicated by call site and 'key' (e.g the 
+   item, appended to the message), each pair gets a token bucket, and what's 
+   suppressed is counted and reported with the next message that gets through 
+   and in a periodic summary; pass a literal 'desc' so a suppressed call 
+   costs no formatting */
+DLL_SPEC_IMPL void    
+TOSDB_LogLimited_(Severity, LPCSTR file, int line, LPCSTR tag, LPCSTR key, LPCSTR desc); 
+
+#define TOSDB_LogLimitedH(tag,key,desc) \
+    TOSDB_LogLimited_(high, __FILE__, __LINE__, tag, key, desc)
+#define TOSDB_LogLimited(tag,key,desc) \
+    TOSDB_LogLimited_(low, __FILE__, __LINE__, tag, key, desc)
+
 EXT_C_SPEC  DLL_SPEC_IMPL  void  
 StartLogging(LPCSTR path);
 
@@ -673,6 +723,24 @@ TOSDB_GetBlockSize(LPCSTR id, size_type* pSize);
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
 TOSDB_SetBlockSize(LPCSTR id, size_type sz);
 
+/* the newest 'sz' elems of each (non-string) stream stay on the heap, older 
+   ones spill to file-backed memory; 0 (default) keeps everything on the heap.
+   Each spilled stream has its own temp file, mapping and view (2 handles, 4 
+   with datetime) so a block of N items x M topics holds up to 4*N*M handles;
+   cold compression (below) uses none */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetBlockHotSize(LPCSTR id, size_type* pSize);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_SetBlockHotSize(LPCSTR id, size_type sz);
+
+/* spilled data is delta/XOR encoded on the heap instead of file-backed */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_IsUsingColdCompression(LPCSTR id, unsigned int* is_compressed);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_SetBlockColdCompression(LPCSTR id, unsigned int compress);
+
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW unsigned long  
 TOSDB_GetLatency();
 
@@ -700,6 +768,22 @@ TOSDB_RemoveTopic(LPCSTR id, LPCSTR topic_str);
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
 TOSDB_RemoveItem(LPCSTR id, LPCSTR item);
 
+/* queue the op and return right away (0 if queued); queued ops run in order 
+   and the engine round-trip doesn't block readers of the block's streams. 
+   'callback' can be NULL */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
+TOSDB_AddAsync(LPCSTR id, LPCSTR* items, size_type items_len, LPCSTR* topics_str, 
+               size_type topics_len, AsyncAdminCallback callback, void* arg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
+TOSDB_RemoveTopicAsync(LPCSTR id, LPCSTR topic_str, AsyncAdminCallback callback, void* arg); 
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
+TOSDB_RemoveItemAsync(LPCSTR id, LPCSTR item, AsyncAdminCallback callback, void* arg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_CloseBlockAsync(LPCSTR id, AsyncAdminCallback callback, void* arg);
+
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
 TOSDB_GetItemCount(LPCSTR id, size_type* count);
 
@@ -712,6 +796,17 @@ TOSDB_GetTopicNames(LPCSTR id, LPSTR* dest, size_type array_len, size_type str_l
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
 TOSDB_GetItemNames(LPCSTR id, LPSTR* dest, size_type array_len, size_type str_len);
 
+/* names in subscription order (the row/column order of frame columns) w/ 
+   their indices; an index is stable for as long as the item/topic is in 
+   the block so labels only need to be re-fetched after adds/removes */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetItemLabels(LPCSTR id, LPSTR* dest, size_type array_len, size_type str_len, 
+                    size_type* item_indices);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetTopicLabels(LPCSTR id, LPSTR* dest, size_type array_len, size_type str_len, 
+                     size_type* topic_indices);
+
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
 TOSDB_GetPreCachedItemCount(LPCSTR id, size_type* count);
 
@@ -742,6 +837,30 @@ TOSDB_GetMarkerPosition(LPCSTR id,LPCSTR item, LPCSTR topic_str, long long* pos)
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
 TOSDB_IsMarkerDirty(LPCSTR id, LPCSTR item, LPCSTR topic_str, unsigned int* is_dirty);
 
+/* named markers are added to every stream of a block so independent consumers 
+   can each use the *FromNamedMarker calls w/o moving each other's marker */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_AddMarker(LPCSTR id, LPCSTR marker);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_RemoveMarker(LPCSTR id, LPCSTR marker);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetNamedMarkerPosition(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, long long* pos);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_IsNamedMarkerDirty(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, unsigned int* is_dirty);
+
+/* 'weight_topic_str' (e.g "LAST_SIZE") can be NULL; see TOSDB_GetStreamStats */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_EnableStreamStats(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR weight_topic_str);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_DisableStreamStats(LPCSTR id, LPCSTR item, LPCSTR topic_str);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetStreamStats(LPCSTR id, LPCSTR item, LPCSTR topic_str, pStreamStats stats);
+
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int           
 TOSDB_DumpSharedBufferStatus();
 
@@ -778,6 +897,20 @@ TOSDB_RemoveItem(std::string id, std::string item);
 DLL_SPEC_IFACE int   
 TOSDB_RemoveTopic(std::string id, TOS_Topics::TOPICS topic_t); 
 
+/* same queue as the C *Async calls; the future holds the return value (or 
+   the exception) of the synchronous version */
+DLL_SPEC_IFACE std::future<int>   
+TOSDB_AddAsync(std::string id, str_set_type items, topic_set_type topics_t);
+
+DLL_SPEC_IFACE std::future<int>   
+TOSDB_RemoveItemAsync(std::string id, std::string item); 
+
+DLL_SPEC_IFACE std::future<int>   
+TOSDB_RemoveTopicAsync(std::string id, TOS_Topics::TOPICS topic_t); 
+
+DLL_SPEC_IFACE std::future<int>   
+TOSDB_CloseBlockAsync(std::string id); 
+
 DLL_SPEC_IFACE str_set_type    
 TOSDB_GetBlockIDs();
 
@@ -790,6 +923,12 @@ TOSDB_GetTopicNames(std::string id);
 DLL_SPEC_IFACE str_set_type    
 TOSDB_GetItemNames(std::string id);
 
+DLL_SPEC_IFACE std::vector<std::pair<size_type, std::string>>    
+TOSDB_GetItemLabels(std::string id);
+
+DLL_SPEC_IFACE std::vector<std::pair<size_type, std::string>>    
+TOSDB_GetTopicLabels(std::string id);
+
 DLL_SPEC_IFACE topic_set_type  
 TOSDB_GetPreCachedTopicEnums(std::string id);
 
@@ -823,6 +962,18 @@ TOSDB_IsUsingDateTime(std::string id);
 DLL_SPEC_IFACE size_type      
 TOSDB_GetBlockSize(std::string id);
 
+DLL_SPEC_IFACE size_type      
+TOSDB_GetBlockHotSize(std::string id);
+
+DLL_SPEC_IFACE void      
+TOSDB_SetBlockHotSize(std::string id, size_type sz);
+
+DLL_SPEC_IFACE bool      
+TOSDB_IsUsingColdCompression(std::string id);
+
+DLL_SPEC_IFACE void      
+TOSDB_SetBlockColdCompression(std::string id, bool compress);
+
 DLL_SPEC_IFACE size_type       
 TOSDB_GetStreamOccupancy(std::string id, std::string item, TOS_Topics::TOPICS topic_t);
 
@@ -832,6 +983,30 @@ TOSDB_GetMarkerPosition(std::string id, std::string item, TOS_Topics::TOPICS top
 DLL_SPEC_IFACE bool            
 TOSDB_IsMarkerDirty(std::string id, std::string item, TOS_Topics::TOPICS topic_t);
 
+DLL_SPEC_IFACE void            
+TOSDB_AddMarker(std::string id, std::string marker);
+
+DLL_SPEC_IFACE void            
+TOSDB_RemoveMarker(std::string id, std::string marker);
+
+DLL_SPEC_IFACE long long       
+TOSDB_GetNamedMarkerPosition(std::string id, std::string item, TOS_Topics::TOPICS topic_t, std::string marker);
+
+DLL_SPEC_IFACE bool            
+TOSDB_IsNamedMarkerDirty(std::string id, std::string item, TOS_Topics::TOPICS topic_t, std::string marker);
+
+DLL_SPEC_IFACE void            
+TOSDB_EnableStreamStats(std::string id, 
+                        std::string item, 
+                        TOS_Topics::TOPICS topic_t,
+                        TOS_Topics::TOPICS weight_topic_t = TOS_Topics::TOPICS::NULL_TOPIC);
+
+DLL_SPEC_IFACE void            
+TOSDB_DisableStreamStats(std::string id, std::string item, TOS_Topics::TOPICS topic_t);
+
+DLL_SPEC_IFACE StreamStats            
+TOSDB_GetStreamStats(std::string id, std::string item, TOS_Topics::TOPICS topic_t);
+
 
 /* 'Get' C/C++ API  -  client_get.cpp
 
@@ -902,6 +1077,30 @@ TOSDB_GetLong(LPCSTR id, LPCSTR item, LPCSTR topic_str, long indx, long* dest, p
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
 TOSDB_GetString(LPCSTR id, LPCSTR item, LPCSTR topic_str, long indx, LPSTR dest, size_type str_len, pDateTimeStamp datetime);
 
+/* most recent value of many streams - (items[i], topics_str[i]) - in one call: the block 
+   is locked and looked up once instead of once per stream; status (optional) gets 0 or 
+   the error for each stream (skipped on error); returns TOSDB_ERROR_GET_DATA if any failed */
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetManyDoubles(LPCSTR id, LPCSTR* items, LPCSTR* topics_str, size_type n, double* dest, 
+                     pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetManyFloats(LPCSTR id, LPCSTR* items, LPCSTR* topics_str, size_type n, float* dest, 
+                    pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetManyLongLongs(LPCSTR id, LPCSTR* items, LPCSTR* topics_str, size_type n, long long* dest, 
+                       pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetManyLongs(LPCSTR id, LPCSTR* items, LPCSTR* topics_str, size_type n, long* dest, 
+                   pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetManyStrings(LPCSTR id, LPCSTR* items, LPCSTR* topics_str, size_type n, LPSTR* dest, 
+                     size_type str_len, pDateTimeStamp datetime, int* status);
+
 #ifdef __cplusplus   
 
 /* get multiple contiguous data points in the stream*/
@@ -974,6 +1173,14 @@ EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int
 TOSDB_GetStreamSnapshotStrings(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR* dest, size_type array_len, size_type str_len, 
                                pDateTimeStamp datetime, long end, long beg);
 
+/* strings packed into one buffer 'dest' (dest_sz bytes), each null-terminated; 'offsets' 
+   (array_len + 1 elems) gets where each starts and then the bytes used; get_size gets 
+   the # of strings copied (stops at the first that doesn't fit) */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsPacked(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR dest, size_type dest_sz, 
+                                     size_type* offsets, size_type array_len, pDateTimeStamp datetime, 
+                                     long end, long beg, size_type* get_size);
+
 /* 'guaranteed' to be contiguous between calls (Get, GetStreamSnapshot, GetStreamSnapshot) */
 
 EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
@@ -1014,6 +1221,328 @@ EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int
 TOSDB_GetNStringsFromMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR* dest, size_type n, size_type str_len, 
                             pDateTimeStamp datetime, long *get_size);
 
+/* same as the *FromMarker calls using a marker added w/ TOSDB_AddMarker (NULL for the default) */
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, double* dest, 
+                                              size_type array_len, pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, float* dest, 
+                                             size_type array_len, pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, long long* dest, 
+                                                size_type array_len, pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, long* dest, 
+                                            size_type array_len, pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, LPSTR* dest, 
+                                              size_type array_len, size_type str_len, pDateTimeStamp datetime, 
+                                              long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNDoublesFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, double* dest, size_type n, 
+                                 pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNFloatsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, float* dest, size_type n, 
+                                pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongLongsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, long long* dest, size_type n, 
+                                   pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, long* dest, size_type n, 
+                               pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNStringsFromNamedMarker(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker, LPSTR* dest, size_type n, 
+                                 size_type str_len, pDateTimeStamp datetime, long *get_size);
+
+/* stream handles: resolve (id, item, topic_str) once and use the *ByHandle versions of the 
+   calls above, which skip the string checks and the block/stream lookups. A handle stays 
+   valid until it's closed or its stream is removed (RemoveItem/RemoveTopic/CloseBlock); 
+   after that the calls return TOSDB_ERROR_BAD_INPUT. Close every handle that's opened */
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_OpenStreamHandle(LPCSTR id, LPCSTR item, LPCSTR topic_str, StreamHandle* handle);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_CloseStreamHandle(StreamHandle handle);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetStreamOccupancyByHandle(StreamHandle handle, size_type* sz);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetMarkerPositionByHandle(StreamHandle handle, long long* pos);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_IsMarkerDirtyByHandle(StreamHandle handle, unsigned int* is_dirty);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_GetNamedMarkerPositionByHandle(StreamHandle handle, LPCSTR marker, long long* pos);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int            
+TOSDB_IsNamedMarkerDirtyByHandle(StreamHandle handle, LPCSTR marker, unsigned int* is_dirty);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetDoubleByHandle(StreamHandle handle, long indx, double* dest, pDateTimeStamp datetime);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetFloatByHandle(StreamHandle handle, long indx, float* dest, pDateTimeStamp datetime);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetLongLongByHandle(StreamHandle handle, long indx, long long* dest, pDateTimeStamp datetime);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetLongByHandle(StreamHandle handle, long indx, long* dest, pDateTimeStamp datetime);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int     
+TOSDB_GetStringByHandle(StreamHandle handle, long indx, LPSTR dest, size_type str_len, pDateTimeStamp datetime);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesByHandle(StreamHandle handle, double* dest, size_type array_len, 
+                                       pDateTimeStamp datetime, long end, long beg); 
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsByHandle(StreamHandle handle, float* dest, size_type array_len, 
+                                      pDateTimeStamp datetime, long end, long beg); 
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsByHandle(StreamHandle handle, long long* dest, size_type array_len, 
+                                         pDateTimeStamp datetime, long end, long beg); 
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsByHandle(StreamHandle handle, long* dest, size_type array_len, 
+                                     pDateTimeStamp datetime, long end, long beg); 
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsByHandle(StreamHandle handle, LPSTR* dest, size_type array_len, size_type str_len, 
+                                       pDateTimeStamp datetime, long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsPackedByHandle(StreamHandle handle, LPSTR dest, size_type dest_sz, size_type* offsets, 
+                                             size_type array_len, pDateTimeStamp datetime, long end, long beg, 
+                                             size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesFromMarkerByHandle(StreamHandle handle, double* dest, size_type array_len, 
+                                                 pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsFromMarkerByHandle(StreamHandle handle, float* dest, size_type array_len, 
+                                                pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsFromMarkerByHandle(StreamHandle handle, long long* dest, size_type array_len, 
+                                                   pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsFromMarkerByHandle(StreamHandle handle, long* dest, size_type array_len, 
+                                               pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsFromMarkerByHandle(StreamHandle handle, LPSTR* dest, size_type array_len, 
+                                                 size_type str_len, pDateTimeStamp datetime, 
+                                                 long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, double* dest, 
+                                                      size_type array_len, pDateTimeStamp datetime, 
+                                                      long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, float* dest, 
+                                                     size_type array_len, pDateTimeStamp datetime, 
+                                                     long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, long long* dest, 
+                                                        size_type array_len, pDateTimeStamp datetime, 
+                                                        long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, long* dest, 
+                                                    size_type array_len, pDateTimeStamp datetime, 
+                                                    long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, LPSTR* dest, 
+                                                      size_type array_len, size_type str_len, 
+                                                      pDateTimeStamp datetime, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNDoublesFromMarkerByHandle(StreamHandle handle, double* dest, size_type n, 
+                                    pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNFloatsFromMarkerByHandle(StreamHandle handle, float* dest, size_type n, 
+                                   pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongLongsFromMarkerByHandle(StreamHandle handle, long long* dest, size_type n, 
+                                      pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongsFromMarkerByHandle(StreamHandle handle, long* dest, size_type n, 
+                                  pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNStringsFromMarkerByHandle(StreamHandle handle, LPSTR* dest, size_type n, size_type str_len, 
+                                    pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNDoublesFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, double* dest, size_type n, 
+                                         pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNFloatsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, float* dest, size_type n, 
+                                        pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongLongsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, long long* dest, size_type n, 
+                                           pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNLongsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, long* dest, size_type n, 
+                                       pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetNStringsFromNamedMarkerByHandle(StreamHandle handle, LPCSTR marker, LPSTR* dest, size_type n, 
+                                         size_type str_len, pDateTimeStamp datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamStatsByHandle(StreamHandle handle, pStreamStats stats);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamIndicesBetweenDateTimesByHandle(StreamHandle handle, pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, long *end, long *beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesBetweenDateTimesByHandle(StreamHandle handle, double* dest, size_type array_len, 
+                                                       pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                                       pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsBetweenDateTimesByHandle(StreamHandle handle, float* dest, size_type array_len, 
+                                                      pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                                      pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsBetweenDateTimesByHandle(StreamHandle handle, long long* dest, 
+                                                         size_type array_len, pDateTimeStamp datetime, 
+                                                         pDateTimeStamp from_datetime, 
+                                                         pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsBetweenDateTimesByHandle(StreamHandle handle, long* dest, size_type array_len, 
+                                                     pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                                     pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsBetweenDateTimesByHandle(StreamHandle handle, LPSTR* dest, size_type array_len, 
+                                                       size_type str_len, pDateTimeStamp datetime, 
+                                                       pDateTimeStamp from_datetime, 
+                                                       pDateTimeStamp to_datetime, long *get_size);
+
+/* GetMany over handles (can be from different blocks); 'status[i]' is TOSDB_ERROR_BAD_INPUT 
+   for a closed handle or one whose stream was removed */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetManyDoublesByHandle(const StreamHandle* handles, size_type n, double* dest, 
+                             pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetManyFloatsByHandle(const StreamHandle* handles, size_type n, float* dest, 
+                            pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetManyLongLongsByHandle(const StreamHandle* handles, size_type n, long long* dest, 
+                               pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetManyLongsByHandle(const StreamHandle* handles, size_type n, long* dest, 
+                           pDateTimeStamp datetime, int* status);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetManyStringsByHandle(const StreamHandle* handles, size_type n, LPSTR* dest, size_type str_len, 
+                             pDateTimeStamp datetime, int* status);
+
+#ifdef __cplusplus
+
+/* get data w/ datetime in [from, to) by binary searching the stream (block must use datetime) */
+
+/* returns (end, beg); end < beg if there's no data in range */
+DLL_SPEC_IFACE std::pair<long,long> 
+TOSDB_GetStreamIndicesBetweenDateTimes(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                       const DateTimeStamp& from, const DateTimeStamp& to);
+
+template<typename T> 
+std::pair<std::vector<T>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                        const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<generic_type>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<generic_type>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                                      const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<double>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<double>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                                const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<float>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<float>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                               const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<long long>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<long long>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                                   const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<long>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<long>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                              const DateTimeStamp& from, const DateTimeStamp& to);
+
+template DLL_SPEC_IFACE std::pair<std::vector<std::string>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes<std::string>(std::string id, std::string item, TOS_Topics::TOPICS topic_t,
+                                                     const DateTimeStamp& from, const DateTimeStamp& to);
+
+#endif
+
+/* sets *end < *beg if there's no data in range */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamIndicesBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, pDateTimeStamp from_datetime, 
+                                       pDateTimeStamp to_datetime, long *end, long *beg);
+
+/* *get_size is negative if array_len is too small for all the data in range */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, double* dest, size_type array_len, 
+                                               pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, float* dest, size_type array_len, 
+                                              pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                              pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, long long* dest, size_type array_len, 
+                                                 pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                                 pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, long* dest, size_type array_len, 
+                                             pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                             pDateTimeStamp to_datetime, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsBetweenDateTimes(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR* dest, size_type array_len, 
+                                               size_type str_len, pDateTimeStamp datetime, pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, long *get_size);
+
 #ifdef __cplusplus
 
 /* get all the most recent item values for a particular topic */
@@ -1053,6 +1582,144 @@ EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int
 TOSDB_GetItemFrameStrings(LPCSTR id, LPCSTR topic_str, LPSTR* dest, size_type array_len, size_type str_len, 
                           LPSTR* label_dest, size_type label_str_len, pDateTimeStamp datetime); 
 
+/* item frames w/o labels or intermediate maps: values (and optionally datetimes and 
+   item indices) for the first array_len items in subscription order; fetch the labels 
+   once w/ TOSDB_GetItemLabels. get_size (if not NULL) gets the # of rows written */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnDoubles(LPCSTR id, LPCSTR topic_str, double* dest, size_type array_len, 
+                                pDateTimeStamp datetime, size_type* item_indices, 
+                                size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnFloats(LPCSTR id, LPCSTR topic_str, float* dest, size_type array_len, 
+                               pDateTimeStamp datetime, size_type* item_indices, 
+                               size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnLongLongs(LPCSTR id, LPCSTR topic_str, long long* dest, size_type array_len, 
+                                  pDateTimeStamp datetime, size_type* item_indices, 
+                                  size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnLongs(LPCSTR id, LPCSTR topic_str, long* dest, size_type array_len, 
+                              pDateTimeStamp datetime, size_type* item_indices, 
+                              size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnStrings(LPCSTR id, LPCSTR topic_str, LPSTR* dest, size_type array_len, 
+                                size_type str_len, pDateTimeStamp datetime, size_type* item_indices, 
+                                size_type* get_size);
+
+/* datetimes as micro-seconds since the (unix) epoch instead of DateTimeStamp structs: 
+   one long long per element, no struct tm to copy or convert field by field. Same as 
+   the calls w/o 'EpochMicros' otherwise; elements w/o data (past the end of the 
+   stream, items w/o a value) get 0 */
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_DateTimeStampToEpochMicros(const DateTimeStamp* src, long long* dest, size_type n);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, double* dest,
+                                          size_type array_len, long long* epoch_micros, long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, float* dest,
+                                         size_type array_len, long long* epoch_micros, long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, long long* dest,
+                                            size_type array_len, long long* epoch_micros, long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, long* dest,
+                                        size_type array_len, long long* epoch_micros, long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR* dest,
+                                          size_type array_len, size_type str_len, long long* epoch_micros,
+                                          long end, long beg);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsPackedEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR dest,
+                                                size_type dest_sz, size_type* offsets, size_type array_len,
+                                                long long* epoch_micros, long end, long beg,
+                                                size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesFromMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, double* dest,
+                                                    size_type array_len, long long* epoch_micros, long beg,
+                                                    long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsFromMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, float* dest,
+                                                   size_type array_len, long long* epoch_micros, long beg,
+                                                   long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsFromMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str,
+                                                      long long* dest, size_type array_len,
+                                                      long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsFromMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, long* dest,
+                                                  size_type array_len, long long* epoch_micros, long beg,
+                                                  long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPSTR* dest,
+                                                    size_type array_len, size_type str_len,
+                                                    long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotDoublesFromNamedMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str,
+                                                         LPCSTR marker, double* dest, size_type array_len,
+                                                         long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotFloatsFromNamedMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str,
+                                                        LPCSTR marker, float* dest, size_type array_len,
+                                                        long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str,
+                                                           LPCSTR marker, long long* dest, size_type array_len,
+                                                           long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotLongsFromNamedMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str, LPCSTR marker,
+                                                       long* dest, size_type array_len,
+                                                       long long* epoch_micros, long beg, long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetStreamSnapshotStringsFromNamedMarkerEpochMicros(LPCSTR id, LPCSTR item, LPCSTR topic_str,
+                                                         LPCSTR marker, LPSTR* dest, size_type array_len,
+                                                         size_type str_len, long long* epoch_micros, long beg,
+                                                         long *get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnDoublesEpochMicros(LPCSTR id, LPCSTR topic_str, double* dest, size_type array_len,
+                                           long long* epoch_micros, size_type* item_indices, 
+                                           size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnFloatsEpochMicros(LPCSTR id, LPCSTR topic_str, float* dest, size_type array_len,
+                                          long long* epoch_micros, size_type* item_indices, 
+                                          size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnLongLongsEpochMicros(LPCSTR id, LPCSTR topic_str, long long* dest, size_type array_len,
+                                             long long* epoch_micros, size_type* item_indices, 
+                                             size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnLongsEpochMicros(LPCSTR id, LPCSTR topic_str, long* dest, size_type array_len,
+                                         long long* epoch_micros, size_type* item_indices, 
+                                         size_type* get_size);
+
+EXT_C_SPEC DLL_SPEC_IFACE NO_THROW int  
+TOSDB_GetItemFrameColumnStringsEpochMicros(LPCSTR id, LPCSTR topic_str, LPSTR* dest, size_type array_len,
+                                           size_type str_len, long long* epoch_micros, size_type* item_indices, 
+                                           size_type* get_size);
+
 #ifdef __cplusplus  
 
 /* get all the most recent topic values for a particular item */
@@ -66,10 +66,25 @@ public interface CLib extends Library {
     int TOSDB_GetLongLong(String name, String item, String topic, int indx, long[] ptrVal,
                           DateTime ptrDateTime);
 
+    int TOSDB_GetManyStrings(String name, String[] items, String[] topics, int n,
+                             Pointer[] arrayVals, int strSz, DateTime[] arrayDateTime,
+                             int[] status);
+
+    int TOSDB_GetManyDoubles(String name, String[] items, String[] topics, int n,
+                             double[] arrayVals, DateTime[] arrayDateTime, int[] status);
+
+    int TOSDB_GetManyLongLongs(String name, String[] items, String[] topics, int n,
+                               long[] arrayVals, DateTime[] arrayDateTime, int[] status);
+
     int TOSDB_GetStreamSnapshotStrings(String name, String item, String topic, Pointer[] arrayVals,
                                        int arraySz, int strSz, DateTime[] arrayDateTime, int end,
                                        int beg);
 
+    int TOSDB_GetStreamSnapshotStringsPacked(String name, String item, String topic,
+                                             Pointer dest, int destSz, int[] offsets,
+                                             int arraySz, DateTime[] arrayDateTime, int end,
+                                             int beg, int[] getSz);
+
     int TOSDB_GetStreamSnapshotDoubles(String name, String item, String topic, double[] arrayVals,
                                        int arraySz, DateTime[] arrayDateTime, int end, int beg);
 
@@ -94,6 +109,34 @@ public interface CLib extends Library {
                                                    DateTime[] arrayDateTime, int beg,
                                                    NativeLong[] getSz);
 
+    int TOSDB_GetStreamSnapshotStringsPackedEpochMicros(String name, String item, String topic,
+                                                        Pointer dest, int destSz, int[] offsets,
+                                                        int arraySz, long[] arrayEpochMicros,
+                                                        int end, int beg, int[] getSz);
+
+    int TOSDB_GetStreamSnapshotDoublesEpochMicros(String name, String item, String topic,
+                                                  double[] arrayVals, int arraySz,
+                                                  long[] arrayEpochMicros, int end, int beg);
+
+    int TOSDB_GetStreamSnapshotLongLongsEpochMicros(String name, String item, String topic,
+                                                    long[] arrayVals, int arraySz,
+                                                    long[] arrayEpochMicros, int end, int beg);
+
+    int TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros(String name, String item, String topic,
+                                                            Pointer[] arrayVals, int arraySz,
+                                                            int strSz, long[] arrayEpochMicros,
+                                                            int beg, NativeLong[] getSz);
+
+    int TOSDB_GetStreamSnapshotDoublesFromMarkerEpochMicros(String name, String item, String topic,
+                                                            double[] arrayVals, int arraySz,
+                                                            long[] arrayEpochMicros, int beg,
+                                                            NativeLong[] getSz);
+
+    int TOSDB_GetStreamSnapshotLongLongsFromMarkerEpochMicros(String name, String item,
+                                                              String topic, long[] arrayVals,
+                                                              int arraySz, long[] arrayEpochMicros,
+                                                              int beg, NativeLong[] getSz);
+
     int TOSDB_GetNStringsFromMarker(String name, String item, String topic, Pointer[] arrayVals,
                                     int n, int strSz, DateTime[] arrayDateTime, NativeLong[] getSz);
 
@@ -535,6 +535,57 @@ public class DataBlock {
         return _helper.get(item, topic, indx, false, String.class);
     }
 
+    /**
+     * Returns most recent data-point of many streams, as List&lt;Long&gt; (null for each
+     * stream with no data). The values are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<Long>
+    getManyLongs(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return _helper.getMany(streams, false, Long.class);
+    }
+
+    /**
+     * Returns most recent data-point of many streams, as List&lt;Double&gt; (null for each
+     * stream with no data). The values are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<Double>
+    getManyDoubles(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return _helper.getMany(streams, false, Double.class);
+    }
+
+    /**
+     * Returns most recent data-point of many streams, as List&lt;String&gt; (null for each
+     * stream with no data). The values are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<String>
+    getManyStrings(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return _helper.getMany(streams, false, String.class);
+    }
+
     /**
      * Returns all data-points of a stream, as List&lt;Long&gt;.
      *
@@ -1202,6 +1253,26 @@ public class DataBlock {
                             int.class, boolean.class}, item, topic, indx, withDateTime);
         }
 
+        public final <T> List<T>
+        getMany(List<Pair<String,Topic>> streams, boolean withDateTime, Class<?> valType)
+                throws LibraryNotLoaded, CLibException, InvalidItemOrTopic
+        {
+            int n = streams.size();
+            String[] items = new String[n];
+            String[] topics = new String[n];
+            for (int i = 0; i < n; ++i) {
+                Pair<String,Topic> p = streams.get(i);
+                items[i] = _handleRawItemTopic(p.first, p.second, true);
+                topics[i] = p.second.val;
+            }
+            if (n == 0) {
+                return new ArrayList<>();
+            }
+            return _nativeAccessByType(valType, "_getMany", "s",
+                    new Class<?>[]{String[].class, String[].class, boolean.class},
+                    items, topics, withDateTime);
+        }
+
         /* suppress DataIndexException */
         public final <T> List<T>
         getStreamSnapshotAll(String item, Topic topic, boolean withDateTime, Class<?> valType)
@@ -1647,19 +1718,86 @@ public class DataBlock {
                                  : Native.toString(val));
     }
 
+    /* ERROR_GET_DATA means some of the streams failed; see status */
+    private void
+    _checkGetMany(String callStr, int err) throws CLibException {
+        if (err != 0 && err != CError.ERROR_GET_DATA) {
+            throw new CLibException(callStr, err);
+        }
+    }
+
+    @SuppressWarnings("unchecked")
+    private <T> List<T>
+    _getManyLongs(String[] items, String[] topics, boolean withDateTime)
+            throws LibraryNotLoaded, CLibException {
+        int n = items.length;
+        DateTime[] dts = (withDateTime ? new DateTime[n] : null);
+        long[] vals = new long[n];
+        int[] status = new int[n];
+        _checkGetMany("TOSDB_GetManyLongLongs", TOSDataBridge.getCLibrary()
+                .TOSDB_GetManyLongLongs(_name, items, topics, n, vals, dts, status));
+        List<T> ret = new ArrayList<>(n);
+        for (int i = 0; i < n; ++i) {
+            ret.add(status[i] != 0 ? null
+                    : (T) (withDateTime ? new DateTimePair<>(vals[i], dts[i]) : vals[i]));
+        }
+        return ret;
+    }
+
+    @SuppressWarnings("unchecked")
+    private <T> List<T>
+    _getManyDoubles(String[] items, String[] topics, boolean withDateTime)
+            throws LibraryNotLoaded, CLibException {
+        int n = items.length;
+        DateTime[] dts = (withDateTime ? new DateTime[n] : null);
+        double[] vals = new double[n];
+        int[] status = new int[n];
+        _checkGetMany("TOSDB_GetManyDoubles", TOSDataBridge.getCLibrary()
+                .TOSDB_GetManyDoubles(_name, items, topics, n, vals, dts, status));
+        List<T> ret = new ArrayList<>(n);
+        for (int i = 0; i < n; ++i) {
+            ret.add(status[i] != 0 ? null
+                    : (T) (withDateTime ? new DateTimePair<>(vals[i], dts[i]) : vals[i]));
+        }
+        return ret;
+    }
+
+    @SuppressWarnings("unchecked")
+    private <T> List<T>
+    _getManyStrings(String[] items, String[] topics, boolean withDateTime)
+            throws LibraryNotLoaded, CLibException {
+        int n = items.length;
+        DateTime[] dts = (withDateTime ? new DateTime[n] : null);
+        Pointer[] vals = new Pointer[n];
+        for (int i = 0; i < n; ++i) {
+            vals[i] = new Memory(STR_DATA_SZ + 1);
+        }
+        int[] status = new int[n];
+        _checkGetMany("TOSDB_GetManyStrings", TOSDataBridge.getCLibrary()
+                .TOSDB_GetManyStrings(_name, items, topics, n, vals, STR_DATA_SZ + 1, dts, status));
+        List<T> ret = new ArrayList<>(n);
+        for (int i = 0; i < n; ++i) {
+            ret.add(status[i] != 0 ? null
+                    : (T) (withDateTime ? new DateTimePair<>(vals[i].getString(0), dts[i])
+                                        : vals[i].getString(0)));
+        }
+        return ret;
+    }
+
     @SuppressWarnings("unchecked")
     private <T> List<T>
     _getStreamSnapshotLongs(String item, Topic topic, int end, int beg, boolean withDateTime,
                             int size)
             throws LibraryNotLoaded, CLibException, DataIndexException {
-        DateTime[] dts = (withDateTime ? new DateTime[size] : null);
+        long[] epochMicros = (withDateTime ? new long[size] : null);
         long[] vals = new long[size];
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotLongLongs(_name, item, topic.val, vals,
-                        size, dts, end, beg);
+                .TOSDB_GetStreamSnapshotLongLongsEpochMicros(_name, item, topic.val, vals,
+                        size, epochMicros, end, beg);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotLongs", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotLongsEpochMicros", err);
         }
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, size) : null);
         return (List<T>)(withDateTime ? rawArraysToList(vals, dts, size)
                                       : rawArraysToList(vals, size));
     }
@@ -1669,14 +1807,15 @@ public class DataBlock {
     _getStreamSnapshotDoubles(String item, Topic topic, int end, int beg, boolean withDateTime,
                               int size)
             throws LibraryNotLoaded, CLibException, DataIndexException {
-        DateTime[] dts = (withDateTime ? new DateTime[size] : null);
+        long[] epochMicros = (withDateTime ? new long[size] : null);
         double[] vals = new double[size];
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotDoubles(_name, item, topic.val, vals,
-                        size, dts, end, beg);
+                .TOSDB_GetStreamSnapshotDoublesEpochMicros(_name, item, topic.val, vals,
+                        size, epochMicros, end, beg);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotDoubles", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotDoublesEpochMicros", err);
         }
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, size) : null);
         return (List<T>)(withDateTime ? rawArraysToList(vals, dts, size)
                                       : rawArraysToList(vals, size));
     }
@@ -1686,19 +1825,24 @@ public class DataBlock {
     _getStreamSnapshotStrings(String item, Topic topic, int end, int beg, boolean withDateTime,
                               int size)
             throws LibraryNotLoaded, CLibException, DataIndexException {
-        DateTime[] dts = (withDateTime ? new DateTime[size] : null);
-        Pointer[] vals = new Pointer[size];
-        for (int i = 0; i < size; ++i) {
-            vals[i] = new Memory(STR_DATA_SZ + 1);
-        }
+        long[] epochMicros = (withDateTime ? new long[size] : null);
+        /* one native buffer for all the strings, not one per string */
+        Memory buf = new Memory((long)(STR_DATA_SZ + 1) * size);
+        int[] offsets = new int[size + 1];
+        int[] getSz = {0};
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotStrings(_name, item, topic.val, vals,
-                        size, STR_DATA_SZ + 1, dts, end, beg);
+                .TOSDB_GetStreamSnapshotStringsPackedEpochMicros(_name, item, topic.val, buf,
+                        (int)buf.size(), offsets, size, epochMicros, end, beg, getSz);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotStrings", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotStringsPackedEpochMicros", err);
         }
-        return (List<T>)(withDateTime ? rawArraysToList(vals, dts, size)
-                                      : rawArraysToList(vals, size));
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, size) : null);
+        List<T> ret = new ArrayList<>(size);
+        for (int i = 0; i < size; ++i) {
+            String s = (i < getSz[0] ? buf.getString(offsets[i]) : "");
+            ret.add((T)(withDateTime ? new DateTimePair<>(s, dts[i]) : s));
+        }
+        return ret;
     }
 
     @SuppressWarnings("unchecked")
@@ -1706,17 +1850,18 @@ public class DataBlock {
     _getStreamSnapshotLongsFromMarker(String item, Topic topic, int beg, boolean withDateTime,
                                       boolean throwIfDataLost, int safeSz)
             throws CLibException, LibraryNotLoaded, DirtyMarkerException {
-        DateTime[] dts = (withDateTime ? new DateTime[safeSz] : null);
+        long[] epochMicros = (withDateTime ? new long[safeSz] : null);
         NativeLong[] getSz = {new NativeLong(0)};
         long[] vals = new long[safeSz];
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotLongLongsFromMarker(_name, item, topic.val,
-                        vals, safeSz, dts, beg, getSz);
+                .TOSDB_GetStreamSnapshotLongLongsFromMarkerEpochMicros(_name, item, topic.val,
+                        vals, safeSz, epochMicros, beg, getSz);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotLongsFromMarker", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotLongsFromMarkerEpochMicros", err);
         }
 
         int szGot = (int) _handleSzGotFromMarker(getSz[0], throwIfDataLost);
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, szGot) : null);
         return (List<T>)(withDateTime ? rawArraysToList(vals, dts, szGot)
                                       : rawArraysToList(vals, szGot));
     }
@@ -1726,17 +1871,18 @@ public class DataBlock {
     _getStreamSnapshotDoublesFromMarker(String item, Topic topic, int beg, boolean withDateTime,
                                         boolean throwIfDataLost, int safeSz)
             throws CLibException, LibraryNotLoaded, DirtyMarkerException {
-        DateTime[] dts = (withDateTime ? new DateTime[safeSz] : null);
+        long[] epochMicros = (withDateTime ? new long[safeSz] : null);
         NativeLong[] getSz = {new NativeLong(0)};
         double[] vals = new double[safeSz];
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotDoublesFromMarker(_name, item, topic.val,
-                        vals, safeSz, dts, beg, getSz);
+                .TOSDB_GetStreamSnapshotDoublesFromMarkerEpochMicros(_name, item, topic.val,
+                        vals, safeSz, epochMicros, beg, getSz);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotDoublesFromMarker", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotDoublesFromMarkerEpochMicros", err);
         }
 
         int szGot = (int) _handleSzGotFromMarker(getSz[0], throwIfDataLost);
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, szGot) : null);
         return (List<T>)(withDateTime ? rawArraysToList(vals, dts, szGot)
                                       : rawArraysToList(vals, szGot));
     }
@@ -1747,19 +1893,20 @@ public class DataBlock {
                                         boolean throwIfDataLost, int safeSz)
             throws CLibException, LibraryNotLoaded, DirtyMarkerException {
         Pointer[] vals = new Pointer[safeSz];
-        DateTime[] dts = (withDateTime ? new DateTime[safeSz] : null);
+        long[] epochMicros = (withDateTime ? new long[safeSz] : null);
         NativeLong[] getSz = {new NativeLong(0)};
         for (int i = 0; i < safeSz; ++i) {
             vals[i] = new Memory(STR_DATA_SZ + 1);
         }
         int err = TOSDataBridge.getCLibrary()
-                .TOSDB_GetStreamSnapshotStringsFromMarker(_name, item, topic.val,
-                        vals, safeSz, STR_DATA_SZ + 1, dts, beg, getSz);
+                .TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros(_name, item, topic.val,
+                        vals, safeSz, STR_DATA_SZ + 1, epochMicros, beg, getSz);
         if (err != 0) {
-            throw new CLibException("TOSDB_GetStreamSnapshotStringsFromMarker", err);
+            throw new CLibException("TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros", err);
         }
 
         int szGot = (int) _handleSzGotFromMarker(getSz[0], throwIfDataLost);
+        DateTime[] dts = (withDateTime ? DateTime.fromEpochMicros(epochMicros, szGot) : null);
         return (List<T>)(withDateTime ? rawArraysToList(vals, dts, szGot)
                                       : rawArraysToList(vals, szGot));
     }
@@ -211,6 +211,60 @@ public class DataBlockWithDateTime extends DataBlock {
         return getHelper().get(item, topic, indx, true, String.class);
     }
 
+    /**
+     * Returns most recent data-point and DateTime of many streams, as
+     * List&lt;DateTimePair&lt;Long&gt;&gt; (null for each stream with no data). The values
+     * are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point and DateTime of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<DateTimePair<Long>>
+    getManyLongsWithDateTime(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return getHelper().getMany(streams, true, Long.class);
+    }
+
+    /**
+     * Returns most recent data-point and DateTime of many streams, as
+     * List&lt;DateTimePair&lt;Double&gt;&gt; (null for each stream with no data). The values
+     * are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point and DateTime of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<DateTimePair<Double>>
+    getManyDoublesWithDateTime(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return getHelper().getMany(streams, true, Double.class);
+    }
+
+    /**
+     * Returns most recent data-point and DateTime of many streams, as
+     * List&lt;DateTimePair&lt;String&gt;&gt; (null for each stream with no data). The values
+     * are pulled in one call to the C lib, not one per stream.
+     *
+     * @param streams (item string, topic enum) pairs of the streams
+     * @return most recent data-point and DateTime of each stream (or null), in the same order
+     * @throws CLibException    error code returned by C lib
+     * @throws LibraryNotLoaded C lib has not been loaded
+     * @throws InvalidItemOrTopic invalid item or topic argument
+     * @see Topic
+     */
+    public List<DateTimePair<String>>
+    getManyStringsWithDateTime(List<Pair<String,Topic>> streams)
+            throws CLibException, LibraryNotLoaded, InvalidItemOrTopic {
+        return getHelper().getMany(streams, true, String.class);
+    }
+
     /**
      * Returns all data-points and DateTime(s) of a stream,
      * as List&lt;DateTimePair&lt;Long&gt;&gt;.
@@ -21,6 +21,7 @@ import com.sun.jna.NativeLong;
 import com.sun.jna.Structure;
 
 import java.util.Arrays;
+import java.util.Calendar;
 import java.util.List;
 
 /**
@@ -66,6 +67,39 @@ public class DateTime extends Structure {
         return Arrays.asList("cTime", "microSeconds");
     }
 
+    /**
+     * Convert micro-seconds since the epoch (from the C lib's 'EpochMicros' calls) to
+     * local DateTime objects; 0 (no data) gives an empty DateTime.
+     *
+     * @param epochMicros micro-seconds since the epoch
+     * @param n number of elements to convert
+     * @return array of n DateTime objects
+     */
+    static DateTime[]
+    fromEpochMicros(long[] epochMicros, int n){
+        DateTime[] dts = new DateTime[n];
+        Calendar cal = Calendar.getInstance();
+        for (int i = 0; i < n; ++i) {
+            DateTime dt = new DateTime();
+            long us = epochMicros[i];
+            if (us != 0) {
+                cal.setTimeInMillis(us / 1000);
+                dt.cTime.tmSec = cal.get(Calendar.SECOND);
+                dt.cTime.tmMin = cal.get(Calendar.MINUTE);
+                dt.cTime.tmHour = cal.get(Calendar.HOUR_OF_DAY);
+                dt.cTime.tmMday = cal.get(Calendar.DAY_OF_MONTH);
+                dt.cTime.tmMon = cal.get(Calendar.MONTH);
+                dt.cTime.tmYear = cal.get(Calendar.YEAR) - 1900;
+                dt.cTime.tmWday = cal.get(Calendar.DAY_OF_WEEK) - 1;
+                dt.cTime.tmYday = cal.get(Calendar.DAY_OF_YEAR) - 1;
+                dt.cTime.tmIsDst = (cal.get(Calendar.DST_OFFSET) != 0 ? 1 : 0);
+                dt.microSeconds = new NativeLong(us % 1000000);
+            }
+            dts[i] = dt;
+        }
+        return dts;
+    }
+
     @Override
     public String
     toString(){
@@ -583,6 +583,12 @@ class VTOSDB_DataBlock(_TOSDB_DataBlock):
                           check_indx, data_str_max) 
 
 
+    @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
+    def get_many(self, pairs, date_time=False, data_str_max=STR_DATA_SZ):
+
+        return self._call(_vCALL, 'get_many', list(pairs), date_time, data_str_max) 
+
+
     @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
     def stream_snapshot(self, item, topic, date_time=False, end=-1, beg=0, 
                         smart_size=True, data_str_max=STR_DATA_SZ):
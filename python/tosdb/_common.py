@@ -262,6 +262,30 @@ class _TOSDB_DataBlock(metaclass=_ABCMeta):
         """
         pass
 
+    @_abstractmethod
+    def get_many(): 
+        """ Return the most recent data-point of many data-streams
+
+        The underlying library call fills all the values for each type in one 
+        pass (one call per type of topic, instead of one per pair).
+
+        get_many(self, pairs, date_time=False, data_str_max=STR_DATA_SZ)
+            
+        pairs        :: list :: (item, topic) 2-tuples in the block
+        date_time    :: bool :: include a TOSDB_DateTime object 
+        data_str_max :: int  :: maximum size of string data returned 
+
+        if date_time == True:  returns -> list of 2-tuple** 
+        else:                  returns -> list**
+
+        **data are of type int, float, or str (depending on the topic); 
+          None for each pair that has no data (yet)
+        
+        throws TOSDB_DataTimeError, TOSDB_CLibError, TOSDB_TypeError, 
+               TOSDB_ValueError
+        """
+        pass
+
     @_abstractmethod
     def stream_snapshot(): 
         """ Return multiple data-points(a snapshot) from the data-stream
@@ -751,6 +775,27 @@ class TOSDB_DateTime( _namedtuple("DateTime",["micro","sec","min",
                              obj.ctime_struct.tm_isdst ])
 
 
+    @classmethod
+    def from_epoch_micros(cls, micro_seconds):
+        """ Construct from micro-seconds since the epoch (inverse of mktime_micro) 
+
+        0 (no data) gives an empty DateTime, like a zeroed _DateTimeStamp
+        """
+        if not micro_seconds:
+            # same fields as TOSDB_DateTime(_DateTimeStamp()): day 0, 1/1900
+            dt = super(TOSDB_DateTime, cls).__new__(cls, 0, 0, 0, 0, 0, 1, BASE_YR)
+            dt._mktime = 0
+            return dt
+        sec, micro = divmod(int(micro_seconds), 1000000)
+        stime = _localtime(sec)
+        dt = super(TOSDB_DateTime, cls).__new__(cls, micro, stime.tm_sec, 
+                                                stime.tm_min, stime.tm_hour, 
+                                                stime.tm_mday, stime.tm_mon, 
+                                                stime.tm_year)
+        dt._mktime = sec
+        return dt
+
+
     @staticmethod
     def micro_to_dtd(micro_seconds):
         """ Converts micro_seconds to DateTimeDiff  """
@@ -77,6 +77,7 @@ _gen_str_buffers_ptrs = lambda bufs: (_pchar_ * len(bufs))(*[_cast(b,_pchar_) fo
 _map_cstr = _partial(map,_cast_cstr)
 _map_dt = _partial(map, TOSDB_DateTime)
 _zip_cstr_dt = lambda cstr, dt: zip(_map_cstr(cstr),_map_dt(dt))
+_map_dt_epoch = _partial(map, TOSDB_DateTime.from_epoch_micros)
 
 DLL_BASE_NAME = "tos-databridge"
 DLL_DEPENDS1_NAME = "_tos-databridge"
@@ -678,6 +679,77 @@ class TOSDB_DataBlock(_TOSDB_DataBlock):
 
         return (n.value, TOSDB_DateTime(dt)) if date_time else n.value       
 
+
+    @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
+    def get_many(self, pairs, date_time=False, data_str_max=STR_DATA_SZ):
+        
+        if date_time and not self._date_time:
+            raise TOSDB_DateTimeError("date_time not available for this block")
+
+        pairs = [(self._handle_raw_item(i), self._handle_raw_topic(t)) for i,t in pairs]
+        tytups = {t : _type_switch(type_bits(t)) for t in set(t for _,t in pairs)}
+
+        # one library call per type, instead of one per pair
+        groups = {}
+        for n, (_,t) in enumerate(pairs):
+            groups.setdefault(tytups[t], []).append(n)
+
+        ret = [None] * len(pairs)
+        for tytup, indxs in groups.items():
+            vals, dts, stats = self._get_many(tytup, [pairs[n] for n in indxs],
+                                              date_time, data_str_max)
+            for i, n in enumerate(indxs):
+                if stats[i] == 0:
+                    ret[n] = (vals[i], TOSDB_DateTime(dts[i])) if date_time else vals[i]
+        return ret
+
+
+    def _get_many(self, tytup, pairs, date_time, data_str_max):
+        size = len(pairs)
+        items = (_str_ * size)(*[i.encode("ascii") for i,_ in pairs])
+        topics = (_str_ * size)(*[t.encode("ascii") for _,t in pairs])
+        dts = (_DateTimeStamp * size)()
+        stats = (_int_ * size)()
+        
+        if tytup[0] == "String":
+            strs = _gen_str_buffers(data_str_max+1, size)
+            pstrs = _gen_str_buffers_ptrs(strs)
+            r = _lib_call("TOSDB_GetManyStrings", 
+                          self._name, 
+                          items, 
+                          topics, 
+                          size, 
+                          pstrs, 
+                          data_str_max + 1,
+                          dts if date_time else _PTR_(_DateTimeStamp)(),
+                          stats,
+                          arg_types=(_str_, _PTR_(_str_), _PTR_(_str_), _uint32_, 
+                                     _ppchar_, _uint32_, _PTR_(_DateTimeStamp), 
+                                     _PTR_(_int_)),
+                          error_check=False)
+            vals = list(_map_cstr(pstrs))
+        else:
+            nums = (tytup[1] * size)()
+            r = _lib_call("TOSDB_GetMany"+tytup[0]+"s", 
+                          self._name, 
+                          items, 
+                          topics, 
+                          size, 
+                          nums, 
+                          dts if date_time else _PTR_(_DateTimeStamp)(),
+                          stats,
+                          arg_types=(_str_, _PTR_(_str_), _PTR_(_str_), _uint32_, 
+                                     _PTR_(tytup[1]), _PTR_(_DateTimeStamp), 
+                                     _PTR_(_int_)),
+                          error_check=False)
+            vals = list(nums)
+
+        # ERROR_GET_DATA just means some pairs failed (see stats)
+        if r and r != ERROR_GET_DATA:
+            raise TOSDB_CLibError("library function [TOSDB_GetMany] returned error code [%i,%s]" \
+                                  % (r, _lookup_error_name(r)))
+        return (vals, dts, stats)
+
        
     @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
     def stream_snapshot(self, item, topic, date_time=False, end=-1, beg=0,
@@ -720,43 +792,54 @@ class TOSDB_DataBlock(_TOSDB_DataBlock):
 
     def _stream_snapshot_strings(self, item, topic, date_time, end, beg, size,
                                  data_str_max):
-        strs = _gen_str_buffers(data_str_max+1, size)
-        pstrs = _gen_str_buffers_ptrs(strs) 
-        dts = (_DateTimeStamp * size)()
+        # one buffer for all the strings instead of one per string; the 
+        # engine's strings are < STR_DATA_SZ so they all fit 
+        buf = _BUF_((max(data_str_max, STR_DATA_SZ) + 1) * size)
+        offs = (_uint32_ * (size + 1))()
+        dts = (_longlong_ * size)() # epoch micro-seconds, not _DateTimeStamp
+        n = _uint32_()
                                  
-        _lib_call("TOSDB_GetStreamSnapshotStrings", 
+        _lib_call("TOSDB_GetStreamSnapshotStringsPackedEpochMicros", 
                   self._name,
                   item.encode("ascii"), 
                   topic.encode("ascii"),
-                  pstrs, 
-                  size, 
-                  data_str_max + 1,                
-                  dts if date_time else _PTR_(_DateTimeStamp)(),
+                  buf, 
+                  len(buf), 
+                  offs,
+                  size,
+                  dts if date_time else _PTR_(_longlong_)(),
                   end, 
                   beg,
-                  arg_types=(_str_, _str_, _str_, _ppchar_, _uint32_, _uint32_, 
-                             _PTR_(_DateTimeStamp), _long_, _long_))   
+                  _pointer(n),
+                  arg_types=(_str_, _str_, _str_, _pchar_, _uint32_, _PTR_(_uint32_),
+                             _uint32_, _PTR_(_longlong_), _long_, _long_, 
+                             _PTR_(_uint32_)))   
+
+        n = n.value
+        raw = buf.raw
+        strs = [raw[offs[i]:offs[i+1]-1][:data_str_max].decode() for i in range(n)]
+        strs.extend([""] * (size - n)) # past the end of the stream
         
-        return list(_zip_cstr_dt(pstrs,dts) if date_time else _map_cstr(pstrs)) 
+        return list(zip(strs,_map_dt_epoch(dts)) if date_time else strs) 
 
         
     def _stream_snapshot_numbers(self, tytup, item, topic, date_time, end, beg, size):
         nums = (tytup[1] * size)()
-        dts = (_DateTimeStamp * size)()
+        dts = (_longlong_ * size)() # epoch micro-seconds, not _DateTimeStamp
                                  
-        _lib_call("TOSDB_GetStreamSnapshot"+tytup[0]+"s", 
+        _lib_call("TOSDB_GetStreamSnapshot"+tytup[0]+"sEpochMicros", 
                   self._name,
                   item.encode("ascii"), 
                   topic.encode("ascii"),
                   nums, 
                   size,
-                  dts if date_time else _PTR_(_DateTimeStamp)(),
+                  dts if date_time else _PTR_(_longlong_)(),
                   end, 
                   beg,
                   arg_types=(_str_, _str_, _str_, _PTR_(tytup[1]), _uint32_, 
-                             _PTR_(_DateTimeStamp), _long_, _long_)) 
+                             _PTR_(_longlong_), _long_, _long_)) 
         
-        return list(zip(nums,_map_dt(dts)) if date_time else nums)
+        return list(zip(nums,_map_dt_epoch(dts)) if date_time else nums)
 
                                  
     @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
@@ -817,21 +900,21 @@ class TOSDB_DataBlock(_TOSDB_DataBlock):
                                              size, throw_if_data_lost, data_str_max):
         strs = _gen_str_buffers(data_str_max+1, size)
         pstrs = _gen_str_buffers_ptrs(strs) 
-        dts = (_DateTimeStamp * size)()
+        dts = (_longlong_ * size)() # epoch micro-seconds, not _DateTimeStamp
         g = _long_()
                                  
-        _lib_call("TOSDB_GetStreamSnapshotStringsFromMarker", 
+        _lib_call("TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros", 
                   self._name,
                   item.encode("ascii"), 
                   topic.encode("ascii"),
                   pstrs, 
                   size, 
                   data_str_max + 1,
-                  dts if date_time else _PTR_(_DateTimeStamp)(),     
+                  dts if date_time else _PTR_(_longlong_)(),     
                   beg, 
                   _pointer(g),
                   arg_types=(_str_, _str_, _str_, _ppchar_, _uint32_, _uint32_,
-                             _PTR_(_DateTimeStamp), _long_, _PTR_(_long_))) 
+                             _PTR_(_longlong_), _long_, _PTR_(_long_))) 
            
         g = g.value
         if g == 0:
@@ -842,26 +925,27 @@ class TOSDB_DataBlock(_TOSDB_DataBlock):
             else:
                 g *= -1
 
-        return list(_zip_cstr_dt(pstrs[:g],dts[:g]) if date_time else _map_cstr(pstrs[:g]))
+        return list(zip(_map_cstr(pstrs[:g]),_map_dt_epoch(dts[:g])) if date_time 
+                    else _map_cstr(pstrs[:g]))
      
                                  
     def _stream_snapshot_from_marker_numbers(self, tytup, item, topic, date_time, beg,
                                              size, throw_if_data_lost):
         nums = (tytup[1] * size)()
-        dts = (_DateTimeStamp * size)()
+        dts = (_longlong_ * size)() # epoch micro-seconds, not _DateTimeStamp
         g = _long_()
                                  
-        _lib_call("TOSDB_GetStreamSnapshot" + tytup[0] + "sFromMarker", 
+        _lib_call("TOSDB_GetStreamSnapshot" + tytup[0] + "sFromMarkerEpochMicros", 
                   self._name,
                   item.encode("ascii"), 
                   topic.encode("ascii"),
                   nums, 
                   size,
-                  dts if date_time else _PTR_(_DateTimeStamp)(),     
+                  dts if date_time else _PTR_(_longlong_)(),     
                   beg, 
                   _pointer(g),
                   arg_types=(_str_, _str_, _str_, _PTR_(tytup[1]), _uint32_, 
-                             _PTR_(_DateTimeStamp), _long_, _PTR_(_long_))) 
+                             _PTR_(_longlong_), _long_, _PTR_(_long_))) 
       
         g = g.value
         if g == 0:
@@ -872,7 +956,7 @@ class TOSDB_DataBlock(_TOSDB_DataBlock):
             else:
                 g *= -1
 
-        return list(zip(nums[:g], _map_dt(dts[:g])) if date_time else nums[:g])                        
+        return list(zip(nums[:g], _map_dt_epoch(dts[:g])) if date_time else nums[:g])                        
 
 
     @_doxtend(_TOSDB_DataBlock) # __doc__ from ABC _TOSDB_DataBlock
@@ -23,12 +23,15 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <atomic>
 #include <memory>
 #include <fstream>
+#include <deque>
+#include <functional>
+#include <future>
 #include "tos_databridge.h"
 #include "client.hpp"
 #include "raw_data_block.hpp"
 #include "ipc.hpp"
 
-std::recursive_mutex global_rmutex;
+RecursiveSharedMutex global_rwmutex;
 
 namespace { 
 
@@ -37,8 +40,14 @@ typedef std::tuple<unsigned int, unsigned int,
 
 typedef std::map<std::pair<TOS_Topics::TOPICS, std::string>, buffer_info_ty>  buffers_ty;
 
+typedef std::vector<std::pair<TOS_Topics::TOPICS, std::string>>  stream_op_list_ty;
+
 LPCSTR LOG_NAME = "client-log.log";
 
+/* max stream ops per IPC message; worst case (255 char item) keeps us 
+   well under IPCMessage::MAX_FRAME_SZ */
+const size_t MAX_STREAM_OPS_PER_MSG = 128;
+
 /* item/topic to test connection */
 const TOS_Topics::TOPICS TEST_TOPIC = TOS_Topics::TOPICS::LAST;
 const std::string TEST_ITEM = "SPY";
@@ -53,6 +62,25 @@ std::mutex buffers_mtx;
 /* !!! 'buffers_lock_guard_' is reserved inside this namespace !!! */
 #define LOCAL_BUFFERS_LOCK_GUARD std::lock_guard<std::mutex> buffers_lock_guard_(buffers_mtx)
 
+/* serializes the admin calls that talk to the engine (add/remove/close); 
+   taken BEFORE the global lock so the engine round-trip can happen w/o it */
+std::recursive_mutex admin_mtx;
+
+/* !!! 'admin_lock_guard_' is reserved inside this namespace !!! */
+#define LOCAL_ADMIN_LOCK_GUARD std::lock_guard<std::recursive_mutex> admin_lock_guard_(admin_mtx)
+
+/* admin ops queued by the *Async calls; run in order on a single thread 
+   that exits when the queue is empty */
+std::deque<std::function<void()>> async_ops;
+std::mutex async_mtx;
+bool async_thread_running = false;
+bool async_stopped = false; /* DLL_PROCESS_DETACH, no more ops */
+
+/* set by the thread on its way out; _stopAsyncOps waits on this, not the 
+   thread handle (thread exit needs the loader lock we hold in DllMain) */
+HANDLE async_done = NULL;
+const unsigned long ASYNC_STOP_WAIT_MSEC = TOSDB_DEF_TIMEOUT;
+
 /* for 'scheduling' buffer reads */
 steady_clock_type steady_clock;
 
@@ -84,14 +112,14 @@ _connected(bool log_if_not_connected=false)
 {    
     if(!aware_of_connection.load()){
         if(log_if_not_connected){
-            TOSDB_LogH("IPC", "not connected to slave (!aware_of_connection)");
+            TOSDB_LogLimitedH("IPC", nullptr, "not connected to slave (!aware_of_connection)");
         }
         return false;
     }
 
     if(!master.connected(TOSDB_DEF_TIMEOUT)){
         if(log_if_not_connected){        
-            TOSDB_LogH("IPC", "not connected to slave (!master.connected)");            
+            TOSDB_LogLimitedH("IPC", nullptr, "not connected to slave (!master.connected)");            
         }
         return false;
     }
@@ -101,16 +129,19 @@ _connected(bool log_if_not_connected=false)
 
 
 long 
-_requestStreamOP(TOS_Topics::TOPICS topic_t, 
-                std::string item, 
-                unsigned long timeout, 
-                unsigned int opcode)
+_requestStreamOPs(const stream_op_list_ty& streams, 
+                  unsigned long timeout, 
+                  unsigned int opcode,
+                  std::vector<long> *rets)
 { /* needs exclusivity but can't block; CALLING CODE MUST LOCK
-     returns 0 on sucess, TOSDB_ERROR... on error */
+     sends the same op for each stream, MAX_STREAM_OPS_PER_MSG per message;
+     returns 0 if every message got a reply (check 'rets' for each stream's 
+     return code), TOSDB_ERROR... if not (streams w/o a reply get the same) */
+    long err = 0;
 
-    /* build ipc msg early so we can log it on error */
-    std::string msg = std::to_string(opcode) + ' ' + TOS_Topics::MAP()[topic_t] + ' '
-                    + item + ' ' + std::to_string(timeout); 
+    rets->assign(streams.size(), 0);
+    if(streams.empty())
+        return 0;
 
     switch(opcode){
     case TOSDB_SIG_ADD:
@@ -118,29 +149,73 @@ _requestStreamOP(TOS_Topics::TOPICS topic_t,
     case TOSDB_SIG_TEST:
         break;
     default:
-        TOSDB_LogRawH("IPC", ("_requestStreamOP received bad opcode, msg:" + msg).c_str());
+        TOSDB_LogRawH("IPC", ("_requestStreamOPs received bad opcode: " + std::to_string(opcode)).c_str());
+        rets->assign(streams.size(), TOSDB_ERROR_BAD_SIG);
         return TOSDB_ERROR_BAD_SIG;
     }         
 
     if( !_connected() ){
-        TOSDB_LogRawH("IPC", ("_requestStreamOP failed, not connected, msg:" + msg).c_str());
+        TOSDB_LogRawH("IPC", ("_requestStreamOPs failed, not connected, op: " + std::to_string(opcode)).c_str());
+        rets->assign(streams.size(), TOSDB_ERROR_NOT_CONNECTED);
         return TOSDB_ERROR_NOT_CONNECTED;
     }
 
-    if( !master.call(&msg,timeout) ){
-        TOSDB_LogRawH("IPC",("master.call failled in _requestStreamOP, msg:" + msg).c_str());
-        return TOSDB_ERROR_IPC;
+    for(size_t beg = 0; beg < streams.size(); beg += MAX_STREAM_OPS_PER_MSG){
+        size_t end = std::min(beg + MAX_STREAM_OPS_PER_MSG, streams.size());
+
+        IPCMessage msg;
+        for(size_t i = beg; i < end; ++i){
+            msg.add_record().add_u32(opcode)
+                            .add_string(TOS_Topics::MAP()[streams[i].first])
+                            .add_string(streams[i].second)
+                            .add_u32(timeout);
+        }
+
+        if( !master.call(&msg,timeout) ){
+            TOSDB_LogRawH("IPC", ("master.call failed in _requestStreamOPs, op: " + std::to_string(opcode) 
+                                  + ", first item: " + streams[beg].second).c_str());
+            std::fill(rets->begin() + beg, rets->begin() + end, TOSDB_ERROR_IPC);
+            err = TOSDB_ERROR_IPC;
+            continue;
+        }
+
+        if(msg.size() != end - beg){
+            TOSDB_LogRawH("IPC", ("wrong number of reply records in _requestStreamOPs: " 
+                                  + std::to_string(msg.size())).c_str());
+            std::fill(rets->begin() + beg, rets->begin() + end, TOSDB_ERROR_IPC);
+            err = TOSDB_ERROR_IPC;
+            continue;
+        }
+
+        for(size_t i = beg; i < end; ++i){
+            int32_t r;
+            if( !msg[i - beg].get_i32(0, &r) ){
+                TOSDB_LogRawH("IPC", ("bad reply record in _requestStreamOPs, item: " + streams[i].second).c_str());
+                r = TOSDB_ERROR_IPC;
+            }else if(r){
+                TOSDB_LogRawH("ENGINE", ("error code returned from engine: " + std::to_string(r)
+                                         + ", item: " + streams[i].second).c_str());
+            }
+            (*rets)[i] = r;
+        }
     }
 
-    try{
-        long r = std::stol(msg);        
-        if(r)
-            TOSDB_LogRawH("ENGINE", ("error code returned from engine: " + std::to_string(r)).c_str());
-        return r;
-    }catch(...){
-        TOSDB_LogRawH("IPC", ("failed to convert return message to long, msg:" + msg).c_str());
-        return TOSDB_ERROR_IPC;
-    }    
+    return err;
+}
+
+
+long 
+_requestStreamOP(TOS_Topics::TOPICS topic_t, 
+                std::string item, 
+                unsigned long timeout, 
+                unsigned int opcode)
+{ /* needs exclusivity but can't block; CALLING CODE MUST LOCK
+     returns 0 on sucess, TOSDB_ERROR... on error */
+    std::vector<long> rets;
+
+    long r = _requestStreamOPs(stream_op_list_ty(1, std::make_pair(topic_t,item)), 
+                               timeout, opcode, &rets);    
+    return r ? r : rets[0];
 }
 
 
@@ -227,6 +302,22 @@ _releaseBuffer(TOS_Topics::TOPICS topic_t,
 }  
 
 
+int
+_removeStreams(const stream_op_list_ty& ops, unsigned long timeout, int err)
+{ /* CALLING CODE MUST LOCK; returns 'err' decremented once per failure */
+    std::vector<long> rets;
+
+    _requestStreamOPs(ops, timeout, TOSDB_SIG_REMOVE, &rets);
+    for(auto r : rets){
+        if(r != 0){
+            --err;
+            TOSDB_LogH("IPC","_requestStreamOPs(REMOVE) failed, stream leaked");
+        }
+    }
+    return err;
+}
+
+
 template<typename T> 
 inline T 
 _castToVal(char* val) 
@@ -249,9 +340,10 @@ _extractFromBuffer(TOS_Topics::TOPICS topic,
                    buffer_info_ty& buf_info)
 {  /* some unecessary comp in here; cache some of the buffer params */ 
     long npos;
-    long long loop_diff, nelems;
+    long long loop_diff, nelems, n;
     unsigned int dlen;
     char* spot;
+    pDateTimeStamp datetime;
 
     pBufferHead head = (pBufferHead)std::get<3>(buf_info);
         
@@ -290,22 +382,40 @@ _extractFromBuffer(TOS_Topics::TOPICS topic,
             nelems = dlen / head->elem_size;
         }
         
-        do{ /* go through each elem, last first  */
-            spot = (char*)head + 
-                   (((head->next_offset - (nelems * head->elem_size)) + dlen) % dlen);  
-      
+        /* blocks can share a stream; only push to each once */
+        std::vector<const void*> pushed;
+        pushed.reserve(std::get<2>(buf_info).size());
+
+        try{
             for(const TOSDBlock* block : std::get<2>(buf_info)){ 
-                /* insert those elements into each block's raw data block */          
-                block->   
-                block->
-                    insert_data(
-                        topic, 
-                        item, 
-                        _castToVal<T>(spot), 
-                        *(pDateTimeStamp)(spot + ((head->elem_size) - sizeof(DateTimeStamp)))
-                    ); 
+                /* insert those elements into each block's raw data block; the typed
+                   ref pushes straight to the DataStream, only the stream is locked */
+                TOSDB_RawDataBlock::TypedStreamRef<T> ref = 
+                    block->block->typed_stream_ref<T>(item, topic);
+
+                if(std::find(pushed.begin(), pushed.end(), ref.stream_id()) != pushed.end())
+                    continue;
+                pushed.push_back(ref.stream_id());
+
+                n = nelems;
+                do{ /* go through each elem, last first  */
+                    spot = (char*)head + 
+                           (((head->next_offset - (n * head->elem_size)) + dlen) % dlen);  
+                    datetime = (pDateTimeStamp)(spot + ((head->elem_size) - sizeof(DateTimeStamp)));
+
+                    if(ref.valid())
+                        ref.push(_castToVal<T>(spot), *datetime);
+                    else
+                        block->block->insert_data(topic, item, _castToVal<T>(spot), *datetime);
+                }while(--n);
             }
-        }while(--nelems);
+        }catch(...){ 
+            /* skip what's left of this batch, don't leave the engine's buffer locked */
+            std::get<0>(buf_info) = head->next_offset - head->beg_offset;
+            std::get<1>(buf_info) = head->loop_seq;    
+            ReleaseMutex(std::get<4>(buf_info));
+            throw;
+        }
     } 
     /* adjust our buffer info to the present values */
     std::get<0>(buf_info) = head->next_offset - head->beg_offset;
@@ -340,8 +450,8 @@ _threadedExtractLoop(LPVOID lParam)
         aware_of_connection.store(true);
 
     while( _connected() ){
-     /* [jan 2017] we should be more careful about how often we call _connected 
-                   (i.e every 30 msec is no good) */
+     /* _connected only reads the engine's heartbeat but there's still no 
+        reason to check more often than every TOSDB_PROBE_WAIT msec */
         probe_waiting = 0;
         /* after waiting for (atleast) TOSDB_PROBE_WAIT msec break to check for connection */
         while(probe_waiting < TOSDB_PROBE_WAIT && aware_of_connection.load()){                     
@@ -352,22 +462,29 @@ _threadedExtractLoop(LPVOID lParam)
                 /* --- CRITICAL SECTION --- */             
                 for(buffers_ty::value_type & buf : buffers)
                 {
-                    switch(TOS_Topics::TypeBits(buf.first.first)){
-                    case TOSDB_STRING_BIT :                  
-                        _extractFromBuffer<std::string>(buf.first.first, buf.first.second, buf.second); 
-                        break;
-                    case TOSDB_INTGR_BIT :                  
-                        _extractFromBuffer<long>(buf.first.first, buf.first.second, buf.second); 
-                        break;                      
-                    case TOSDB_QUAD_BIT :                   
-                        _extractFromBuffer<double>(buf.first.first, buf.first.second, buf.second); 
-                        break;            
-                    case TOSDB_INTGR_BIT | TOSDB_QUAD_BIT :                  
-                        _extractFromBuffer<long long>(buf.first.first, buf.first.second, buf.second); 
-                        break;              
-                    default : 
-                        _extractFromBuffer<float>(buf.first.first, buf.first.second, buf.second);                         
-                    };        
+                    try{
+                        switch(TOS_Topics::TypeBits(buf.first.first)){
+                        case TOSDB_STRING_BIT :                  
+                            _extractFromBuffer<std::string>(buf.first.first, buf.first.second, buf.second); 
+                            break;
+                        case TOSDB_INTGR_BIT :                  
+                            _extractFromBuffer<long>(buf.first.first, buf.first.second, buf.second); 
+                            break;                      
+                        case TOSDB_QUAD_BIT :                   
+                            _extractFromBuffer<double>(buf.first.first, buf.first.second, buf.second); 
+                            break;            
+                        case TOSDB_INTGR_BIT | TOSDB_QUAD_BIT :                  
+                            _extractFromBuffer<long long>(buf.first.first, buf.first.second, buf.second); 
+                            break;              
+                        default : 
+                            _extractFromBuffer<float>(buf.first.first, buf.first.second, buf.second);                         
+                        };        
+                    }catch(const std::exception& e){
+                        /* a bad buffer/stream shouldn't take the loop (and every other stream) down */
+                        std::string key = TOS_Topics::map[buf.first.first] + " " + buf.first.second 
+                                        + ": " + e.what();
+                        TOSDB_LogLimitedH("DATA BUFFER", key.c_str(), "error extracting from buffer");
+                    }
                 }
                 /* --- CRITICAL SECTION --- */
             } /* make sure we give up this lock each time through the buffers */
@@ -396,7 +513,7 @@ _createBlock(LPCSTR id,
     if( !IsValidBlockSize(sz) )
         return TOSDB_ERROR_BLOCK_SIZE;  
 
-    GLOBAL_RLOCK_GUARD;
+    GLOBAL_WLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
 
     if( GetBlockPtr(id,false) ){
@@ -427,6 +544,153 @@ _createBlock(LPCSTR id,
     /* --- CRITICAL SECTION --- */
 }
 
+
+DWORD WINAPI 
+_asyncAdminLoop(LPVOID lParam)
+{ /* lParam is the module ref _queueAsyncOp took for us */
+    bool done = false;
+
+    while(!done){
+        std::function<void()> op;
+        {
+            std::lock_guard<std::mutex> lock(async_mtx);
+            /* --- CRITICAL SECTION --- */
+            if(async_ops.empty()){
+                async_thread_running = false;
+                SetEvent(async_done);
+                done = true;
+            }else{
+                op = std::move(async_ops.front());
+                async_ops.pop_front();
+            }
+            /* --- CRITICAL SECTION --- */
+        }
+        if(op)
+            op();
+    }
+
+    /* the DLL can't be unloaded until we let go of it here, after the last
+       of our code has run (no unwinding, so nothing can be left in scope) */
+    FreeLibraryAndExitThread((HMODULE)lParam, 0);
+    return 0;
+}
+
+
+void
+_queueAsyncOp(std::function<void()> op)
+{ /* if we can't start a thread the op runs on the calling thread */
+    HANDLE hndl;
+    HMODULE mod;
+    {
+        std::lock_guard<std::mutex> lock(async_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(async_stopped){
+            TOSDB_LogH("THREAD", "async admin op after DLL_PROCESS_DETACH, dropped");
+            return;
+        }
+
+        async_ops.push_back(op);
+        if(async_thread_running)
+            return;
+
+        if(!async_done)
+            async_done = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+        /* the thread holds a ref to this DLL so FreeLibrary can't unload it 
+           out from under the thread (see _asyncAdminLoop) */
+        if( async_done 
+            && GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, 
+                                  (LPCSTR)_asyncAdminLoop, &mod) )
+        {
+            ResetEvent(async_done);
+            hndl = CreateThread(NULL, 0, _asyncAdminLoop, (LPVOID)mod, 0, NULL);
+            if(hndl){
+                async_thread_running = true;
+                CloseHandle(hndl);
+                return;
+            }
+            FreeLibrary(mod);
+        }
+        async_ops.pop_back();
+        /* --- CRITICAL SECTION --- */
+    }
+    TOSDB_LogH("THREAD", "using calling thread for async admin op (THIS MAY BLOCK)");
+    op();
+}
+
+
+std::future<int>
+_asyncAdminOp(std::function<int()> op)
+{
+    auto task = std::make_shared<std::packaged_task<int()>>(op);
+    std::future<int> fut = task->get_future();
+
+    _queueAsyncOp( [=]{ (*task)(); } );
+    return fut;
+}
+
+
+int
+_asyncAdminOp(std::function<int()> op, AsyncAdminCallback callback, void* arg)
+{ /* C version: exceptions become TOSDB_ERROR_UNKNOWN */
+    _queueAsyncOp( 
+        [=]{
+            int ret;
+            try{
+                ret = op();
+            }catch(const std::exception& e){
+                TOSDB_LogH("ASYNC", e.what());
+                ret = TOSDB_ERROR_UNKNOWN;
+            }catch(...){
+                ret = TOSDB_ERROR_UNKNOWN;
+            }
+            if(callback)
+                callback(ret, arg);
+        }
+    );
+    return 0;
+}
+
+
+bool
+_stopAsyncOps(bool process_exit)
+{ /* 
+   * from DllMain: drop the queued ops (their futures get broken_promise, C 
+   * callbacks aren't called) and give the one in progress a bounded wait 
+   * to finish before the cleanup it may still be using; false if it didn't. 
+   * (The thread's module ref means FreeLibrary only gets us here once it's 
+   * done, so this is just a guard.) On process exit the thread is already 
+   * gone (maybe holding async_mtx), just stop.
+   */
+    std::deque<std::function<void()>> dropped;
+    bool running;
+
+    if(process_exit){
+        async_stopped = true;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(async_mtx);
+        /* --- CRITICAL SECTION --- */
+        async_stopped = true;
+        dropped.swap(async_ops);
+        running = async_thread_running;
+        /* --- CRITICAL SECTION --- */
+    }
+
+    if(!dropped.empty())
+        TOSDB_LogH("THREAD", ("dropped " + std::to_string(dropped.size()) 
+                              + " queued async admin op(s) at DLL_PROCESS_DETACH").c_str());
+
+    if(running && WaitForSingleObject(async_done, ASYNC_STOP_WAIT_MSEC) != WAIT_OBJECT_0){
+        TOSDB_LogH("THREAD", "timed out waiting for async admin op at DLL_PROCESS_DETACH");
+        return false;
+    }
+
+    return true;
+}
+
 }; /* namespace */
 
 
@@ -451,12 +715,16 @@ DllMain(HANDLE mod, DWORD why, LPVOID res) /* ENTRY POINT */
         break;
     case DLL_PROCESS_DETACH:  
         {                                   
+            /* 'res' is non-NULL if the process is exiting (vs. FreeLibrary) */
+            bool async_idle = _stopAsyncOps(res != NULL);
             for(const auto & buffer : buffers)
             {/* signal the service and close the handles */        
                 _requestStreamOP(buffer.first.first, buffer.first.second, 
                                 TOSDB_DEF_TIMEOUT, TOSDB_SIG_REMOVE);
-                UnmapViewOfFile(std::get<3>(buffer.second));
-                CloseHandle(std::get<4>(buffer.second));
+                if(async_idle){ /* else the op may still be reading them; leak */
+                    UnmapViewOfFile(std::get<3>(buffer.second));
+                    CloseHandle(std::get<4>(buffer.second));
+                }
             }                                             
             /* needs to come after close ops or _requestStreamOP will fail on _connected() */
             aware_of_connection.store(false);
@@ -594,7 +862,11 @@ TOSDB_Add(std::string id, str_set_type items, topic_set_type topics_t)
     str_set_type old_items;
     str_set_type tot_items;
     str_set_type iunion;
-    bool is_empty;
+    stream_op_list_ty topic_ops;
+    stream_op_list_ty item_ops;
+    std::vector<long> topic_rets;
+    std::vector<long> item_rets;
+    bool is_empty = false;
     TOSDBlock *db;
 
     HWND hndl = NULL;
@@ -629,36 +901,40 @@ TOSDB_Add(std::string id, str_set_type items, topic_set_type topics_t)
     if( items.empty() && topics_t.empty() )
         return TOSDB_ERROR_BAD_INPUT; 
 
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */
+    {
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = _getBlockPtr(id);
+        if(!db){
+            TOSDB_LogH("BLOCK", ("block (" + id + ") doesn't exist").c_str());
+            return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        }
 
-    db = _getBlockPtr(id);
-    if(!db){
-        TOSDB_LogH("BLOCK", ("block (" + id + ") doesn't exist").c_str());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
-    }
-
-    old_topics = db->block->topics();
-    old_items = db->block->items(); 
+        old_topics = db->block->topics();
+        old_items = db->block->items(); 
   
-    if( !db->item_precache.empty() ) 
-       /* if we have pre-cached items, include them */
-       std::set_union(items.cbegin(), items.cend(),
-                      db->item_precache.cbegin(), db->item_precache.cend(),
-                      std::insert_iterator<str_set_type>(tot_items,tot_items.begin())); 
-    else 
-        tot_items = items; /* 'copy', keep items available for pre-caching */ 
-   
-  
-    if( !db->topic_precache.empty() ) 
-        /* if we have pre-cached topics, include them */
-        std::set_union(topics_t.cbegin(), topics_t.cend(),
-                       db->topic_precache.cbegin(), db->topic_precache.cend(),
-                       std::insert_iterator<topic_set_type>(tot_topics,tot_topics.begin()),
-                       TOS_Topics::top_less()); 
-    else 
-        tot_topics = std::move(topics_t); /* move, don't need topics_t anymore */  
-    
+        if( !db->item_precache.empty() ) 
+           /* if we have pre-cached items, include them */
+           std::set_union(items.cbegin(), items.cend(),
+                          db->item_precache.cbegin(), db->item_precache.cend(),
+                          std::insert_iterator<str_set_type>(tot_items,tot_items.begin())); 
+        else 
+            tot_items = items; /* 'copy', keep items available for pre-caching */ 
+     
+        if( !db->topic_precache.empty() ) 
+            /* if we have pre-cached topics, include them */
+            std::set_union(topics_t.cbegin(), topics_t.cend(),
+                           db->topic_precache.cbegin(), db->topic_precache.cend(),
+                           std::insert_iterator<topic_set_type>(tot_topics,tot_topics.begin()),
+                           TOS_Topics::top_less()); 
+        else 
+            tot_topics = std::move(topics_t); /* move, don't need topics_t anymore */  
+        /* --- CRITICAL SECTION --- */
+    }
+    /* 'db' stays valid w/o the global lock: only code holding the admin lock
+        closes blocks or changes their items/topics/pre-caches */
 
     /* find new items and topics to add */
     std::set_difference(tot_topics.cbegin(), tot_topics.cend(),
@@ -670,7 +946,6 @@ TOSDB_Add(std::string id, str_set_type items, topic_set_type topics_t)
                         old_items.cbegin(), old_items.cend(),
                         std::insert_iterator<str_set_type>(idiff, idiff.begin()));
 
-
     if( !tdiff.empty() ){
         /* if new topics, atleast one item, add them to the block
            add ALL the items (new and old) for each */
@@ -681,37 +956,52 @@ TOSDB_Add(std::string id, str_set_type items, topic_set_type topics_t)
         is_empty = iunion.empty();
 
         for(auto & topic : tdiff){  
-            if(is_empty)
+            for(auto & item : iunion)
+                topic_ops.push_back( std::make_pair(topic,item) );
+        }
+    }
+
+    /* add new items to the old topics */
+    for(auto & topic : old_topics){     
+        for(auto & item : idiff)
+            item_ops.push_back( std::make_pair(topic,item) );
+    }
+
+    /* TRY TO ADD TO ENGINE (batched); readers aren't blocked while we wait */
+    _requestStreamOPs(topic_ops, db->timeout, TOSDB_SIG_ADD, &topic_rets);
+    _requestStreamOPs(item_ops, db->timeout, TOSDB_SIG_ADD, &item_rets);
+
+    GLOBAL_WLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    if( !tdiff.empty() ){
+        if(is_empty){
+            for(auto & topic : tdiff)
                 db->topic_precache.insert(topic);
+        }
 
-            for(auto & item : iunion){
-                /* TRY TO ADD TO BLOCK */
-                if(_requestStreamOP(topic, item, db->timeout, TOSDB_SIG_ADD) == 0){
-                    db->block->add_topic(topic);
-                    db->block->add_item(item);
-                    db->item_precache.clear();
-                    db->topic_precache.clear();
-                    _captureBuffer(topic, item, db);  
-                }else
-                    --err;                        
-            }          
+        for(size_t i = 0; i < topic_ops.size(); ++i){
+            /* TRY TO ADD TO BLOCK */
+            if(topic_rets[i] == 0){
+                db->block->add_topic(topic_ops[i].first);
+                db->block->add_item(topic_ops[i].second);
+                db->item_precache.clear();
+                db->topic_precache.clear();
+                _captureBuffer(topic_ops[i].first, topic_ops[i].second, db);  
+            }else
+                --err;                        
         }    
     }else if(old_topics.empty()){ /* don't ignore items if no topics yet.. */
         for(auto & i : items)
             db->item_precache.insert(i); /* ...pre-cache them */     
     }
-    
 
-    /* add new items to the old topics */
-    for(auto & topic : old_topics){     
-        for(auto & item : idiff){       
-            /* TRY TO ADD TO BLOCK */
-            if(_requestStreamOP(topic, item, db->timeout, TOSDB_SIG_ADD) == 0){
-                db->block->add_item(item);          
-                _captureBuffer(topic, item, db);   
-            }else
-                --err;             
-        }
+    for(size_t i = 0; i < item_ops.size(); ++i){       
+        /* TRY TO ADD TO BLOCK */
+        if(item_rets[i] == 0){
+            db->block->add_item(item_ops[i].second);          
+            _captureBuffer(item_ops[i].first, item_ops[i].second, db);   
+        }else
+            --err;             
     }
 
     /* if we didn't decr err return success */
@@ -852,6 +1142,7 @@ int
 TOSDB_RemoveTopic(std::string id, TOS_Topics::TOPICS topic_t)
 {  
     TOSDBlock* db;
+    stream_op_list_ty ops;
     int err = TOSDB_ERROR_DECREMENT_BASE;
 
     if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC){
@@ -862,36 +1153,43 @@ TOSDB_RemoveTopic(std::string id, TOS_Topics::TOPICS topic_t)
     if( !_connected(true) )
         return TOSDB_ERROR_NOT_CONNECTED;
   
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-
-    db = _getBlockPtr(id);
-    if(!db){
-        TOSDB_LogH("BLOCK", ("block (" + id + ") doesn't exist").c_str());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
-    }   
+    {
+        GLOBAL_WLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = _getBlockPtr(id);
+        if(!db){
+            TOSDB_LogH("BLOCK", ("block (" + id + ") doesn't exist").c_str());
+            return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        }   
         
-    if( db->block->has_topic(topic_t) ){
-        for(auto & item : db->block->items())
-        {
-            _releaseBuffer(topic_t, item, db); 
-            if(_requestStreamOP(topic_t, item, db->timeout, TOSDB_SIG_REMOVE) != 0){
-                --err;
-                TOSDB_LogH("IPC","_requestStreamOP(REMOVE) failed, stream leaked");
+        if( db->block->has_topic(topic_t) ){
+            for(auto & item : db->block->items())
+            {
+                _releaseBuffer(topic_t, item, db); 
+                ops.push_back( std::make_pair(topic_t,item) );
             }
+            InvalidateStreamHandles(db, std::string(), topic_t);
+            db->block->remove_topic(topic_t);
+            if( db->block->topics().empty() ){
+                InvalidateStreamHandles(db);
+                for(const std::string & item : db->block->items()){
+                    db->item_precache.insert(item);
+                    db->block->remove_item(item); 
+                }  
+            }
+        }else if(db->topic_precache.find(topic_t) == db->topic_precache.end()){
+            return TOSDB_ERROR_BAD_TOPIC;  
         }
-        db->block->remove_topic(topic_t);
-        if( db->block->topics().empty() ){
-            for(const std::string & item : db->block->items()){
-                db->item_precache.insert(item);
-                db->block->remove_item(item); 
-            }  
-        }
-    }else if(db->topic_precache.find(topic_t) == db->topic_precache.end()){
-        return TOSDB_ERROR_BAD_TOPIC;  
+
+        db->topic_precache.erase(topic_t);
+        /* --- CRITICAL SECTION --- */
     }
 
-    db->topic_precache.erase(topic_t);
+    /* streams are already out of the block; tell the engine w/o the global lock */
+    err = _removeStreams(ops, db->timeout, err);
+
     /* if we didn't decr err return success */
     return (err == TOSDB_ERROR_DECREMENT_BASE) ? 0 : err;
     /* --- CRITICAL SECTION --- */
@@ -909,6 +1207,7 @@ int
 TOSDB_RemoveItem(LPCSTR id, LPCSTR item)
 {  
     TOSDBlock* db;
+    stream_op_list_ty ops;
     int err = TOSDB_ERROR_DECREMENT_BASE;
 
     if( !CheckStringLength(item) || !IsValidBlockID(id) )
@@ -917,36 +1216,43 @@ TOSDB_RemoveItem(LPCSTR id, LPCSTR item)
     if( !_connected(true) )
         return TOSDB_ERROR_NOT_CONNECTED;  
   
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */ 
-
-    db = _getBlockPtr(id);
-    if(!db){
-        TOSDB_LogH("BLOCK", ("block (" + std::string(id) + ") doesn't exist").c_str());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
-    }  
+    {
+        GLOBAL_WLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */ 
+        db = _getBlockPtr(id);
+        if(!db){
+            TOSDB_LogH("BLOCK", ("block (" + std::string(id) + ") doesn't exist").c_str());
+            return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        }  
         
-    if( db->block->has_item(item) ){
-        for(auto topic : db->block->topics())
-        {
-            _releaseBuffer(topic, item, db); 
-            if(_requestStreamOP(topic, item, db->timeout, TOSDB_SIG_REMOVE) != 0){
-                --err;
-                TOSDB_LogH("IPC","_requestStreamOP(REMOVE) failed, stream leaked");
+        if( db->block->has_item(item) ){
+            for(auto topic : db->block->topics())
+            {
+                _releaseBuffer(topic, item, db); 
+                ops.push_back( std::make_pair(topic,std::string(item)) );
             }
-        }
-        db->block->remove_item(item);
-        if( db->block->items().empty() ){
-            for(const TOS_Topics::TOPICS topic : db->block->topics()){
-                db->topic_precache.insert (topic);
-                db->block->remove_topic(topic);
+            InvalidateStreamHandles(db, item);
+            db->block->remove_item(item);
+            if( db->block->items().empty() ){
+                InvalidateStreamHandles(db);
+                for(const TOS_Topics::TOPICS topic : db->block->topics()){
+                    db->topic_precache.insert (topic);
+                    db->block->remove_topic(topic);
+                }
             }
+        }else if(db->item_precache.find(item) == db->item_precache.end()){
+            return TOSDB_ERROR_BAD_ITEM;
         }
-    }else if(db->item_precache.find(item) == db->item_precache.end()){
-        return TOSDB_ERROR_BAD_ITEM;
+
+        db->item_precache.erase(item);
+        /* --- CRITICAL SECTION --- */ 
     }
 
-    db->item_precache.erase(item);
+    /* streams are already out of the block; tell the engine w/o the global lock */
+    err = _removeStreams(ops, db->timeout, err);
+
     /* if we didn't decr err return success */
     return (err == TOSDB_ERROR_DECREMENT_BASE) ? 0 : err;    
   /* --- CRITICAL SECTION --- */
@@ -957,44 +1263,52 @@ int
 TOSDB_CloseBlock(LPCSTR id)
 {
     TOSDBlock* db;
+    stream_op_list_ty ops;
     HANDLE del_thrd_hndl;
     DWORD del_thrd_id;
+    unsigned long timeout;
 
     int err = TOSDB_ERROR_DECREMENT_BASE;  
 
     if( !IsValidBlockID(id) )        
         return TOSDB_ERROR_BAD_INPUT;   
 
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */  
-
-    db = _getBlockPtr(id);
-    if(!db){
-        TOSDB_LogH("BLOCK", ("block (" + std::string(id) + ") doesn't exist").c_str());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
-    }  
-
-    for(auto & item : db->block->items()){
-        for(auto topic : db->block->topics())
-        {
-            _releaseBuffer(topic, item, db);
-            if(_requestStreamOP(topic, item, db->timeout, TOSDB_SIG_REMOVE) != 0){
-                --err;
-                TOSDB_LogH("IPC", "_requestStreamOP(REMOVE) failed, stream leaked");
+    {
+        GLOBAL_WLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */  
+        db = _getBlockPtr(id);
+        if(!db){
+            TOSDB_LogH("BLOCK", ("block (" + std::string(id) + ") doesn't exist").c_str());
+            return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        }  
+
+        for(auto & item : db->block->items()){
+            for(auto topic : db->block->topics())
+            {
+                _releaseBuffer(topic, item, db);
+                ops.push_back( std::make_pair(topic,item) );
             }
         }
-    }
 
-    dde_blocks.erase(id);       
+        InvalidateStreamHandles(db);
+        dde_blocks.erase(id);       
 
-    /* spin-off block destruction to its own thread so we don't block main */
-    del_thrd_hndl = CreateThread(NULL, 0, _cleanupBlock, (LPVOID)db->block, 0, &(del_thrd_id));
-    if(!del_thrd_hndl){       
-        TOSDB_LogH("THREAD", "using main thread to clean-up(THIS MAY BLOCK)"); 
-        _cleanupBlock((LPVOID)db->block);
+        /* spin-off block destruction to its own thread so we don't block main */
+        del_thrd_hndl = CreateThread(NULL, 0, _cleanupBlock, (LPVOID)db->block, 0, &(del_thrd_id));
+        if(!del_thrd_hndl){       
+            TOSDB_LogH("THREAD", "using main thread to clean-up(THIS MAY BLOCK)"); 
+            _cleanupBlock((LPVOID)db->block);
+        }
+
+        timeout = db->timeout;
+        delete db;
+        /* --- CRITICAL SECTION --- */  
     }
 
-    delete db;
+    /* block is gone; tell the engine w/o the global lock */
+    err = _removeStreams(ops, timeout, err);
 
     /* if we didn't decr err return success */
     return (err == TOSDB_ERROR_DECREMENT_BASE) ? 0 : err;   
@@ -1007,12 +1321,14 @@ TOSDB_CloseBlocks()
     std::map<std::string, TOSDBlock*> bcopy;  
     int err = TOSDB_ERROR_DECREMENT_BASE;
     try{ 
-        GLOBAL_RLOCK_GUARD;  
+        LOCAL_ADMIN_LOCK_GUARD;  
         /* --- CRITICAL SECTION --- */
-
-        /* need a copy, _CloseBlock removes from original */    
-        std::insert_iterator<std::map<std::string,TOSDBlock*>> i(bcopy,bcopy.begin());
-        std::copy(dde_blocks.begin(), dde_blocks.end(), i); 
+        {
+            GLOBAL_RLOCK_GUARD;
+            /* need a copy, _CloseBlock removes from original */    
+            std::insert_iterator<std::map<std::string,TOSDBlock*>> i(bcopy,bcopy.begin());
+            std::copy(dde_blocks.begin(), dde_blocks.end(), i); 
+        }
         for(auto & b: bcopy){    
             if( TOSDB_CloseBlock(b.first.c_str()) )
                 --err;
@@ -1027,28 +1343,121 @@ TOSDB_CloseBlocks()
 }
 
 
+int 
+TOSDB_AddAsync(LPCSTR id, 
+               LPCSTR* items, 
+               size_type items_len, 
+               LPCSTR* topics_str, 
+               size_type topics_len,
+               AsyncAdminCallback callback,
+               void* arg)
+{ 
+    if( !IsValidBlockID(id) 
+          || !CheckStringLengths(items, items_len) 
+          || !CheckStringLengths(topics_str, topics_len) )
+    {  
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    /* copy everything now, the caller's arrays may not outlive the call */
+    auto f = [=](LPCSTR str){ return GetTopicEnum(str); };
+    std::string sid(id);
+    str_set_type iset(items, items_len);
+    topic_set_type tset(topics_str, topics_len, f);
+  
+    return _asyncAdminOp([=]{ return TOSDB_Add(sid, iset, tset); }, callback, arg); 
+}
+
+
+int 
+TOSDB_RemoveTopicAsync(LPCSTR id, LPCSTR topic_str, AsyncAdminCallback callback, void* arg)
+{
+    if( !IsValidBlockID(id) || !CheckStringLength(topic_str) )
+        return TOSDB_ERROR_BAD_INPUT;
+    
+    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC; 
+
+    std::string sid(id);
+    return _asyncAdminOp([=]{ return TOSDB_RemoveTopic(sid, t); }, callback, arg);
+}
+
+
+int 
+TOSDB_RemoveItemAsync(LPCSTR id, LPCSTR item, AsyncAdminCallback callback, void* arg)
+{
+    if( !CheckStringLength(item) || !IsValidBlockID(id) )
+        return TOSDB_ERROR_BAD_INPUT;
+
+    std::string sid(id);
+    std::string sitem(item);
+    return _asyncAdminOp([=]{ return TOSDB_RemoveItem(sid, sitem); }, callback, arg);
+}
+
+
+int 
+TOSDB_CloseBlockAsync(LPCSTR id, AsyncAdminCallback callback, void* arg)
+{
+    if( !IsValidBlockID(id) )        
+        return TOSDB_ERROR_BAD_INPUT;  
+
+    std::string sid(id);
+    return _asyncAdminOp([=]{ return TOSDB_CloseBlock(sid.c_str()); }, callback, arg);
+}
+
+
+std::future<int>
+TOSDB_AddAsync(std::string id, str_set_type items, topic_set_type topics_t)
+{
+    return _asyncAdminOp([=]{ return TOSDB_Add(id, items, topics_t); });
+}
+
+
+std::future<int>
+TOSDB_RemoveTopicAsync(std::string id, TOS_Topics::TOPICS topic_t)
+{
+    return _asyncAdminOp([=]{ return TOSDB_RemoveTopic(id, topic_t); });
+}
+
+
+std::future<int>
+TOSDB_RemoveItemAsync(std::string id, std::string item)
+{
+    return _asyncAdminOp([=]{ return TOSDB_RemoveItem(id, item); });
+}
+
+
+std::future<int>
+TOSDB_CloseBlockAsync(std::string id)
+{
+    return _asyncAdminOp([=]{ return TOSDB_CloseBlock(id.c_str()); });
+}
+
+
 int
 TOSDB_DumpSharedBufferStatus()
 {
     if( !_connected(true) )
         return TOSDB_ERROR_NOT_CONNECTED;
 
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */
 
-    std::string msg = std::to_string(TOSDB_SIG_DUMP);
+    IPCMessage msg;
+    msg.add_record().add_u32(TOSDB_SIG_DUMP);
 
     if( !master.call(&msg, TOSDB_DEF_TIMEOUT) ){
-        TOSDB_LogH("IPC",("master.call failled, msg:" + msg).c_str());
+        TOSDB_LogH("IPC","master.call failled, msg: TOSDB_SIG_DUMP");
         return TOSDB_ERROR_IPC;
     }
 
-    try{        
-        return (std::stol(msg) == TOSDB_SIG_GOOD) ? 0 : TOSDB_ERROR_IPC;
-    }catch(...){
-        TOSDB_LogH("IPC", "failed to convert return message to long");
+    int32_t r;
+    if( msg.size() != 1 || !msg[0].get_i32(0, &r) ){
+        TOSDB_LogH("IPC", "bad reply record for TOSDB_SIG_DUMP");
         return TOSDB_ERROR_IPC;
     }      
+    return (r == TOSDB_SIG_GOOD) ? 0 : TOSDB_ERROR_IPC;
     /* --- CRITICAL SECTION --- */
 }
 
@@ -1074,7 +1483,7 @@ TOSDB_RemoveOrphanedStream(LPCSTR item, LPCSTR topic_str)
     if( !_connected(true) )
         return TOSDB_ERROR_NOT_CONNECTED;    
   
-    GLOBAL_RLOCK_GUARD;
+    LOCAL_ADMIN_LOCK_GUARD;
     /* --- CRITICAL SECTION --- */
     return _requestStreamOP(t, item, TOSDB_DEF_TIMEOUT, TOSDB_SIG_REMOVE);    
     /* --- CRITICAL SECTION --- */
@@ -1139,7 +1548,7 @@ TOSDB_GetClientLogPath(char* path, size_type sz)
 unsigned long 
 TOSDB_SetLatency(UpdateLatency latency) 
 {
-    GLOBAL_RLOCK_GUARD;  
+    GLOBAL_WLOCK_GUARD;  
     /* --- CRITICAL SECTION --- */
     unsigned long tmp = buffer_latency;
 
@@ -34,7 +34,7 @@ TOSDB_GetBlockLimit()
 size_type 
 TOSDB_SetBlockLimit(size_type sz)
 {  
-    GLOBAL_RLOCK_GUARD; 
+    GLOBAL_WLOCK_GUARD; 
     /* --- CRITICAL SECTION --- */
     return TOSDB_RawDataBlock::max_block_count(sz);
     /* --- CRITICAL SECTION --- */
@@ -112,6 +112,129 @@ TOSDB_SetBlockSize(LPCSTR id, size_type sz)
     } 
 }
 
+int 
+TOSDB_GetBlockHotSize(LPCSTR id, size_type* pSize)
+{
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    try{   
+        GLOBAL_RLOCK_GUARD;  
+        /* --- CRITICAL SECTION --- */
+        *pSize = GetBlockOrThrow(id)->block->hot_size();
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str()); 
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetBlockHotSize", e.what());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    } 
+}
+
+int 
+TOSDB_SetBlockHotSize(LPCSTR id, size_type sz)
+{
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    if(sz > TOSDB_MAX_BLOCK_SZ)
+        return TOSDB_ERROR_BLOCK_SIZE;           
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        GetBlockOrThrow(id)->block->hot_size(sz);
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_SetBlockHotSize", e.what());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    } 
+}
+
+int 
+TOSDB_IsUsingColdCompression(LPCSTR id, unsigned int* is_compressed)
+{
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    try{   
+        GLOBAL_RLOCK_GUARD;  
+        /* --- CRITICAL SECTION --- */
+        *is_compressed = GetBlockOrThrow(id)->block->cold_compressed();
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str()); 
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_IsUsingColdCompression", e.what());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    } 
+}
+
+int 
+TOSDB_SetBlockColdCompression(LPCSTR id, unsigned int compress)
+{
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        GetBlockOrThrow(id)->block->cold_compressed(compress != 0);
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_SetBlockColdCompression", e.what());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    } 
+}
+
 int 
 TOSDB_GetItemCount(LPCSTR id, size_type* count)
 {
@@ -233,6 +356,76 @@ TOSDB_GetItemNames(LPCSTR id, LPSTR* dest, size_type array_len, size_type str_le
     /* --- CRITICAL SECTION --- */
 }
 
+int 
+TOSDB_GetItemLabels(LPCSTR id, 
+                    LPSTR* dest, 
+                    size_type array_len, 
+                    size_type str_len, 
+                    size_type* item_indices)
+{
+    const TOSDBlock *db;
+    std::vector<std::pair<size_type, std::string>> labels;
+    size_type i;
+
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockPtr(id);
+    if (!db) 
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    labels = db->block->item_labels();   
+    if (array_len < labels.size()) 
+        return TOSDB_ERROR_BAD_INPUT_BUFFER;   
+ 
+    for(i = 0; i < labels.size(); ++i){
+        if( strcpy_s(dest[i], str_len, labels[i].second.c_str()) )
+            return TOSDB_ERROR_BAD_INPUT_BUFFER;
+        if(item_indices)
+            item_indices[i] = labels[i].first;
+    }
+
+    return 0;
+    /* --- CRITICAL SECTION --- */
+}
+
+int 
+TOSDB_GetTopicLabels(LPCSTR id, 
+                     LPSTR* dest, 
+                     size_type array_len, 
+                     size_type str_len, 
+                     size_type* topic_indices)
+{
+    const TOSDBlock *db;
+    std::vector<std::pair<size_type, TOS_Topics::TOPICS>> labels;
+    size_type i;
+
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockPtr(id);
+    if (!db) 
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    labels = db->block->topic_labels();   
+    if (array_len < labels.size()) 
+        return TOSDB_ERROR_BAD_INPUT_BUFFER;   
+ 
+    for(i = 0; i < labels.size(); ++i){
+        if( strcpy_s(dest[i], str_len, TOS_Topics::map[labels[i].second].c_str()) )
+            return TOSDB_ERROR_BAD_INPUT_BUFFER;
+        if(topic_indices)
+            topic_indices[i] = labels[i].first;
+    }
+
+    return 0;
+    /* --- CRITICAL SECTION --- */
+}
+
 
 int 
 TOSDB_GetPreCachedItemCount(LPCSTR id, size_type* count)
@@ -466,6 +659,34 @@ TOSDB_GetItemNames(std::string id)
     /* --- CRITICAL SECTION --- */
 }
 
+std::vector<std::pair<size_type, std::string>> 
+TOSDB_GetItemLabels(std::string id)
+{
+    const TOSDBlock* db;  
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->item_labels();
+    /* --- CRITICAL SECTION --- */
+}
+
+std::vector<std::pair<size_type, std::string>> 
+TOSDB_GetTopicLabels(std::string id)
+{
+    const TOSDBlock* db;  
+    std::vector<std::pair<size_type, std::string>> labels;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    for(auto & t : db->block->topic_labels())
+        labels.push_back( std::make_pair(t.first, TOS_Topics::map[t.second]) );
+    /* --- CRITICAL SECTION --- */
+
+    return labels;
+}
+
 topic_set_type 
 TOSDB_GetPreCachedTopicEnums(std::string id)
 {
@@ -577,6 +798,42 @@ TOSDB_GetBlockSize(std::string id)
     /* --- CRITICAL SECTION --- */
 }
 
+void 
+TOSDB_SetBlockHotSize(std::string id, size_type sz)
+{
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    GetBlockOrThrow(id)->block->hot_size(sz);  
+    /* --- CRITICAL SECTION --- */
+}
+
+size_type 
+TOSDB_GetBlockHotSize(std::string id)
+{
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    return GetBlockOrThrow(id)->block->hot_size();  
+    /* --- CRITICAL SECTION --- */
+}
+
+void 
+TOSDB_SetBlockColdCompression(std::string id, bool compress)
+{
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    GetBlockOrThrow(id)->block->cold_compressed(compress);  
+    /* --- CRITICAL SECTION --- */
+}
+
+bool 
+TOSDB_IsUsingColdCompression(std::string id)
+{
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    return GetBlockOrThrow(id)->block->cold_compressed();  
+    /* --- CRITICAL SECTION --- */
+}
+
 bool 
 TOSDB_IsUsingDateTime(std::string id)
 {  
@@ -791,218 +1048,172 @@ TOSDB_IsMarkerDirty(std::string id,
     /* --- CRITICAL SECTION --- */
 }
 
-template<> 
-generic_type 
-TOSDB_Get<generic_type, false>(std::string id, 
-                               std::string item, 
-                               TOS_Topics::TOPICS topic_t, 
-                               long indx)
-{  
-    const TOSDBlock *db;  
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+int 
+TOSDB_AddMarker(LPCSTR id, LPCSTR marker)
+{
+    if(!IsValidBlockID(id) || !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;  
 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
-        throw std::invalid_argument("NULL TOPIC");
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        GetBlockOrThrow(id)->block->add_marker(marker);
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_AddMarker", e.what());
+        return TOSDB_ERROR_SET_STATE;
 
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }  
+}
+
+void 
+TOSDB_AddMarker(std::string id, std::string marker)
+{
     GLOBAL_RLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    dat = db->block->raw_stream_ptr(item, topic_t);  
-    try{
-        return dat->operator[](indx);
-    }catch(const DataStreamError& e){
-        throw TOSDB_DataStreamError(e, "TOSDB_Get<generic_type,false>");
-    }
+    GetBlockOrThrow(id)->block->add_marker(marker);
     /* --- CRITICAL SECTION --- */
 }
 
-template<> 
-generic_dts_type 
-TOSDB_Get<generic_type, true>(std::string id, 
-                              std::string item, 
-                              TOS_Topics::TOPICS topic_t, 
-                              long indx)
+int 
+TOSDB_RemoveMarker(LPCSTR id, LPCSTR marker)
 {
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    if(!IsValidBlockID(id) || !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;  
 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
-        throw std::invalid_argument("NULL TOPIC");
-
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    dat = db->block->raw_stream_ptr(item, topic_t);
-    try{
-        return dat->both(indx);
-    }catch(const DataStreamError& e){
-        throw TOSDB_DataStreamError(e, "TOSDB_Get<generic_type,true>");
-    }    
-    /* --- CRITICAL SECTION --- */
-}
-
-/* use functors of partially specialized object to overload by explicit call */
-template<typename T, bool b> 
-struct GRetType;
-
-template<typename T>
-struct GRetType<T, true>{
-    std::pair<T, DateTimeStamp> 
-    operator()(T val, DateTimeStamp dts)
-    {      
-        return std::pair<T, DateTimeStamp>(val, std::move(dts));
-    }
-};
-
-template<typename T>
-struct GRetType<T, false>{
-    T 
-    operator()(T val, DateTimeStamp dts) 
-    { 
-        return val; 
-    }
-};
-
-template<typename T, bool b> 
-auto 
-TOSDB_Get(std::string id, 
-          std::string item, 
-          TOS_Topics::TOPICS topic_t, 
-          long indx) -> typename std::conditional<b, std::pair<T, DateTimeStamp>, T>::type
-{
-    T tmp;
-    DateTimeStamp datetime;
-
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
-        throw std::invalid_argument("NULL TOPIC");
-
-    if(TOSDB_Get_(id, item, topic_t, indx, &tmp, &datetime))    
-        throw TOSDB_DataStreamError("TOSDB_Get_");
-
-    return GRetType<T,b>()(tmp, std::move(datetime));  
-}
-
-template<typename T> 
-int 
-TOSDB_Get_(std::string id, 
-           std::string item, 
-           TOS_Topics::TOPICS topic_t, 
-           long indx, 
-           T* dest, 
-           pDateTimeStamp datetime)
-{   
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat; 
-   
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
-        db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);  
-        dat->copy(dest, 1,indx, indx, datetime);
+        GetBlockOrThrow(id)->block->remove_marker(marker);
         return 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
     }catch(const TOSDB_Error& e){
         TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
-        return TOSDB_ERROR_GET_DATA;
+        return TOSDB_ERROR_SET_STATE;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_Get<T>", e.what());       
-        return TOSDB_ERROR_GET_DATA;
+        TOSDB_LogH("TOSDB_RemoveMarker", e.what());
+        return TOSDB_ERROR_SET_STATE;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
-    }
+    }  
+}
+
+void 
+TOSDB_RemoveMarker(std::string id, std::string marker)
+{
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    GetBlockOrThrow(id)->block->remove_marker(marker);
+    /* --- CRITICAL SECTION --- */
 }
 
-template<typename T> 
 int 
-TOSDB_Get_(LPCSTR id, 
-           LPCSTR item, 
-           LPCSTR topic_str, 
-           long indx, 
-           T* dest, 
-           pDateTimeStamp datetime)
-{ 
+TOSDB_GetNamedMarkerPosition(LPCSTR id, 
+                             LPCSTR item, 
+                             LPCSTR topic_str, 
+                             LPCSTR marker, 
+                             long long* pos)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS t;
+
     if( !IsValidBlockID(id) 
         || !CheckStringLength(item)
-        || !CheckStringLength(topic_str) )
+        || !CheckStringLength(topic_str)
+        || !CheckStringLength(marker) )
     {
         return TOSDB_ERROR_BAD_INPUT;  
     }
 
-    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
+    t = GetTopicEnum(topic_str);   
     if(t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
-  
-    return TOSDB_Get_(id, item, t, indx, dest, datetime);
-}
 
-int 
-TOSDB_GetDouble(LPCSTR id, 
-                LPCSTR item, 
-                LPCSTR topic_str, 
-                long indx, 
-                double* dest, 
-                pDateTimeStamp datetime)
-{  
-    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
-}
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, t);
+        *pos = (dat->marker_position(dat.marker_name(marker)));
+        return 0;
+        /* --- CRITICAL SECTION --- */
 
-int 
-TOSDB_GetFloat(LPCSTR id, 
-               LPCSTR item, 
-               LPCSTR topic_str, 
-               long indx, 
-               float* dest, 
-               pDateTimeStamp datetime)
-{
-    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
-}
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
-int 
-TOSDB_GetLongLong(LPCSTR id, 
-                  LPCSTR item, 
-                  LPCSTR topic_str, 
-                  long indx, 
-                  long long* dest, 
-                  pDateTimeStamp datetime)
-{
-    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetNamedMarkerPosition", e.what());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    } 
 }
 
-int 
-TOSDB_GetLong(LPCSTR id, 
-              LPCSTR item, 
-              LPCSTR topic_str, 
-              long indx, 
-              long* dest, 
-              pDateTimeStamp datetime)
+long long 
+TOSDB_GetNamedMarkerPosition(std::string id, 
+                             std::string item, 
+                             TOS_Topics::TOPICS topic_t,
+                             std::string marker)
 {
-    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
+    const TOSDBlock *db;  
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    dat = db->block->raw_stream_ptr(item, topic_t);      
+    try{
+        return dat->marker_position(dat.marker_name(marker));
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_GetNamedMarkerPosition");
+    }
+    /* --- CRITICAL SECTION --- */
 }
 
 int 
-TOSDB_GetString(LPCSTR id, 
-                LPCSTR item, 
-                LPCSTR topic_str, 
-                long indx, 
-                LPSTR dest, 
-                size_type str_len, 
-                pDateTimeStamp datetime)
-{  
+TOSDB_IsNamedMarkerDirty(LPCSTR id,
+                         LPCSTR item, 
+                         LPCSTR topic_str, 
+                         LPCSTR marker,
+                         unsigned int* is_dirty)
+{
     const TOSDBlock *db;
     TOSDB_RawDataBlock::stream_const_ptr_type dat;
     TOS_Topics::TOPICS t;
 
     if( !IsValidBlockID(id) 
         || !CheckStringLength(item)
-        || !CheckStringLength(topic_str) )
+        || !CheckStringLength(topic_str)
+        || !CheckStringLength(marker) )
     { 
         return TOSDB_ERROR_BAD_INPUT;  
     }
@@ -1016,36 +1227,34 @@ TOSDB_GetString(LPCSTR id,
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
         dat = db->block->raw_stream_ptr(item, t);
-        dat->copy(&dest, 1, str_len, indx,indx,datetime);
+        *is_dirty = (unsigned int)(dat->is_marker_dirty(dat.marker_name(marker)));
         return 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
     }catch(const TOSDB_Error& e){
         TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
-        return TOSDB_ERROR_GET_DATA;
+        return TOSDB_ERROR_GET_STATE;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetString", e.what());
-        return TOSDB_ERROR_GET_DATA;
+        TOSDB_LogH("TOSDB_IsNamedMarkerDirty", e.what());
+        return TOSDB_ERROR_GET_STATE;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
-    } 
+    }  
 }
 
-template<> 
-generic_vector_type 
-TOSDB_GetStreamSnapshot<generic_type, false>(std::string id, 
-                                             std::string item, 
-                                             TOS_Topics::TOPICS topic_t, 
-                                             long end, 
-                                             long beg)
+bool 
+TOSDB_IsNamedMarkerDirty(std::string id, 
+                         std::string item, 
+                         TOS_Topics::TOPICS topic_t,
+                         std::string marker)
 {
-    const TOSDBlock *db;
+    const TOSDBlock *db;  
     TOSDB_RawDataBlock::stream_const_ptr_type dat;
 
     if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
@@ -1053,337 +1262,386 @@ TOSDB_GetStreamSnapshot<generic_type, false>(std::string id,
 
     GLOBAL_RLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);  
+    db = GetBlockOrThrow(id);
     dat = db->block->raw_stream_ptr(item, topic_t);  
     try{
-        return dat->vector(end, beg); 
+        return dat->is_marker_dirty(dat.marker_name(marker));
     }catch(const DataStreamError& e){
-        throw TOSDB_DataStreamError(e,"TOSDB_GetStreamSnapshot<generic_type,false>");
-    }    
+        throw TOSDB_DataStreamError(e, "TOSDB_IsNamedMarkerDirty");
+    }        
     /* --- CRITICAL SECTION --- */
 }
 
-template<> 
-std::pair<std::vector<generic_type>,std::vector<DateTimeStamp>>     
-TOSDB_GetStreamSnapshot<generic_type, true>(std::string id, 
-                                            std::string item, 
-                                            TOS_Topics::TOPICS topic_t, 
-                                            long end, 
-                                            long beg)
+int 
+TOSDB_EnableStreamStats(LPCSTR id, 
+                        LPCSTR item, 
+                        LPCSTR topic_str, 
+                        LPCSTR weight_topic_str)
 {
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS t;
+    TOS_Topics::TOPICS wt = TOS_Topics::TOPICS::NULL_TOPIC;
 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
-        throw std::invalid_argument("NULL TOPIC");
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) 
+        || (weight_topic_str && !CheckStringLength(weight_topic_str)) )
+    { 
+        return TOSDB_ERROR_BAD_INPUT;  
+    }
 
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);  
-    dat = db->block->raw_stream_ptr(item, topic_t);
-    try{
-        return std::pair<std::vector<generic_type>,
-                         std::vector<DateTimeStamp>>(
-                                dat->vector(end, beg), 
-                                dat->secondary_vector(end,beg)
-                         );
-    }catch(const DataStreamError& e){
-        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamSnapshot<generic_type,true>");
-    }    
-    /* --- CRITICAL SECTION --- */
-}
+    t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
 
-/* 
-   use functors of partially specialized object to overload by explicit call
-   note: data_stream takes raw pointers so we need to pass the addr of the 
-   dereferenced first element of the vector 
+    if(weight_topic_str){
+        wt = GetTopicEnum(weight_topic_str);
+        if(wt == TOS_Topics::TOPICS::NULL_TOPIC)
+            return TOSDB_ERROR_BAD_TOPIC;
+    }
 
-   ARE WE RELYING ON VECTOR IMPLEMENTATION ??
-*/
-template<typename T, bool b> 
-struct GSSRetType;
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        GetBlockOrThrow(id)->block->stream_stats(item, t, true, wt);
+        return 0;
+        /* --- CRITICAL SECTION --- */
 
-template<typename T>
-struct GSSRetType<T, true>{
-    std::pair<std::vector<T>, std::vector<DateTimeStamp>> 
-    operator()(TOSDB_RawDataBlock::stream_const_ptr_type dat, 
-               long end, 
-               long beg, 
-               size_t diff)
-    {        
-        std::vector<T> v(diff); /* adjust for [) -> [ ] */
-        std::vector<DateTimeStamp> dtsv(diff); /* adjust for [) -> [ ] */  
-        if(diff > 0)
-            dat->copy(&(*(v.begin())), diff, end, beg, &(*(dtsv.begin())));  
-   
-        return std::pair<std::vector<T>,std::vector<DateTimeStamp>>(v, dtsv);
-    }
-};
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
-template<typename T>
-struct GSSRetType<T, false>{
-    std::vector<T> 
-    operator()(TOSDB_RawDataBlock::stream_const_ptr_type dat, 
-               long end, 
-               long beg, 
-               size_t diff)
-    {  
-        std::vector<T> v(diff); /* adjust for [) -> [ ] */
-        if(diff > 0)
-            dat->copy(&(*(v.begin())), diff, end, beg, nullptr); 
-     
-        return v;
-    }
-};
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_SET_STATE;
 
-template<typename T, bool b> 
-auto 
-TOSDB_GetStreamSnapshot(std::string id, 
-                        std::string item, 
-                        TOS_Topics::TOPICS topic_t, 
-                        long end, 
-                        long beg) 
-    -> typename std::conditional<b, 
-                                 std::pair<std::vector<T>, std::vector<DateTimeStamp>>, 
-                                 std::vector<T>>::type
-{ 
-    size_type sz;
-    long diff;  
-    long long mindiff;
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_EnableStreamStats", e.what());
+        return TOSDB_ERROR_SET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }  
+}
 
+void 
+TOSDB_EnableStreamStats(std::string id, 
+                        std::string item, 
+                        TOS_Topics::TOPICS topic_t,
+                        TOS_Topics::TOPICS weight_topic_t)
+{
     if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
         throw std::invalid_argument("NULL TOPIC");
 
     GLOBAL_RLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);  
-    dat = db->block->raw_stream_ptr(item, topic_t); /* get stream size */
-    sz = (size_type)(dat->bound_size());
-
-    if(end < 0) 
-        end += sz;
-    if(beg < 0) 
-        beg += sz;
-    diff = end - beg;
-    if(diff < 0)
-        throw std::invalid_argument("end < beg");
-    
-    mindiff = (long long)std::min<size_t>((size_t)end + 1, dat->size()) - beg;
-    if(mindiff < 0)
-        mindiff = 0;
-    else if(mindiff > TOSDB_MAX_BLOCK_SZ) /* protect the size_t cast(below) */
-        throw std::invalid_argument("mindiff > TOSDB_MAX_BLOCK_SZ");
-
-    try{ 
-        return GSSRetType<T,b>()(dat, end, beg, (size_t)mindiff);
-    }catch(const DataStreamError& e){
-        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamSnapshot<T,b>");
-    }  
+    GetBlockOrThrow(id)->block->stream_stats(item, topic_t, true, weight_topic_t);
     /* --- CRITICAL SECTION --- */
 }
 
-template<typename T> 
 int 
-TOSDB_GetStreamSnapshot_(LPCSTR id,
-                         LPCSTR item, 
-                         TOS_Topics::TOPICS topic_t, 
-                         T* dest, 
-                         size_type array_len, 
-                         pDateTimeStamp datetime, 
-                         long end, 
-                         long beg)
+TOSDB_DisableStreamStats(LPCSTR id, LPCSTR item, LPCSTR topic_str)
 {
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS t;
 
-    if(!IsValidBlockID(id) || !CheckStringLength(item))
-    {
-        return TOSDB_ERROR_BAD_INPUT;
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) )
+    { 
+        return TOSDB_ERROR_BAD_INPUT;  
     }
 
+    t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
-        db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-        dat->copy(dest,array_len,end,beg,datetime);
+        GetBlockOrThrow(id)->block->stream_stats(item, t, false);
         return 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
     }catch(const TOSDB_Error& e){
         TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
-        return TOSDB_ERROR_GET_DATA;
+        return TOSDB_ERROR_SET_STATE;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("GetStreamSnapshot<T>", e.what());
-        return TOSDB_ERROR_GET_DATA;
+        TOSDB_LogH("TOSDB_DisableStreamStats", e.what());
+        return TOSDB_ERROR_SET_STATE;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
-    }
-}
-
-template<typename T> 
-int 
-TOSDB_GetStreamSnapshot_(LPCSTR id,
-                         LPCSTR item, 
-                         LPCSTR topic_str, 
-                         T* dest, 
-                         size_type array_len, 
-                         pDateTimeStamp datetime, 
-                         long end, 
-                         long beg)
-{  
-    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
-        return TOSDB_ERROR_BAD_INPUT;   
-   
-    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
-    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
-        return TOSDB_ERROR_BAD_TOPIC;
-
-    return TOSDB_GetStreamSnapshot_(id, item, t, dest, array_len, datetime, end, beg);
+    }  
 }
 
-int 
-TOSDB_GetStreamSnapshotDoubles(LPCSTR id,
-                               LPCSTR item, 
-                               LPCSTR topic_str, 
-                               double* dest, 
-                               size_type array_len, 
-                               pDateTimeStamp datetime, 
-                               long end, 
-                               long beg)
+void 
+TOSDB_DisableStreamStats(std::string id, 
+                         std::string item, 
+                         TOS_Topics::TOPICS topic_t)
 {
-    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
-                                    datetime, end, beg);
-}
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
 
-int 
-TOSDB_GetStreamSnapshotFloats(LPCSTR id, 
-                              LPCSTR item, 
-                              LPCSTR topic_str, 
-                              float* dest, 
-                              size_type array_len, 
-                              pDateTimeStamp datetime, 
-                              long end, 
-                              long beg)
-{
-    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
-                                    datetime, end, beg);
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    GetBlockOrThrow(id)->block->stream_stats(item, topic_t, false);
+    /* --- CRITICAL SECTION --- */
 }
 
-int 
-TOSDB_GetStreamSnapshotLongLongs(LPCSTR id, 
-                                 LPCSTR item, 
-                                 LPCSTR topic_str, 
-                                 long long* dest, 
-                                 size_type array_len, 
-                                 pDateTimeStamp datetime, 
-                                 long end, 
-                                 long beg)
+namespace {
+
+void
+_copyStreamStats(const DataStreamStats& src, pStreamStats dest)
 {
-    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
-                                    datetime, end, beg);  
+    dest->min = src.min;
+    dest->max = src.max;
+    dest->mean = src.mean;
+    dest->variance = src.variance;
+    dest->vwap = src.vwap;
+    dest->count = (size_type)src.count;
 }
 
-int 
-TOSDB_GetStreamSnapshotLongs(LPCSTR id, 
-                             LPCSTR item, 
-                             LPCSTR topic_str, 
-                             long* dest, 
-                             size_type array_len, 
-                             pDateTimeStamp datetime, 
-                             long end, 
-                             long beg)
-{ 
-    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
-                                    datetime, end, beg);  
-}
+};
 
 int 
-TOSDB_GetStreamSnapshotStrings(LPCSTR id, 
-                               LPCSTR item, 
-                               LPCSTR topic_str, 
-                               LPSTR* dest, 
-                               size_type array_len, 
-                               size_type str_len, 
-                               pDateTimeStamp datetime, 
-                               long end, 
-                               long beg)
+TOSDB_GetStreamStats(LPCSTR id, LPCSTR item, LPCSTR topic_str, pStreamStats stats)
 {
     const TOSDBlock *db;
     TOSDB_RawDataBlock::stream_const_ptr_type dat;
-    TOS_Topics::TOPICS topic_t;
+    TOS_Topics::TOPICS t;
 
-    if( !IsValidBlockID(id) 
+    if( !stats
+        || !IsValidBlockID(id) 
         || !CheckStringLength(item)
         || !CheckStringLength(topic_str) )
-    {
-        return TOSDB_ERROR_BAD_INPUT;
+    { 
+        return TOSDB_ERROR_BAD_INPUT;  
     }
 
-    topic_t = GetTopicEnum(topic_str);
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+    t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
 
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-        dat->copy(dest,array_len,str_len,end,beg,datetime);
+        dat = db->block->raw_stream_ptr(item, t);
+        _copyStreamStats(dat->stats(), stats);
         return 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST; 
 
     }catch(const TOSDB_Error& e){
         TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
-        return TOSDB_ERROR_GET_DATA;
+        return TOSDB_ERROR_GET_STATE;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetStreamSnapshotStrings", e.what());
-        return TOSDB_ERROR_GET_DATA;
+        TOSDB_LogH("TOSDB_GetStreamStats", e.what());
+        return TOSDB_ERROR_GET_STATE;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
-    }
+    }  
 }
 
-template<typename T> 
-int 
-TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
-                                   LPCSTR item, 
-                                   TOS_Topics::TOPICS topic_t, 
-                                   T* dest, 
-                                   size_type array_len, 
-                                   pDateTimeStamp datetime,                     
-                                   long beg,
-                                   long *get_size)
+StreamStats 
+TOSDB_GetStreamStats(std::string id, 
+                     std::string item, 
+                     TOS_Topics::TOPICS topic_t)
 {
-    const TOSDBlock *db;
+    const TOSDBlock *db;  
     TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    StreamStats stats;
 
-    if(!IsValidBlockID(id) || !CheckStringLength(item))
-    {
-        return TOSDB_ERROR_BAD_INPUT;
-    }
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    dat = db->block->raw_stream_ptr(item, topic_t);  
+    try{
+        _copyStreamStats(dat->stats(), &stats);
+        return stats;
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamStats");
+    }        
+    /* --- CRITICAL SECTION --- */
+}
+
+template<> 
+generic_type 
+TOSDB_Get<generic_type, false>(std::string id, 
+                               std::string item, 
+                               TOS_Topics::TOPICS topic_t, 
+                               long indx)
+{  
+    const TOSDBlock *db;  
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    dat = db->block->raw_stream_ptr(item, topic_t);  
+    try{
+        return dat->operator[](indx);
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_Get<generic_type,false>");
+    }
+    /* --- CRITICAL SECTION --- */
+}
+
+template<> 
+generic_dts_type 
+TOSDB_Get<generic_type, true>(std::string id, 
+                              std::string item, 
+                              TOS_Topics::TOPICS topic_t, 
+                              long indx)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    dat = db->block->raw_stream_ptr(item, topic_t);
+    try{
+        return dat->both(indx);
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_Get<generic_type,true>");
+    }    
+    /* --- CRITICAL SECTION --- */
+}
+
+/* use functors of partially specialized object to overload by explicit call */
+template<typename T, bool b> 
+struct GRetType;
+
+template<typename T>
+struct GRetType<T, true>{
+    std::pair<T, DateTimeStamp> 
+    operator()(T val, DateTimeStamp dts)
+    {      
+        return std::pair<T, DateTimeStamp>(val, std::move(dts));
+    }
+};
+
+template<typename T>
+struct GRetType<T, false>{
+    T 
+    operator()(T val, DateTimeStamp dts) 
+    { 
+        return val; 
+    }
+};
+
+namespace {
+
+/* use the typed (devirtualized) stream path when T is the stream's type */
+template<typename T>
+size_t
+_copyTyped(TOSDB_RawDataBlock *block,
+           std::string item,
+           TOS_Topics::TOPICS topic_t,
+           T* dest,
+           size_type array_len,
+           long end,
+           long beg,
+           TOSDB_RawDataBlock::datetime_dest_type datetime)
+{
+    TOSDB_RawDataBlock::TypedStreamRef<T> ref = block->typed_stream_ref<T>(item, topic_t);
+    if(ref.valid())
+        return ref.copy(dest, array_len, end, beg, datetime);
+
+    return block->raw_stream_ptr(item, topic_t)->copy(dest, array_len, end, beg, datetime);
+}
+
+/* same, for a stream already resolved to its ids (RawDataBlock::stream_ids) */
+template<typename T>
+size_t
+_copyTyped(TOSDB_RawDataBlock *block,
+           size_type item_id,
+           size_type topic_id,
+           TOS_Topics::TOPICS topic_t,
+           T* dest,
+           size_type array_len,
+           long end,
+           long beg,
+           TOSDB_RawDataBlock::datetime_dest_type datetime)
+{
+    TOSDB_RawDataBlock::TypedStreamRef<T> ref = 
+        block->typed_stream_ref<T>(item_id, topic_id, topic_t);
+
+    if(ref.valid())
+        return ref.copy(dest, array_len, end, beg, datetime);
+
+    return block->raw_stream_ptr(item_id, topic_id)->copy(dest, array_len, end, beg, datetime);
+}
 
+size_t
+_copyTyped(TOSDB_RawDataBlock *block,
+           std::string item,
+           TOS_Topics::TOPICS topic_t,
+           generic_type* dest,
+           size_type array_len,
+           long end,
+           long beg,
+           TOSDB_RawDataBlock::datetime_dest_type datetime)
+{ /* no stream holds generic_type */
+    return block->raw_stream_ptr(item, topic_t)->copy(dest, array_len, end, beg, datetime);
+}
+
+};
+
+template<typename T, bool b> 
+auto 
+TOSDB_Get(std::string id, 
+          std::string item, 
+          TOS_Topics::TOPICS topic_t, 
+          long indx) -> typename std::conditional<b, std::pair<T, DateTimeStamp>, T>::type
+{
+    T tmp;
+    DateTimeStamp datetime;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    if(TOSDB_Get_(id, item, topic_t, indx, &tmp, &datetime))    
+        throw TOSDB_DataStreamError("TOSDB_Get_");
+
+    return GRetType<T,b>()(tmp, std::move(datetime));  
+}
+
+template<typename T> 
+int 
+TOSDB_Get_(std::string id, 
+           std::string item, 
+           TOS_Topics::TOPICS topic_t, 
+           long indx, 
+           T* dest, 
+           pDateTimeStamp datetime)
+{   
+    const TOSDBlock *db;
+   
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-                   /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
-        *get_size = (long)(dat->copy_from_marker(dest,array_len,beg,datetime));
+        _copyTyped(db->block, item, topic_t, dest, 1, indx, indx, datetime);
         return 0;
         /* --- CRITICAL SECTION --- */
 
@@ -1396,7 +1654,7 @@ TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("GetStreamSnapshotFromMarker<T>", e.what());
+        TOSDB_LogH("TOSDB_Get<T>", e.what());       
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
@@ -1406,114 +1664,101 @@ TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
 
 template<typename T> 
 int 
-TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
-                                   LPCSTR item, 
-                                   LPCSTR topic_str, 
-                                   T* dest, 
-                                   size_type array_len, 
-                                   pDateTimeStamp datetime,               
-                                   long beg,
-                                   long *get_size)
-{  
-    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
-        return 0;   
-   
+TOSDB_Get_(LPCSTR id, 
+           LPCSTR item, 
+           LPCSTR topic_str, 
+           long indx, 
+           T* dest, 
+           pDateTimeStamp datetime)
+{ 
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) )
+    {
+        return TOSDB_ERROR_BAD_INPUT;  
+    }
+
     TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
     if(t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
-
-    return TOSDB_GetStreamSnapshotFromMarker_(id, item, t, dest, array_len, datetime, beg, get_size);
+  
+    return TOSDB_Get_(id, item, t, indx, dest, datetime);
 }
 
 int 
-TOSDB_GetStreamSnapshotDoublesFromMarker(LPCSTR id,
-                                         LPCSTR item, 
-                                         LPCSTR topic_str, 
-                                         double* dest, 
-                                         size_type array_len, 
-                                         pDateTimeStamp datetime,                         
-                                         long beg,
-                                         long *get_size)
-{
-    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, dest, array_len, 
-                                              datetime, beg, get_size);
+TOSDB_GetDouble(LPCSTR id, 
+                LPCSTR item, 
+                LPCSTR topic_str, 
+                long indx, 
+                double* dest, 
+                pDateTimeStamp datetime)
+{  
+    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
 }
 
 int 
-TOSDB_GetStreamSnapshotFloatsFromMarker(LPCSTR id, 
-                                        LPCSTR item, 
-                                        LPCSTR topic_str, 
-                                        float* dest, 
-                                        size_type array_len, 
-                                        pDateTimeStamp datetime,                        
-                                        long beg,
-                                        long *get_size)
+TOSDB_GetFloat(LPCSTR id, 
+               LPCSTR item, 
+               LPCSTR topic_str, 
+               long indx, 
+               float* dest, 
+               pDateTimeStamp datetime)
 {
-    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, dest, array_len, 
-                                              datetime, beg, get_size);
+    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
 }
 
 int 
-TOSDB_GetStreamSnapshotLongLongsFromMarker(LPCSTR id, 
-                                           LPCSTR item, 
-                                           LPCSTR topic_str, 
-                                           long long* dest, 
-                                           size_type array_len, 
-                                           pDateTimeStamp datetime,                         
-                                           long beg,
-                                           long *get_size)
+TOSDB_GetLongLong(LPCSTR id, 
+                  LPCSTR item, 
+                  LPCSTR topic_str, 
+                  long indx, 
+                  long long* dest, 
+                  pDateTimeStamp datetime)
 {
-    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, dest, array_len, 
-                                              datetime, beg, get_size);  
+    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
 }
 
 int 
-TOSDB_GetStreamSnapshotLongsFromMarker(LPCSTR id, 
-                                       LPCSTR item, 
-                                       LPCSTR topic_str, 
-                                       long* dest, 
-                                       size_type array_len, 
-                                       pDateTimeStamp datetime,                        
-                                       long beg,
-                                       long *get_size)
+TOSDB_GetLong(LPCSTR id, 
+              LPCSTR item, 
+              LPCSTR topic_str, 
+              long indx, 
+              long* dest, 
+              pDateTimeStamp datetime)
 {
-    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, dest, array_len, 
-                                              datetime, beg, get_size);  
+    return TOSDB_Get_(id, item, topic_str , indx, dest, datetime);
 }
 
 int 
-TOSDB_GetStreamSnapshotStringsFromMarker(LPCSTR id, 
-                                         LPCSTR item, 
-                                         LPCSTR topic_str, 
-                                         LPSTR* dest, 
-                                         size_type array_len, 
-                                         size_type str_len, 
-                                         pDateTimeStamp datetime,                         
-                                         long beg,
-                                         long *get_size)
-{
+TOSDB_GetString(LPCSTR id, 
+                LPCSTR item, 
+                LPCSTR topic_str, 
+                long indx, 
+                LPSTR dest, 
+                size_type str_len, 
+                pDateTimeStamp datetime)
+{  
     const TOSDBlock *db;
     TOSDB_RawDataBlock::stream_const_ptr_type dat;
-    TOS_Topics::TOPICS topic_t;
+    TOS_Topics::TOPICS t;
 
     if( !IsValidBlockID(id) 
         || !CheckStringLength(item)
         || !CheckStringLength(topic_str) )
-    {
-        return TOSDB_ERROR_BAD_INPUT;
+    { 
+        return TOSDB_ERROR_BAD_INPUT;  
     }
 
-    topic_t = GetTopicEnum(topic_str); 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+    t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
 
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-                    /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
-        *get_size = (long)(dat->copy_from_marker(dest, array_len, str_len, beg, datetime));   
+        dat = db->block->raw_stream_ptr(item, t);
+        dat->copy(&dest, 1, str_len, indx,indx,datetime);
         return 0;
         /* --- CRITICAL SECTION --- */
 
@@ -1526,161 +1771,113 @@ TOSDB_GetStreamSnapshotStringsFromMarker(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetStreamSnapshotStringsFromMarker", e.what());
+        TOSDB_LogH("TOSDB_GetString", e.what());
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
-    }
+    } 
 }
 
 
-template<typename T> 
-int 
-TOSDB_GetNFromMarker_(LPCSTR id,
-                      LPCSTR item, 
-                      TOS_Topics::TOPICS topic_t, 
-                      T* dest, 
-                      size_type n, 
-                      pDateTimeStamp datetime,                                                       
-                      long *get_size)
+namespace {
+
+/* one entry of a GetMany call; CALLING CODE MUST HOLD GLOBAL_RLOCK. The 
+   (item, topic) is looked up once, by stream_ids, then the stream is read 
+   by its ids like a handle's (nothing below logs, a failure is logged here) */
+template<typename T>
+int
+_getManyEntry(TOSDB_RawDataBlock *block, 
+              LPCSTR item, 
+              LPCSTR topic_str, 
+              T* dest, 
+              size_type /* str_len */,
+              pDateTimeStamp datetime)
 {
-    const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS t;
+    size_type iid, tid;
 
-    if(!IsValidBlockID(id) || !CheckStringLength(item))
-    {
+    if( !CheckStringLength(item) || !CheckStringLength(topic_str) )
         return TOSDB_ERROR_BAD_INPUT;
-    }
+
+    t = GetTopicEnum(topic_str, false);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
 
     try{
-        GLOBAL_RLOCK_GUARD;
-        /* --- CRITICAL SECTION --- */
-        db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-                     /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
-        *get_size = (long)(dat->ncopy_from_marker(dest,n,datetime));
+        block->stream_ids(item, t, &iid, &tid);
+        _copyTyped(block, iid, tid, t, dest, 1, 0, 0, datetime);
         return 0;
-        /* --- CRITICAL SECTION --- */
-
-    }catch(const TOSDB_DataBlockDoesntExist& e){
-        TOSDB_LogH("BLOCK", e.what());
-        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
-
-    }catch(const TOSDB_Error& e){
-        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
-        return TOSDB_ERROR_GET_DATA;
-
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetNFromMarker<T>", e.what());
+        /* a bad entry in a big list shouldn't flood the log on every call */
+        TOSDB_LogLimitedH("TOSDB_GetMany", item, e.what());
         return TOSDB_ERROR_GET_DATA;
-
-    }catch(...){ 
-        return TOSDB_ERROR_UNKNOWN;
     }
 }
 
-template<typename T> 
-int 
-TOSDB_GetNFromMarker_(LPCSTR id,
-                      LPCSTR item, 
-                      LPCSTR topic_str, 
-                      T* dest, 
-                      size_type n, 
-                      pDateTimeStamp datetime,                                                       
-                      long *get_size)
-{  
-    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
-        return 0;   
-   
-    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
-    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
-        return TOSDB_ERROR_BAD_TOPIC;
+int
+_getManyEntry(TOSDB_RawDataBlock *block, 
+              LPCSTR item, 
+              LPCSTR topic_str, 
+              LPSTR* dest, 
+              size_type str_len,
+              pDateTimeStamp datetime)
+{
+    TOS_Topics::TOPICS t;
+    size_type iid, tid;
 
-    return TOSDB_GetNFromMarker_(id, item, t, dest, n, datetime, get_size);
-}
+    if( !CheckStringLength(item) || !CheckStringLength(topic_str) )
+        return TOSDB_ERROR_BAD_INPUT;
 
-int 
-TOSDB_GetNDoublesFromMarker(LPCSTR id,
-                            LPCSTR item, 
-                            LPCSTR topic_str, 
-                            double *dest, 
-                            size_type n, 
-                            pDateTimeStamp datetime,                                                       
-                            long *get_size)
-{
-    return TOSDB_GetNFromMarker_(id, item, topic_str, dest, n, datetime, get_size);
-}
+    t = GetTopicEnum(topic_str, false);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
 
-int 
-TOSDB_GetNFloatsFromMarker(LPCSTR id,
-                           LPCSTR item, 
-                           LPCSTR topic_str, 
-                           float *dest, 
-                           size_type n, 
-                           pDateTimeStamp datetime,
-                           long *get_size)
-{
-    return TOSDB_GetNFromMarker_(id, item, topic_str, dest, n, datetime, get_size);
+    try{
+        block->stream_ids(item, t, &iid, &tid);
+        block->raw_stream_ptr(iid, tid)->copy(dest, 1, str_len, 0, 0, datetime);
+        return 0;
+    }catch(const std::exception& e){
+        TOSDB_LogLimitedH("TOSDB_GetMany", item, e.what());
+        return TOSDB_ERROR_GET_DATA;
+    }
 }
 
-int 
-TOSDB_GetNLongLongsFromMarker(LPCSTR id,
-                              LPCSTR item, 
-                              LPCSTR topic_str, 
-                              long long *dest, 
-                              size_type n, 
-                              pDateTimeStamp datetime,                                                       
-                              long *get_size)
-{
-    return TOSDB_GetNFromMarker_(id, item, topic_str, dest, n, datetime, get_size);  
-}
+};
 
-int 
-TOSDB_GetNLongsFromMarker(LPCSTR id,
-                          LPCSTR item, 
-                          LPCSTR topic_str, 
-                          long *dest, 
-                          size_type n, 
-                          pDateTimeStamp datetime,                                                       
-                          long *get_size)
-{
-    return TOSDB_GetNFromMarker_(id, item, topic_str, dest, n, datetime, get_size);  
-}
 
+template<typename T> 
 int 
-TOSDB_GetNStringsFromMarker(LPCSTR id, 
-                            LPCSTR item, 
-                            LPCSTR topic_str, 
-                            LPSTR* dest, 
-                            size_type n, 
-                            size_type str_len, 
-                            pDateTimeStamp datetime,
-                            long *get_size)
+TOSDB_GetMany_(LPCSTR id, 
+               LPCSTR* items, 
+               LPCSTR* topics_str, 
+               size_type n,
+               T* dest, 
+               size_type str_len, /* strings only */
+               pDateTimeStamp datetime,
+               int* status)
 {
     const TOSDBlock *db;
-    TOSDB_RawDataBlock::stream_const_ptr_type dat;
-    TOS_Topics::TOPICS topic_t;
-
-    if( !IsValidBlockID(id) 
-        || !CheckStringLength(item)
-        || !CheckStringLength(topic_str) )
-    {
-        return TOSDB_ERROR_BAD_INPUT;
-    }
+    int r;
+    size_type nfail = 0;
 
-    topic_t = GetTopicEnum(topic_str); 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
-        return TOSDB_ERROR_BAD_TOPIC;
+    if( !IsValidBlockID(id) || !items || !topics_str || !dest )
+        return TOSDB_ERROR_BAD_INPUT;  
 
     try{
+        /* one lock and block lookup for all n, instead of one per stream */
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
-        dat = db->block->raw_stream_ptr(item, topic_t);
-                    /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
-        *get_size = (long)(dat->ncopy_from_marker(dest, n, str_len, datetime));   
-        return 0;
+        for(size_type i = 0; i < n; ++i){
+            r = _getManyEntry(db->block, items[i], topics_str[i], dest + i, 
+                              str_len, datetime ? datetime + i : nullptr);
+            if(r)
+                ++nfail;
+            if(status)
+                status[i] = r;
+        }
+        return nfail ? TOSDB_ERROR_GET_DATA : 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
@@ -1692,7 +1889,7 @@ TOSDB_GetNStringsFromMarker(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetNStringsFromMarker", e.what());
+        TOSDB_LogH("TOSDB_GetMany<T>", e.what());       
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
@@ -1700,96 +1897,238 @@ TOSDB_GetNStringsFromMarker(LPCSTR id,
     }
 }
 
+int 
+TOSDB_GetManyDoubles(LPCSTR id, 
+                     LPCSTR* items, 
+                     LPCSTR* topics_str, 
+                     size_type n,
+                     double* dest, 
+                     pDateTimeStamp datetime,
+                     int* status)
+{  
+    return TOSDB_GetMany_(id, items, topics_str, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyFloats(LPCSTR id, 
+                    LPCSTR* items, 
+                    LPCSTR* topics_str, 
+                    size_type n,
+                    float* dest, 
+                    pDateTimeStamp datetime,
+                    int* status)
+{  
+    return TOSDB_GetMany_(id, items, topics_str, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyLongLongs(LPCSTR id, 
+                       LPCSTR* items, 
+                       LPCSTR* topics_str, 
+                       size_type n,
+                       long long* dest, 
+                       pDateTimeStamp datetime,
+                       int* status)
+{  
+    return TOSDB_GetMany_(id, items, topics_str, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyLongs(LPCSTR id, 
+                   LPCSTR* items, 
+                   LPCSTR* topics_str, 
+                   size_type n,
+                   long* dest, 
+                   pDateTimeStamp datetime,
+                   int* status)
+{  
+    return TOSDB_GetMany_(id, items, topics_str, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyStrings(LPCSTR id, 
+                     LPCSTR* items, 
+                     LPCSTR* topics_str, 
+                     size_type n,
+                     LPSTR* dest, 
+                     size_type str_len,
+                     pDateTimeStamp datetime,
+                     int* status)
+{  
+    return TOSDB_GetMany_(id, items, topics_str, n, dest, str_len, datetime, status);
+}
 
 template<> 
-generic_map_type 
-TOSDB_GetItemFrame<false>(std::string id, TOS_Topics::TOPICS topic_t)
+generic_vector_type 
+TOSDB_GetStreamSnapshot<generic_type, false>(std::string id, 
+                                             std::string item, 
+                                             TOS_Topics::TOPICS topic_t, 
+                                             long end, 
+                                             long beg)
 {
-    const TOSDBlock *db; 
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
 
     if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
         throw std::invalid_argument("NULL TOPIC");
 
     GLOBAL_RLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->map_of_frame_items(topic_t);
+    db = GetBlockOrThrow(id);  
+    dat = db->block->raw_stream_ptr(item, topic_t);  
+    try{
+        return dat->vector(end, beg); 
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e,"TOSDB_GetStreamSnapshot<generic_type,false>");
+    }    
     /* --- CRITICAL SECTION --- */
 }
 
 template<> 
-generic_dts_map_type 
-TOSDB_GetItemFrame<true>(std::string id, TOS_Topics::TOPICS topic_t)
+std::pair<std::vector<generic_type>,std::vector<DateTimeStamp>>     
+TOSDB_GetStreamSnapshot<generic_type, true>(std::string id, 
+                                            std::string item, 
+                                            TOS_Topics::TOPICS topic_t, 
+                                            long end, 
+                                            long beg)
 {
-    const TOSDBlock *db; 
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
 
     if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
         throw std::invalid_argument("NULL TOPIC");
 
     GLOBAL_RLOCK_GUARD;
     /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->pair_map_of_frame_items(topic_t);
+    db = GetBlockOrThrow(id);  
+    dat = db->block->raw_stream_ptr(item, topic_t);
+    try{
+        return std::pair<std::vector<generic_type>,
+                         std::vector<DateTimeStamp>>(
+                                dat->vector(end, beg), 
+                                dat->secondary_vector(end,beg)
+                         );
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamSnapshot<generic_type,true>");
+    }    
     /* --- CRITICAL SECTION --- */
 }
 
-template<typename T> 
-int 
-TOSDB_GetItemFrame_(LPCSTR id, 
-                    TOS_Topics::TOPICS topic_t, 
-                    T* dest, 
-                    size_type array_len, 
-                    LPSTR* dest2, 
-                    size_type str_len2, 
-                    pDateTimeStamp datetime)
-{
-    const TOSDBlock *db;
-  
-    if(!IsValidBlockID(id))
-        return TOSDB_ERROR_BAD_INPUT;
+/* 
+   use functors of partially specialized object to overload by explicit call
+   note: data_stream takes raw pointers so we need to pass the addr of the 
+   dereferenced first element of the vector 
 
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC){
-        TOSDB_LogH("INPUT", "NULL topic passed to TOSDB_GetItemFrame_");
-        return TOSDB_ERROR_BAD_TOPIC;
-    }
+   ARE WE RELYING ON VECTOR IMPLEMENTATION ??
+*/
+template<typename T, bool b> 
+struct GSSRetType;
 
-    try{
-        GLOBAL_RLOCK_GUARD;
-        /* --- CRITICAL SECTION --- */
-        db = GetBlockOrThrow(id);
+template<typename T>
+struct GSSRetType<T, true>{
+    std::pair<std::vector<T>, std::vector<DateTimeStamp>> 
+    operator()(TOSDB_RawDataBlock::stream_const_ptr_type dat, 
+               long end, 
+               long beg, 
+               size_t diff)
+    {        
+        std::vector<T> v(diff); /* adjust for [) -> [ ] */
+        std::vector<DateTimeStamp> dtsv(diff); /* adjust for [) -> [ ] */  
+        if(diff > 0)
+            dat->copy(&(*(v.begin())), diff, end, beg, &(*(dtsv.begin())));  
+   
+        return std::pair<std::vector<T>,std::vector<DateTimeStamp>>(v, dtsv);
+    }
+};
 
-        if(datetime){  
-            auto dtsm = db->block->pair_map_of_frame_items(topic_t);
-            auto b_iter = dtsm.cbegin();
-            auto e_iter = dtsm.cend();
+template<typename T>
+struct GSSRetType<T, false>{
+    std::vector<T> 
+    operator()(TOSDB_RawDataBlock::stream_const_ptr_type dat, 
+               long end, 
+               long beg, 
+               size_t diff)
+    {  
+        std::vector<T> v(diff); /* adjust for [) -> [ ] */
+        if(diff > 0)
+            dat->copy(&(*(v.begin())), diff, end, beg, nullptr); 
+     
+        return v;
+    }
+};
 
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                 ++b_iter, ++i )
-            {
-                dest[i] = (T)b_iter->second.first;
-                datetime[i] = b_iter->second.second;
-                if(dest2){
-                    if( strcpy_s(dest2[i], str_len2, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
-                }
-            }      
-        }else{        
-            auto m = db->block->map_of_frame_items(topic_t);
-            auto b_iter = m.cbegin();
-            auto e_iter = m.cend();   
-           
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                 ++b_iter, ++i )  
-            {      
-                dest[i] = (T)b_iter->second;  
-                if(dest2){
-                    if( strcpy_s(dest2[i], str_len2, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;                  
-                }
-            }            
-        }    
+template<typename T, bool b> 
+auto 
+TOSDB_GetStreamSnapshot(std::string id, 
+                        std::string item, 
+                        TOS_Topics::TOPICS topic_t, 
+                        long end, 
+                        long beg) 
+    -> typename std::conditional<b, 
+                                 std::pair<std::vector<T>, std::vector<DateTimeStamp>>, 
+                                 std::vector<T>>::type
+{ 
+    size_type sz;
+    long diff;  
+    long long mindiff;
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);  
+    dat = db->block->raw_stream_ptr(item, topic_t); /* get stream size */
+    sz = (size_type)(dat->bound_size());
+
+    if(end < 0) 
+        end += sz;
+    if(beg < 0) 
+        beg += sz;
+    diff = end - beg;
+    if(diff < 0)
+        throw std::invalid_argument("end < beg");
+    
+    mindiff = (long long)std::min<size_t>((size_t)end + 1, dat->size()) - beg;
+    if(mindiff < 0)
+        mindiff = 0;
+    else if(mindiff > TOSDB_MAX_BLOCK_SZ) /* protect the size_t cast(below) */
+        throw std::invalid_argument("mindiff > TOSDB_MAX_BLOCK_SZ");
+
+    try{ 
+        return GSSRetType<T,b>()(dat, end, beg, (size_t)mindiff);
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamSnapshot<T,b>");
+    }  
+    /* --- CRITICAL SECTION --- */
+}
+
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshot_(LPCSTR id,
+                         LPCSTR item, 
+                         TOS_Topics::TOPICS topic_t, 
+                         T* dest, 
+                         size_type array_len, 
+                         TOSDB_RawDataBlock::datetime_dest_type datetime, 
+                         long end, 
+                         long beg)
+{
+    const TOSDBlock *db;
+
+    if(!IsValidBlockID(id) || !CheckStringLength(item))
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        _copyTyped(db->block, item, topic_t, dest, array_len, end, beg, datetime);
+        return 0;
         /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
@@ -1801,153 +2140,195 @@ TOSDB_GetItemFrame_(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("GetItemFrame<T>", e.what());
+        TOSDB_LogH("GetStreamSnapshot<T>", e.what());
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
     }
-
-  return 0;
 }
 
 template<typename T> 
 int 
-TOSDB_GetItemFrame_(LPCSTR id, 
-                    LPCSTR topic_str, 
-                    T* dest, 
-                    size_type array_len, 
-                    LPSTR* dest2, 
-                    size_type str_len2, 
-                    pDateTimeStamp datetime)
+TOSDB_GetStreamSnapshot_(LPCSTR id,
+                         LPCSTR item, 
+                         LPCSTR topic_str, 
+                         T* dest, 
+                         size_type array_len, 
+                         TOSDB_RawDataBlock::datetime_dest_type datetime, 
+                         long end, 
+                         long beg)
 {  
-    if(!CheckStringLength(topic_str))
+    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
         return TOSDB_ERROR_BAD_INPUT;   
    
     TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
     if(t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
 
-    return TOSDB_GetItemFrame_(id, t, dest, array_len, dest2, str_len2, datetime);  
+    return TOSDB_GetStreamSnapshot_(id, item, t, dest, array_len, datetime, end, beg);
 }
 
 int 
-TOSDB_GetItemFrameDoubles(LPCSTR id, 
-                          LPCSTR topic_str, 
-                          double* dest, 
-                          size_type array_len, 
-                          LPSTR* label_dest, 
-                          size_type label_str_len, 
-                          pDateTimeStamp datetime)
+TOSDB_GetStreamSnapshotDoubles(LPCSTR id,
+                               LPCSTR item, 
+                               LPCSTR topic_str, 
+                               double* dest, 
+                               size_type array_len, 
+                               pDateTimeStamp datetime, 
+                               long end, 
+                               long beg)
 {
-    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
-                               label_str_len, datetime);    
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    datetime, end, beg);
 }
 
 int 
-TOSDB_GetItemFrameFloats(LPCSTR id, 
-                         LPCSTR topic_str, 
-                         float* dest, 
-                         size_type array_len, 
-                         LPSTR* label_dest, 
-                         size_type label_str_len, 
-                         pDateTimeStamp datetime)
+TOSDB_GetStreamSnapshotFloats(LPCSTR id, 
+                              LPCSTR item, 
+                              LPCSTR topic_str, 
+                              float* dest, 
+                              size_type array_len, 
+                              pDateTimeStamp datetime, 
+                              long end, 
+                              long beg)
 {
-    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
-                               label_str_len, datetime);      
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    datetime, end, beg);
 }
 
 int 
-TOSDB_GetItemFrameLongLongs(LPCSTR id, 
-                            LPCSTR topic_str, 
-                            long long* dest, 
-                            size_type array_len, 
-                            LPSTR* label_dest, 
-                            size_type label_str_len, 
-                            pDateTimeStamp datetime)
+TOSDB_GetStreamSnapshotLongLongs(LPCSTR id, 
+                                 LPCSTR item, 
+                                 LPCSTR topic_str, 
+                                 long long* dest, 
+                                 size_type array_len, 
+                                 pDateTimeStamp datetime, 
+                                 long end, 
+                                 long beg)
 {
-    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
-                               label_str_len, datetime);      
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    datetime, end, beg);  
 }
 
 int 
-TOSDB_GetItemFrameLongs(LPCSTR id, 
-                        LPCSTR topic_str, 
-                        long* dest, 
-                        size_type array_len,
-                        LPSTR* label_dest, 
-                        size_type label_str_len, 
-                        pDateTimeStamp datetime)
+TOSDB_GetStreamSnapshotLongs(LPCSTR id, 
+                             LPCSTR item, 
+                             LPCSTR topic_str, 
+                             long* dest, 
+                             size_type array_len, 
+                             pDateTimeStamp datetime, 
+                             long end, 
+                             long beg)
 { 
-    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
-                               label_str_len, datetime);      
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    datetime, end, beg);  
 }
 
 int 
-TOSDB_GetItemFrameStrings(LPCSTR id, 
-                          LPCSTR topic_str, 
-                          LPSTR* dest,  
-                          size_type array_len, 
-                          size_type str_len, 
-                          LPSTR* label_dest, 
-                          size_type label_str_len, 
-                          pDateTimeStamp datetime)
-{  
+TOSDB_GetStreamSnapshotStrings_(LPCSTR id, 
+                                LPCSTR item, 
+                                LPCSTR topic_str, 
+                                LPSTR* dest, 
+                                size_type array_len, 
+                                size_type str_len, 
+                                TOSDB_RawDataBlock::datetime_dest_type datetime, 
+                                long end, 
+                                long beg)
+{
     const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
     TOS_Topics::TOPICS topic_t;
 
-    if(!IsValidBlockID(id) || !CheckStringLength(topic_str))
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) )
     {
         return TOSDB_ERROR_BAD_INPUT;
     }
 
     topic_t = GetTopicEnum(topic_str);
-    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)        
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
         return TOSDB_ERROR_BAD_TOPIC;
 
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+        dat->copy(dest,array_len,str_len,end,beg,datetime);
+        return 0;
+        /* --- CRITICAL SECTION --- */
 
-        if(datetime){      
-            auto dtsm = db->block->pair_map_of_frame_items(topic_t);
-            auto b_iter = dtsm.cbegin();
-            auto e_iter = dtsm.cend();        
-     
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                  ++b_iter, ++i)
-            {
-                datetime[i] = b_iter->second.second;
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
 
-                if( strcpy_s(dest[i], str_len, (b_iter->second.first).as_string().c_str()) )
-                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
- 
-                if(label_dest){
-                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
-                }
-            }    
-        }else{          
-            auto m = db->block->map_of_frame_items(topic_t);
-            auto b_iter = m.cbegin();
-            auto e_iter = m.cend();   
-         
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                 ++b_iter, ++i )
-            {
-                if( strcpy_s(dest[i], str_len, (b_iter->second).as_string().c_str()) )
-                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
 
-                if(label_dest){
-                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
-                }
-            }
-        }    
-       /* --- CRITICAL SECTION --- */
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetStreamSnapshotStrings", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+int 
+TOSDB_GetStreamSnapshotStrings(LPCSTR id, 
+                               LPCSTR item, 
+                               LPCSTR topic_str, 
+                               LPSTR* dest, 
+                               size_type array_len, 
+                               size_type str_len, 
+                               pDateTimeStamp datetime, 
+                               long end, 
+                               long beg)
+{
+    return TOSDB_GetStreamSnapshotStrings_(id, item, topic_str, dest, array_len, str_len, 
+                                           datetime, end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsPacked_(LPCSTR id, 
+                                      LPCSTR item, 
+                                      LPCSTR topic_str, 
+                                      LPSTR dest, 
+                                      size_type dest_sz, 
+                                      size_type* offsets, 
+                                      size_type array_len, 
+                                      TOSDB_RawDataBlock::datetime_dest_type datetime, 
+                                      long end, 
+                                      long beg,
+                                      size_type* get_size)
+{
+    const TOSDBlock *db;
+    TOS_Topics::TOPICS topic_t;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) 
+        || !get_size )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str);
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        *get_size = (size_type)db->block->raw_stream_ptr(item, topic_t)->copy_packed(
+            dest, dest_sz, offsets, array_len, end, beg, datetime
+        );
+        return 0;
+        /* --- CRITICAL SECTION --- */
 
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
@@ -1958,103 +2339,65 @@ TOSDB_GetItemFrameStrings(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetItemFrameStrings", e.what());
+        TOSDB_LogH("TOSDB_GetStreamSnapshotStringsPacked", e.what());
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
     }
-
-  return 0;    
-} 
-
-template<> 
-generic_map_type 
-TOSDB_GetTopicFrame<false>(std::string id, std::string item)
-{
-    const TOSDBlock *db;
-
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->map_of_frame_topics(item);
-    /* --- CRITICAL SECTION --- */
 }
 
-template<> 
-generic_dts_map_type 
-TOSDB_GetTopicFrame<true>(std::string id,std::string item)
+int 
+TOSDB_GetStreamSnapshotStringsPacked(LPCSTR id, 
+                                     LPCSTR item, 
+                                     LPCSTR topic_str, 
+                                     LPSTR dest, 
+                                     size_type dest_sz, 
+                                     size_type* offsets, 
+                                     size_type array_len, 
+                                     pDateTimeStamp datetime, 
+                                     long end, 
+                                     long beg,
+                                     size_type* get_size)
 {
-    const TOSDBlock *db;
-
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->pair_map_of_frame_topics(item);
-    /* --- CRITICAL SECTION --- */
+    return TOSDB_GetStreamSnapshotStringsPacked_(id, item, topic_str, dest, dest_sz, offsets, 
+                                                 array_len, datetime, end, beg, get_size);
 }
 
+template<typename T> 
 int 
-TOSDB_GetTopicFrameStrings(LPCSTR id, 
-                           LPCSTR item, 
-                           LPSTR* dest, 
-                           size_type array_len, 
-                           size_type str_len, 
-                           LPSTR* label_dest, 
-                           size_type label_str_len, 
-                           pDateTimeStamp datetime)
-{  
+TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
+                                   LPCSTR item, 
+                                   TOS_Topics::TOPICS topic_t, 
+                                   LPCSTR marker, /* NULL for default */
+                                   T* dest, 
+                                   size_type array_len, 
+                                   TOSDB_RawDataBlock::datetime_dest_type datetime,                     
+                                   long beg,
+                                   long *get_size)
+{
     const TOSDBlock *db;
-    int err = 0;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
 
-    if(!IsValidBlockID(id) || !CheckStringLength(item))
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || (marker && !CheckStringLength(marker)) )
     {
-        return TOSDB_ERROR_BAD_INPUT;  
+        return TOSDB_ERROR_BAD_INPUT;
     }
 
     try{
         GLOBAL_RLOCK_GUARD;
         /* --- CRITICAL SECTION --- */
         db = GetBlockOrThrow(id);
-
-        if(datetime){       
-            auto dtsm = db->block->pair_map_of_frame_topics(item);
-            auto b_iter = dtsm.cbegin();
-            auto e_iter = dtsm.cend(); 
-  
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                 ++b_iter, ++i)
-            {
-                datetime[i] = b_iter->second.second;
-
-                if( strcpy_s(dest[i], str_len, (b_iter->second.first).as_string().c_str()) )
-                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
-
-                if(label_dest){
-                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
-                }
-            }    
-        }else{    
-            auto m = db->block->map_of_frame_topics(item);
-            auto b_iter = m.cbegin();
-            auto e_iter = m.cend();     
- 
-            for( size_type i = 0; 
-                 (i < array_len) && (b_iter != e_iter); 
-                 ++b_iter, ++i)
-            {
-                if( strcpy_s(dest[i], str_len, (b_iter->second).as_string().c_str()) )
-                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
-
-                if(label_dest){
-                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
-                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
-                }
-            }  
-        }
+        dat = db->block->raw_stream_ptr(item, topic_t);
+                   /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+        *get_size = (long)(marker 
+                           ? dat->copy_from_named_marker(dat.marker_name(marker),dest,array_len,beg,datetime)
+                           : dat->copy_from_marker(dest,array_len,beg,datetime));
+        return 0;
         /* --- CRITICAL SECTION --- */
+
     }catch(const TOSDB_DataBlockDoesntExist& e){
         TOSDB_LogH("BLOCK", e.what());
         return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
@@ -2064,45 +2407,2713 @@ TOSDB_GetTopicFrameStrings(LPCSTR id,
         return TOSDB_ERROR_GET_DATA;
 
     }catch(const std::exception& e){
-        TOSDB_LogH("TOSDB_GetTopicFrameStrings", e.what());
+        TOSDB_LogH("GetStreamSnapshotFromMarker<T>", e.what());
         return TOSDB_ERROR_GET_DATA;
 
     }catch(...){ 
         return TOSDB_ERROR_UNKNOWN;
     }
+}
 
-  return 0;
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshotFromMarker_(LPCSTR id,
+                                   LPCSTR item, 
+                                   LPCSTR topic_str, 
+                                   LPCSTR marker,
+                                   T* dest, 
+                                   size_type array_len, 
+                                   TOSDB_RawDataBlock::datetime_dest_type datetime,               
+                                   long beg,
+                                   long *get_size)
+{  
+    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
+        return 0;   
+   
+    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, t, marker, dest, array_len, datetime, beg, get_size);
 }
 
-template<> 
-generic_matrix_type 
-TOSDB_GetTotalFrame<false>(std::string id)
+int 
+TOSDB_GetStreamSnapshotDoublesFromMarker(LPCSTR id,
+                                         LPCSTR item, 
+                                         LPCSTR topic_str, 
+                                         double* dest, 
+                                         size_type array_len, 
+                                         pDateTimeStamp datetime,                         
+                                         long beg,
+                                         long *get_size)
 {
-    const TOSDBlock *db;
-
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->matrix_of_frame();
-    /* --- CRITICAL SECTION --- */
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              datetime, beg, get_size);
 }
 
-template<> 
-generic_dts_matrix_type 
-TOSDB_GetTotalFrame<true>(std::string id)
+int 
+TOSDB_GetStreamSnapshotFloatsFromMarker(LPCSTR id, 
+                                        LPCSTR item, 
+                                        LPCSTR topic_str, 
+                                        float* dest, 
+                                        size_type array_len, 
+                                        pDateTimeStamp datetime,                        
+                                        long beg,
+                                        long *get_size)
 {
-    const TOSDBlock *db;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              datetime, beg, get_size);
+}
 
-    GLOBAL_RLOCK_GUARD;
-    /* --- CRITICAL SECTION --- */
-    db = GetBlockOrThrow(id);
-    return db->block->pair_matrix_of_frame();
-    /* --- CRITICAL SECTION --- */
+int 
+TOSDB_GetStreamSnapshotLongLongsFromMarker(LPCSTR id, 
+                                           LPCSTR item, 
+                                           LPCSTR topic_str, 
+                                           long long* dest, 
+                                           size_type array_len, 
+                                           pDateTimeStamp datetime,                         
+                                           long beg,
+                                           long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              datetime, beg, get_size);  
 }
 
+int 
+TOSDB_GetStreamSnapshotLongsFromMarker(LPCSTR id, 
+                                       LPCSTR item, 
+                                       LPCSTR topic_str, 
+                                       long* dest, 
+                                       size_type array_len, 
+                                       pDateTimeStamp datetime,                        
+                                       long beg,
+                                       long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              datetime, beg, get_size);  
+}
 
+int 
+TOSDB_GetStreamSnapshotDoublesFromNamedMarker(LPCSTR id,
+                                              LPCSTR item, 
+                                              LPCSTR topic_str, 
+                                              LPCSTR marker,
+                                              double* dest, 
+                                              size_type array_len, 
+                                              pDateTimeStamp datetime,                         
+                                              long beg,
+                                              long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              datetime, beg, get_size);
+}
 
+int 
+TOSDB_GetStreamSnapshotFloatsFromNamedMarker(LPCSTR id,
+                                             LPCSTR item, 
+                                             LPCSTR topic_str, 
+                                             LPCSTR marker,
+                                             float* dest, 
+                                             size_type array_len, 
+                                             pDateTimeStamp datetime,                         
+                                             long beg,
+                                             long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              datetime, beg, get_size);
+}
 
+int 
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarker(LPCSTR id,
+                                                LPCSTR item, 
+                                                LPCSTR topic_str, 
+                                                LPCSTR marker,
+                                                long long* dest, 
+                                                size_type array_len, 
+                                                pDateTimeStamp datetime,                         
+                                                long beg,
+                                                long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              datetime, beg, get_size);
+}
 
+int 
+TOSDB_GetStreamSnapshotLongsFromNamedMarker(LPCSTR id,
+                                            LPCSTR item, 
+                                            LPCSTR topic_str, 
+                                            LPCSTR marker,
+                                            long* dest, 
+                                            size_type array_len, 
+                                            pDateTimeStamp datetime,                         
+                                            long beg,
+                                            long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              datetime, beg, get_size);
+}
 
+int 
+TOSDB_GetStreamSnapshotStringsFromMarker(LPCSTR id, 
+                                         LPCSTR item, 
+                                         LPCSTR topic_str, 
+                                         LPSTR* dest, 
+                                         size_type array_len, 
+                                         size_type str_len, 
+                                         pDateTimeStamp datetime,                         
+                                         long beg,
+                                         long *get_size)
+{
+    return TOSDB_GetStreamSnapshotStringsFromNamedMarker(id, item, topic_str, NULL, dest, array_len, 
+                                                         str_len, datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromMarker_(LPCSTR id, 
+                                          LPCSTR item, 
+                                          LPCSTR topic_str, 
+                                          LPCSTR marker, /* NULL for default */
+                                          LPSTR* dest, 
+                                          size_type array_len, 
+                                          size_type str_len, 
+                                          TOSDB_RawDataBlock::datetime_dest_type datetime,                         
+                                          long beg,
+                                          long *get_size)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS topic_t;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) 
+        || (marker && !CheckStringLength(marker)) )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str); 
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+                    /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+        *get_size = (long)(marker 
+                           ? dat->copy_from_named_marker(dat.marker_name(marker), dest, array_len, str_len, beg, datetime)
+                           : dat->copy_from_marker(dest, array_len, str_len, beg, datetime));   
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetStreamSnapshotStringsFromNamedMarker", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromNamedMarker(LPCSTR id, 
+                                              LPCSTR item, 
+                                              LPCSTR topic_str, 
+                                              LPCSTR marker,
+                                              LPSTR* dest, 
+                                              size_type array_len, 
+                                              size_type str_len, 
+                                              pDateTimeStamp datetime,                         
+                                              long beg,
+                                              long *get_size)
+{
+    return TOSDB_GetStreamSnapshotStringsFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                                     str_len, datetime, beg, get_size);
+}
+
+
+template<typename T> 
+int 
+TOSDB_GetNFromMarker_(LPCSTR id,
+                      LPCSTR item, 
+                      TOS_Topics::TOPICS topic_t, 
+                      LPCSTR marker, /* NULL for default */
+                      T* dest, 
+                      size_type n, 
+                      pDateTimeStamp datetime,                                                       
+                      long *get_size)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || (marker && !CheckStringLength(marker)) )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+                     /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+        *get_size = (long)(marker 
+                           ? dat->ncopy_from_named_marker(dat.marker_name(marker),dest,n,datetime)
+                           : dat->ncopy_from_marker(dest,n,datetime));
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetNFromMarker<T>", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+template<typename T> 
+int 
+TOSDB_GetNFromMarker_(LPCSTR id,
+                      LPCSTR item, 
+                      LPCSTR topic_str, 
+                      LPCSTR marker,
+                      T* dest, 
+                      size_type n, 
+                      pDateTimeStamp datetime,                                                       
+                      long *get_size)
+{  
+    if(!CheckStringLength(topic_str)) /* let this go thru std::string ? */
+        return 0;   
+   
+    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    return TOSDB_GetNFromMarker_(id, item, t, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNDoublesFromMarker(LPCSTR id,
+                            LPCSTR item, 
+                            LPCSTR topic_str, 
+                            double *dest, 
+                            size_type n, 
+                            pDateTimeStamp datetime,                                                       
+                            long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNFloatsFromMarker(LPCSTR id,
+                           LPCSTR item, 
+                           LPCSTR topic_str, 
+                           float *dest, 
+                           size_type n, 
+                           pDateTimeStamp datetime,
+                           long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongLongsFromMarker(LPCSTR id,
+                              LPCSTR item, 
+                              LPCSTR topic_str, 
+                              long long *dest, 
+                              size_type n, 
+                              pDateTimeStamp datetime,                                                       
+                              long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, NULL, dest, n, datetime, get_size);  
+}
+
+int 
+TOSDB_GetNLongsFromMarker(LPCSTR id,
+                          LPCSTR item, 
+                          LPCSTR topic_str, 
+                          long *dest, 
+                          size_type n, 
+                          pDateTimeStamp datetime,                                                       
+                          long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, NULL, dest, n, datetime, get_size);  
+}
+
+int 
+TOSDB_GetNDoublesFromNamedMarker(LPCSTR id,
+                                 LPCSTR item, 
+                                 LPCSTR topic_str, 
+                                 LPCSTR marker,
+                                 double *dest, 
+                                 size_type n, 
+                                 pDateTimeStamp datetime,
+                                 long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNFloatsFromNamedMarker(LPCSTR id,
+                                LPCSTR item, 
+                                LPCSTR topic_str, 
+                                LPCSTR marker,
+                                float *dest, 
+                                size_type n, 
+                                pDateTimeStamp datetime,
+                                long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongLongsFromNamedMarker(LPCSTR id,
+                                   LPCSTR item, 
+                                   LPCSTR topic_str, 
+                                   LPCSTR marker,
+                                   long long *dest, 
+                                   size_type n, 
+                                   pDateTimeStamp datetime,
+                                   long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongsFromNamedMarker(LPCSTR id,
+                               LPCSTR item, 
+                               LPCSTR topic_str, 
+                               LPCSTR marker,
+                               long *dest, 
+                               size_type n, 
+                               pDateTimeStamp datetime,
+                               long *get_size)
+{
+    return TOSDB_GetNFromMarker_(id, item, topic_str, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNStringsFromMarker(LPCSTR id, 
+                            LPCSTR item, 
+                            LPCSTR topic_str, 
+                            LPSTR* dest, 
+                            size_type n, 
+                            size_type str_len, 
+                            pDateTimeStamp datetime,
+                            long *get_size)
+{
+    return TOSDB_GetNStringsFromNamedMarker(id, item, topic_str, NULL, dest, n, str_len, 
+                                            datetime, get_size);
+}
+
+int 
+TOSDB_GetNStringsFromNamedMarker(LPCSTR id, 
+                                 LPCSTR item, 
+                                 LPCSTR topic_str, 
+                                 LPCSTR marker,
+                                 LPSTR* dest, 
+                                 size_type n, 
+                                 size_type str_len, 
+                                 pDateTimeStamp datetime,
+                                 long *get_size)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS topic_t;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str) 
+        || (marker && !CheckStringLength(marker)) )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str); 
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+                    /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+        *get_size = (long)(marker 
+                           ? dat->ncopy_from_named_marker(dat.marker_name(marker), dest, n, str_len, datetime)
+                           : dat->ncopy_from_marker(dest, n, str_len, datetime));   
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetNStringsFromNamedMarker", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+
+std::pair<long,long> 
+TOSDB_GetStreamIndicesBetweenDateTimes(std::string id, 
+                                       std::string item, 
+                                       TOS_Topics::TOPICS topic_t,
+                                       const DateTimeStamp& from, 
+                                       const DateTimeStamp& to)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    int end, beg;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);  
+    dat = db->block->raw_stream_ptr(item, topic_t);
+    try{
+        dat->secondary_range(from, to, &end, &beg);
+        return std::pair<long,long>(end, beg);
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "TOSDB_GetStreamIndicesBetweenDateTimes");
+    }
+    /* --- CRITICAL SECTION --- */
+}
+
+template<typename T> 
+std::pair<std::vector<T>, dts_vector_type>  
+TOSDB_GetStreamSnapshotBetweenDateTimes(std::string id, 
+                                        std::string item, 
+                                        TOS_Topics::TOPICS topic_t,
+                                        const DateTimeStamp& from, 
+                                        const DateTimeStamp& to)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    std::pair<long,long> range;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);  
+    dat = db->block->raw_stream_ptr(item, topic_t);
+    /* the extract thread doesn't take the global lock; hold the stream's 
+       across both calls so the indices stay valid */
+    TOSDB_RawDataBlock::stream_type::lock_scope stream_lock(dat);
+
+    range = TOSDB_GetStreamIndicesBetweenDateTimes(id, item, topic_t, from, to);
+    if(range.first < range.second)
+        return std::pair<std::vector<T>, dts_vector_type>();
+
+    return TOSDB_GetStreamSnapshot<T,true>(id, item, topic_t, range.first, range.second);
+    /* --- CRITICAL SECTION --- */
+}
+
+namespace {
+
+template<typename T>
+size_t
+_copyBetween(TOSDB_RawDataBlock::stream_const_ptr_type dat,
+             T* dest, 
+             size_type array_len, 
+             size_type str_len, /* ignored */
+             long end,
+             long beg,
+             pDateTimeStamp datetime)
+{
+    return dat->copy(dest, array_len, end, beg, datetime);
+}
+
+size_t
+_copyBetween(TOSDB_RawDataBlock::stream_const_ptr_type dat,
+             char** dest, 
+             size_type array_len, 
+             size_type str_len,
+             long end,
+             long beg,
+             pDateTimeStamp datetime)
+{
+    return dat->copy(dest, array_len, str_len, end, beg, datetime);
+}
+
+};
+
+int 
+TOSDB_GetStreamIndicesBetweenDateTimes(LPCSTR id, 
+                                       LPCSTR item, 
+                                       LPCSTR topic_str, 
+                                       pDateTimeStamp from_datetime, 
+                                       pDateTimeStamp to_datetime, 
+                                       long *end, 
+                                       long *beg)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS topic_t;
+    int e_indx, b_indx;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str)
+        || !from_datetime || !to_datetime || !end || !beg )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str); 
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+        dat->secondary_range(*from_datetime, *to_datetime, &e_indx, &b_indx);
+        *end = e_indx;
+        *beg = b_indx;
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetStreamIndicesBetweenDateTimes", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshotBetweenDateTimes_(LPCSTR id,
+                                         LPCSTR item, 
+                                         LPCSTR topic_str, 
+                                         T* dest, 
+                                         size_type array_len, 
+                                         size_type str_len,
+                                         pDateTimeStamp datetime,
+                                         pDateTimeStamp from_datetime,
+                                         pDateTimeStamp to_datetime,
+                                         long *get_size)
+{
+    const TOSDBlock *db;
+    TOSDB_RawDataBlock::stream_const_ptr_type dat;
+    TOS_Topics::TOPICS topic_t;
+    int end, beg;
+    long n;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item)
+        || !CheckStringLength(topic_str)
+        || !from_datetime || !to_datetime || !get_size )
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str); 
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        dat = db->block->raw_stream_ptr(item, topic_t);
+        /* no pushes between the search and the copy */
+        TOSDB_RawDataBlock::stream_type::lock_scope stream_lock(dat);
+
+        dat->secondary_range(*from_datetime, *to_datetime, &end, &beg);
+        if(end < beg){
+            *get_size = 0;
+            return 0;
+        }
+                     /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+        n = (long)_copyBetween(dat, dest, array_len, str_len, end, beg, datetime);
+        /* like the marker calls, negative size indicates buffer too small */
+        *get_size = (n < (end - beg + 1)) ? -n : n;
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetStreamSnapshotBetweenDateTimes_", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesBetweenDateTimes(LPCSTR id, 
+                                               LPCSTR item, 
+                                               LPCSTR topic_str, 
+                                               double* dest, 
+                                               size_type array_len, 
+                                               pDateTimeStamp datetime, 
+                                               pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, 
+                                               long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimes_(id, item, topic_str, dest, array_len, 0,
+                                                    datetime, from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsBetweenDateTimes(LPCSTR id, 
+                                              LPCSTR item, 
+                                              LPCSTR topic_str, 
+                                              float* dest, 
+                                              size_type array_len, 
+                                              pDateTimeStamp datetime, 
+                                              pDateTimeStamp from_datetime, 
+                                              pDateTimeStamp to_datetime, 
+                                              long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimes_(id, item, topic_str, dest, array_len, 0,
+                                                    datetime, from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsBetweenDateTimes(LPCSTR id, 
+                                                 LPCSTR item, 
+                                                 LPCSTR topic_str, 
+                                                 long long* dest, 
+                                                 size_type array_len, 
+                                                 pDateTimeStamp datetime, 
+                                                 pDateTimeStamp from_datetime, 
+                                                 pDateTimeStamp to_datetime, 
+                                                 long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimes_(id, item, topic_str, dest, array_len, 0,
+                                                    datetime, from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsBetweenDateTimes(LPCSTR id, 
+                                             LPCSTR item, 
+                                             LPCSTR topic_str, 
+                                             long* dest, 
+                                             size_type array_len, 
+                                             pDateTimeStamp datetime, 
+                                             pDateTimeStamp from_datetime, 
+                                             pDateTimeStamp to_datetime, 
+                                             long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimes_(id, item, topic_str, dest, array_len, 0,
+                                                    datetime, from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsBetweenDateTimes(LPCSTR id, 
+                                               LPCSTR item, 
+                                               LPCSTR topic_str, 
+                                               LPSTR* dest, 
+                                               size_type array_len, 
+                                               size_type str_len,
+                                               pDateTimeStamp datetime, 
+                                               pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, 
+                                               long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimes_(id, item, topic_str, dest, array_len, str_len,
+                                                    datetime, from_datetime, to_datetime, get_size);
+}
+
+
+template<> 
+generic_map_type 
+TOSDB_GetItemFrame<false>(std::string id, TOS_Topics::TOPICS topic_t)
+{
+    const TOSDBlock *db; 
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->map_of_frame_items(topic_t);
+    /* --- CRITICAL SECTION --- */
+}
+
+template<> 
+generic_dts_map_type 
+TOSDB_GetItemFrame<true>(std::string id, TOS_Topics::TOPICS topic_t)
+{
+    const TOSDBlock *db; 
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)
+        throw std::invalid_argument("NULL TOPIC");
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->pair_map_of_frame_items(topic_t);
+    /* --- CRITICAL SECTION --- */
+}
+
+template<typename T> 
+int 
+TOSDB_GetItemFrame_(LPCSTR id, 
+                    TOS_Topics::TOPICS topic_t, 
+                    T* dest, 
+                    size_type array_len, 
+                    LPSTR* dest2, 
+                    size_type str_len2, 
+                    pDateTimeStamp datetime)
+{
+    const TOSDBlock *db;
+  
+    if(!IsValidBlockID(id))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC){
+        TOSDB_LogH("INPUT", "NULL topic passed to TOSDB_GetItemFrame_");
+        return TOSDB_ERROR_BAD_TOPIC;
+    }
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+
+        if(datetime){  
+            auto dtsm = db->block->pair_map_of_frame_items(topic_t);
+            auto b_iter = dtsm.cbegin();
+            auto e_iter = dtsm.cend();
+
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                 ++b_iter, ++i )
+            {
+                dest[i] = (T)b_iter->second.first;
+                datetime[i] = b_iter->second.second;
+                if(dest2){
+                    if( strcpy_s(dest2[i], str_len2, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+                }
+            }      
+        }else{        
+            auto m = db->block->map_of_frame_items(topic_t);
+            auto b_iter = m.cbegin();
+            auto e_iter = m.cend();   
+           
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                 ++b_iter, ++i )  
+            {      
+                dest[i] = (T)b_iter->second;  
+                if(dest2){
+                    if( strcpy_s(dest2[i], str_len2, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;                  
+                }
+            }            
+        }    
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("GetItemFrame<T>", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+
+  return 0;
+}
+
+template<typename T> 
+int 
+TOSDB_GetItemFrame_(LPCSTR id, 
+                    LPCSTR topic_str, 
+                    T* dest, 
+                    size_type array_len, 
+                    LPSTR* dest2, 
+                    size_type str_len2, 
+                    pDateTimeStamp datetime)
+{  
+    if(!CheckStringLength(topic_str))
+        return TOSDB_ERROR_BAD_INPUT;   
+   
+    TOS_Topics::TOPICS t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    return TOSDB_GetItemFrame_(id, t, dest, array_len, dest2, str_len2, datetime);  
+}
+
+int 
+TOSDB_GetItemFrameDoubles(LPCSTR id, 
+                          LPCSTR topic_str, 
+                          double* dest, 
+                          size_type array_len, 
+                          LPSTR* label_dest, 
+                          size_type label_str_len, 
+                          pDateTimeStamp datetime)
+{
+    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
+                               label_str_len, datetime);    
+}
+
+int 
+TOSDB_GetItemFrameFloats(LPCSTR id, 
+                         LPCSTR topic_str, 
+                         float* dest, 
+                         size_type array_len, 
+                         LPSTR* label_dest, 
+                         size_type label_str_len, 
+                         pDateTimeStamp datetime)
+{
+    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
+                               label_str_len, datetime);      
+}
+
+int 
+TOSDB_GetItemFrameLongLongs(LPCSTR id, 
+                            LPCSTR topic_str, 
+                            long long* dest, 
+                            size_type array_len, 
+                            LPSTR* label_dest, 
+                            size_type label_str_len, 
+                            pDateTimeStamp datetime)
+{
+    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
+                               label_str_len, datetime);      
+}
+
+int 
+TOSDB_GetItemFrameLongs(LPCSTR id, 
+                        LPCSTR topic_str, 
+                        long* dest, 
+                        size_type array_len,
+                        LPSTR* label_dest, 
+                        size_type label_str_len, 
+                        pDateTimeStamp datetime)
+{ 
+    return TOSDB_GetItemFrame_(id, topic_str, dest, array_len, label_dest, 
+                               label_str_len, datetime);      
+}
+
+int 
+TOSDB_GetItemFrameStrings(LPCSTR id, 
+                          LPCSTR topic_str, 
+                          LPSTR* dest,  
+                          size_type array_len, 
+                          size_type str_len, 
+                          LPSTR* label_dest, 
+                          size_type label_str_len, 
+                          pDateTimeStamp datetime)
+{  
+    const TOSDBlock *db;
+    TOS_Topics::TOPICS topic_t;
+
+    if(!IsValidBlockID(id) || !CheckStringLength(topic_str))
+    {
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    topic_t = GetTopicEnum(topic_str);
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)        
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+
+        if(datetime){      
+            auto dtsm = db->block->pair_map_of_frame_items(topic_t);
+            auto b_iter = dtsm.cbegin();
+            auto e_iter = dtsm.cend();        
+     
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                  ++b_iter, ++i)
+            {
+                datetime[i] = b_iter->second.second;
+
+                if( strcpy_s(dest[i], str_len, (b_iter->second.first).as_string().c_str()) )
+                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
+ 
+                if(label_dest){
+                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+                }
+            }    
+        }else{          
+            auto m = db->block->map_of_frame_items(topic_t);
+            auto b_iter = m.cbegin();
+            auto e_iter = m.cend();   
+         
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                 ++b_iter, ++i )
+            {
+                if( strcpy_s(dest[i], str_len, (b_iter->second).as_string().c_str()) )
+                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
+
+                if(label_dest){
+                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+                }
+            }
+        }    
+       /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetItemFrameStrings", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+
+  return 0;    
+} 
+
+template<typename T> 
+int 
+TOSDB_GetItemFrameColumn_(LPCSTR id, 
+                          LPCSTR topic_str, 
+                          T* dest, 
+                          size_type array_len, 
+                          size_type str_len,  /* only used for strings */
+                          TOSDB_RawDataBlock::datetime_dest_type datetime,
+                          size_type* item_indices,
+                          size_type* get_size)
+{
+    const TOSDBlock *db;
+    TOS_Topics::TOPICS topic_t;
+    size_type n;
+
+    if(!IsValidBlockID(id) || !CheckStringLength(topic_str))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    topic_t = GetTopicEnum(topic_str);
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)        
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        n = db->block->item_frame_columns(topic_t, dest, array_len, datetime, item_indices);
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("GetItemFrameColumn<T>", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+
+    if(get_size)
+        *get_size = n;
+
+    return 0;
+}
+
+template<> 
+int 
+TOSDB_GetItemFrameColumn_(LPCSTR id, 
+                          LPCSTR topic_str, 
+                          LPSTR* dest, 
+                          size_type array_len, 
+                          size_type str_len,
+                          TOSDB_RawDataBlock::datetime_dest_type datetime,
+                          size_type* item_indices,
+                          size_type* get_size)
+{
+    const TOSDBlock *db;
+    TOS_Topics::TOPICS topic_t;
+    size_type n;
+
+    if(!IsValidBlockID(id) || !CheckStringLength(topic_str))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    topic_t = GetTopicEnum(topic_str);
+    if(topic_t == TOS_Topics::TOPICS::NULL_TOPIC)        
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    if(!str_len)
+        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        n = db->block->item_frame_columns(topic_t, dest, array_len, str_len, datetime, item_indices);
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetItemFrameColumnStrings", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+
+    if(get_size)
+        *get_size = n;
+
+    return 0;
+}
+
+int 
+TOSDB_GetItemFrameColumnDoubles(LPCSTR id, 
+                                LPCSTR topic_str, 
+                                double* dest, 
+                                size_type array_len, 
+                                pDateTimeStamp datetime,
+                                size_type* item_indices,
+                                size_type* get_size)
+{
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, datetime, 
+                                     item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnFloats(LPCSTR id, 
+                               LPCSTR topic_str, 
+                               float* dest, 
+                               size_type array_len, 
+                               pDateTimeStamp datetime,
+                               size_type* item_indices,
+                               size_type* get_size)
+{
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, datetime, 
+                                     item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnLongLongs(LPCSTR id, 
+                                  LPCSTR topic_str, 
+                                  long long* dest, 
+                                  size_type array_len, 
+                                  pDateTimeStamp datetime,
+                                  size_type* item_indices,
+                                  size_type* get_size)
+{
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, datetime, 
+                                     item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnLongs(LPCSTR id, 
+                              LPCSTR topic_str, 
+                              long* dest, 
+                              size_type array_len, 
+                              pDateTimeStamp datetime,
+                              size_type* item_indices,
+                              size_type* get_size)
+{
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, datetime, 
+                                     item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnStrings(LPCSTR id, 
+                                LPCSTR topic_str, 
+                                LPSTR* dest, 
+                                size_type array_len, 
+                                size_type str_len,
+                                pDateTimeStamp datetime,
+                                size_type* item_indices,
+                                size_type* get_size)
+{
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, str_len, datetime, 
+                                     item_indices, get_size);
+}
+
+template<> 
+generic_map_type 
+TOSDB_GetTopicFrame<false>(std::string id, std::string item)
+{
+    const TOSDBlock *db;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->map_of_frame_topics(item);
+    /* --- CRITICAL SECTION --- */
+}
+
+template<> 
+generic_dts_map_type 
+TOSDB_GetTopicFrame<true>(std::string id,std::string item)
+{
+    const TOSDBlock *db;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->pair_map_of_frame_topics(item);
+    /* --- CRITICAL SECTION --- */
+}
+
+int 
+TOSDB_GetTopicFrameStrings(LPCSTR id, 
+                           LPCSTR item, 
+                           LPSTR* dest, 
+                           size_type array_len, 
+                           size_type str_len, 
+                           LPSTR* label_dest, 
+                           size_type label_str_len, 
+                           pDateTimeStamp datetime)
+{  
+    const TOSDBlock *db;
+    int err = 0;
+
+    if(!IsValidBlockID(id) || !CheckStringLength(item))
+    {
+        return TOSDB_ERROR_BAD_INPUT;  
+    }
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+
+        if(datetime){       
+            auto dtsm = db->block->pair_map_of_frame_topics(item);
+            auto b_iter = dtsm.cbegin();
+            auto e_iter = dtsm.cend(); 
+  
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                 ++b_iter, ++i)
+            {
+                datetime[i] = b_iter->second.second;
+
+                if( strcpy_s(dest[i], str_len, (b_iter->second.first).as_string().c_str()) )
+                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
+
+                if(label_dest){
+                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+                }
+            }    
+        }else{    
+            auto m = db->block->map_of_frame_topics(item);
+            auto b_iter = m.cbegin();
+            auto e_iter = m.cend();     
+ 
+            for( size_type i = 0; 
+                 (i < array_len) && (b_iter != e_iter); 
+                 ++b_iter, ++i)
+            {
+                if( strcpy_s(dest[i], str_len, (b_iter->second).as_string().c_str()) )
+                    return TOSDB_ERROR_BAD_INPUT_BUFFER;
+
+                if(label_dest){
+                    if( strcpy_s(label_dest[i], label_str_len, (b_iter->first).c_str()) )
+                        return TOSDB_ERROR_BAD_INPUT_BUFFER;
+                }
+            }  
+        }
+        /* --- CRITICAL SECTION --- */
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetTopicFrameStrings", e.what());
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+
+  return 0;
+}
+
+template<> 
+generic_matrix_type 
+TOSDB_GetTotalFrame<false>(std::string id)
+{
+    const TOSDBlock *db;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->matrix_of_frame();
+    /* --- CRITICAL SECTION --- */
+}
+
+template<> 
+generic_dts_matrix_type 
+TOSDB_GetTotalFrame<true>(std::string id)
+{
+    const TOSDBlock *db;
+
+    GLOBAL_RLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    db = GetBlockOrThrow(id);
+    return db->block->pair_matrix_of_frame();
+    /* --- CRITICAL SECTION --- */
+}
+
+
+
+
+
+
+
+
+
+namespace {
+
+/* stream handles: the slot in stream_handles (+1, so 0 is never valid) in 
+   the low 32 bits and the slot's generation in the high 32, so a handle to 
+   a slot that's been closed and reused is rejected. The stream is resolved 
+   to its (item id, topic id) when the handle is opened; calls through the 
+   handle skip the string checks and the block/stream name lookups and just 
+   index the block's stream matrix. 
+
+   Like the blocks they point into entries are read under GLOBAL_RLOCK and 
+   changed under GLOBAL_WLOCK; client_admin drops them (InvalidateStreamHandles) 
+   before their item/topic/block goes away. The slot stays taken until the 
+   handle is closed so calls w/ a dropped handle fail instead of reading 
+   someone else's stream */
+struct StreamHandleEntry{
+    const TOSDBlock *db; /* null if the stream was removed */
+    std::string item;
+    TOS_Topics::TOPICS topic;
+    size_type item_id;
+    size_type topic_id;
+    unsigned int gen;
+    bool in_use;
+};
+
+std::vector<StreamHandleEntry> stream_handles;
+std::vector<size_type> free_stream_handles;
+
+/* null if closed or never opened; CALLING CODE MUST HOLD GLOBAL_RLOCK */
+const StreamHandleEntry*
+_getHandleEntry(StreamHandle handle)
+{
+    size_type slot = (size_type)(handle & 0xFFFFFFFF);
+    unsigned int gen = (unsigned int)(handle >> 32);
+
+    if(slot == 0 || slot > stream_handles.size())
+        return nullptr;
+
+    const StreamHandleEntry& e = stream_handles[slot - 1];
+    return (e.in_use && e.gen == gen) ? &e : nullptr;
+}
+
+/* run func(entry) under GLOBAL_RLOCK; 'err' if it throws */
+template<typename F>
+int
+_callWithHandle(StreamHandle handle, LPCSTR name, int err, F func)
+{
+    const StreamHandleEntry *entry;
+
+    try{
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        entry = _getHandleEntry(handle);
+        if(!entry){ /* these are used in tight loops, don't flood the log */
+            TOSDB_LogLimitedH("HANDLE", name, "invalid stream handle");
+            return TOSDB_ERROR_BAD_INPUT;
+        }
+        if(!entry->db){
+            TOSDB_LogLimitedH("HANDLE", name, "stream of handle has been removed");
+            return TOSDB_ERROR_BAD_INPUT;
+        }
+        func(*entry);
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return err;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH(name, e.what());
+        return err;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+/* _copyTyped for a handle's stream */
+template<typename T>
+size_t
+_copyTyped(const StreamHandleEntry& e,
+           T* dest,
+           size_type array_len,
+           long end,
+           long beg,
+           pDateTimeStamp datetime)
+{
+    return _copyTyped(e.db->block, e.item_id, e.topic_id, e.topic, dest, array_len, 
+                      end, beg, datetime);
+}
+
+};
+
+
+void
+InvalidateStreamHandles(const TOSDBlock* db, std::string item, TOS_Topics::TOPICS topic)
+{
+    for(StreamHandleEntry & e : stream_handles){
+        if( e.db != db )
+            continue;
+        if( !item.empty() && e.item != item )
+            continue;
+        if( topic != TOS_Topics::TOPICS::NULL_TOPIC && e.topic != topic )
+            continue;
+        e.db = nullptr;
+    }
+}
+
+
+int
+TOSDB_OpenStreamHandle(LPCSTR id, LPCSTR item, LPCSTR topic_str, StreamHandle* handle)
+{
+    const TOSDBlock *db;
+    TOS_Topics::TOPICS t;
+    size_type item_id, topic_id, slot;
+
+    if( !IsValidBlockID(id) 
+        || !CheckStringLength(item) 
+        || !CheckStringLength(topic_str) 
+        || !handle )
+    {
+        return TOSDB_ERROR_BAD_INPUT;  
+    }
+
+    t = GetTopicEnum(topic_str);
+    if(t == TOS_Topics::TOPICS::NULL_TOPIC)
+        return TOSDB_ERROR_BAD_TOPIC;
+
+    try{
+        GLOBAL_WLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        db = GetBlockOrThrow(id);
+        if( !db->block->has_item(item) )
+            return TOSDB_ERROR_BAD_ITEM;
+        if( !db->block->has_topic(t) )
+            return TOSDB_ERROR_BAD_TOPIC;
+
+        db->block->stream_ids(item, t, &item_id, &topic_id);
+
+        if( free_stream_handles.empty() ){
+            if(stream_handles.size() >= 0xFFFFFFFF)
+                throw std::length_error("too many stream handles");
+            StreamHandleEntry e = {nullptr, std::string(), t, 0, 0, 0, false};
+            stream_handles.push_back(e);
+            slot = (size_type)stream_handles.size();
+        }else{
+            slot = free_stream_handles.back();
+            free_stream_handles.pop_back();
+        }
+
+        StreamHandleEntry& e = stream_handles[slot - 1];
+        e.db = db;
+        e.item = item;
+        e.topic = t;
+        e.item_id = item_id;
+        e.topic_id = topic_id;
+        e.in_use = true;
+
+        *handle = ((StreamHandle)e.gen << 32) | slot;
+        return 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const TOSDB_DataBlockDoesntExist& e){
+        TOSDB_LogH("BLOCK", e.what());
+        return TOSDB_ERROR_BLOCK_DOESNT_EXIST;
+
+    }catch(const TOSDB_Error& e){
+        TOSDB_LogH(e.tag().c_str(), e.info_and_what().c_str());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_OpenStreamHandle", e.what());
+        return TOSDB_ERROR_GET_STATE;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+int
+TOSDB_CloseStreamHandle(StreamHandle handle)
+{
+    size_type slot = (size_type)(handle & 0xFFFFFFFF);
+
+    GLOBAL_WLOCK_GUARD;
+    /* --- CRITICAL SECTION --- */
+    if( !_getHandleEntry(handle) ){
+        TOSDB_LogH("HANDLE", "TOSDB_CloseStreamHandle: invalid stream handle");
+        return TOSDB_ERROR_BAD_INPUT;
+    }
+
+    StreamHandleEntry& e = stream_handles[slot - 1];
+    e.db = nullptr;
+    e.item.clear();
+    e.in_use = false;
+    ++e.gen; /* invalidate copies of the handle before the slot is reused */
+    free_stream_handles.push_back(slot);
+    return 0;
+    /* --- CRITICAL SECTION --- */
+}
+
+int 
+TOSDB_GetStreamOccupancyByHandle(StreamHandle handle, size_type* sz)
+{
+    return _callWithHandle(handle, "TOSDB_GetStreamOccupancyByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            *sz = (size_type)(e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->size());
+        });
+}
+
+int 
+TOSDB_GetMarkerPositionByHandle(StreamHandle handle, long long* pos)
+{
+    return _callWithHandle(handle, "TOSDB_GetMarkerPositionByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            *pos = e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->marker_position();
+        });
+}
+
+int 
+TOSDB_IsMarkerDirtyByHandle(StreamHandle handle, unsigned int* is_dirty)
+{
+    return _callWithHandle(handle, "TOSDB_IsMarkerDirtyByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            *is_dirty = (unsigned int)
+                (e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->is_marker_dirty());
+        });
+}
+
+int 
+TOSDB_GetNamedMarkerPositionByHandle(StreamHandle handle, LPCSTR marker, long long* pos)
+{
+    if( !CheckStringLength(marker) )
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetNamedMarkerPositionByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+            *pos = dat->marker_position(dat.marker_name(marker));
+        });
+}
+
+int 
+TOSDB_IsNamedMarkerDirtyByHandle(StreamHandle handle, LPCSTR marker, unsigned int* is_dirty)
+{
+    if( !CheckStringLength(marker) )
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_IsNamedMarkerDirtyByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+            *is_dirty = (unsigned int)(dat->is_marker_dirty(dat.marker_name(marker)));
+        });
+}
+
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshotByHandle_(StreamHandle handle,
+                                 T* dest, 
+                                 size_type array_len, 
+                                 pDateTimeStamp datetime, 
+                                 long end, 
+                                 long beg)
+{
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotByHandle<T>", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            _copyTyped(e, dest, array_len, end, beg, datetime);
+        });
+}
+
+int
+TOSDB_GetDoubleByHandle(StreamHandle handle, long indx, double* dest, pDateTimeStamp datetime)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, 1, datetime, indx, indx);
+}
+
+int
+TOSDB_GetFloatByHandle(StreamHandle handle, long indx, float* dest, pDateTimeStamp datetime)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, 1, datetime, indx, indx);
+}
+
+int
+TOSDB_GetLongLongByHandle(StreamHandle handle, long indx, long long* dest, pDateTimeStamp datetime)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, 1, datetime, indx, indx);
+}
+
+int
+TOSDB_GetLongByHandle(StreamHandle handle, long indx, long* dest, pDateTimeStamp datetime)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, 1, datetime, indx, indx);
+}
+
+int
+TOSDB_GetStringByHandle(StreamHandle handle, 
+                        long indx, 
+                        LPSTR dest, 
+                        size_type str_len, 
+                        pDateTimeStamp datetime)
+{
+    return TOSDB_GetStreamSnapshotStringsByHandle(handle, &dest, 1, str_len, datetime, indx, indx);
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesByHandle(StreamHandle handle,
+                                       double* dest, 
+                                       size_type array_len, 
+                                       pDateTimeStamp datetime, 
+                                       long end, 
+                                       long beg)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, array_len, datetime, end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsByHandle(StreamHandle handle,
+                                      float* dest, 
+                                      size_type array_len, 
+                                      pDateTimeStamp datetime, 
+                                      long end, 
+                                      long beg)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, array_len, datetime, end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsByHandle(StreamHandle handle,
+                                         long long* dest, 
+                                         size_type array_len, 
+                                         pDateTimeStamp datetime, 
+                                         long end, 
+                                         long beg)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, array_len, datetime, end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsByHandle(StreamHandle handle,
+                                     long* dest, 
+                                     size_type array_len, 
+                                     pDateTimeStamp datetime, 
+                                     long end, 
+                                     long beg)
+{
+    return TOSDB_GetStreamSnapshotByHandle_(handle, dest, array_len, datetime, end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsByHandle(StreamHandle handle,
+                                       LPSTR* dest, 
+                                       size_type array_len, 
+                                       size_type str_len, 
+                                       pDateTimeStamp datetime, 
+                                       long end, 
+                                       long beg)
+{
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotStringsByHandle", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->copy(dest, array_len, str_len, 
+                                                                     end, beg, datetime);
+        });
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsPackedByHandle(StreamHandle handle,
+                                             LPSTR dest, 
+                                             size_type dest_sz, 
+                                             size_type* offsets, 
+                                             size_type array_len, 
+                                             pDateTimeStamp datetime, 
+                                             long end, 
+                                             long beg,
+                                             size_type* get_size)
+{
+    if(!get_size)
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotStringsPackedByHandle", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            *get_size = (size_type)e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->copy_packed(
+                dest, dest_sz, offsets, array_len, end, beg, datetime
+            );
+        });
+}
+
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshotFromMarkerByHandle_(StreamHandle handle,
+                                           LPCSTR marker, /* NULL for default */
+                                           T* dest, 
+                                           size_type array_len, 
+                                           pDateTimeStamp datetime,                     
+                                           long beg,
+                                           long *get_size)
+{
+    if(marker && !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotFromMarkerByHandle<T>", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+                       /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+            *get_size = (long)(marker 
+                               ? dat->copy_from_named_marker(dat.marker_name(marker),dest,array_len,beg,datetime)
+                               : dat->copy_from_marker(dest,array_len,beg,datetime));
+        });
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesFromMarkerByHandle(StreamHandle handle,
+                                                 double* dest, 
+                                                 size_type array_len, 
+                                                 pDateTimeStamp datetime,                         
+                                                 long beg,
+                                                 long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, NULL, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsFromMarkerByHandle(StreamHandle handle,
+                                                float* dest, 
+                                                size_type array_len, 
+                                                pDateTimeStamp datetime,                         
+                                                long beg,
+                                                long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, NULL, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsFromMarkerByHandle(StreamHandle handle,
+                                                   long long* dest, 
+                                                   size_type array_len, 
+                                                   pDateTimeStamp datetime,                         
+                                                   long beg,
+                                                   long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, NULL, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsFromMarkerByHandle(StreamHandle handle,
+                                               long* dest, 
+                                               size_type array_len, 
+                                               pDateTimeStamp datetime,                         
+                                               long beg,
+                                               long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, NULL, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromMarkerByHandle(StreamHandle handle,
+                                                 LPSTR* dest, 
+                                                 size_type array_len, 
+                                                 size_type str_len, 
+                                                 pDateTimeStamp datetime,                         
+                                                 long beg,
+                                                 long *get_size)
+{
+    return TOSDB_GetStreamSnapshotStringsFromNamedMarkerByHandle(handle, NULL, dest, array_len, 
+                                                                 str_len, datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesFromNamedMarkerByHandle(StreamHandle handle,
+                                                      LPCSTR marker,
+                                                      double* dest, 
+                                                      size_type array_len, 
+                                                      pDateTimeStamp datetime,                         
+                                                      long beg,
+                                                      long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, marker, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsFromNamedMarkerByHandle(StreamHandle handle,
+                                                     LPCSTR marker,
+                                                     float* dest, 
+                                                     size_type array_len, 
+                                                     pDateTimeStamp datetime,                         
+                                                     long beg,
+                                                     long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, marker, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarkerByHandle(StreamHandle handle,
+                                                        LPCSTR marker,
+                                                        long long* dest, 
+                                                        size_type array_len, 
+                                                        pDateTimeStamp datetime,                         
+                                                        long beg,
+                                                        long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, marker, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsFromNamedMarkerByHandle(StreamHandle handle,
+                                                    LPCSTR marker,
+                                                    long* dest, 
+                                                    size_type array_len, 
+                                                    pDateTimeStamp datetime,                         
+                                                    long beg,
+                                                    long *get_size)
+{
+    return TOSDB_GetStreamSnapshotFromMarkerByHandle_(handle, marker, dest, array_len, 
+                                                      datetime, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromNamedMarkerByHandle(StreamHandle handle,
+                                                      LPCSTR marker,
+                                                      LPSTR* dest, 
+                                                      size_type array_len, 
+                                                      size_type str_len, 
+                                                      pDateTimeStamp datetime,                         
+                                                      long beg,
+                                                      long *get_size)
+{
+    if(marker && !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotStringsFromNamedMarkerByHandle", 
+                           TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+                        /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+            *get_size = (long)(marker 
+                               ? dat->copy_from_named_marker(dat.marker_name(marker), dest, array_len, 
+                                                             str_len, beg, datetime)
+                               : dat->copy_from_marker(dest, array_len, str_len, beg, datetime));
+        });
+}
+
+template<typename T> 
+int 
+TOSDB_GetNFromMarkerByHandle_(StreamHandle handle,
+                              LPCSTR marker, /* NULL for default */
+                              T* dest, 
+                              size_type n, 
+                              pDateTimeStamp datetime,
+                              long *get_size)
+{
+    if(marker && !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetNFromMarkerByHandle<T>", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+                         /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+            *get_size = (long)(marker 
+                               ? dat->ncopy_from_named_marker(dat.marker_name(marker),dest,n,datetime)
+                               : dat->ncopy_from_marker(dest,n,datetime));
+        });
+}
+
+int 
+TOSDB_GetNDoublesFromMarkerByHandle(StreamHandle handle,
+                                    double* dest, 
+                                    size_type n, 
+                                    pDateTimeStamp datetime,
+                                    long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNFloatsFromMarkerByHandle(StreamHandle handle,
+                                   float* dest, 
+                                   size_type n, 
+                                   pDateTimeStamp datetime,
+                                   long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongLongsFromMarkerByHandle(StreamHandle handle,
+                                      long long* dest, 
+                                      size_type n, 
+                                      pDateTimeStamp datetime,
+                                      long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongsFromMarkerByHandle(StreamHandle handle,
+                                  long* dest, 
+                                  size_type n, 
+                                  pDateTimeStamp datetime,
+                                  long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, NULL, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNStringsFromMarkerByHandle(StreamHandle handle,
+                                    LPSTR* dest, 
+                                    size_type n, 
+                                    size_type str_len, 
+                                    pDateTimeStamp datetime,
+                                    long *get_size)
+{
+    return TOSDB_GetNStringsFromNamedMarkerByHandle(handle, NULL, dest, n, str_len, 
+                                                    datetime, get_size);
+}
+
+int 
+TOSDB_GetNDoublesFromNamedMarkerByHandle(StreamHandle handle,
+                                         LPCSTR marker,
+                                         double* dest, 
+                                         size_type n, 
+                                         pDateTimeStamp datetime,
+                                         long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNFloatsFromNamedMarkerByHandle(StreamHandle handle,
+                                        LPCSTR marker,
+                                        float* dest, 
+                                        size_type n, 
+                                        pDateTimeStamp datetime,
+                                        long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongLongsFromNamedMarkerByHandle(StreamHandle handle,
+                                           LPCSTR marker,
+                                           long long* dest, 
+                                           size_type n, 
+                                           pDateTimeStamp datetime,
+                                           long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNLongsFromNamedMarkerByHandle(StreamHandle handle,
+                                       LPCSTR marker,
+                                       long* dest, 
+                                       size_type n, 
+                                       pDateTimeStamp datetime,
+                                       long *get_size)
+{
+    return TOSDB_GetNFromMarkerByHandle_(handle, marker, dest, n, datetime, get_size);
+}
+
+int 
+TOSDB_GetNStringsFromNamedMarkerByHandle(StreamHandle handle,
+                                         LPCSTR marker,
+                                         LPSTR* dest, 
+                                         size_type n, 
+                                         size_type str_len, 
+                                         pDateTimeStamp datetime,
+                                         long *get_size)
+{
+    if(marker && !CheckStringLength(marker))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetNStringsFromNamedMarkerByHandle", TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+                        /* O.K. as long as data_stream::MAX_BOUND_SIZE == INT_MAX */
+            *get_size = (long)(marker 
+                               ? dat->ncopy_from_named_marker(dat.marker_name(marker), dest, n, 
+                                                              str_len, datetime)
+                               : dat->ncopy_from_marker(dest, n, str_len, datetime));
+        });
+}
+
+
+int 
+TOSDB_GetStreamStatsByHandle(StreamHandle handle, pStreamStats stats)
+{
+    if(!stats)
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamStatsByHandle", TOSDB_ERROR_GET_STATE,
+        [&](const StreamHandleEntry& e){
+            _copyStreamStats(e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->stats(), stats);
+        });
+}
+
+int 
+TOSDB_GetStreamIndicesBetweenDateTimesByHandle(StreamHandle handle,
+                                               pDateTimeStamp from_datetime, 
+                                               pDateTimeStamp to_datetime, 
+                                               long *end, 
+                                               long *beg)
+{
+    if( !from_datetime || !to_datetime || !end || !beg )
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamIndicesBetweenDateTimesByHandle", 
+                           TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            int e_indx, b_indx;
+            e.db->block->raw_stream_ptr(e.item_id, e.topic_id)->secondary_range(
+                *from_datetime, *to_datetime, &e_indx, &b_indx
+            );
+            *end = e_indx;
+            *beg = b_indx;
+        });
+}
+
+template<typename T> 
+int 
+TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(StreamHandle handle,
+                                                 T* dest, 
+                                                 size_type array_len, 
+                                                 size_type str_len,
+                                                 pDateTimeStamp datetime,
+                                                 pDateTimeStamp from_datetime,
+                                                 pDateTimeStamp to_datetime,
+                                                 long *get_size)
+{
+    if( !from_datetime || !to_datetime || !get_size )
+        return TOSDB_ERROR_BAD_INPUT;
+
+    return _callWithHandle(handle, "TOSDB_GetStreamSnapshotBetweenDateTimesByHandle<T>", 
+                           TOSDB_ERROR_GET_DATA,
+        [&](const StreamHandleEntry& e){
+            int end, beg;
+            long n;
+            TOSDB_RawDataBlock::stream_const_ptr_type dat = 
+                e.db->block->raw_stream_ptr(e.item_id, e.topic_id);
+            /* no pushes between the search and the copy */
+            TOSDB_RawDataBlock::stream_type::lock_scope stream_lock(dat);
+
+            dat->secondary_range(*from_datetime, *to_datetime, &end, &beg);
+            if(end < beg){
+                *get_size = 0;
+                return;
+            }
+            n = (long)_copyBetween(dat, dest, array_len, str_len, end, beg, datetime);
+            *get_size = (n < (end - beg + 1)) ? -n : n;
+        });
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesBetweenDateTimesByHandle(StreamHandle handle,
+                                                       double* dest, 
+                                                       size_type array_len, 
+                                                       pDateTimeStamp datetime, 
+                                                       pDateTimeStamp from_datetime, 
+                                                       pDateTimeStamp to_datetime, 
+                                                       long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(handle, dest, array_len, 0, datetime, 
+                                                            from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsBetweenDateTimesByHandle(StreamHandle handle,
+                                                      float* dest, 
+                                                      size_type array_len, 
+                                                      pDateTimeStamp datetime, 
+                                                      pDateTimeStamp from_datetime, 
+                                                      pDateTimeStamp to_datetime, 
+                                                      long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(handle, dest, array_len, 0, datetime, 
+                                                            from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsBetweenDateTimesByHandle(StreamHandle handle,
+                                                         long long* dest, 
+                                                         size_type array_len, 
+                                                         pDateTimeStamp datetime, 
+                                                         pDateTimeStamp from_datetime, 
+                                                         pDateTimeStamp to_datetime, 
+                                                         long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(handle, dest, array_len, 0, datetime, 
+                                                            from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsBetweenDateTimesByHandle(StreamHandle handle,
+                                                     long* dest, 
+                                                     size_type array_len, 
+                                                     pDateTimeStamp datetime, 
+                                                     pDateTimeStamp from_datetime, 
+                                                     pDateTimeStamp to_datetime, 
+                                                     long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(handle, dest, array_len, 0, datetime, 
+                                                            from_datetime, to_datetime, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsBetweenDateTimesByHandle(StreamHandle handle,
+                                                       LPSTR* dest, 
+                                                       size_type array_len, 
+                                                       size_type str_len,
+                                                       pDateTimeStamp datetime, 
+                                                       pDateTimeStamp from_datetime, 
+                                                       pDateTimeStamp to_datetime, 
+                                                       long *get_size)
+{
+    return TOSDB_GetStreamSnapshotBetweenDateTimesByHandle_(handle, dest, array_len, str_len, datetime, 
+                                                            from_datetime, to_datetime, get_size);
+}
+
+namespace {
+
+/* one entry of a GetManyByHandle call; CALLING CODE MUST HOLD GLOBAL_RLOCK */
+template<typename T>
+int
+_getManyHandleEntry(StreamHandle handle, 
+                    T* dest, 
+                    size_type /* str_len */,
+                    pDateTimeStamp datetime)
+{
+    const StreamHandleEntry *entry = _getHandleEntry(handle);
+
+    if(!entry || !entry->db) /* closed, or its stream was removed; see 'status' */
+        return TOSDB_ERROR_BAD_INPUT;
+
+    try{
+        _copyTyped(*entry, dest, 1, 0, 0, datetime);
+        return 0;
+    }catch(const std::exception& e){
+        TOSDB_LogLimitedH("TOSDB_GetManyByHandle", entry->item.c_str(), e.what());
+        return TOSDB_ERROR_GET_DATA;
+    }
+}
+
+int
+_getManyHandleEntry(StreamHandle handle, 
+                    LPSTR* dest, 
+                    size_type str_len,
+                    pDateTimeStamp datetime)
+{
+    const StreamHandleEntry *entry = _getHandleEntry(handle);
+
+    if(!entry || !entry->db)
+        return TOSDB_ERROR_BAD_INPUT;
+
+    try{
+        entry->db->block->raw_stream_ptr(entry->item_id, entry->topic_id)->copy(
+            dest, 1, str_len, 0, 0, datetime
+        );
+        return 0;
+    }catch(const std::exception& e){
+        TOSDB_LogLimitedH("TOSDB_GetManyByHandle", entry->item.c_str(), e.what());
+        return TOSDB_ERROR_GET_DATA;
+    }
+}
+
+};
+
+template<typename T> 
+int 
+TOSDB_GetManyByHandle_(const StreamHandle* handles, 
+                       size_type n,
+                       T* dest, 
+                       size_type str_len, /* strings only */
+                       pDateTimeStamp datetime,
+                       int* status)
+{
+    int r;
+    size_type nfail = 0;
+
+    if( !handles || !dest )
+        return TOSDB_ERROR_BAD_INPUT;  
+
+    try{
+        /* one lock for all n; handles can point into different blocks */
+        GLOBAL_RLOCK_GUARD;
+        /* --- CRITICAL SECTION --- */
+        for(size_type i = 0; i < n; ++i){
+            r = _getManyHandleEntry(handles[i], dest + i, str_len, 
+                                    datetime ? datetime + i : nullptr);
+            if(r)
+                ++nfail;
+            if(status)
+                status[i] = r;
+        }
+        return nfail ? TOSDB_ERROR_GET_DATA : 0;
+        /* --- CRITICAL SECTION --- */
+
+    }catch(const std::exception& e){
+        TOSDB_LogH("TOSDB_GetManyByHandle<T>", e.what());       
+        return TOSDB_ERROR_GET_DATA;
+
+    }catch(...){ 
+        return TOSDB_ERROR_UNKNOWN;
+    }
+}
+
+int 
+TOSDB_GetManyDoublesByHandle(const StreamHandle* handles, 
+                             size_type n,
+                             double* dest, 
+                             pDateTimeStamp datetime,
+                             int* status)
+{  
+    return TOSDB_GetManyByHandle_(handles, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyFloatsByHandle(const StreamHandle* handles, 
+                            size_type n,
+                            float* dest, 
+                            pDateTimeStamp datetime,
+                            int* status)
+{  
+    return TOSDB_GetManyByHandle_(handles, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyLongLongsByHandle(const StreamHandle* handles, 
+                               size_type n,
+                               long long* dest, 
+                               pDateTimeStamp datetime,
+                               int* status)
+{  
+    return TOSDB_GetManyByHandle_(handles, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyLongsByHandle(const StreamHandle* handles, 
+                           size_type n,
+                           long* dest, 
+                           pDateTimeStamp datetime,
+                           int* status)
+{  
+    return TOSDB_GetManyByHandle_(handles, n, dest, 0, datetime, status);
+}
+
+int 
+TOSDB_GetManyStringsByHandle(const StreamHandle* handles, 
+                             size_type n,
+                             LPSTR* dest, 
+                             size_type str_len,
+                             pDateTimeStamp datetime,
+                             int* status)
+{  
+    return TOSDB_GetManyByHandle_(handles, n, dest, str_len, datetime, status);
+}
+
+/* epoch micro-second versions of the datetime-returning calls */
+
+namespace {
+
+/* DateTimeStamps are broken-down local time (see DDE_Data::_init_datetime) and 
+   mktime has to consult the time zone, so only convert the start of each hour; 
+   consecutive stamps of a stream are almost always in the same one */
+class EpochMicrosConverter
+        : public TOSDB_RawDataBlock::stream_type::secondary_converter {
+    struct tm _hour; 
+    time_t _hour_sec;
+    bool _have_hour;
+
+public:
+    EpochMicrosConverter()
+        :
+            _hour_sec(0),
+            _have_hour(false)
+        {
+        }
+
+    long long
+    operator()(const DateTimeStamp& dts)
+    {
+        const struct tm& t = dts.ctime_struct;
+
+        if(t.tm_mday == 0) /* zeroed, no data */
+            return 0;
+
+        if( !_have_hour 
+            || t.tm_hour != _hour.tm_hour 
+            || t.tm_mday != _hour.tm_mday
+            || t.tm_mon != _hour.tm_mon 
+            || t.tm_year != _hour.tm_year 
+            || t.tm_isdst != _hour.tm_isdst )
+        {
+            _hour = t;
+            _hour.tm_min = 0;
+            _hour.tm_sec = 0;
+            struct tm tmp = _hour; /* mktime normalizes its arg */
+            _hour_sec = mktime(&tmp);
+            _have_hour = (_hour_sec != (time_t)-1);
+            if(!_have_hour)
+                return 0;
+        }
+
+        return ((long long)_hour_sec + (t.tm_min * 60) + t.tm_sec) * 1000000LL 
+               + dts.micro_second;
+    }
+};
+
+
+/* a datetime dest the stream copies convert straight into, so the calls 
+   below don't build any DateTimeStamps; zeroed first since they don't all 
+   fill every elem */
+TOSDB_RawDataBlock::datetime_dest_type
+_epochMicrosDest(long long* epoch_micros, size_type n, EpochMicrosConverter& conv)
+{
+    if(epoch_micros)
+        std::fill(epoch_micros, epoch_micros + n, 0LL);
+
+    return TOSDB_RawDataBlock::datetime_dest_type(epoch_micros, conv);
+}
+
+} /* namespace */
+
+
+int 
+TOSDB_DateTimeStampToEpochMicros(const DateTimeStamp* src, long long* dest, size_type n)
+{
+    if(!dest || (n && !src))
+        return TOSDB_ERROR_BAD_INPUT;
+
+    EpochMicrosConverter conv;
+    for(size_type i = 0; i < n; ++i)
+        dest[i] = conv(src[i]);
+
+    return 0;
+}
+
+
+int 
+TOSDB_GetStreamSnapshotDoublesEpochMicros(LPCSTR id,
+                                          LPCSTR item,
+                                          LPCSTR topic_str,
+                                          double* dest,
+                                          size_type array_len,
+                                          long long* epoch_micros,
+                                          long end,
+                                          long beg)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    _epochMicrosDest(epoch_micros, array_len, conv), end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsEpochMicros(LPCSTR id,
+                                         LPCSTR item,
+                                         LPCSTR topic_str,
+                                         float* dest,
+                                         size_type array_len,
+                                         long long* epoch_micros,
+                                         long end,
+                                         long beg)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    _epochMicrosDest(epoch_micros, array_len, conv), end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsEpochMicros(LPCSTR id,
+                                            LPCSTR item,
+                                            LPCSTR topic_str,
+                                            long long* dest,
+                                            size_type array_len,
+                                            long long* epoch_micros,
+                                            long end,
+                                            long beg)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    _epochMicrosDest(epoch_micros, array_len, conv), end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsEpochMicros(LPCSTR id,
+                                        LPCSTR item,
+                                        LPCSTR topic_str,
+                                        long* dest,
+                                        size_type array_len,
+                                        long long* epoch_micros,
+                                        long end,
+                                        long beg)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshot_(id, item, topic_str, dest, array_len, 
+                                    _epochMicrosDest(epoch_micros, array_len, conv), end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsEpochMicros(LPCSTR id,
+                                          LPCSTR item,
+                                          LPCSTR topic_str,
+                                          LPSTR* dest,
+                                          size_type array_len,
+                                          size_type str_len,
+                                          long long* epoch_micros,
+                                          long end,
+                                          long beg)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotStrings_(id, item, topic_str, dest, array_len, str_len, 
+                                           _epochMicrosDest(epoch_micros, array_len, conv), end, beg);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsPackedEpochMicros(LPCSTR id,
+                                                LPCSTR item,
+                                                LPCSTR topic_str,
+                                                LPSTR dest,
+                                                size_type dest_sz,
+                                                size_type* offsets,
+                                                size_type array_len,
+                                                long long* epoch_micros,
+                                                long end,
+                                                long beg,
+                                                size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotStringsPacked_(id, item, topic_str, dest, dest_sz, offsets, array_len, 
+                                                 _epochMicrosDest(epoch_micros, array_len, conv), end, beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesFromMarkerEpochMicros(LPCSTR id,
+                                                    LPCSTR item,
+                                                    LPCSTR topic_str,
+                                                    double* dest,
+                                                    size_type array_len,
+                                                    long long* epoch_micros,
+                                                    long beg,
+                                                    long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsFromMarkerEpochMicros(LPCSTR id,
+                                                   LPCSTR item,
+                                                   LPCSTR topic_str,
+                                                   float* dest,
+                                                   size_type array_len,
+                                                   long long* epoch_micros,
+                                                   long beg,
+                                                   long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsFromMarkerEpochMicros(LPCSTR id,
+                                                      LPCSTR item,
+                                                      LPCSTR topic_str,
+                                                      long long* dest,
+                                                      size_type array_len,
+                                                      long long* epoch_micros,
+                                                      long beg,
+                                                      long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsFromMarkerEpochMicros(LPCSTR id,
+                                                  LPCSTR item,
+                                                  LPCSTR topic_str,
+                                                  long* dest,
+                                                  size_type array_len,
+                                                  long long* epoch_micros,
+                                                  long beg,
+                                                  long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, NULL, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromMarkerEpochMicros(LPCSTR id,
+                                                    LPCSTR item,
+                                                    LPCSTR topic_str,
+                                                    LPSTR* dest,
+                                                    size_type array_len,
+                                                    size_type str_len,
+                                                    long long* epoch_micros,
+                                                    long beg,
+                                                    long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotStringsFromMarker_(id, item, topic_str, NULL, dest, array_len, str_len, 
+                                                     _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotDoublesFromNamedMarkerEpochMicros(LPCSTR id,
+                                                         LPCSTR item,
+                                                         LPCSTR topic_str,
+                                                         LPCSTR marker,
+                                                         double* dest,
+                                                         size_type array_len,
+                                                         long long* epoch_micros,
+                                                         long beg,
+                                                         long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotFloatsFromNamedMarkerEpochMicros(LPCSTR id,
+                                                        LPCSTR item,
+                                                        LPCSTR topic_str,
+                                                        LPCSTR marker,
+                                                        float* dest,
+                                                        size_type array_len,
+                                                        long long* epoch_micros,
+                                                        long beg,
+                                                        long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongLongsFromNamedMarkerEpochMicros(LPCSTR id,
+                                                           LPCSTR item,
+                                                           LPCSTR topic_str,
+                                                           LPCSTR marker,
+                                                           long long* dest,
+                                                           size_type array_len,
+                                                           long long* epoch_micros,
+                                                           long beg,
+                                                           long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotLongsFromNamedMarkerEpochMicros(LPCSTR id,
+                                                       LPCSTR item,
+                                                       LPCSTR topic_str,
+                                                       LPCSTR marker,
+                                                       long* dest,
+                                                       size_type array_len,
+                                                       long long* epoch_micros,
+                                                       long beg,
+                                                       long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotFromMarker_(id, item, topic_str, marker, dest, array_len, 
+                                              _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetStreamSnapshotStringsFromNamedMarkerEpochMicros(LPCSTR id,
+                                                         LPCSTR item,
+                                                         LPCSTR topic_str,
+                                                         LPCSTR marker,
+                                                         LPSTR* dest,
+                                                         size_type array_len,
+                                                         size_type str_len,
+                                                         long long* epoch_micros,
+                                                         long beg,
+                                                         long *get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetStreamSnapshotStringsFromMarker_(id, item, topic_str, marker, dest, array_len, str_len, 
+                                                     _epochMicrosDest(epoch_micros, array_len, conv), beg, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnDoublesEpochMicros(LPCSTR id,
+                                           LPCSTR topic_str,
+                                           double* dest,
+                                           size_type array_len,
+                                           long long* epoch_micros,
+                                           size_type* item_indices,
+                                           size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, 
+                                     _epochMicrosDest(epoch_micros, array_len, conv), item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnFloatsEpochMicros(LPCSTR id,
+                                          LPCSTR topic_str,
+                                          float* dest,
+                                          size_type array_len,
+                                          long long* epoch_micros,
+                                          size_type* item_indices,
+                                          size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, 
+                                     _epochMicrosDest(epoch_micros, array_len, conv), item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnLongLongsEpochMicros(LPCSTR id,
+                                             LPCSTR topic_str,
+                                             long long* dest,
+                                             size_type array_len,
+                                             long long* epoch_micros,
+                                             size_type* item_indices,
+                                             size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, 
+                                     _epochMicrosDest(epoch_micros, array_len, conv), item_indices, get_size);
+}
+
+int 
+TOSDB_GetItemFrameColumnLongsEpochMicros(LPCSTR id,
+                                         LPCSTR topic_str,
+                                         long* dest,
+                                         size_type array_len,
+                                         long long* epoch_micros,
+                                         size_type* item_indices,
+                                         size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, 0, 
+                                     _epochMicrosDest(epoch_micros, array_len, conv), item_indices, get_size);
+}
 
+int 
+TOSDB_GetItemFrameColumnStringsEpochMicros(LPCSTR id,
+                                           LPCSTR topic_str,
+                                           LPSTR* dest,
+                                           size_type array_len,
+                                           size_type str_len,
+                                           long long* epoch_micros,
+                                           size_type* item_indices,
+                                           size_type* get_size)
+{
+    EpochMicrosConverter conv;
+    return TOSDB_GetItemFrameColumn_(id, topic_str, dest, array_len, str_len, 
+                                     _epochMicrosDest(epoch_micros, array_len, conv), item_indices, get_size);
+}
@@ -15,72 +15,103 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see http://www.gnu.org/licenses.
 */
 
+#ifdef _WIN32
 #include "tos_databridge.h"
+#endif
 #include "concurrency.hpp"
 
-#ifdef CPP_COND_VAR
+#include <algorithm>
 
-bool 
-SignalManager::wait(std::string unq_id)
-{  
-    std::unique_lock<std::mutex> lck(_mtx);     
-    auto iter = _unq_flags.find(unq_id);
-  
-    if(iter == _unq_flags.end())
-        return false;
+/* (CPP_COND_VAR) doesn't need the windows headers so the SignalManager 
+   can be built/tested on its own (see test/c_cpp/bench_signal_manager.cpp) */
+#ifdef CPP_COND_VAR
 
-    _cnd.wait(lck, [=]{ return iter->second.first; });
-    _unq_flags.erase(iter);  
+void 
+SignalManager::set_signal_ID(std::string unq_id)
+{
+    _shard_ty& shard = _shard(unq_id);
 
-    return iter->second.second;  
+    std::lock_guard<std::mutex> lck(shard.mtx); 
+    /* --- CRITICAL SECTION --- */
+    shard.slots[unq_id].emplace_back(std::this_thread::get_id());
+    /* --- CRITICAL SECTION --- */
 }
 
-bool 
-SignalManager::wait_for(std::string unq_id, size_t timeout)
+
+bool
+SignalManager::_wait(const std::string& unq_id, size_t timeout, bool use_timeout)
 {
     bool wait_res;
-    {
-        std::unique_lock<std::mutex> lck(_mtx);     
-        auto iter = _unq_flags.find(unq_id);
+    _shard_ty& shard = _shard(unq_id);
+    std::thread::id me = std::this_thread::get_id();
+
+    std::unique_lock<std::mutex> lck(shard.mtx);     
+    /* --- CRITICAL SECTION --- */
+    auto iter = shard.slots.find(unq_id);
+    if(iter == shard.slots.end())
+        return false;
 
-        if(iter == _unq_flags.end())
-            return false;
+    _slots_ty& slots = iter->second;
+    _slots_ty::iterator slot = std::find_if(slots.begin(), slots.end(), 
+                                            [=](const _slot_ty& s){ return s.owner == me; });
+    if(slot == slots.end())
+        return false;
 
-        wait_res = _cnd.wait_for(lck, std::chrono::milliseconds(timeout), 
-                                 [=]{ return iter->second.first; });
+    /* only signal() on *this* slot notifies its condition */
+    auto pred = [=]{ return slot->signaled; };
+    if(use_timeout)
+        wait_res = slot->cnd.wait_for(lck, std::chrono::milliseconds(timeout), pred);
+    else{
+        slot->cnd.wait(lck, pred);
+        wait_res = true;
+    }
+    wait_res = wait_res && slot->secondary;
+
+    /* list nodes (and the map's) don't move while we wait, 'slots' is still good */
+    slots.erase(slot);
+    if(slots.empty())
+        shard.slots.erase(unq_id);
 
-        wait_res = wait_res && iter->second.second;
-        _unq_flags.erase(iter); 
-    } 
     return wait_res;
+    /* --- CRITICAL SECTION --- */
 }
 
-void 
-SignalManager::set_signal_ID(std::string unq_id)
+
+bool 
+SignalManager::wait(std::string unq_id)
+{  
+    return _wait(unq_id, 0, false);
+}
+
+
+bool 
+SignalManager::wait_for(std::string unq_id, size_t timeout)
 {
-    std::lock_guard<std::mutex> lck(_mtx); 
-    /* --- CRITICAL SECTION --- */
-    _unq_flags.insert(_sig_pair_ty(unq_id,_flag_pair_ty(false,true)));
-   /* --- CRITICAL SECTION --- */
+    return _wait(unq_id, timeout, true);
 }
 
+
 bool 
 SignalManager::signal(std::string unq_id, bool secondary)
 {
-    {      
-        std::lock_guard<std::mutex> lck(_mtx); 
-        /* --- CRITICAL SECTION --- */      
-        auto iter = _unq_flags.find(unq_id);
-
-        if(iter == _unq_flags.end()) 
-            return false;    
-
-        iter->second.first = true;
-        iter->second.second = secondary;  
-        /* --- CRITICAL SECTION --- */
-    }  
-    _cnd.notify_one();   
-    return true;
+    _shard_ty& shard = _shard(unq_id);
+
+    std::lock_guard<std::mutex> lck(shard.mtx); 
+    /* --- CRITICAL SECTION --- */      
+    auto iter = shard.slots.find(unq_id);
+    if(iter == shard.slots.end()) 
+        return false;    
+
+    for(_slot_ty& slot : iter->second){
+        if(!slot.signaled){
+            slot.signaled = true;
+            slot.secondary = secondary;  
+            slot.cnd.notify_one(); /* exactly one waiter per slot */
+            return true;
+        }
+    }
+    return false;
+    /* --- CRITICAL SECTION --- */
 }
 
 #else
@@ -88,71 +119,92 @@ SignalManager::signal(std::string unq_id, bool secondary)
 void 
 SignalManager::set_signal_ID(std::string unq_id)
 {    
-    WinLockGuard lock(_mtx);
+    _shard_ty& shard = _shard(unq_id);
+
+    WinLockGuard lock(shard.mtx);
     /* --- CRITICAL SECTION --- */
-    _unq_flags.insert(std::pair<std::string, volatile bool>(unq_id, true));  
+    shard.slots[unq_id].emplace_back(GetCurrentThreadId());
     /* --- CRITICAL SECTION --- */
 }
 
-bool 
-SignalManager::wait(std::string unq_id)
-{      
-    std::map<std::string, volatile bool>::iterator iter;
-    {
-        WinLockGuard lock(_mtx);    
-        /* --- CRITICAL SECTION --- */
-        iter = _unq_flags.find(unq_id);
-        if(iter == _unq_flags.end())
-            return false;
-        /* --- CRITICAL SECTION --- */
-    }
-    WaitForSingleObject(_event, INFINITE);  
 
-    WinLockGuard lock(_mtx);
+bool
+SignalManager::_wait(const std::string& unq_id, DWORD timeout)
+{
+    DWORD beg;
+    DWORD elapsed;
+    bool b_res;
+    _shard_ty& shard = _shard(unq_id);
+    DWORD me = GetCurrentThreadId();
+
+    WinLockGuard lock(shard.mtx);
     /* --- CRITICAL SECTION --- */
-    _unq_flags.erase(iter); 
-    return iter->second;    
+    auto iter = shard.slots.find(unq_id);
+    if(iter == shard.slots.end())
+        return false;
+
+    _slots_ty& slots = iter->second;
+    _slots_ty::iterator slot = std::find_if(slots.begin(), slots.end(), 
+                                            [=](const _slot_ty& s){ return s.owner == me; });
+    if(slot == slots.end())
+        return false;
+
+    /* only signal() on *this* slot wakes its condition; loop for spurious wake-ups */
+    beg = GetTickCount();
+    while(!slot->signaled){
+        elapsed = GetTickCount() - beg;
+        if(timeout != INFINITE && elapsed >= timeout)
+            break;
+        SleepConditionVariableCS(&slot->cnd, shard.mtx.native_handle(), 
+                                 (timeout == INFINITE) ? INFINITE : (timeout - elapsed));
+    }
+    b_res = slot->signaled && slot->secondary;
+
+    /* list nodes (and the map's) don't move while we wait, 'slots' is still good */
+    slots.erase(slot);
+    if(slots.empty())
+        shard.slots.erase(unq_id);
+
+    return b_res;
     /* --- CRITICAL SECTION --- */
+}
+
+
+bool 
+SignalManager::wait(std::string unq_id)
+{      
+    return _wait(unq_id, INFINITE);
 }    
 
+
 bool 
 SignalManager::wait_for(std::string unq_id, size_type timeout)
 {    
-    std::map<std::string, volatile bool>::iterator iter;
-    DWORD wait_res; 
-    bool b_res;
-    {
-       WinLockGuard lock(_mtx);   
-       /* --- CRITICAL SECTION --- */
-       iter = _unq_flags.find(unq_id);
-       if(iter == _unq_flags.end())
-           return false;     
-       /* --- CRITICAL SECTION --- */
-    }
-    wait_res = WaitForSingleObject(_event, timeout);  
-
-    WinLockGuard lock(_mtx); 
-    /* --- CRITICAL SECTION --- */
-    b_res = iter->second;
-    _unq_flags.erase(iter);   
-    return (wait_res == WAIT_TIMEOUT) ? false : b_res;
-    /* --- CRITICAL SECTION --- */
+    return _wait(unq_id, timeout);
 }
 
+
 bool 
 SignalManager::signal(std::string unq_id, bool secondary)
 {  
-    {
-        WinLockGuard lock(_mtx);
-        /* --- CRITICAL SECTION --- */
-        std::map<std::string,volatile bool>::iterator iter = _unq_flags.find(unq_id);
-        if(iter == _unq_flags.end())       
-            return false;  
-        iter->second = secondary;
-        /* --- CRITICAL SECTION --- */
+    _shard_ty& shard = _shard(unq_id);
+
+    WinLockGuard lock(shard.mtx);
+    /* --- CRITICAL SECTION --- */
+    auto iter = shard.slots.find(unq_id);
+    if(iter == shard.slots.end())       
+        return false;  
+
+    for(_slot_ty& slot : iter->second){
+        if(!slot.signaled){
+            slot.signaled = true;
+            slot.secondary = secondary;  
+            WakeConditionVariable(&slot.cnd); /* exactly one waiter per slot */
+            return true;
+        }
     }
-    SetEvent(_event); 
-    return true;
+    return false;
+    /* --- CRITICAL SECTION --- */
 }
 
 
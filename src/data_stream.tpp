@@ -1,5 +1,727 @@
 #include "data_stream.hpp"
 
+template<typename Ty, bool IsNumeric>
+void
+DataStreamStatsTracker<Ty,IsNumeric>::push(const Ty& v)
+{
+    double x = (double)v;
+
+    if(!_count){ 
+        /* shift sums by first value to limit cancellation in variance */
+        _shift = x;
+        _sum = _sum_sq = _wsum = _wsum_val = 0;
+    }
+
+    while(!_min_q.empty() && _min_q.back().second >= x)
+        _min_q.pop_back();
+    _min_q.push_back(_seq_val_ty(_seq, x));
+
+    while(!_max_q.empty() && _max_q.back().second <= x)
+        _max_q.pop_back();
+    _max_q.push_back(_seq_val_ty(_seq, x));
+
+    _sum += (x - _shift);
+    _sum_sq += (x - _shift) * (x - _shift);
+
+    _weights.push_front(_weight);
+    _wsum += _weight;
+    _wsum_val += _weight * x;
+
+    ++_seq;
+    ++_count;
+}
+
+template<typename Ty, bool IsNumeric>
+void
+DataStreamStatsTracker<Ty,IsNumeric>::evict(const Ty& v)
+{
+    double x = (double)v;
+    unsigned long long oldest;
+
+    if(!_count)
+        return;
+
+    oldest = _seq - _count;
+    if(!_min_q.empty() && _min_q.front().first == oldest)
+        _min_q.pop_front();
+    if(!_max_q.empty() && _max_q.front().first == oldest)
+        _max_q.pop_front();
+
+    _sum -= (x - _shift);
+    _sum_sq -= (x - _shift) * (x - _shift);
+
+    _wsum -= _weights.back();
+    _wsum_val -= _weights.back() * x;
+    _weights.pop_back();
+
+    --_count;
+}
+
+template<typename Ty, bool IsNumeric>
+DataStreamStats
+DataStreamStatsTracker<Ty,IsNumeric>::get() const
+{
+    DataStreamStats s = DataStreamStats();
+    double mean_shifted;
+
+    s.count = _count;
+    if(!_count)
+        return s;
+
+    mean_shifted = _sum / _count;
+
+    s.min = _min_q.front().second;
+    s.max = _max_q.front().second;
+    s.mean = _shift + mean_shifted;
+    /* running sums can drift slightly negative */
+    s.variance = std::max<double>(_sum_sq / _count - mean_shifted * mean_shifted, 0.0);
+    s.vwap = (_wsum > 0) ? (_wsum_val / _wsum) : s.mean;
+
+    return s;
+}
+
+
+template<typename Ty>
+DataStreamMappedRing<Ty>::DataStreamMappedRing(size_t cap)
+    :
+        _file(INVALID_HANDLE_VALUE),
+        _mapping(NULL),
+        _data(nullptr),
+        _cap(std::max<size_t>(cap,1)),
+        _head(0),
+        _count(0)
+    {
+        char dir[MAX_PATH];
+        char path[MAX_PATH];
+        unsigned long long nbytes = (unsigned long long)_cap * sizeof(Ty);
+
+        if( !GetTempPathA(MAX_PATH, dir) || !GetTempFileNameA(dir, "tdb", 0, path) )
+            throw DataStreamError("failed to get temp file for mapped ring");
+
+        _file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 
+                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+        if(_file == INVALID_HANDLE_VALUE)
+            throw DataStreamError("failed to create file for mapped ring");
+
+        _mapping = CreateFileMappingA(_file, NULL, PAGE_READWRITE, 
+                                      (DWORD)(nbytes >> 32), (DWORD)nbytes, NULL);
+        if(!_mapping){
+            _close();
+            throw DataStreamError("failed to create file mapping for mapped ring");
+        }
+
+        _data = (Ty*)MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if(!_data){
+            _close();
+            throw DataStreamError("failed to map view of mapped ring");
+        }
+    }
+
+template<typename Ty>
+void
+DataStreamMappedRing<Ty>::_close()
+{
+    if(_data){
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+
+    if(_mapping){
+        CloseHandle(_mapping);
+        _mapping = NULL;
+    }
+
+    if(_file != INVALID_HANDLE_VALUE){
+        CloseHandle(_file); /* deletes the file */
+        _file = INVALID_HANDLE_VALUE;
+    }
+}
+
+template<typename Ty>
+void
+DataStreamMappedRing<Ty>::capacity(size_t cap)
+{
+    HANDLE mapping;
+    Ty *data;
+    size_t tail;
+    unsigned long long nbytes;
+
+    cap = std::max<size_t>(cap,1);
+    if(cap == _cap)
+        return;
+
+    if(cap < _cap){ /* newest to the start of the view, drop the oldest */
+        std::rotate(_data, _data + _head, _data + _cap);
+        _head = 0;
+        _cap = cap;
+        _count = std::min<size_t>(_count, cap);
+        return;
+    }
+
+    /* a bigger mapping of the same file extends it; the old view stays 
+       good until the new one is mapped so a failure changes nothing */
+    nbytes = (unsigned long long)cap * sizeof(Ty);
+    mapping = CreateFileMappingA(_file, NULL, PAGE_READWRITE, 
+                                 (DWORD)(nbytes >> 32), (DWORD)nbytes, NULL);
+    if(!mapping)
+        throw DataStreamError("failed to grow file mapping for mapped ring");
+
+    data = (Ty*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if(!data){
+        CloseHandle(mapping);
+        throw DataStreamError("failed to map view of grown mapped ring");
+    }
+
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+    _mapping = mapping;
+    _data = data;
+
+    /* newest run ([_head, _cap)) to the end of the bigger view */
+    tail = _cap - _head;
+    if(_head)
+        std::copy_backward(_data + _head, _data + _cap, _data + cap);
+    _head = _head ? (cap - tail) : 0;
+    _cap = cap;
+}
+
+template<typename Ty>
+DataStreamMappedRing<Ty>*
+DataStreamMappedRing<Ty>::clone() const
+{
+    DataStreamMappedRing *r = new DataStreamMappedRing(_cap);
+
+    r->_count = copy(0, _count, r->_data); /* newest at r->_data[0] */
+    return r;
+}
+
+template<typename Ty>
+size_t
+DataStreamMappedRing<Ty>::copy(size_t beg, size_t end, Ty *dest) const
+{
+    size_t b, n, run;
+
+    end = std::min<size_t>(end, _count);
+    if(beg >= end)
+        return 0;
+
+    n = end - beg;
+    b = _pos(beg);
+    run = std::min<size_t>(n, _cap - b);
+
+    std::copy(_data + b, _data + b + run, dest);
+    if(run < n) /* wrapped */
+        std::copy(_data, _data + (n - run), dest + run);
+
+    return n;
+}
+
+
+inline void
+DataStreamCodecBase::_bit_writer::put(unsigned long long v, unsigned int n)
+{
+    unsigned int take;
+
+    while(n){
+        take = std::min<unsigned int>(n, 8 - _used);
+        _cur = (_cur << take) | (unsigned int)((v >> (n - take)) & ((1u << take) - 1));
+        _used += take;
+        n -= take;
+        if(_used == 8){
+            _out.push_back((unsigned char)_cur);
+            _cur = _used = 0;
+        }
+    }
+}
+
+inline void
+DataStreamCodecBase::_bit_writer::flush()
+{
+    if(_used){
+        _out.push_back((unsigned char)(_cur << (8 - _used)));
+        _cur = _used = 0;
+    }
+}
+
+inline unsigned long long
+DataStreamCodecBase::_bit_reader::get(unsigned int n)
+{
+    unsigned long long v = 0;
+    unsigned int take;
+
+    while(n){
+        take = std::min<unsigned int>(n, 8 - _used);
+        v = (v << take) | ((*_in >> (8 - _used - take)) & ((1u << take) - 1));
+        _used += take;
+        n -= take;
+        if(_used == 8){
+            ++_in;
+            _used = 0;
+        }
+    }
+
+    return v;
+}
+
+inline unsigned int
+DataStreamCodecBase::_clz64(unsigned long long x)
+{
+    unsigned int n = 0;
+
+    if(!(x >> 32)){ n += 32; x <<= 32; }
+    if(!(x >> 48)){ n += 16; x <<= 16; }
+    if(!(x >> 56)){ n += 8; x <<= 8; }
+    if(!(x >> 60)){ n += 4; x <<= 4; }
+    if(!(x >> 62)){ n += 2; x <<= 2; }
+    if(!(x >> 63)){ n += 1; }
+
+    return n;
+}
+
+inline unsigned int
+DataStreamCodecBase::_ctz64(unsigned long long x)
+{
+    unsigned int n = 0;
+
+    if(!(x & 0xFFFFFFFFULL)){ n += 32; x >>= 32; }
+    if(!(x & 0xFFFF)){ n += 16; x >>= 16; }
+    if(!(x & 0xFF)){ n += 8; x >>= 8; }
+    if(!(x & 0xF)){ n += 4; x >>= 4; }
+    if(!(x & 0x3)){ n += 2; x >>= 2; }
+    if(!(x & 0x1)){ n += 1; }
+
+    return n;
+}
+
+template<typename Ty>
+double
+DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>::_pow10(int d)
+{
+    static const double p[] = {1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+    return p[d];
+}
+
+template<typename Ty>
+int
+DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>::_decimals(const Ty *src, size_t n)
+{
+    static const double LIMIT = 9007199254740992.0; /* 2**53 */
+    double scale, x;
+    long long iv;
+    Ty r;
+    size_t i;
+
+    for(int d = 0; d <= _MAX_DECIMALS; ++d){
+        scale = _pow10(d);
+        for(i = 0; i < n; ++i){
+            x = (double)src[i] * scale;
+            if( !(x < LIMIT && x > -LIMIT) ) /* NaN/inf too */
+                return -1;
+            iv = (long long)((x < 0) ? (x - 0.5) : (x + 0.5));
+            r = (Ty)((double)iv / scale); /* same as decode */
+            if( memcmp(&r, src + i, sizeof(Ty)) )
+                break;
+        }
+        if(i == n)
+            return d;
+    }
+
+    return -1;
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>::encode(const Ty *src, 
+                                                  size_t n, 
+                                                  std::vector<unsigned char>& out)
+{
+    int d = _decimals(src, n);
+    double scale, x;
+    unsigned long long prev = 0, iv;
+
+    if(d < 0){
+        out.push_back((unsigned char)_XOR_MODE);
+        _encode_xor(src, n, out);
+        return;
+    }
+
+    out.push_back((unsigned char)d);
+    scale = _pow10(d);
+    for(size_t i = 0; i < n; ++i){
+        x = (double)src[i] * scale;
+        iv = (unsigned long long)(long long)((x < 0) ? (x - 0.5) : (x + 0.5));
+        _put_varint(out, _zigzag<unsigned long long>(iv - prev));
+        prev = iv;
+    }
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>::_encode_xor(const Ty *src, 
+                                                       size_t n, 
+                                                       std::vector<unsigned char>& out)
+{
+    _my_word_ty prev = 0, cur, x;
+    unsigned int lz, tz, plz = _bits, ptz = 0; /* plz == _bits: no window yet */
+    _bit_writer bits(out);
+
+    for(size_t i = 0; i < n; ++i){
+        memcpy(&cur, src + i, sizeof(_my_word_ty));
+        x = cur ^ prev;
+        prev = cur;
+
+        if(!x){ /* same value */
+            bits.put(0, 1);
+            continue;
+        }
+
+        lz = std::min<unsigned int>(_clz64(x) - (64 - _bits), 31);
+        tz = _ctz64(x);
+
+        if(plz != _bits && lz >= plz && tz >= ptz){ /* fits previous window */
+            bits.put(2, 2);
+            bits.put(x >> ptz, _bits - plz - ptz);
+        }else{
+            bits.put(3, 2);
+            bits.put(lz, 5);
+            bits.put(_bits - lz - tz - 1, 6);
+            bits.put(x >> tz, _bits - lz - tz);
+            plz = lz;
+            ptz = tz;
+        }
+    }
+
+    bits.flush();
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_XOR>::decode(const unsigned char *in, size_t n, Ty *dest)
+{
+    unsigned char mode = *in++;
+    unsigned long long iv = 0;
+    double scale;
+    _my_word_ty prev = 0;
+    unsigned int lz = 0, tz = 0, m;
+
+    if(mode != _XOR_MODE){
+        scale = _pow10(mode);
+        for(size_t i = 0; i < n; ++i){
+            iv += _unzigzag<unsigned long long>(_get_varint(in));
+            dest[i] = (Ty)((double)(long long)iv / scale);
+        }
+        return;
+    }
+
+    _bit_reader bits(in);
+    for(size_t i = 0; i < n; ++i){
+        if(bits.get(1)){
+            if(bits.get(1)){ /* new window */
+                lz = (unsigned int)bits.get(5);
+                m = (unsigned int)bits.get(6) + 1;
+                tz = _bits - lz - m;
+            }
+            prev ^= (_my_word_ty)(bits.get(_bits - lz - tz) << tz);
+        }
+        memcpy(dest + i, &prev, sizeof(_my_word_ty));
+    }
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_DELTA>::encode(const Ty *src, 
+                                                    size_t n, 
+                                                    std::vector<unsigned char>& out)
+{
+    _my_word_ty prev = 0;
+
+    for(size_t i = 0; i < n; ++i){
+        _put_varint(out, _zigzag<_my_word_ty>((_my_word_ty)src[i] - prev));
+        prev = (_my_word_ty)src[i];
+    }
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_DELTA>::decode(const unsigned char *in, size_t n, Ty *dest)
+{
+    _my_word_ty prev = 0;
+
+    for(size_t i = 0; i < n; ++i){
+        prev += _unzigzag<_my_word_ty>((_my_word_ty)_get_varint(in));
+        dest[i] = (Ty)prev;
+    }
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_LANES>::encode(const Ty *src, 
+                                                    size_t n, 
+                                                    std::vector<unsigned char>& out)
+{
+    unsigned int cur[_nlanes], prev[_nlanes], delta[_nlanes], dod[_nlanes];
+    unsigned long long mask;
+    size_t l;
+
+    memset(prev, 0, sizeof(prev));
+    memset(delta, 0, sizeof(delta));
+
+    for(size_t i = 0; i < n; ++i){
+        memcpy(cur, src + i, sizeof(Ty));
+
+        mask = 0;
+        for(l = 0; l < _nlanes; ++l){
+            dod[l] = (cur[l] - prev[l]) - delta[l];
+            delta[l] = cur[l] - prev[l];
+            prev[l] = cur[l];
+            if(dod[l])
+                mask |= (1ULL << l);
+        }
+
+        _put_varint(out, mask);
+        for(l = 0; l < _nlanes; ++l){
+            if(dod[l])
+                _put_varint(out, _zigzag<unsigned int>(dod[l]));
+        }
+    }
+}
+
+template<typename Ty>
+void
+DataStreamCodec<Ty, DATASTREAM_CODEC_LANES>::decode(const unsigned char *in, size_t n, Ty *dest)
+{
+    unsigned int prev[_nlanes], delta[_nlanes];
+    unsigned long long mask;
+    size_t l;
+
+    memset(prev, 0, sizeof(prev));
+    memset(delta, 0, sizeof(delta));
+
+    for(size_t i = 0; i < n; ++i){
+        mask = _get_varint(in);
+        for(l = 0; l < _nlanes; ++l){
+            if(mask & (1ULL << l))
+                delta[l] += _unzigzag<unsigned int>((unsigned int)_get_varint(in));
+            prev[l] += delta[l];
+        }
+        memcpy(dest + i, prev, sizeof(Ty));
+    }
+}
+
+
+template<typename Ty>
+const Ty*
+DataStreamPackedRing<Ty>::_decode(size_t bindx) const
+{
+    unsigned long long seq = _front_seq - bindx;
+
+    if(_decoded_seq != seq){
+        _decoded.resize(BLOCK_SZ);
+        _my_codec_ty::decode(&_blocks[bindx][0], BLOCK_SZ, &_decoded[0]);
+        _decoded_seq = seq;
+    }
+
+    return &_decoded[0];
+}
+
+template<typename Ty>
+void
+DataStreamPackedRing<Ty>::_drop_dead_blocks()
+{ /* oldest block is dead if _count doesn't reach into it */
+    while( !_blocks.empty() 
+           && _count <= _open.size() + (_blocks.size() - 1) * BLOCK_SZ )
+    {
+        _blocks.pop_back();
+    }
+}
+
+template<typename Ty>
+size_t
+DataStreamPackedRing<Ty>::footprint() const
+{
+    size_t n = (_open.capacity() + _decoded.capacity()) * sizeof(Ty);
+
+    for(auto& b : _blocks)
+        n += b.capacity();
+
+    return n;
+}
+
+template<typename Ty>
+const Ty&
+DataStreamPackedRing<Ty>::operator[](size_t indx) const
+{
+    if(indx < _open.size())
+        return _open[_open.size() - 1 - indx];
+
+    indx -= _open.size();
+    return _decode(indx / BLOCK_SZ)[BLOCK_SZ - 1 - (indx % BLOCK_SZ)];
+}
+
+template<typename Ty>
+void
+DataStreamPackedRing<Ty>::push_front(const Ty& v)
+{
+    _open.push_back(v);
+
+    if(_open.size() == BLOCK_SZ){ /* seal it */
+        _blocks.push_front(_my_block_ty());
+        _my_codec_ty::encode(&_open[0], BLOCK_SZ, _blocks.front());
+        _blocks.front().shrink_to_fit();
+        _open.clear();
+        ++_front_seq;
+    }
+
+    if(_count < _cap)
+        ++_count;
+    else
+        _drop_dead_blocks();
+}
+
+template<typename Ty>
+size_t
+DataStreamPackedRing<Ty>::copy(size_t beg, size_t end, Ty *dest) const
+{
+    size_t osz = _open.size();
+    size_t n = 0;
+    size_t b, e, bindx;
+    const Ty *block;
+
+    end = std::min<size_t>(end, _count);
+    if(beg >= end)
+        return 0;
+
+    for( ; beg < end && beg < osz; ++beg, ++n)
+        dest[n] = _open[osz - 1 - beg];
+
+    while(beg < end){ /* one block at a time, newest first */
+        bindx = (beg - osz) / BLOCK_SZ;
+        b = (beg - osz) % BLOCK_SZ;
+        e = b + (end - beg);
+        if(e > BLOCK_SZ)
+            e = BLOCK_SZ;
+        block = _decode(bindx);
+        std::reverse_copy(block + BLOCK_SZ - e, block + BLOCK_SZ - b, dest + n);
+        n += (e - b);
+        beg += (e - b);
+    }
+
+    return n;
+}
+
+
+template<typename Ty, typename Allocator>
+void
+DataStreamDeque<Ty,Allocator>::resize(size_t sz)
+{
+    if(sz >= size())
+        return;
+
+    if(sz >= _hot.size()){
+        while(_cold->size() > sz - _hot.size())
+            _cold->pop_back();
+    }else{
+        if(_cold)
+            _cold->clear();
+        _hot.resize(sz);
+    }
+}
+
+template<typename Ty, typename Allocator>
+void
+DataStreamDeque<Ty,Allocator>::spill(size_t hot_sz, size_t bound, bool compress)
+{
+    std::unique_ptr<_my_cold_ty> cold;
+
+    if(hot_sz && hot_sz < bound){
+        cold.reset( 
+            compress 
+                ? _new_packed(bound - hot_sz, std::integral_constant<bool,compress_supported>())
+                : _new_mapped(bound - hot_sz, std::integral_constant<bool,spill_supported>())
+        );
+    }
+
+    if(_cold){ /* back to the heap, oldest last */
+        for(size_t i = 0; i < _cold->size(); ++i)
+            _hot.push_back((*_cold)[i]);
+    }
+
+    _cold = std::move(cold);
+    _hot_req = hot_sz;
+    _hot_sz = _cold ? hot_sz : 0; /* no cold tier (hot_sz >= bound), no threshold */
+    _compress = compress;
+
+    if(_cold && _hot.size() > hot_sz){ /* oldest first, so it ends up at the back */
+        for(size_t i = _hot.size(); i > hot_sz; --i)
+            _cold->push_front(_hot[i-1]);
+        _hot.resize(hot_sz);
+        _hot.shrink_to_fit();
+    }
+}
+
+template<typename Ty, typename Allocator>
+void
+DataStreamDeque<Ty,Allocator>::rebound(size_t bound)
+{
+    if( (bool)_cold != (_hot_req && _hot_req < bound) ) /* split changes */
+        spill(_hot_req, bound, _compress);
+    else if(_cold)
+        _cold->capacity(bound - _hot_sz);
+}
+
+template<typename Ty, typename Allocator>
+size_t
+DataStreamDeque<Ty,Allocator>::copy(size_t beg, size_t end, Ty *dest) const
+{
+    size_t hsz = _hot.size();
+    size_t n = 0;
+
+    end = std::min<size_t>(end, size());
+    if(beg >= end)
+        return 0;
+
+    if(beg < hsz)
+        n = std::copy(_hot.cbegin() + beg, _hot.cbegin() + std::min<size_t>(end, hsz), dest) - dest;
+
+    if(end > hsz)
+        n += _cold->copy(std::max<size_t>(beg, hsz) - hsz, end - hsz, dest + n);
+
+    return n;
+}
+
+template<typename Ty, typename Allocator>
+template<typename OutTy, typename Conv>
+size_t
+DataStreamDeque<Ty,Allocator>::copy(size_t beg, size_t end, OutTy *dest, Conv& conv) const
+{ /* elem by elem; a packed cold tier decodes each block once (see _decode) */
+    size_t n = 0;
+
+    end = std::min<size_t>(end, size());
+    for( ; beg < end; ++beg, ++n)
+        dest[n] = conv((*this)[beg]);
+
+    return n;
+}
+
+template<typename Ty, typename Allocator>
+template<typename Pred>
+size_t
+DataStreamDeque<Ty,Allocator>::partition_point(size_t beg, Pred pred) const
+{
+    size_t end = size();
+    size_t mid;
+
+    while(beg < end){
+        mid = beg + (end - beg) / 2;
+        if(pred((*this)[mid]))
+            beg = mid + 1;
+        else
+            end = mid;
+    }
+
+    return beg;
+}
+
 DATASTREAM_INTERFACE_TEMPLATE
 template<typename InTy, typename OutTy>
 size_t 
@@ -7,7 +729,7 @@ DATASTREAM_INTERFACE_CLASS::_copy(OutTy *dest,
                                   size_t sz, 
                                   int end, 
                                   int beg, 
-                                  typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec) const
+                                  typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec) const
 {  
     size_t ret;
 
@@ -29,7 +751,7 @@ long long
 DATASTREAM_INTERFACE_CLASS::_copy_using_atomic_marker(OutTy *dest, 
                                                       size_t sz,         
                                                       int beg, 
-                                                      typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec) const
+                                                      typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec) const
 {  
     long long ret;
 
@@ -50,7 +772,7 @@ template<typename InTy, typename OutTy>
 long long 
 DATASTREAM_INTERFACE_CLASS::_ncopy_using_atomic_marker(OutTy *dest, 
                                                        size_t sz,                                                              
-                                                       typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec) const
+                                                       typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec) const
 {  
     long long ret;
 
@@ -73,7 +795,7 @@ DATASTREAM_INTERFACE_CLASS::copy(char **dest,
                                  size_t str_sz, 
                                  int end = -1, 
                                  int beg = 0 , 
-                                 typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const 
+                                 typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const 
 { 
     BuildThrowTypeError<std::string*,false>("copy()");  
     return 0;
@@ -85,7 +807,7 @@ DATASTREAM_INTERFACE_CLASS::copy(std::string *dest,
                                  size_t sz, 
                                  int end = -1, 
                                  int beg = 0, 
-                                 typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const
+                                 typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const
 {
     size_t ret;
 
@@ -107,7 +829,7 @@ DATASTREAM_INTERFACE_CLASS::copy_from_marker(char **dest,
                                              size_t dest_sz, 
                                              size_t str_sz,             
                                              int beg = 0, 
-                                             typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const 
+                                             typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const 
 { 
     BuildThrowTypeError<std::string*,false>("copy_from_marker()");  
     return 0;
@@ -118,7 +840,7 @@ long long
 DATASTREAM_INTERFACE_CLASS::copy_from_marker(std::string *dest, 
                                              size_t sz,                     
                                              int beg = 0, 
-                                             typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const
+                                             typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const
 {
     long long ret;
 
@@ -139,7 +861,7 @@ long long
 DATASTREAM_INTERFACE_CLASS::ncopy_from_marker(char **dest, 
                                               size_t dest_sz, 
                                               size_t str_sz,                                                       
-                                              typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const 
+                                              typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const 
 { 
     BuildThrowTypeError<std::string*,false>("ncopy_from_marker()");  
     return 0;
@@ -149,7 +871,7 @@ DATASTREAM_INTERFACE_TEMPLATE
 long long 
 DATASTREAM_INTERFACE_CLASS::ncopy_from_marker(std::string *dest, 
                                               size_t sz,                                                                
-                                              typename DATASTREAM_INTERFACE_CLASS::secondary_ty *sec = nullptr) const
+                                              typename DATASTREAM_INTERFACE_CLASS::secondary_dest sec = nullptr) const
 {
     long long ret;
 
@@ -175,8 +897,10 @@ DATASTREAM_PRIMARY_CLASS::_push(const Ty v)
     if(!_push_has_priority) 
         _mtx->lock(); /* block regardless */  
     /* --- CRITICAL SECTION --- */
+    _stats_on_push(v);
     _deque_primary.push_front(v); 
-    _deque_primary.pop_back();     
+    if(_deque_primary.size() > _qbound) /* grow on demand until we hit bound */
+        _deque_primary.pop_back();     
     _incr_internal_counts();
     /* --- CRITICAL SECTION --- */
     _mtx->unlock();
@@ -185,11 +909,14 @@ DATASTREAM_PRIMARY_CLASS::_push(const Ty v)
 DATASTREAM_PRIMARY_TEMPLATE
 template<typename T>
 bool
-DATASTREAM_PRIMARY_CLASS::_check_adj(int& end, int& beg, const std::deque<T,Allocator>& d) const
-{ 
-    int sz = (int)d.size(); /* O.K. sz can't be > INT_MAX  */
-    if(_qbound != sz)
-        throw DataStreamSizeViolation("internal size/bounds violation", _qbound, sz);      
+DATASTREAM_PRIMARY_CLASS::_check_adj(int& end, int& beg, const DataStreamDeque<T,Allocator>& d) const
+{ /* 
+    * indices are checked against the logical bound, not the deque; slots 
+    * past _qcount haven't been allocated yet and read as default values
+    */
+    int sz = (int)_qbound; /* O.K. sz can't be > INT_MAX  */
+    if(d.size() != _qcount)
+        throw DataStreamSizeViolation("internal size/bounds violation", _qbound, d.size());      
     
     if(end < 0) 
         end += sz; 
@@ -205,6 +932,14 @@ DATASTREAM_PRIMARY_CLASS::_check_adj(int& end, int& beg, const std::deque<T,Allo
     return true;
 }
 
+DATASTREAM_PRIMARY_TEMPLATE
+template<typename T>
+T
+DATASTREAM_PRIMARY_CLASS::_at_or_default(const DataStreamDeque<T,Allocator>& d, int indx) const
+{
+    return ((size_t)indx < d.size()) ? d[indx] : T();
+}
+
 DATASTREAM_PRIMARY_TEMPLATE
 void
 DATASTREAM_PRIMARY_CLASS::_incr_internal_counts()
@@ -214,19 +949,47 @@ DATASTREAM_PRIMARY_CLASS::_incr_internal_counts()
     if(_qcount < _qbound)
         ++_qcount;
         
-    if(*_mark_count == penult)
-        *_mark_is_dirty = true;
-    else if(*_mark_count < penult)
-        ++(*_mark_count);
-    else{/* 
-          * WE CANT THROW so attempt to get _mark_count back in line;
-          * also set dirty flag to alert caller of possible data issue
-          */
-        --(*_mark_count);
-        *_mark_is_dirty = true;
+    for(auto& m : *_markers){
+        long long& count = m.second.first;
+        if(count == penult)
+            m.second.second = true;
+        else if(count < penult)
+            ++count;
+        else{/* 
+              * WE CANT THROW so attempt to get marker back in line;
+              * also set dirty flag to alert caller of possible data issue
+              */
+            --count;
+            m.second.second = true;
+        }
     }
 }
 
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::_select_marker(const std::string& name) const
+{
+    _mtx->lock(); /* released by _unselect_marker */
+    auto m = _markers->find(name);
+    if(m == _markers->end()){
+        _mtx->unlock();
+        throw DataStreamInvalidArgument("marker does not exist");
+    }
+    _prev_markers.push_back( std::make_pair(_mark_count, _mark_is_dirty) );
+    _mark_count = &(m->second.first);
+    _mark_is_dirty = &(m->second.second);
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::_unselect_marker() const
+{
+    _mark_count = _prev_markers.back().first;
+    _mark_is_dirty = _prev_markers.back().second;
+    _prev_markers.pop_back();
+    _mtx->unlock();
+}
+
 DATASTREAM_PRIMARY_TEMPLATE
 template<typename DequeTy, typename DestTy> 
 size_t 
@@ -236,23 +999,40 @@ DATASTREAM_PRIMARY_CLASS::_copy_to_ptr(DequeTy& d,
                                        unsigned int end, 
                                        unsigned int beg) const
 {  
-    auto b_iter = d.cbegin() + beg;
-    auto e_iter = d.cbegin() + std::min<size_t>(sz+beg, std::min<size_t>(++end, _qcount));
-    
-    return (b_iter < e_iter) ? (std::copy(b_iter, e_iter, dest) - dest) : 0;     
+    return d.copy(std::min<size_t>(beg, _qcount), 
+                  std::min<size_t>(sz+beg, std::min<size_t>(++end, _qcount)), 
+                  dest);     
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+template<typename DequeTy> 
+size_t 
+DATASTREAM_PRIMARY_CLASS::_copy_to_ptr(DequeTy& d, 
+                                       const typename DATASTREAM_PRIMARY_CLASS::secondary_dest& dest, 
+                                       size_t sz, 
+                                       unsigned int end, 
+                                       unsigned int beg) const
+{  
+    return dest.copy_from(d, 
+                          std::min<size_t>(beg, _qcount), 
+                          std::min<size_t>(sz+beg, std::min<size_t>(++end, _qcount)));     
 }
 
 DATASTREAM_PRIMARY_TEMPLATE
 DATASTREAM_PRIMARY_CLASS::DataStream(size_t sz)
     : 
-        _deque_primary(std::max<size_t>(std::min<size_t>(sz,MAX_BOUND_SIZE),1)),
+        _deque_primary(), /* allocated lazily in _push */
         _qbound(std::max<size_t>(std::min<size_t>(sz,MAX_BOUND_SIZE),1)),
         _qcount(0),
-        _mark_count(new long long(-1)),
-        _mark_is_dirty(new bool(false)),      
+        _markers(new _my_markers_ty),
+        _default_marker(&(*_markers)[""]),
+        _mark_count(&(_default_marker->first)),
+        _mark_is_dirty(&(_default_marker->second)),      
         _push_has_priority(true),
-        _mtx(new std::recursive_mutex)
+        _mtx(new std::recursive_mutex),
+        _stats()
     {      
+        *_default_marker = _my_marker_ty(-1, false);
     }
 
 DATASTREAM_PRIMARY_TEMPLATE
@@ -261,10 +1041,13 @@ DATASTREAM_PRIMARY_CLASS::DataStream(const typename DATASTREAM_PRIMARY_CLASS::_m
         _deque_primary(stream._deque_primary),
         _qbound(stream._qbound),
         _qcount(stream._qcount),
-        _mark_count(new long long(*(stream._mark_count))),
-        _mark_is_dirty(new bool(*(stream._mark_is_dirty))),    
+        _markers(new _my_markers_ty(*(stream._markers))),
+        _default_marker(&(*_markers)[""]),
+        _mark_count(&(_default_marker->first)),
+        _mark_is_dirty(&(_default_marker->second)),    
         _push_has_priority(true),
-        _mtx(new std::recursive_mutex)
+        _mtx(new std::recursive_mutex),
+        _stats(stream._stats ? new _my_stats_ty(*stream._stats) : nullptr)
     {      
     }
 
@@ -274,11 +1057,16 @@ DATASTREAM_PRIMARY_CLASS::DataStream(typename DATASTREAM_PRIMARY_CLASS::_my_ty &
         _deque_primary(std::move(stream._deque_primary)),
         _qbound(stream._qbound),
         _qcount(stream._qcount),   
-        _mark_count(stream._mark_count),
-        _mark_is_dirty(stream._mark_is_dirty),    
+        _markers(stream._markers),
+        _default_marker(stream._default_marker),
+        _mark_count(&(_default_marker->first)),
+        _mark_is_dirty(&(_default_marker->second)),    
         _push_has_priority(true),
-        _mtx(stream._mtx) // ??
+        _mtx(stream._mtx), // ??
+        _stats(std::move(stream._stats))
     {      
+        stream._markers = nullptr;
+        stream._default_marker = nullptr;
         stream._mark_count = nullptr;
         stream._mark_is_dirty = nullptr;
         stream._mtx = nullptr;
@@ -290,11 +1078,8 @@ DATASTREAM_PRIMARY_CLASS::~DataStream()
     if(_mtx) 
         delete _mtx;  
 
-    if(_mark_count) 
-        delete _mark_count;
-
-    if(_mark_is_dirty) 
-        delete _mark_is_dirty;
+    if(_markers) 
+        delete _markers;
  }
 
 
@@ -306,19 +1091,29 @@ DATASTREAM_PRIMARY_CLASS::bound_size(size_t sz)
 
     _my_lock_guard_type lock(*_mtx);
     /* --- CRITICAL SECTION --- */
-    _deque_primary.resize(sz);
-
     if(sz < _qbound){
         /* IF bound is 'clipped' from the left(end) */
-        _deque_primary.shrink_to_fit();  
+        if(sz < _deque_primary.size()){
+            if(_stats){ /* evict oldest first */
+                for(size_t i = _deque_primary.size(); i > sz; --i)
+                    _stats->evict(_deque_primary[i-1]);
+            }
+            _deque_primary.resize(sz);
+            _deque_primary.shrink_to_fit(); /* copies, so only if we trimmed */
+        }
 
-        if( (long long)sz <= *_mark_count ){
-            /* IF marker is 'clipped' from the left(end) */
-            *_mark_count = (long long)sz -1;
-            *_mark_is_dirty = true;
+        for(auto& m : *_markers){
+            if( (long long)sz <= m.second.first ){
+                /* IF marker is 'clipped' from the left(end) */
+                m.second.first = (long long)sz -1;
+                m.second.second = true;
+            }
         }
     }    
 
+    if(sz != _qbound) /* cold tier is sized to the bound */
+        _deque_primary.rebound(sz);
+
     _qbound = sz;
     if(sz < _qcount) /* IF count is 'clipped' from the left(end) */
         _qcount = sz;
@@ -327,13 +1122,169 @@ DATASTREAM_PRIMARY_CLASS::bound_size(size_t sz)
     /* --- CRITICAL SECTION --- */
 }  
 
+DATASTREAM_PRIMARY_TEMPLATE
+size_t
+DATASTREAM_PRIMARY_CLASS::hot_size(size_t hot_sz)
+{
+    if(!DataStreamDeque<Ty,Allocator>::spill_supported)
+        BuildThrowTypeError<Ty,false>("hot_size()");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    _deque_primary.spill(hot_sz, _qbound, _deque_primary.compressed());
+    return hot_sz;
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::cold_compressed(bool on)
+{
+    if(on && !DataStreamDeque<Ty,Allocator>::compress_supported)
+        BuildThrowTypeError<Ty,false>("cold_compressed()");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(on != _deque_primary.compressed())
+        _deque_primary.spill(_deque_primary.hot_size_requested(), _qbound, on);
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+bool
+DATASTREAM_PRIMARY_CLASS::add_marker(const std::string& name) const
+{
+    if(name.empty())
+        throw DataStreamInvalidArgument("marker name can not be empty");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    /* a new marker only sees data pushed after it's added */
+    return _markers->insert( 
+        typename _my_markers_ty::value_type(name, _my_marker_ty(-1, false)) 
+    ).second;
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+bool
+DATASTREAM_PRIMARY_CLASS::remove_marker(const std::string& name) const
+{
+    if(name.empty())
+        throw DataStreamInvalidArgument("can not remove default marker");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    return (_markers->erase(name) > 0);
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::retain_markers(const std::string& prefix) const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    for(auto m = _markers->begin(); m != _markers->end(); ){
+        if( m->first.empty() || !m->first.compare(0, prefix.size(), prefix) )
+            ++m;
+        else
+            m = _markers->erase(m);
+    }
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+bool
+DATASTREAM_PRIMARY_CLASS::has_marker(const std::string& name) const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    return (_markers->find(name) != _markers->end());
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+long long
+DATASTREAM_PRIMARY_CLASS::marker_position(const std::string& name) const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    auto m = _markers->find(name);
+    if(m == _markers->end())
+        throw DataStreamInvalidArgument("marker does not exist");
+    return m->second.first;
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+bool
+DATASTREAM_PRIMARY_CLASS::is_marker_dirty(const std::string& name) const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    auto m = _markers->find(name);
+    if(m == _markers->end())
+        throw DataStreamInvalidArgument("marker does not exist");
+    return m->second.second;
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::stats_enable(bool on)
+{
+    if(!_my_stats_ty::supported)
+        BuildThrowTypeError<Ty,false>("stats_enable()");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(!on){
+        _stats.reset();
+        return;
+    }
+
+    if(_stats)
+        return;
+
+    _stats.reset(new _my_stats_ty);
+    /* seed w/ current contents, oldest first */
+    for(size_t i = _deque_primary.size(); i > 0; --i)
+        _stats->push(_deque_primary[i-1]);
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::stats_weight(double w)
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(_stats)
+        _stats->weight(w);
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_PRIMARY_TEMPLATE
+DataStreamStats
+DATASTREAM_PRIMARY_CLASS::stats() const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(!_stats)
+        throw DataStreamInvalidArgument("stats not enabled for stream");
+
+    return _stats->get();
+    /* --- CRITICAL SECTION --- */
+}
+
 ///
 
 DATASTREAM_PRIMARY_TEMPLATE
 long long
 DATASTREAM_PRIMARY_CLASS::ncopy_from_marker(Ty *dest, 
                                             size_t sz,                                          
-                                            typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                                            typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {              
     _yld_to_push();
     _my_lock_guard_type lock(*_mtx);
@@ -348,7 +1299,7 @@ long long
 DATASTREAM_PRIMARY_CLASS::ncopy_from_marker(char **dest, 
                                             size_t dest_sz, 
                                             size_t str_sz,                                                           
-                                            typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                                            typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {  
     _yld_to_push();
     _my_lock_guard_type lock(*_mtx);
@@ -365,7 +1316,7 @@ long long
 DATASTREAM_PRIMARY_CLASS::copy_from_marker(Ty *dest, 
                                            size_t sz,              
                                            int beg = 0, 
-                                           typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                                           typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {         
     /* 1) we need to cache mark vals before copy changes state
        2) adjust beg here; _check_adj requires a ref that we can't pass
@@ -405,7 +1356,7 @@ DATASTREAM_PRIMARY_CLASS::copy_from_marker(char **dest,
                                            size_t dest_sz, 
                                            size_t str_sz,                
                                            int beg = 0, 
-                                           typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                                           typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {  
    /* 1) we need to cache mark vals before copy changes state
       2) adjust beg here; _check_adj requires a ref that we can't pass
@@ -445,7 +1396,7 @@ DATASTREAM_PRIMARY_CLASS::copy(Ty *dest,
                                size_t sz, 
                                int end = -1, 
                                int beg = 0, 
-                               typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                               typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {  
     size_t ret;
 
@@ -460,7 +1411,7 @@ DATASTREAM_PRIMARY_CLASS::copy(Ty *dest,
     _check_adj(end, beg, _deque_primary);           
 
     if(end == beg){
-        *dest = beg ? _deque_primary.at(beg) : _deque_primary.front();
+        *dest = _at_or_default(_deque_primary, beg);
         ret = 1;
     }else 
         ret = _copy_to_ptr(_deque_primary, dest, sz, end, beg);     
@@ -479,7 +1430,7 @@ DATASTREAM_PRIMARY_CLASS::copy(char **dest,
                                size_t str_sz, 
                                int end = -1, 
                                int beg = 0, 
-                               typename DATASTREAM_PRIMARY_CLASS::secondary_ty *sec = nullptr) const 
+                               typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
 {  /* 
     * slow(er), has to go thru generic_ty to get strings 
     * note: if sz <= gstr.length() the string is truncated 
@@ -494,14 +1445,14 @@ DATASTREAM_PRIMARY_CLASS::copy(char **dest,
     /* --- CRITICAL SECTION --- */
     _check_adj(end, beg, _deque_primary);            
 
-    auto b_iter = _deque_primary.cbegin() + beg; 
-    auto e_iter = _deque_primary.cbegin() + std::min<size_t>(++end, _qcount);
+    size_t b = std::min<size_t>(beg, _qcount); 
+    size_t e = std::min<size_t>(++end, _qcount);
 
     for( i = 0; 
-         (i < dest_sz) && (b_iter < e_iter); 
-         ++b_iter, ++i )
+         (i < dest_sz) && (b < e); 
+         ++b, ++i )
     {       
-        std::string gstr = generic_ty(*b_iter).as_string();        
+        std::string gstr = generic_ty(_deque_primary[b]).as_string();        
         strncpy_s(dest[i], str_sz, gstr.c_str(), std::min<size_t>(str_sz-1, gstr.length()));                  
     }  
 
@@ -512,6 +1463,52 @@ DATASTREAM_PRIMARY_CLASS::copy(char **dest,
     /* --- CRITICAL SECTION --- */
 }
 
+DATASTREAM_PRIMARY_TEMPLATE
+size_t
+DATASTREAM_PRIMARY_CLASS::copy_packed(char *dest, 
+                                      size_t dest_sz, 
+                                      uint32_t *offsets, 
+                                      size_t sz, 
+                                      int end = -1, 
+                                      int beg = 0, 
+                                      typename DATASTREAM_PRIMARY_CLASS::secondary_dest sec = nullptr) const 
+{  /* 
+    * unlike copy(char**) no per-string buffers or truncation: the caller 
+    * sizes one buffer and we stop at the first string that doesn't fit 
+    */
+    size_t i, n;
+    size_t off = 0;
+ 
+    if(!dest || !offsets)
+        throw DataStreamInvalidArgument("NULL dest argument");
+
+    _yld_to_push();    
+    _my_lock_guard_type lock(*_mtx); 
+    /* --- CRITICAL SECTION --- */
+    _check_adj(end, beg, _deque_primary);            
+
+    size_t b = std::min<size_t>(beg, _qcount); 
+    size_t e = std::min<size_t>(++end, _qcount);
+
+    for( i = 0; 
+         (i < sz) && (b < e); 
+         ++b, ++i )
+    {       
+        n = _pack_str(_deque_primary[b], dest + off, dest_sz - off);
+        if(!n)
+            break;
+        offsets[i] = (uint32_t)off;
+        off += n;
+    }  
+    offsets[i] = (uint32_t)off;
+
+    *_mark_count = beg - 1; 
+    *_mark_is_dirty = false;
+
+    return i;
+    /* --- CRITICAL SECTION --- */
+}
+
 DATASTREAM_PRIMARY_TEMPLATE
 typename DATASTREAM_PRIMARY_CLASS::generic_ty
 DATASTREAM_PRIMARY_CLASS::operator[](int indx) const
@@ -524,7 +1521,7 @@ DATASTREAM_PRIMARY_CLASS::operator[](int indx) const
         /* optimize for indx == 0 */
         *_mark_count = -1;
         *_mark_is_dirty = false;
-        return generic_ty(_deque_primary.front()); 
+        return generic_ty(_at_or_default(_deque_primary, 0)); 
     }
 
     _check_adj(indx, dummy, _deque_primary); 
@@ -532,7 +1529,7 @@ DATASTREAM_PRIMARY_CLASS::operator[](int indx) const
     *_mark_count = indx - 1; 
     *_mark_is_dirty = false;
 
-    return generic_ty(_deque_primary.at(indx));   
+    return generic_ty(_at_or_default(_deque_primary, indx));   
     /* --- CRITICAL SECTION --- */
 }
 
@@ -556,12 +1553,12 @@ DATASTREAM_PRIMARY_CLASS::get_leave_marker(int indx) const
     _my_lock_guard_type lock(*_mtx);
     /* --- CRITICAL SECTION --- */
     if(!indx){         
-        return generic_ty(_deque_primary.front()); 
+        return generic_ty(_at_or_default(_deque_primary, 0)); 
     }
 
     _check_adj(indx, dummy, _deque_primary); 
 
-    return generic_ty(_deque_primary.at(indx));   
+    return generic_ty(_at_or_default(_deque_primary, indx));   
     /* --- CRITICAL SECTION --- */
 }
 
@@ -576,6 +1573,16 @@ DATASTREAM_PRIMARY_CLASS::both_leave_marker(int indx) const
     /* --- CRITICAL SECTION --- */
 }
 
+DATASTREAM_PRIMARY_TEMPLATE
+Ty
+DATASTREAM_PRIMARY_CLASS::front_leave_marker() const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    return _at_or_default(_deque_primary, 0);
+    /* --- CRITICAL SECTION --- */
+}
+
 DATASTREAM_PRIMARY_TEMPLATE
 typename DATASTREAM_PRIMARY_CLASS::generic_vector_ty
 DATASTREAM_PRIMARY_CLASS::vector(int end = -1, int beg = 0) const 
@@ -587,18 +1594,14 @@ DATASTREAM_PRIMARY_CLASS::vector(int end = -1, int beg = 0) const
     /* --- CRITICAL SECTION --- */
     _check_adj(end, beg, _deque_primary);
         
-    auto b_iter = _deque_primary.cbegin() + beg;
-    auto e_iter = _deque_primary.cbegin() + std::min<size_t>(++end, _qcount);  
+    size_t b = std::min<size_t>(beg, _qcount);
+    size_t e = std::min<size_t>(++end, _qcount);  
     
-    if(b_iter < e_iter){          
-        std::transform(
-            b_iter, 
-            e_iter, 
-            /* have to use slower insert_iterator approach, 
-               generic_ty doesn't allow default construction */
-            std::insert_iterator<generic_vector_ty>(tmp, tmp.begin()), 
-            [](Ty x){ return generic_ty(x); }
-        );   
+    if(b < e){ 
+        /* generic_ty doesn't allow default construction */
+        tmp.reserve(e - b);
+        for( ; b < e; ++b)
+            tmp.push_back(generic_ty(_deque_primary[b]));
     }
 
     *_mark_count = beg - 1; 
@@ -616,6 +1619,16 @@ DATASTREAM_PRIMARY_CLASS::secondary_vector(int end = -1, int beg = 0) const
     return secondary_vector_ty(std::min< size_t >(++end - beg, _qcount));
 }
 
+DATASTREAM_PRIMARY_TEMPLATE
+void
+DATASTREAM_PRIMARY_CLASS::secondary_range(const typename DATASTREAM_PRIMARY_CLASS::secondary_ty& from, 
+                                          const typename DATASTREAM_PRIMARY_CLASS::secondary_ty& to, 
+                                          int *end, 
+                                          int *beg) const
+{
+    throw DataStreamInvalidArgument("secondary_range() requires secondary (datetime) data");
+}
+
 
 DATASTREAM_SECONDARY_TEMPLATE
 void
@@ -625,10 +1638,13 @@ DATASTREAM_SECONDARY_CLASS::_push(const Ty v, const typename DATASTREAM_SECONDAR
     if(!_push_has_priority) 
         _mtx->lock();
     /* --- CRITICAL SECTION --- */
+    _my_base_ty::_stats_on_push(v);
     _my_base_ty::_deque_primary.push_front(v); 
-    _my_base_ty::_deque_primary.pop_back();
-    _deque_secondary.push_front(std::move(sec));
-    _deque_secondary.pop_back();
+    _deque_secondary.push_front(sec);
+    if(_deque_secondary.size() > _qbound){ /* grow on demand until we hit bound */
+        _my_base_ty::_deque_primary.pop_back();
+        _deque_secondary.pop_back();
+    }
     _incr_internal_counts();
     /* --- CRITICAL SECTION --- */
     _mtx->unlock();
@@ -637,7 +1653,7 @@ DATASTREAM_SECONDARY_CLASS::_push(const Ty v, const typename DATASTREAM_SECONDAR
 DATASTREAM_SECONDARY_TEMPLATE
 DATASTREAM_SECONDARY_CLASS::DataStream(size_t sz)
     : 
-        _deque_secondary(std::max<size_t>(std::min<size_t>(sz,MAX_BOUND_SIZE),1)),
+        _deque_secondary(), /* allocated lazily in _push */
         _my_base_ty(std::max<size_t>(std::min<size_t>(sz,MAX_BOUND_SIZE),1))
     {
     }
@@ -667,21 +1683,64 @@ DATASTREAM_SECONDARY_CLASS::bound_size(size_t sz)
 
     _my_lock_guard_type lock(*_mtx);   
     /* --- CRITICAL SECTION --- */
-    _deque_secondary.resize(sz);
-    if (sz < _qcount)
-        _deque_secondary.shrink_to_fit();  
+    if(sz < _qbound){
+        if(sz < _deque_secondary.size()){
+            _deque_secondary.resize(sz);
+            _deque_secondary.shrink_to_fit();
+        }
+    }
+
+    if(sz != _qbound) /* cold tier is sized to the bound */
+        _deque_secondary.rebound(sz);
 
     return _my_base_ty::bound_size(sz);   
     /* --- CRITICAL SECTION --- */
 }
 
+DATASTREAM_SECONDARY_TEMPLATE
+size_t
+DATASTREAM_SECONDARY_CLASS::hot_size(size_t hot_sz)
+{
+    if(!DataStreamDeque<SecTy,Allocator>::spill_supported)
+        BuildThrowTypeError<SecTy,false>("hot_size()");
+
+    _my_lock_guard_type lock(*_mtx);   
+    /* --- CRITICAL SECTION --- */
+    _my_base_ty::hot_size(hot_sz); 
+    try{
+        _deque_secondary.spill(hot_sz, _qbound, _deque_secondary.compressed());
+    }catch(...){ /* keep the tiers in step */
+        _my_base_ty::_deque_primary.spill(0, _qbound, _my_base_ty::_deque_primary.compressed()); 
+        _deque_secondary.spill(0, _qbound, _deque_secondary.compressed());
+        throw;
+    }
+
+    return hot_sz;
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_SECONDARY_TEMPLATE
+void
+DATASTREAM_SECONDARY_CLASS::cold_compressed(bool on)
+{
+    if(on && !DataStreamDeque<SecTy,Allocator>::compress_supported)
+        BuildThrowTypeError<SecTy,false>("cold_compressed()");
+
+    _my_lock_guard_type lock(*_mtx);   
+    /* --- CRITICAL SECTION --- */
+    _my_base_ty::cold_compressed(on); 
+    if(on != _deque_secondary.compressed())
+        _deque_secondary.spill(_deque_secondary.hot_size_requested(), _qbound, on);
+    /* --- CRITICAL SECTION --- */
+}
+
 DATASTREAM_SECONDARY_TEMPLATE
 size_t
 DATASTREAM_SECONDARY_CLASS::copy(Ty *dest, 
                                  size_t sz, 
                                  int end = -1, 
                                  int beg = 0, 
-                                 typename DATASTREAM_SECONDARY_CLASS::secondary_ty *sec = nullptr) const 
+                                 typename DATASTREAM_SECONDARY_CLASS::secondary_dest sec = nullptr) const 
 {   
     size_t ret;
 
@@ -692,13 +1751,13 @@ DATASTREAM_SECONDARY_CLASS::copy(Ty *dest,
     /* --- CRITICAL SECTION --- */
     ret = _my_base_ty::copy(dest, sz, end, beg); /*_mark_count reset by _my_base_ty*/
       
-    if(!sec)
+    if(sec.empty())
         return ret;
         
     _check_adj(end, beg, _deque_secondary); /*repeat to update index vals */ 
  
     if(end == beg){  
-        *sec = beg ? _deque_secondary.at(beg) : _deque_secondary.front();
+        sec.assign(0, _at_or_default(_deque_secondary, beg));
         ret = 1;
     }else  
         ret = _copy_to_ptr(_deque_secondary, sec, sz, end, beg);  
@@ -715,7 +1774,7 @@ DATASTREAM_SECONDARY_CLASS::copy(char **dest,
                                  size_t str_sz, 
                                  int end = -1, 
                                  int beg = 0, 
-                                 typename DATASTREAM_SECONDARY_CLASS::secondary_ty *sec = nullptr) const 
+                                 typename DATASTREAM_SECONDARY_CLASS::secondary_dest sec = nullptr) const 
 {    
     size_t ret;
 
@@ -726,13 +1785,13 @@ DATASTREAM_SECONDARY_CLASS::copy(char **dest,
     /* --- CRITICAL SECTION --- */
     ret = _my_base_ty::copy(dest, dest_sz, str_sz, end, beg);
 
-    if(!sec)
+    if(sec.empty())
         return ret;
     
     _check_adj(end, beg, _deque_secondary); /*repeat to update index vals*/ 
 
     if(end == beg){
-        *sec = beg ? _deque_secondary.at(beg) : _deque_secondary.front();
+        sec.assign(0, _at_or_default(_deque_secondary, beg));
         ret = 1;
     }else
         ret = _copy_to_ptr(_deque_secondary, sec, dest_sz, end, beg);    
@@ -742,6 +1801,37 @@ DATASTREAM_SECONDARY_CLASS::copy(char **dest,
     return ret;
 }
   
+DATASTREAM_SECONDARY_TEMPLATE
+size_t
+DATASTREAM_SECONDARY_CLASS::copy_packed(char *dest, 
+                                        size_t dest_sz, 
+                                        uint32_t *offsets, 
+                                        size_t sz, 
+                                        int end = -1, 
+                                        int beg = 0, 
+                                        typename DATASTREAM_SECONDARY_CLASS::secondary_dest sec = nullptr) const 
+{    
+    size_t ret;
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    ret = _my_base_ty::copy_packed(dest, dest_sz, offsets, sz, end, beg);
+
+    if(sec.empty() || !ret)
+        return ret;
+    
+    _check_adj(end, beg, _deque_secondary); /*repeat to update index vals*/ 
+
+    /* only as many as the strings that fit */
+    if(end == beg)
+        sec.assign(0, _at_or_default(_deque_secondary, beg));
+    else
+        _copy_to_ptr(_deque_secondary, sec, ret, end, beg);    
+
+    return ret;
+    /* --- CRITICAL SECTION --- */
+}
+  
 DATASTREAM_SECONDARY_TEMPLATE
 typename DATASTREAM_SECONDARY_CLASS::both_ty
 DATASTREAM_SECONDARY_CLASS::both(int indx) const            
@@ -752,11 +1842,11 @@ DATASTREAM_SECONDARY_CLASS::both(int indx) const
     /* --- CRITICAL SECTION --- */
     generic_ty gen = operator[](indx); /* _mark_count reset by _my_base_ty */
     if(!indx)
-        return both_ty(gen, _deque_secondary.front());
+        return both_ty(gen, _at_or_default(_deque_secondary, 0));
 
     _check_adj(indx, dummy, _deque_secondary); 
      
-    return both_ty(gen, _deque_secondary.at(indx));
+    return both_ty(gen, _at_or_default(_deque_secondary, indx));
     /* --- CRITICAL SECTION --- */
 }
 
@@ -771,11 +1861,23 @@ DATASTREAM_SECONDARY_CLASS::both_leave_marker(int indx) const
     /* --- CRITICAL SECTION --- */
     generic_ty gen = get_leave_marker(indx); 
     if(!indx)
-        return both_ty(gen, _deque_secondary.front());
+        return both_ty(gen, _at_or_default(_deque_secondary, 0));
 
     _check_adj(indx, dummy, _deque_secondary); 
      
-    return both_ty(gen, _deque_secondary.at(indx));
+    return both_ty(gen, _at_or_default(_deque_secondary, indx));
+    /* --- CRITICAL SECTION --- */
+}
+
+DATASTREAM_SECONDARY_TEMPLATE
+Ty
+DATASTREAM_SECONDARY_CLASS::front_leave_marker(typename DATASTREAM_SECONDARY_CLASS::secondary_dest sec) const
+{
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    sec.assign(0, _at_or_default(_deque_secondary, 0));
+
+    return _my_base_ty::front_leave_marker();
     /* --- CRITICAL SECTION --- */
 }
 
@@ -789,10 +1891,7 @@ DATASTREAM_SECONDARY_CLASS::secondary(typename DATASTREAM_SECONDARY_CLASS::secon
     /* --- CRITICAL SECTION --- */
     _check_adj(indx, dummy, _deque_secondary);
 
-    if(!indx)
-        *dest = _deque_secondary.front();
-    else
-        *dest = _deque_secondary.at(indx);  
+    *dest = _at_or_default(_deque_secondary, indx);
 
     *_mark_count = indx - 1; /* _mark_count NOT reset by _my_base_ty */
     *_mark_is_dirty = false;
@@ -810,14 +1909,13 @@ DATASTREAM_SECONDARY_CLASS::secondary_vector(int end = -1, int beg = 0) const
     /* --- CRITICAL SECTION --- */
     _check_adj(end, beg, _deque_secondary);  
         
-    auto b_iter = _deque_secondary.cbegin() + beg;
-    auto e_iter = _deque_secondary.cbegin() + std::min<size_t>(++end, _qcount);  
-    auto ndiff = e_iter - b_iter;
+    size_t b = std::min<size_t>(beg, _qcount);
+    size_t e = std::min<size_t>(++end, _qcount);  
 
-    if(ndiff > 0){ 
+    if(b < e){ 
       /* do this manually; insert iterators too slow */
-        tmp.resize(ndiff); 
-        std::copy(b_iter, e_iter, tmp.begin());
+        tmp.resize(e - b); 
+        _deque_secondary.copy(b, e, &tmp[0]);
     }
 
     *_mark_count = beg - 1; /* _mark_count NOT reset by _my_base_ty */
@@ -826,3 +1924,32 @@ DATASTREAM_SECONDARY_CLASS::secondary_vector(int end = -1, int beg = 0) const
     return tmp;  
     /* --- CRITICAL SECTION --- */
 }
+
+DATASTREAM_SECONDARY_TEMPLATE
+void
+DATASTREAM_SECONDARY_CLASS::secondary_range(const typename DATASTREAM_SECONDARY_CLASS::secondary_ty& from, 
+                                            const typename DATASTREAM_SECONDARY_CLASS::secondary_ty& to, 
+                                            int *end, 
+                                            int *beg) const
+{
+    if(!end || !beg)
+        throw DataStreamInvalidArgument("NULL end/beg argument");
+
+    _my_lock_guard_type lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    /* front is most recent so secondary values are descending; 
+       first elem < 'to' is beg, first elem < 'from' is one past end */
+    size_t b = _deque_secondary.partition_point(
+        0, 
+        [&](const secondary_ty& s){ return !(s < to); }
+    );
+
+    size_t e = _deque_secondary.partition_point(
+        b, 
+        [&](const secondary_ty& s){ return !(s < from); }
+    );
+
+    *beg = (int)b;
+    *end = (int)e - 1;
+    /* --- CRITICAL SECTION --- */
+}
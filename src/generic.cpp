@@ -18,14 +18,39 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include "generic.hpp"
 
 
+void
+TOSDB_Generic::_set_string(const char* str, size_t len)
+{
+    if(len > STR_MAX)
+        len = STR_MAX;
+
+    _str_len = (unsigned char)len;
+    if(_str_is_inline()){
+        memcpy(_sub, str, len);
+        _sub[len] = 0;
+    }else{ /* rare: anything the engine didn't produce */
+        *(std::string**)_sub = new std::string(str, len);
+    }
+}
+
+
+void
+TOSDB_Generic::_release()
+{
+    if(is_string() && !_str_is_inline())
+        delete *(std::string**)_sub;
+}
+
+
 /* COPY CONSTRUCT */
 TOSDB_Generic::TOSDB_Generic(const TOSDB_Generic& gen)
     : 
-        _type_val( gen._type_val )
+        _type_val( gen._type_val ),
+        _str_len( gen._str_len )
     {  
-        if(gen.is_string())        
+        if(gen.is_string() && !gen._str_is_inline())        
             *(std::string**)_sub = new std::string(**(std::string**)(gen._sub));
-        else            
+        else /* scalar OR inline string */            
             memcpy(_sub, gen._sub, SUB_SZ);                      
     }  
 
@@ -33,9 +58,10 @@ TOSDB_Generic::TOSDB_Generic(const TOSDB_Generic& gen)
 /* MOVE CONSTRUCT */
 TOSDB_Generic::TOSDB_Generic(TOSDB_Generic&& gen)
     :      
-        _type_val( gen._type_val )
+        _type_val( gen._type_val ),
+        _str_len( gen._str_len )
     {                
-      /* we are stealing the scalar value OR the string pointer */           
+      /* we are stealing the scalar value, inline string OR the string pointer */           
         memcpy(_sub, gen._sub, SUB_SZ);      
 
       /* leave the pointer but set _type_val to VOID to avoid bad free; ptr is an 
@@ -48,22 +74,21 @@ TOSDB_Generic::TOSDB_Generic(TOSDB_Generic&& gen)
 TOSDB_Generic& 
 TOSDB_Generic::operator=(const TOSDB_Generic& gen)
 {
-    if(*this == gen)
+    if(this == &gen)
         return *this;
 
-    if(gen.is_string()){          
-        if(is_string())  /* if we're also a string simply assign */
+    if(gen.is_string() && !gen._str_is_inline()){          
+        if(is_string() && !_str_is_inline())  /* if we're also on the heap simply assign */
             **(std::string**)_sub = **(std::string**)(gen._sub);
         else /* otherwise allocate new */ 
             *(std::string**)_sub = new std::string(**(std::string**)(gen._sub));
     }else{
-        if(is_string())
-            delete *(std::string**)_sub;  
-           
+        _release();            
         memcpy(_sub, gen._sub, SUB_SZ);    
     }
 
     _type_val = gen._type_val;        
+    _str_len = gen._str_len;
     return *this;    
 }
 
@@ -72,17 +97,15 @@ TOSDB_Generic::operator=(const TOSDB_Generic& gen)
 TOSDB_Generic& 
 TOSDB_Generic::operator=(TOSDB_Generic&& gen)
 {
-  /* not sure if this is optimal or its better to branch(as above) and move
-     the string object in, allowing gen's destructor to delete 
-
-     although, this way is a lot cleaner than 2 nested conditionals*/
+    if(this == &gen)
+        return *this;
 
-    if(_type_val == TYVAL_STRING)
-        delete *(std::string**)_sub; 
+    _release();
      
     _type_val = gen._type_val;
+    _str_len = gen._str_len;
 
-  /* we are stealing the scalar value OR the string pointer */           
+  /* we are stealing the scalar value, inline string OR the string pointer */           
     memcpy(_sub, gen._sub, SUB_SZ);    
        
   /* leave the pointer but set _type_val to VOID to avoid bad free; ptr is an 
@@ -104,7 +127,7 @@ TOSDB_Generic::as_string() const
     case(TYVAL_DOUBLE):
         return std::to_string(*(double*)_sub);
     case(TYVAL_STRING):
-        return **(std::string**)_sub;
+        return std::string(_str_data(), _str_len);
     default:
         return std::string();
     };
@@ -123,7 +146,7 @@ TOSDB_Generic::size() const
     case(TYVAL_DOUBLE):    
         return sizeof(double);
     case(TYVAL_STRING):    
-        return (*(std::string**)_sub)->size();
+        return _str_len;
     default:               
         return 0;
     };
@@ -24,229 +24,416 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 #include <algorithm>
 
 
-bool 
-IPCBase::send(std::string msg) const
+NamedPipeConnection::NamedPipeConnection(HANDLE hndl)
+    :
+        _hndl(hndl),
+        _read_event( CreateEvent(NULL, TRUE, FALSE, NULL) ),
+        _write_event( CreateEvent(NULL, TRUE, FALSE, NULL) ),
+        _closed(false)
+    {
+        if(!_read_event || !_write_event)
+            TOSDB_LogEx("IPC", "CreateEvent failed in NamedPipeConnection", GetLastError());
+    }
+
+
+NamedPipeConnection::~NamedPipeConnection()
 {
-    DWORD d; 
-    BOOL ret;
+    /* NOTE: no DisconnectNamedPipe on the server end; that would discard a 
+             reply the other end hasn't read yet */
+    CloseHandle(_hndl);
+    if(_read_event)
+        CloseHandle(_read_event);
+    if(_write_event)
+        CloseHandle(_write_event);
+}
+
 
-    if(msg.length() > MAX_MESSAGE_SZ){
-        TOSDB_LogH("IPC", "IPCBase::send() :: msg length > MAX_MESSAGE_SZ");
-        throw std::invalid_argument("IPCBase::send() :: msg length > MAX_MESSAGE_SZ");
+DWORD
+NamedPipeConnection::_io(bool read, char *buf, DWORD n, DWORD *done)
+{ /* one overlapped read/write; returns ERROR_SUCCESS or the error */
+    BOOL ret;
+    DWORD e;
+    OVERLAPPED ov = {};
+
+    *done = 0;
+    if(_closed)
+        return ERROR_OPERATION_ABORTED;
+
+    ov.hEvent = read ? _read_event : _write_event;
+    if(!ov.hEvent)
+        return ERROR_INVALID_HANDLE;
+    ResetEvent(ov.hEvent);
+
+    ret = read ? ReadFile(_hndl, buf, n, NULL, &ov) 
+               : WriteFile(_hndl, buf, n, NULL, &ov);
+    if(!ret){
+        e = GetLastError();
+        if(e != ERROR_IO_PENDING && e != ERROR_MORE_DATA)
+            return e;
     }
-    
-    /* size_t to DWORD cast ok because we check msg length above */
-    ret = WriteFile(_main_channel_pipe_hndl, (void*)msg.c_str(), msg.length() + 1, &d, NULL);
-    if(!ret){        
-        TOSDB_LogEx("IPC", "WriteFile failed in _recv()", GetLastError());  
-        return false; 
+
+    /* wait for completion; poll so a close() that raced the call can't 
+       leave us blocked */
+    for(;;){
+        e = WaitForSingleObject(ov.hEvent, CLOSE_POLL_MSEC);
+        if(e == WAIT_OBJECT_0)
+            break;
+        if(e != WAIT_TIMEOUT || _closed){
+            CancelIoEx(_hndl, &ov);
+            GetOverlappedResult(_hndl, &ov, done, TRUE);
+            return ERROR_OPERATION_ABORTED;
+        }
     }
 
-    return true;
+    if( !GetOverlappedResult(_hndl, &ov, done, FALSE) )
+        return GetLastError(); /* incl. ERROR_MORE_DATA */
+
+    return ERROR_SUCCESS;
 }
- 
+
 
 bool 
-IPCBase::recv(std::string *msg) const 
+NamedPipeConnection::read_frame(std::string *frame)
 {    
     DWORD d; 
-    BOOL ret;
+    DWORD e;
+    size_t off = 0;
     
-    msg->clear();
-    msg->resize(MAX_MESSAGE_SZ); 
+    frame->resize(IPCMessage::MAX_FRAME_SZ); 
     
-    ret = ReadFile(_main_channel_pipe_hndl, (void*)msg->c_str(), MAX_MESSAGE_SZ + 1, &d, NULL);
-    if(!ret || d == 0){
-        TOSDB_LogEx("IPC", "ReadFile failed in _recv()", GetLastError());
+    /* one frame == one pipe message; loop in case it comes in pieces */
+    for(;;){
+        e = _io(true, &(*frame)[off], (DWORD)(frame->size() - off), &d);
+        off += d;
+        if(e == ERROR_SUCCESS)
+            break;
+
+        if(e != ERROR_MORE_DATA || off >= frame->size()){
+            if(e == ERROR_BROKEN_PIPE || e == ERROR_OPERATION_ABORTED)
+                TOSDB_LogDebug("***IPC*** READ FRAME - (BROKEN_PIPE/ABORTED)");
+            else
+                TOSDB_LogEx("IPC", "ReadFile failed in read_frame()", e);
+            return false;
+        }
+    }
+
+    if(off == 0){
+        TOSDB_LogH("IPC", "ReadFile returned 0 bytes in read_frame()");
         return false;
     }
 
+    frame->resize(off);
     return true;
 }
 
-// needs to be non-blocking, called from ::call() which is called from DLLMain
-template<typename T>
-bool 
-IPCBase::_call_pipe( std::string name,
-                     T* in,
-                     DWORD in_sz,
-                     T* out, 
-                     DWORD out_sz,
-                     unsigned long timeout, 
-                     std::function<bool(T*,DWORD)> handle_good_call,
-                     std::function<void(void)> handle_file_not_found ) 
-{     
-    errno_t e;
-    DWORD r = 0;  
-   
-    if( CallNamedPipe(name.c_str(), (void*)in, in_sz, (void*)out, out_sz, &r, timeout) )
-    {    
-        return handle_good_call(out, r);                 
-    }
 
-    e = GetLastError(); 
-    if(e == ERROR_FILE_NOT_FOUND){
-        if(handle_file_not_found){
-            handle_file_not_found();
-        }
-    }else{
-        TOSDB_LogRawH("IPC", ("CallNamedPipe failed for pipe: " + name + 
-                              ", ERROR# " + std::to_string(e)).c_str() );
+bool 
+NamedPipeConnection::write_frame(const std::string& frame)
+{
+    DWORD d; 
+    DWORD e;
+    
+    /* size_t to DWORD cast ok, frames are <= MAX_FRAME_SZ */
+    e = _io(false, (char*)frame.c_str(), (DWORD)frame.size(), &d);
+    if(e != ERROR_SUCCESS || d != frame.size()){        
+        TOSDB_LogEx("IPC", "WriteFile failed in write_frame()", e);  
+        return false; 
     }
 
-    return false;     
+    return true;
 }
 
-template bool /* connected() / _probe_channel_pipe */
-IPCBase::_call_pipe<uint8_t>(std::string, uint8_t*, DWORD, uint8_t*, DWORD, unsigned long, 
-                             std::function<bool(uint8_t*,DWORD)>, std::function<void(void)>);
 
-template bool /* call() / _main_channel_pipe */
-IPCBase::_call_pipe<const char>(std::string, const char*, DWORD, const char*, DWORD, unsigned long, 
-                                std::function<bool(const char*,DWORD)>, std::function<void(void)>);
+void
+NamedPipeConnection::close()
+{
+    _closed = true;
+    CancelIoEx(_hndl, NULL);
+}
 
 
-bool 
-IPCBase::connected(unsigned long timeout) 
-{ 
-    uint8_t i = PROBE_BYTE;
-    uint8_t o = 0;  
-
-    /* check for a single byte that == PROBE_BYTE */
-    std::function<bool(uint8_t*,DWORD)> cb = 
-        [](uint8_t *out, DWORD r){ 
-            if (r != sizeof(PROBE_BYTE) ){
-                TOSDB_LogRawH("IPC", ("bad probe size returned: " + std::to_string(r)).c_str());
-                return false;
-            }
-            if( *out != PROBE_BYTE ){
-                TOSDB_LogRawH("IPC", ("bad probe value returned: " + std::to_string(*out)).c_str());
-                if( *out == PROBE_BYTE_WRONG_ARCH ){
-                    TOSDB_LogRawH("IPC", "build mismatch between engine and library(x86 vs x64)");                
-                }           
-                return false;
-            }
-            return true;
-        };
-  
-    return _call_pipe(_probe_channel_pipe_name, &i, sizeof(i), &o, sizeof(o), timeout, cb); 
-}
+NamedPipeServerTransport::NamedPipeServerTransport(std::string name, 
+                                                   SECURITY_ATTRIBUTES *sec_attr)
+    :
+        _name(name),
+        _sec_attr(sec_attr),
+        _next_hndl(INVALID_HANDLE_VALUE),
+        _connect_event( CreateEvent(NULL, TRUE, FALSE, NULL) ),
+        _stop_event( CreateEvent(NULL, TRUE, FALSE, NULL) )
+    {
+        if(!_connect_event || !_stop_event){
+            errno_t e = GetLastError();
+            TOSDB_LogEx("IPC-Slave", "CreateEvent failed in NamedPipeServerTransport", e);
+            throw std::runtime_error("NamedPipeServerTransport failed to create events");
+        }
 
+        _next_hndl = _create_instance(true);
+        if(_next_hndl == INVALID_HANDLE_VALUE){
+            std::string msg = "IPCSlave failed to create pipe: " + _name;
+            CloseHandle(_connect_event);
+            CloseHandle(_stop_event);
+            throw std::runtime_error(msg);
+        }
+    }
 
-// needs to be non-blocking, called from DLLMain
-bool
-IPCMaster::call(std::string *msg, unsigned long timeout)
-{  
-    /* buffer for returned string */
-    std::string recv(MAX_MESSAGE_SZ, '\0');  
-
-    /* check buffer length */
-    if(msg->length() > MAX_MESSAGE_SZ){
-        TOSDB_LogRawH("IPC", "IPCMaster::call() :: msg length > MAX_MESSAGE_SZ");
-        throw std::invalid_argument("IPCMaster::call() :: msg length > MAX_MESSAGE_SZ");
-    } 
-
-    /* assign the receive buffer*/
-    std::function<bool(const char*,DWORD)> cb_good = 
-        [msg,&recv](const char* d1, DWORD d2){ *msg = recv; return true; };
-
-    /* if we get here the main pipe *should* be available; log if not */
-    std::function<void(void)> cb_no_file = 
-        [](){ TOSDB_LogRawH("IPC", "main pipe not found (slave not available)"); };
-       
-    /* size_t to DWORD cast ok because we check msg length above */
-    return _call_pipe( _main_channel_pipe_name, 
-                       msg->c_str(), msg->length() + 1, 
-                       recv.c_str(), recv.length() + 1, 
-                       timeout, cb_good, cb_no_file ); 
+
+NamedPipeServerTransport::~NamedPipeServerTransport()
+{
+    if(_next_hndl != INVALID_HANDLE_VALUE)
+        CloseHandle(_next_hndl);
+    CloseHandle(_connect_event);
+    CloseHandle(_stop_event);
 }
 
 
 HANDLE
-IPCSlave::_create_pipe(std::string name)
+NamedPipeServerTransport::_create_instance(bool first)
 {
-    HANDLE h = CreateNamedPipe(name.c_str(), PIPE_ACCESS_DUPLEX,
-                               PIPE_TYPE_MESSAGE | PIPE_READMODE_BYTE | PIPE_WAIT,
-                               1, 0, 0, NMPWAIT_NOWAIT, &_sec_attr);    
+    /* the first instance makes sure no one else (another engine) owns the name */
+    DWORD open_mode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED 
+                      | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+
+    HANDLE h = CreateNamedPipe(_name.c_str(), open_mode,
+                               PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+                               PIPE_UNLIMITED_INSTANCES, IPCMessage::MAX_FRAME_SZ, 
+                               IPCMessage::MAX_FRAME_SZ, 0, _sec_attr);    
      
     if(h == INVALID_HANDLE_VALUE){        
         errno_t e = GetLastError();
-        std::string msg = "IPCSlave failed to create pipe: " + name + " ("  + std::to_string(e) + ")";
+        std::string msg = "failed to create pipe instance: " + _name + " ("  + std::to_string(e) + ")";
         TOSDB_LogEx("IPC-Slave", msg.c_str(), e);        
-        throw std::runtime_error(msg);
     }
 
     return h;
 }
 
 
-bool 
-IPCSlave::wait_for_master()
-{    
-    if( !ConnectNamedPipe(_main_channel_pipe_hndl, NULL) )
-    {       
-        TOSDB_LogEx("IPC-Slave", "ConnectNamedPipe failed in wait_for_master", GetLastError());        
-        return false;
+IPCConnection*
+NamedPipeServerTransport::accept()
+{
+    HANDLE h;
+    DWORD d;
+    DWORD w;
+    errno_t e;
+
+    for(;;){
+        if(_next_hndl == INVALID_HANDLE_VALUE){
+            _next_hndl = _create_instance(false);
+            if(_next_hndl == INVALID_HANDLE_VALUE)
+                return nullptr;
+        }
+
+        OVERLAPPED ov = {};
+        ov.hEvent = _connect_event;
+        ResetEvent(_connect_event);
+
+        if( !ConnectNamedPipe(_next_hndl, &ov) ){
+            e = GetLastError();
+            if(e == ERROR_IO_PENDING){
+                HANDLE evs[2] = {_stop_event, _connect_event};
+                w = WaitForMultipleObjects(2, evs, FALSE, INFINITE);
+                if(w != WAIT_OBJECT_0 + 1){ /* interrupt() (or failure) */
+                    CancelIoEx(_next_hndl, &ov);
+                    GetOverlappedResult(_next_hndl, &ov, &d, TRUE);
+                    return nullptr;
+                }
+                if( !GetOverlappedResult(_next_hndl, &ov, &d, FALSE) )
+                    e = GetLastError();
+                else
+                    e = ERROR_PIPE_CONNECTED;
+            }
+            if(e != ERROR_PIPE_CONNECTED){ 
+                /* this instance is no good (client gave up?); try another */
+                TOSDB_LogEx("IPC-Slave", "ConnectNamedPipe failed in accept", e);
+                CloseHandle(_next_hndl);
+                _next_hndl = INVALID_HANDLE_VALUE;
+                continue;
+            }
+        }
+
+        /* hand off the connected instance, keep a fresh one listening */
+        h = _next_hndl;
+        _next_hndl = _create_instance(false);
+        return new NamedPipeConnection(h);
     }
-    return true;
 }
 
 
 void
-IPCSlave::_listen_for_probes()
+NamedPipeServerTransport::interrupt()
 {
-    BOOL ret;
-    DWORD r;
-    uint8_t b;
-    errno_t e;          
-
-    while(_probe_channel_run_flag){ 
-     /* Main run loop for the probe channel: a very simple named pipe server that 
-        allows clients (master AND slave objects) to share a single pipe instance 
-        in order to send a PROBE_BYTE. If the server receives a valid PROBE_BYTE it 
-        returns it, disconnects the pipe instance and waits for another */
-
-        ret = ConnectNamedPipe(_probe_channel_pipe_hndl, NULL);
-        if(!ret){
-            e = GetLastError();                               
-            if(e != ERROR_PIPE_CONNECTED){  /* in case client connects first */
-                TOSDB_LogEx("IPC", "ConnectNamedPipe failed in probe_channel", e);
-                continue;
-            }
+    SetEvent(_stop_event);
+}
+
+
+IPCConnection*
+NamedPipeClientTransport::connect(unsigned long timeout)
+{
+    HANDLE h;
+    errno_t e;
+    DWORD mode = PIPE_READMODE_MESSAGE;
+
+    for(;;){
+        h = CreateFile(_name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, 
+                       OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+        if(h != INVALID_HANDLE_VALUE)
+            break;
+
+        e = GetLastError(); 
+        if(e == ERROR_FILE_NOT_FOUND){
+            /* if we get here the main pipe *should* be available; log if not */
+            TOSDB_LogLimitedH("IPC", nullptr, "main pipe not found (slave not available)"); 
+            return nullptr;
         }
 
-        b = 0;
-        r = 0;
-        ret = ReadFile(_probe_channel_pipe_hndl, (void*)&b, sizeof(b), &r, NULL);
-        if(!ret){           
-            e = GetLastError();
-            if(e == ERROR_BROKEN_PIPE)
-                TOSDB_LogDebug("***IPC*** PROBE RECV - (BROKEN_PIPE)");
-            else
-                TOSDB_LogEx("IPC", "ReadFile failed in _listen_for_probes()", e);            
-        }                          
- 
-        if (r != sizeof(PROBE_BYTE)){
-            TOSDB_LogH("IPC", ("bad probe size received: " + std::to_string(r)).c_str());
-            b = 0;            
-        }else if(b != PROBE_BYTE){
-            TOSDB_LogH("IPC", ("bad probe value received: " + std::to_string(b)).c_str());                      
-            if (b == PROBE_BYTE_WRONG_ARCH){
-                TOSDB_LogH("IPC", "build mismatch between engine and library(x86 vs x64)");                
-                b = PROBE_BYTE;
-            }else{
-                b = 0;  
-            }
+        if(e != ERROR_PIPE_BUSY || !WaitNamedPipe(_name.c_str(), timeout)){
+            TOSDB_LogLimitedH("IPC", std::to_string(e).c_str(), "failed to open pipe, ERROR#");
+            return nullptr;
         }
- 
-        r = 0;
-        ret = WriteFile(_probe_channel_pipe_hndl, (void*)&b, sizeof(b), &r, NULL);
-        if(!ret || r != sizeof(PROBE_BYTE))
-            TOSDB_LogEx("IPC", "WriteFile failed in _listen_for_probes()", GetLastError());
-
-        FlushFileBuffers(_probe_channel_pipe_hndl);        
-        DisconnectNamedPipe(_probe_channel_pipe_hndl);       
-    } 
+    }
+
+    if( !SetNamedPipeHandleState(h, &mode, NULL, NULL) ){
+        TOSDB_LogEx("IPC", "SetNamedPipeHandleState failed in connect()", GetLastError());
+        CloseHandle(h);
+        return nullptr;
+    }
+
+    return new NamedPipeConnection(h);
+}
+
+
+const IPCHeartbeat*
+IPCMaster::_open_heartbeat()
+{ /* CALLING CODE MUST LOCK _heartbeat_mtx; NULL if the slave isn't up (yet) */
+    void *addr;
+
+    _heartbeat_hndl = OpenFileMapping(FILE_MAP_READ, FALSE, _heartbeat_name.c_str());
+    if(!_heartbeat_hndl)
+        return nullptr;
+
+    addr = MapViewOfFile(_heartbeat_hndl, FILE_MAP_READ, 0, 0, sizeof(IPCHeartbeat));
+    if(!addr){
+        TOSDB_LogEx("IPC", ("failed to map heartbeat: " + _heartbeat_name).c_str(), GetLastError());
+        CloseHandle(_heartbeat_hndl);
+        _heartbeat_hndl = NULL;
+        return nullptr;
+    }
+
+    return (const IPCHeartbeat*)addr;
+}
+
+
+// needs to be non-blocking, called from DLLMain
+bool 
+IPCMaster::connected(unsigned long timeout) 
+{ 
+    const IPCHeartbeat *hb = _heartbeat.load();
+
+    if(!hb){
+        std::lock_guard<std::mutex> lock(_heartbeat_mtx);
+        /* --- CRITICAL SECTION --- */
+        hb = _heartbeat.load();
+        if(!hb){
+            hb = _open_heartbeat();
+            if(!hb)
+                return false;
+            _heartbeat.store(hb);
+        }
+        /* --- CRITICAL SECTION --- */
+    }
+
+    if(hb->magic != IPCHeartbeat::MAGIC || hb->pid == 0)
+        return false;
+
+    if(hb->build != BUILD_WORD){
+        if( !_logged_build_mismatch.exchange(true) ){
+            TOSDB_LogRawH("IPC", ("bad build word in heartbeat: " + std::to_string(hb->build)).c_str());
+            if(hb->build == BUILD_WORD_WRONG_ARCH)
+                TOSDB_LogRawH("IPC", "build mismatch between engine and library(x86 vs x64)");   
+        }
+        return false;
+    }
+
+    /* unsigned diff handles GetTickCount() wrap-around */
+    return (GetTickCount() - hb->tick) <= timeout;
+}
+
+
+// needs to be non-blocking, called from DLLMain
+bool
+IPCMaster::call(IPCMessage *msg, unsigned long timeout)
+{  
+    uint32_t id;
+
+    if( !_main_channel.call(msg, timeout) ){
+        TOSDB_LogRawH("IPC", "IPCMaster::call() :: call failed (connection, size or reply)");
+        return false;
+    }
+
+    id = msg->request_id();
+    if(msg->flags() & IPCMessage::FLAG_ERROR){
+        TOSDB_LogRawH("IPC", ("IPCMaster::call() :: slave couldn't parse request #" 
+                              + std::to_string(id)).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+void
+IPCSlave::_init_heartbeat()
+{ /* the segment may already exist if a master still holds it from a 
+     previous engine; we just take it over */
+    std::string msg;
+    errno_t e;
+
+    _heartbeat_stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if(!_heartbeat_stop_event){
+        e = GetLastError();
+        msg = "IPCSlave failed to create heartbeat event";
+        TOSDB_LogEx("IPC-Slave", msg.c_str(), e);
+        throw std::runtime_error(msg);
+    }
+
+    _heartbeat_hndl = CreateFileMapping(INVALID_HANDLE_VALUE, &_sec_attr, PAGE_READWRITE, 
+                                        0, sizeof(IPCHeartbeat), _heartbeat_name.c_str());
+    if(!_heartbeat_hndl){
+        e = GetLastError();
+        msg = "IPCSlave failed to create heartbeat: " + _heartbeat_name + " ("  + std::to_string(e) + ")";
+        TOSDB_LogEx("IPC-Slave", msg.c_str(), e);
+        CloseHandle(_heartbeat_stop_event);
+        throw std::runtime_error(msg);
+    }
+
+    _heartbeat = (IPCHeartbeat*)MapViewOfFile(_heartbeat_hndl, FILE_MAP_ALL_ACCESS, 
+                                              0, 0, sizeof(IPCHeartbeat));
+    if(!_heartbeat){
+        e = GetLastError();
+        msg = "IPCSlave failed to map heartbeat: " + _heartbeat_name + " ("  + std::to_string(e) + ")";
+        TOSDB_LogEx("IPC-Slave", msg.c_str(), e);
+        CloseHandle(_heartbeat_hndl);
+        CloseHandle(_heartbeat_stop_event);
+        throw std::runtime_error(msg);
+    }
+
+    /* pid last; it's what masters check first */
+    _heartbeat->pid = 0;
+    _heartbeat->magic = IPCHeartbeat::MAGIC;
+    _heartbeat->build = BUILD_WORD;
+    _heartbeat->count = 0;
+    _heartbeat->tick = GetTickCount();
+    _heartbeat->pid = GetCurrentProcessId();
+}
+
+
+void
+IPCSlave::_beat()
+{
+    do{
+        ++(_heartbeat->count);
+        _heartbeat->tick = GetTickCount();
+    }while( WaitForSingleObject(_heartbeat_stop_event, IPCHeartbeat::INTERVAL_MSEC) == WAIT_TIMEOUT );
 }
 
 
@@ -0,0 +1,290 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/* no tos_databridge.h here; the channel has to build off windows too */
+#include "ipc_channel.hpp"
+
+
+void
+IPCClientChannel::_fail_connection(std::shared_ptr<IPCConnection> conn)
+{ /* CALLING CODE MUST LOCK _mtx; by value, we may be passed _conn itself */
+    if(!conn || _conn != conn) /* already failed (and maybe replaced) */
+        return;
+
+    _conn.reset();
+    conn->close();
+
+    /* everyone waiting on this connection is done */
+    for(auto & p : _pending){
+        p.second->done = true;
+        p.second->ok = false;
+        p.second->cond.notify_one();
+    }
+    _pending.clear();
+}
+
+
+bool
+IPCClientChannel::call(IPCMessage *msg, unsigned long timeout)
+{
+    std::shared_ptr<IPCConnection> conn;
+    std::string frame;
+    _waiter w;
+    bool ok;
+
+    w.msg = msg;
+    w.done = false;
+    w.ok = false;
+
+    std::unique_lock<std::mutex> lock(_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(!_conn){
+        /* connect under the lock; anyone else calling needs it too */
+        IPCConnection *c = _transport->connect(timeout);
+        if(!c)
+            return false;
+        _conn.reset(c);
+    }
+    conn = _conn;
+
+    if(_next_id == 0) /* 0 is reserved for 'unknown' */
+        ++_next_id;
+    msg->request_id(_next_id++);
+
+    if( !msg->encode(&frame) )
+        return false;
+
+    _pending[msg->request_id()] = &w;
+    lock.unlock();
+    /* --- CRITICAL SECTION --- */
+
+    {
+        std::lock_guard<std::mutex> wlock(_write_mtx);
+        ok = conn->write_frame(frame);
+    }
+
+    lock.lock();
+    /* --- CRITICAL SECTION --- */
+    if(!ok)
+        _fail_connection(conn);
+
+    while(!w.done){
+        if(_reading){ /* someone else is reading; they'll wake us */
+            w.cond.wait(lock);
+            continue;
+        }
+
+        /* our turn to read for everyone */
+        _reading = true;
+        lock.unlock();
+
+        IPCMessage reply;
+        ok = conn->read_frame(&frame) 
+             && IPCMessage::decode(frame.c_str(), frame.size(), &reply);
+
+        lock.lock();
+        _reading = false;
+
+        if(!ok){
+            _fail_connection(conn);
+            break;
+        }
+
+        auto iter = _pending.find(reply.request_id());
+        if(iter == _pending.end() || !(reply.flags() & IPCMessage::FLAG_REPLY))
+            continue; /* not ours to deliver (caller already failed) */
+
+        _waiter *pw = iter->second;
+        *(pw->msg) = reply;
+        pw->ok = true;
+        pw->done = true;
+        _pending.erase(iter);
+        if(pw != &w)
+            pw->cond.notify_one();
+    }
+
+    /* hand the reading off to one of those still waiting */
+    if(!_reading && !_pending.empty())
+        _pending.begin()->second->cond.notify_one();
+
+    return w.ok;
+    /* --- CRITICAL SECTION --- */
+}
+
+
+void
+IPCClientChannel::close()
+{
+    std::lock_guard<std::mutex> lock(_mtx);
+    /* --- CRITICAL SECTION --- */
+    _fail_connection(_conn);
+    /* --- CRITICAL SECTION --- */
+}
+
+
+IPCServerChannel::IPCServerChannel(IPCServerTransport *transport)
+    :
+        _transport(transport),
+        _stopped(false),
+        _failed(false)
+    {
+        _accept_thread = std::thread( std::bind(&IPCServerChannel::_accept_loop, this) );
+    }
+
+
+void
+IPCServerChannel::_accept_loop()
+{
+    for(;;){
+        IPCConnection *conn = _transport->accept();
+
+        std::unique_lock<std::mutex> lock(_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(_stopped){
+            delete conn;
+            return;
+        }
+
+        if(!conn){ /* transport is broken; let recv() report it */
+            _failed = true;
+            _cond.notify_all();
+            return;
+        }
+
+        client_ty c = std::make_shared<_client>(conn);
+        _clients.push_back(c);
+        c->reader = std::thread( std::bind(&IPCServerChannel::_read_loop, this, c) );
+        lock.unlock();
+        /* --- CRITICAL SECTION --- */
+
+        _reap(false);
+    }
+}
+
+
+void
+IPCServerChannel::_read_loop(client_ty c)
+{
+    std::string frame;
+
+    while( c->conn->read_frame(&frame) ){
+        IPCMessage msg;
+        if( !IPCMessage::decode(frame.c_str(), frame.size(), &msg) ){
+            /* framed but malformed; tell the sender so it doesn't wait forever */
+            IPCMessage err(IPCMessage::request_id_of(frame.c_str(), frame.size()), 
+                           IPCMessage::FLAG_REPLY | IPCMessage::FLAG_ERROR);
+            send(c, err);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(_stopped)
+            break;
+        _requests.push_back( std::make_pair(msg, c) );
+        _cond.notify_one();
+        /* --- CRITICAL SECTION --- */
+    }
+
+    /* client hung up (or we're stopping) */
+    c->conn->close();
+    c->finished = true;
+}
+
+
+void
+IPCServerChannel::_reap(bool all)
+{ /* join/drop reader threads of clients that are gone (or all of them) */
+    std::list<client_ty> dead;
+    
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        /* --- CRITICAL SECTION --- */
+        auto iter = _clients.begin();
+        while(iter != _clients.end()){
+            if(all || (*iter)->finished){
+                dead.push_back(*iter);
+                iter = _clients.erase(iter);
+            }else{
+                ++iter;
+            }
+        }
+        /* --- CRITICAL SECTION --- */
+    }
+
+    for(auto & c : dead){
+        c->conn->close();
+        if(c->reader.joinable())
+            c->reader.join();
+    }
+}
+
+
+bool
+IPCServerChannel::recv(IPCMessage *msg, client_ty *from)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    /* --- CRITICAL SECTION --- */
+    while(_requests.empty() && !_stopped && !_failed)
+        _cond.wait(lock);
+
+    if(_requests.empty())
+        return false;
+
+    *msg = _requests.front().first;
+    *from = _requests.front().second;
+    _requests.pop_front();
+    return true;
+    /* --- CRITICAL SECTION --- */
+}
+
+
+bool
+IPCServerChannel::send(const client_ty& to, const IPCMessage& msg)
+{
+    std::string frame;
+
+    if( !to || !msg.encode(&frame) )
+        return false;
+
+    std::lock_guard<std::mutex> lock(to->write_mtx);
+    /* --- CRITICAL SECTION --- */
+    return to->conn->write_frame(frame);
+    /* --- CRITICAL SECTION --- */
+}
+
+
+void
+IPCServerChannel::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(_stopped)
+            return;
+        _stopped = true;
+        _requests.clear();
+        _cond.notify_all();
+        /* --- CRITICAL SECTION --- */
+    }
+
+    _transport->interrupt();
+    if(_accept_thread.joinable())
+        _accept_thread.join();
+
+    _reap(true);
+}
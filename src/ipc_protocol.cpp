@@ -0,0 +1,268 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/* no tos_databridge.h here; the codec has to build off windows too */
+#include "ipc_protocol.hpp"
+
+#include <string.h>
+
+namespace {
+
+void
+_put_u16(std::string *out, uint16_t v)
+{
+    out->push_back((char)(v & 0xFF));
+    out->push_back((char)((v >> 8) & 0xFF));
+}
+
+void
+_put_u32(std::string *out, uint32_t v)
+{
+    for(int i = 0; i < 4; ++i)
+        out->push_back((char)((v >> (8*i)) & 0xFF));
+}
+
+uint16_t
+_get_u16(const char *p)
+{
+    const unsigned char *u = (const unsigned char*)p;
+    return (uint16_t)(u[0] | (u[1] << 8));
+}
+
+uint32_t
+_get_u32(const char *p)
+{
+    const unsigned char *u = (const unsigned char*)p;
+    return (uint32_t)u[0] | ((uint32_t)u[1] << 8) 
+           | ((uint32_t)u[2] << 16) | ((uint32_t)u[3] << 24);
+}
+
+}; /* namespace */
+
+
+IPCRecord&
+IPCRecord::add_u32(uint32_t val)
+{
+    _field f;
+    f.type = FIELD_U32;
+    f.val = val;
+    _fields.push_back(std::move(f));
+    return *this;
+}
+
+
+IPCRecord&
+IPCRecord::add_i32(int32_t val)
+{
+    _field f;
+    f.type = FIELD_I32;
+    f.val = (uint32_t)val;
+    _fields.push_back(std::move(f));
+    return *this;
+}
+
+
+IPCRecord&
+IPCRecord::add_string(const std::string& val)
+{
+    _field f;
+    f.type = FIELD_STR;
+    f.val = 0;
+    f.str = val;
+    _fields.push_back(std::move(f));
+    return *this;
+}
+
+
+bool
+IPCRecord::get_u32(size_t i, uint32_t *val) const
+{
+    if(i >= _fields.size() || _fields[i].type != FIELD_U32)
+        return false;
+
+    *val = _fields[i].val;
+    return true;
+}
+
+
+bool
+IPCRecord::get_i32(size_t i, int32_t *val) const
+{
+    if(i >= _fields.size() || _fields[i].type != FIELD_I32)
+        return false;
+
+    *val = (int32_t)_fields[i].val;
+    return true;
+}
+
+
+bool
+IPCRecord::get_string(size_t i, std::string *val) const
+{
+    if(i >= _fields.size() || _fields[i].type != FIELD_STR)
+        return false;
+
+    *val = _fields[i].str;
+    return true;
+}
+
+
+IPCRecord&
+IPCMessage::add_record()
+{
+    _records.push_back(IPCRecord());
+    return _records.back();
+}
+
+
+bool
+IPCMessage::encode(std::string *frame) const
+{
+    std::string body;
+
+    for(auto & rec : _records){
+        if(rec._fields.size() > 0xFFFF)
+            return false;
+
+        _put_u16(&body, (uint16_t)rec._fields.size());
+        for(auto & f : rec._fields){
+            body.push_back((char)f.type);
+            switch(f.type){
+            case IPCRecord::FIELD_U32:
+            case IPCRecord::FIELD_I32:
+                _put_u32(&body, f.val);
+                break;
+            case IPCRecord::FIELD_STR:
+                if(f.str.size() > MAX_STRING_SZ)
+                    return false;
+                _put_u16(&body, (uint16_t)f.str.size());
+                body.append(f.str);
+                break;
+            }
+        }
+
+        if(body.size() > MAX_FRAME_SZ - HEADER_SZ)
+            return false;
+    }
+
+    frame->clear();
+    frame->reserve(HEADER_SZ + body.size());
+    _put_u32(frame, MAGIC);
+    _put_u16(frame, VERSION);
+    _put_u16(frame, _flags);
+    _put_u32(frame, _request_id);
+    _put_u32(frame, (uint32_t)_records.size());
+    _put_u32(frame, (uint32_t)body.size());
+    frame->append(body);
+
+    return true;
+}
+
+
+size_t
+IPCMessage::frame_size(const char *header, size_t len)
+{
+    if(len < HEADER_SZ)
+        return 0;
+
+    if(_get_u32(header) != MAGIC || _get_u16(header + 4) != VERSION)
+        return 0;
+
+    uint32_t blen = _get_u32(header + 16);
+    if(blen > MAX_FRAME_SZ - HEADER_SZ)
+        return 0;
+
+    return HEADER_SZ + blen;
+}
+
+
+uint32_t
+IPCMessage::request_id_of(const char *frame, size_t len)
+{
+    return (len < HEADER_SZ) ? 0 : _get_u32(frame + 8);
+}
+
+
+bool
+IPCMessage::decode(const char *frame, size_t len, IPCMessage *msg)
+{
+    size_t fsz = frame_size(frame, len);
+    if(fsz == 0 || fsz != len) /* 0 == bad header, even if 'len' is 0 too */
+        return false;
+
+    IPCMessage tmp(_get_u32(frame + 8), _get_u16(frame + 6));
+    uint32_t nrecs = _get_u32(frame + 12);
+
+    const char *p = frame + HEADER_SZ;
+    const char *end = frame + len;
+
+    /* each record needs atleast its 2-byte field count */
+    if(nrecs > (uint32_t)(end - p) / 2)
+        return false;
+
+    tmp._records.reserve(nrecs);
+    for(uint32_t r = 0; r < nrecs; ++r){
+        if(end - p < 2)
+            return false;
+
+        uint16_t nfields = _get_u16(p);
+        p += 2;
+
+        IPCRecord& rec = tmp.add_record();
+        for(uint16_t i = 0; i < nfields; ++i){
+            if(end - p < 1)
+                return false;
+
+            uint8_t type = (uint8_t)*p++;
+            switch(type){
+            case IPCRecord::FIELD_U32:
+            case IPCRecord::FIELD_I32:
+                if(end - p < 4)
+                    return false;
+                if(type == IPCRecord::FIELD_U32)
+                    rec.add_u32(_get_u32(p));
+                else
+                    rec.add_i32((int32_t)_get_u32(p));
+                p += 4;
+                break;
+            case IPCRecord::FIELD_STR:
+                {
+                    if(end - p < 2)
+                        return false;
+                    uint16_t slen = _get_u16(p);
+                    p += 2;
+                    if(end - p < slen)
+                        return false;
+                    rec.add_string(std::string(p, slen));
+                    p += slen;
+                }
+                break;
+            default: /* unknown field type */
+                return false;
+            }
+        }
+    }
+
+    if(p != end) /* trailing junk */
+        return false;
+
+    /* no implicit move ops on VS2012; swap the records in */
+    msg->_request_id = tmp._request_id;
+    msg->_flags = tmp._flags;
+    msg->_records.swap(tmp._records);
+    return true;
+}
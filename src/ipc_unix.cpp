@@ -0,0 +1,214 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/* unix domain socket transport for the control channel protocol; NOT part 
+   of the windows build - lets us run/test ipc_protocol off windows 
+   (see test/c_cpp/test_ipc_unix.cpp) */
+
+#ifndef _WIN32
+
+#include "ipc_protocol.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+
+bool
+_read_n(int fd, char *buf, size_t n)
+{
+    while(n){
+        ssize_t r = ::recv(fd, buf, n, 0);
+        if(r <= 0){
+            if(r < 0 && errno == EINTR)
+                continue;
+            return false; /* error or peer closed */
+        }
+        buf += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+bool
+_make_addr(const std::string& path, sockaddr_un *addr)
+{
+    if(path.size() >= sizeof(addr->sun_path))
+        return false;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strncpy(addr->sun_path, path.c_str(), sizeof(addr->sun_path) - 1);
+    return true;
+}
+
+}; /* namespace */
+
+
+bool
+IPCReadFrameFD(int fd, std::string *frame)
+{
+    char hdr[IPCMessage::HEADER_SZ];
+
+    if( !_read_n(fd, hdr, sizeof(hdr)) )
+        return false;
+
+    size_t fsz = IPCMessage::frame_size(hdr, sizeof(hdr));
+    if(fsz == 0)
+        return false;
+
+    frame->assign(hdr, sizeof(hdr));
+    frame->resize(fsz);
+    return _read_n(fd, &(*frame)[0] + sizeof(hdr), fsz - sizeof(hdr));
+}
+
+
+bool
+IPCWriteFrameFD(int fd, const std::string& frame)
+{
+    const char *p = frame.c_str();
+    size_t n = frame.size();
+
+    while(n){
+        ssize_t r = ::send(fd, p, n, MSG_NOSIGNAL);
+        if(r < 0){
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+
+UnixSocketConnection::~UnixSocketConnection()
+{
+    ::close(_fd);
+}
+
+
+bool
+UnixSocketConnection::read_frame(std::string *frame)
+{
+    return IPCReadFrameFD(_fd, frame);
+}
+
+
+bool
+UnixSocketConnection::write_frame(const std::string& frame)
+{
+    return IPCWriteFrameFD(_fd, frame);
+}
+
+
+void
+UnixSocketConnection::close()
+{
+    /* wakes a blocked recv(); the fd itself is closed by the destructor so
+       it can't be reused out from under a thread still using it */
+    shutdown(_fd, SHUT_RDWR);
+}
+
+
+UnixSocketServerTransport::UnixSocketServerTransport(std::string path)
+    :
+        _path(path),
+        _listen_fd(-1)
+    {
+        sockaddr_un addr;
+
+        if( !_make_addr(_path, &addr) )
+            throw std::runtime_error("UnixSocketServerTransport: path too long: " + _path);
+
+        _listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(_listen_fd < 0)
+            throw std::runtime_error("UnixSocketServerTransport: socket failed");
+
+        unlink(_path.c_str());
+        if( bind(_listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 
+            || listen(_listen_fd, 16) != 0 )
+        {
+            ::close(_listen_fd);
+            throw std::runtime_error("UnixSocketServerTransport: bind/listen failed: " + _path);
+        }
+    }
+
+
+UnixSocketServerTransport::~UnixSocketServerTransport()
+{
+    ::close(_listen_fd);
+    unlink(_path.c_str());
+}
+
+
+IPCConnection*
+UnixSocketServerTransport::accept()
+{
+    int fd;
+
+    do{
+        fd = ::accept(_listen_fd, NULL, NULL);
+    }while(fd < 0 && errno == EINTR);
+
+    return (fd < 0) ? nullptr : new UnixSocketConnection(fd);
+}
+
+
+void
+UnixSocketServerTransport::interrupt()
+{
+    /* accept() in another thread returns with an error */
+    shutdown(_listen_fd, SHUT_RDWR);
+}
+
+
+IPCConnection*
+UnixSocketClientTransport::connect(unsigned long timeout)
+{
+    sockaddr_un addr;
+    int fd;
+
+    if( !_make_addr(_path, &addr) )
+        return nullptr;
+
+    /* like WaitNamedPipe, 'timeout' bounds how long we wait for the server */
+    auto tend = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    for(;;){
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0)
+            return nullptr;
+
+        if( ::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0 )
+            return new UnixSocketConnection(fd);
+
+        ::close(fd);
+        if(std::chrono::steady_clock::now() >= tend)
+            return nullptr;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+#endif /* _WIN32 */
@@ -17,16 +17,29 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 
 #include "tos_databridge.h"
 #include "concurrency.hpp"
+#include "logging.hpp"
 
 #include <iomanip>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
 
-/* [Jan 16 2017] in order to synchronize 'atomic' write operations we use 
-   a named mutex via NamedMutexLockGuard (if LOG_BACKEND_USE_SINGLE_FILE is 
-   #defined and we need inter-process sync) or std::lock_guard<std::mutex>        
-     
-   (ideally we should use an async producer/consumer queue for better performance) */
+/* each thread that logs gets its own (lock-free, single-producer) ring of 
+   fixed-size records, claimed on its first log call and handed back on 
+   DLL_THREAD_DETACH. A background writer drains all the rings every 
+   WRITER_WAIT_MSEC (sooner on a HIGH record or a half-full ring), writes 
+   the batch in time order and flushes once; the named mutex 
+   (LOG_BACKEND_USE_SINGLE_FILE) is taken once per batch instead of per line. 
+
+   If a ring is full the new record is dropped and counted; the writer logs 
+   how many were dropped so the loss is bounded and visible. 
+
+   The writer also writes the TOSDB_LogLimited_ summary every 
+   LIMIT_SUMMARY_MSEC. */
 
 namespace {
 
@@ -34,25 +47,146 @@ const system_clock_type SYSTEM_CLOCK;
 const size_type COL_WIDTHS[5] = {36, 12, 12, 20, 12};
 const LPCSTR  SEVERITY[2] = {"LOW","HIGH"};
 
+const size_t RING_SZ = 256;
+const size_t TAG_SZ = 20; /* = COL_WIDTHS[3] */
+const size_t DESC_SZ = 512; /* longer descriptions are truncated */
+const DWORD WRITER_WAIT_MSEC = 50;
+const DWORD STOP_WAIT_MSEC = 1000;
+
+typedef struct{
+    system_clock_type::time_point time;
+    DWORD tid;
+    Severity sevr;
+    char tag[TAG_SZ];
+    char desc[DESC_SZ];
+} LogRecord;
+
+
+class LogRing{
+    LogRecord _recs[RING_SZ];
+    std::atomic<size_t> _head; /* next to write (owner) */
+    std::atomic<size_t> _tail; /* next to read (writer) */
+
+    LogRing(const LogRing&);
+    LogRing& operator=(const LogRing&);
+
+public:
+    std::atomic<DWORD> owner; /* 0 if free */
+    std::atomic<unsigned long> dropped;
+
+    LogRing()
+        :
+            _head(0),
+            _tail(0),
+            owner(0),
+            dropped(0)
+        {
+        }
+
+    bool
+    push(system_clock_type::time_point now, Severity sevr, LPCSTR tag, LPCSTR desc)
+    { /* owner only */
+        size_t h = _head.load(std::memory_order_relaxed);
+        if(h - _tail.load(std::memory_order_acquire) >= RING_SZ){
+            ++dropped;
+            return false;
+        }
+
+        LogRecord& r = _recs[h % RING_SZ];
+        r.time = now;
+        r.tid = GetCurrentThreadId();
+        r.sevr = sevr;
+        strncpy_s(r.tag, sizeof(r.tag), tag, _TRUNCATE);
+        strncpy_s(r.desc, sizeof(r.desc), desc, _TRUNCATE);
+
+        _head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t
+    pending() const
+    {
+        return _head.load(std::memory_order_relaxed) 
+               - _tail.load(std::memory_order_relaxed);
+    }
+
+    void
+    drain(std::vector<LogRecord> *dest)
+    { /* writer only */
+        size_t t = _tail.load(std::memory_order_relaxed);
+        size_t h = _head.load(std::memory_order_acquire);
+        for( ; t != h; ++t)
+            dest->push_back(_recs[t % RING_SZ]);
+        _tail.store(t, std::memory_order_release);
+    }
+};
+
+
 #ifndef LOG_BACKEND_USE_SINGLE_FILE
 std::mutex log_file_mtx;
 #endif
 
 std::ofstream log_file;
 
+/* rings are never freed while logging (a writer may be reading them), 
+   only handed to another thread; guards 'rings' not the rings themselves */
+std::vector<LogRing*> rings;
+std::mutex rings_mtx;
+DWORD ring_tls = TlsAlloc();
+
+/* serializes draining/writing between the writer and Stop/ClearLog */
+std::mutex writer_mtx;
+std::atomic<bool> writer_run(false);
+HANDLE writer_wake = NULL;
+HANDLE writer_done = NULL;
+
+
+std::string
+_time_string(system_clock_type::time_point tp, bool use_msec)
+{
+    using namespace std::chrono;
+
+    time_t now;
+    long long ms_rem = 0;
+    int madj = use_msec ? 10 : 0; // 2 + 6 + 1 + 1(pad) = 10 char
+
+    SmartBuffer<char> buf(COL_WIDTHS[0] - madj);    
+
+    if(use_msec){
+        auto ms = duration_cast<microseconds>(tp.time_since_epoch());
+        ms_rem = ms.count() % 1000000; 
+        /* remove the msec so we don't accidentally round up */
+        now = SYSTEM_CLOCK.to_time_t(tp - microseconds(ms_rem));  
+    }else{
+        now = SYSTEM_CLOCK.to_time_t(tp);  
+    }
+  
+    ctime_s(buf.get(), COL_WIDTHS[0] - madj, &now); 
+
+    std::string tmp(buf.get());
+    tmp.pop_back();
+
+    if(use_msec)        
+        tmp += " [" + std::to_string(ms_rem) + ']';     
+
+    return tmp;
+}
+
+
 void
 _write_log(std::ofstream& fout, 
            std::string now, 
+           DWORD tid,
            Severity sevr, 
            std::string tag, 
            std::string desc)
-{
+{ /* no std::endl, the writer flushes once per batch */
     fout << std::setw(COL_WIDTHS[0]) << std::left << now.substr(0,COL_WIDTHS[0]-1)
          << std::setw(COL_WIDTHS[1]) << std::left << GetCurrentProcessId()
-         << std::setw(COL_WIDTHS[2]) << std::left << GetCurrentThreadId()
+         << std::setw(COL_WIDTHS[2]) << std::left << tid
          << std::setw(COL_WIDTHS[3]) << std::left << std::string(tag).substr(0,COL_WIDTHS[3]-1)
          << std::setw(COL_WIDTHS[4]) << std::left << SEVERITY[sevr] 
-                                     << std::left << desc << std::endl; 
+                                     << std::left << desc << '\n'; 
 }
 
 void
@@ -65,39 +199,356 @@ _write_err(std::string now, std::string tag, std::string desc)
                                           << std::left << desc << std::endl;     
 }
 
+
+LogRing*
+_thread_ring()
+{ /* NULL if we can't get one (caller falls back to a direct write) */
+    LogRing *r = (LogRing*)TlsGetValue(ring_tls);
+    if(r)
+        return r;
+
+    DWORD tid = GetCurrentThreadId();
+    try{
+        std::lock_guard<std::mutex> lock(rings_mtx);
+        /* --- CRITICAL SECTION --- */
+        for(LogRing *free_ring : rings){
+            DWORD zero = 0;
+            if( free_ring->owner.compare_exchange_strong(zero, tid) ){
+                r = free_ring;
+                break;
+            }
+        }
+        if(!r){
+            r = new LogRing;
+            r->owner = tid;
+            rings.push_back(r);
+        }
+        /* --- CRITICAL SECTION --- */
+    }catch(...){
+        return nullptr;
+    }
+
+    TlsSetValue(ring_tls, r);
+    return r;
+}
+
+
+void
+_drain_and_write()
+{ /* CALLING CODE MUST LOCK writer_mtx */
+    std::vector<LogRecord> batch;
+    std::vector<std::pair<DWORD,unsigned long>> drops;
+    {
+        std::lock_guard<std::mutex> lock(rings_mtx);
+        /* --- CRITICAL SECTION --- */
+        for(LogRing *r : rings){
+            r->drain(&batch);
+            unsigned long d = r->dropped.exchange(0);
+            if(d)
+                drops.push_back( std::make_pair(r->owner.load(), d) );
+        }
+        /* --- CRITICAL SECTION --- */
+    }
+
+    if(batch.empty() && drops.empty())
+        return;
+
+    /* interleave the threads' records by time */
+    std::stable_sort(batch.begin(), batch.end(), 
+                     [](const LogRecord& l, const LogRecord& r){ return l.time < r.time; });
+    {
+#ifdef LOG_BACKEND_USE_SINGLE_FILE
+        /* if we share back end logs we need to sync across processes */ 
+        NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
+#else 
+        /* if not just use a typical mutex to sync across intra-process threads  */
+        std::lock_guard<std::mutex> lock(log_file_mtx);
+#endif
+        /* --- CRITICAL SECTION --- */
+        for(const LogRecord& r : batch){
+            if(log_file.is_open())
+                _write_log(log_file, _time_string(r.time, true), r.tid, r.sevr, r.tag, r.desc); 
+            else if(r.sevr > 0)
+                _write_err(_time_string(r.time, true), r.tag, r.desc);         
+        }
+        for(auto & d : drops){
+            std::string msg = std::to_string(d.second) + " log records from thread "
+                            + std::to_string(d.first) + " dropped (ring full)";
+            if(log_file.is_open())
+                _write_log(log_file, SysTimeString(), GetCurrentThreadId(), high, "LOGGING", msg); 
+            else
+                _write_err(SysTimeString(), "LOGGING", msg); 
+        }
+        if(log_file.is_open())
+            log_file.flush();
+        /* --- CRITICAL SECTION --- */
+    }
+}
+
+
+void
+_write_direct(system_clock_type::time_point now, 
+              Severity sevr, 
+              LPCSTR tag, 
+              LPCSTR description)
+{
+    if(log_file.is_open()){
+        _write_log(log_file, _time_string(now, true), GetCurrentThreadId(), sevr, tag, description); 
+        log_file.flush();
+    }else if(sevr > 0){
+        _write_err(_time_string(now, true), tag, description);         
+    }
+}
+
+
+/* TOSDB_LogLimited_: one token bucket per (call site, key), LIMIT_BURST 
+   messages then one every LIMIT_REFILL_MSEC; entries live in hashed shards 
+   so storms from different threads/sites don't serialize on one lock. 
+   Buckets are found by (__FILE__ ptr, line, hash of key) so a suppressed 
+   call doesn't allocate; strings are only built for a new bucket (which 
+   always logs) and for what's written. Keys that collide share a bucket. */
+const unsigned int LIMIT_BURST = 5;
+const long long LIMIT_REFILL_MSEC = 10000;
+const long long LIMIT_SUMMARY_MSEC = 60000;
+const size_t LIMIT_NSHARDS = 16;
+const size_t LIMIT_MAX_ENTRIES = 256; /* per shard, past this key is ignored */
+
+typedef struct{
+    Severity sevr;
+    std::string tag;
+    std::string desc;
+    std::string key;
+    std::string site;
+    unsigned int tokens;
+    steady_clock_type::time_point last_refill;
+    unsigned long long suppressed; /* since last reported */
+} LimitEntry;
+
+typedef struct{
+    LPCSTR file; /* __FILE__, compared by address */
+    int line;
+    size_t key_hash; /* 0: shared by all keys of the site (see LIMIT_MAX_ENTRIES) */
+} LimitSite;
+
+inline bool
+operator==(const LimitSite& l, const LimitSite& r)
+{
+    return l.file == r.file && l.line == r.line && l.key_hash == r.key_hash;
+}
+
+struct LimitSiteHash{
+    size_t
+    operator()(const LimitSite& s) const
+    {
+        size_t h = std::hash<const void*>()(s.file);
+        h ^= (size_t)s.line + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= s.key_hash + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+size_t
+_limit_key_hash(LPCSTR key)
+{ /* FNV-1a; never 0, that's the shared bucket */
+    unsigned long long h = 14695981039346656037ULL;
+
+    if(key){
+        for( ; *key; ++key)
+            h = (h ^ (unsigned char)*key) * 1099511628211ULL;
+    }
+    size_t r = (size_t)(h ^ (h >> 32));
+    return r ? r : 1;
+}
+
+class LimitShard{
+    LimitShard(const LimitShard&);
+    LimitShard& operator=(const LimitShard&);
+
+public:
+    std::mutex mtx;
+    std::unordered_map<LimitSite, LimitEntry, LimitSiteHash> entries;
+
+    LimitShard() {}
+};
+
+const steady_clock_type STEADY_CLOCK;
+LimitShard limit_shards[LIMIT_NSHARDS];
+std::atomic<unsigned long long> limit_emitted(0);
+std::atomic<unsigned long long> limit_suppressed(0);
+steady_clock_type::time_point limit_last_summary = STEADY_CLOCK.now(); /* writer only */
+
+
+void
+_limited_summary()
+{
+    using namespace std::chrono;
+
+    std::vector<LimitEntry> pending;
+    auto now = STEADY_CLOCK.now();
+
+    for(LimitShard & shard : limit_shards){
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        /* --- CRITICAL SECTION --- */
+        for(auto iter = shard.entries.begin(); iter != shard.entries.end(); ){
+            LimitEntry& e = iter->second;
+            if(e.suppressed){
+                pending.push_back(e);
+                e.suppressed = 0;
+                ++iter;
+            }else if(now - e.last_refill >= milliseconds(LIMIT_REFILL_MSEC * LIMIT_BURST)){
+                /* quiet long enough to have a full bucket, don't keep it */
+                iter = shard.entries.erase(iter);
+            }else{
+                ++iter;
+            }
+        }
+        /* --- CRITICAL SECTION --- */
+    }
+
+    for(const LimitEntry& e : pending){
+        std::string msg = e.desc + (e.key.empty() ? "" : " (" + e.key + ")") 
+                        + " - " + std::to_string(e.suppressed) + " suppressed [" + e.site + "]";
+        TOSDB_Log_(e.sevr, e.tag.c_str(), msg.c_str());
+    }
+
+    if(!pending.empty()){
+        std::string msg = "limited log totals: " + std::to_string(limit_emitted.load()) 
+                        + " logged, " + std::to_string(limit_suppressed.load()) + " suppressed";
+        TOSDB_Log_(low, "LOGGING", msg.c_str());
+    }
+}
+
+
+DWORD WINAPI
+_writer_loop(LPVOID lParam)
+{ /* lParam is the module ref StartLogging took for us */
+    using namespace std::chrono;
+
+    while(writer_run.load()){
+        WaitForSingleObject(writer_wake, WRITER_WAIT_MSEC);
+        if(STEADY_CLOCK.now() - limit_last_summary >= milliseconds(LIMIT_SUMMARY_MSEC)){
+            limit_last_summary = STEADY_CLOCK.now();
+            _limited_summary(); /* written on the next pass */
+        }
+        std::lock_guard<std::mutex> lock(writer_mtx);
+        /* --- CRITICAL SECTION --- */
+        _drain_and_write();
+        /* --- CRITICAL SECTION --- */
+    }
+    /* Stop waits on this (not the thread handle, we may be in DllMain) */
+    SetEvent(writer_done);
+
+    /* the DLL can't be unloaded until we let go of it here, once we're done 
+       running its code */
+    FreeLibraryAndExitThread((HMODULE)lParam, 0);
+    return 0;
+}
+
+
+void
+_log(Severity sevr, LPCSTR tag, LPCSTR description, bool sync)
+{
+    auto now = SYSTEM_CLOCK.now();
+    LogRing *r;
+
+    if(writer_run.load() && (r = _thread_ring()) ){
+        r->push(now, sevr, tag, description); /* if full, dropped and counted */
+        if(sevr > 0 || r->pending() >= RING_SZ / 2)
+            SetEvent(writer_wake);
+        return;
+    }
+
+    /* no writer (not started/stopped): write directly, like before */
+    if(!sync){
+        _write_direct(now, sevr, tag, description);
+        return;
+    }
+#ifdef LOG_BACKEND_USE_SINGLE_FILE
+    NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
+#else 
+    std::lock_guard<std::mutex> lock(log_file_mtx);
+#endif
+    /* --- CRITICAL SECTION --- */
+    _write_direct(now, sevr, tag, description);
+    /* --- CRITICAL SECTION --- */
+}
+
 };
 
 
 void 
 StartLogging(LPCSTR path)
 {
+    HMODULE mod;
+
+    {
 /* need to sync admin ops if we are sharing log between processes */
 #ifdef LOG_BACKEND_USE_SINGLE_FILE
-    NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
+        NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
 #endif
 
-    if(log_file.is_open())
-        return;
-
-    log_file.open(path , std::ios::out | std::ios::app);    
+        if(log_file.is_open())
+            return;
+
+        log_file.open(path , std::ios::out | std::ios::app);    
+
+        auto pos = log_file.seekp(0,std::ios::end).tellp();
+        if(pos == std::ios::pos_type(0)){
+            /* write header if necessary */
+            log_file << std::setw(COL_WIDTHS[0]) << std::left << "DATE / TIME"
+                     << std::setw(COL_WIDTHS[1]) << std::left << "Process ID"
+                     << std::setw(COL_WIDTHS[2]) << std::left << "Thread ID"
+                     << std::setw(COL_WIDTHS[3]) << std::left << "Log TAG"
+                     << std::setw(COL_WIDTHS[4]) << std::left << "Severity"
+                                                 << std::left << "Description"
+                                                 << std::endl << std::endl;    
+        }      
+    }
 
-    auto pos = log_file.seekp(0,std::ios::end).tellp();
-    if(pos == std::ios::pos_type(0)){
-        /* write header if necessary */
-        log_file << std::setw(COL_WIDTHS[0]) << std::left << "DATE / TIME"
-                 << std::setw(COL_WIDTHS[1]) << std::left << "Process ID"
-                 << std::setw(COL_WIDTHS[2]) << std::left << "Thread ID"
-                 << std::setw(COL_WIDTHS[3]) << std::left << "Log TAG"
-                 << std::setw(COL_WIDTHS[4]) << std::left << "Severity"
-                                             << std::left << "Description"
-                                             << std::endl << std::endl;    
-    }      
+    if(!writer_wake)
+        writer_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if(!writer_done)
+        writer_done = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    /* the writer holds a ref to this DLL so it can't be unloaded out from 
+       under the writer after StopLogging (see _writer_loop) */
+    if(writer_wake && writer_done && !writer_run.load()
+       && GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, 
+                             (LPCSTR)_writer_loop, &mod) )
+    {
+        ResetEvent(writer_done);
+        writer_run.store(true);
+        HANDLE h = CreateThread(NULL, 0, _writer_loop, (LPVOID)mod, 0, NULL);
+        if(h){
+            CloseHandle(h);
+        }else{
+            writer_run.store(false); /* log synchronously */
+            FreeLibrary(mod);
+        }
+    }
 }
 
 
 void 
 StopLogging() 
 { 
+    /* anything still suppressed goes out with the final drain */
+    _limited_summary();
+
+    if( writer_run.exchange(false) ){
+        SetEvent(writer_wake);
+        /* the writer may be gone already (process exit) */
+        WaitForSingleObject(writer_done, STOP_WAIT_MSEC);
+    }
+
+    {
+        /* whatever is left in the rings; don't block on a writer that 
+           was killed holding the lock */
+        std::unique_lock<std::mutex> lock(writer_mtx, std::try_to_lock);
+        if(lock.owns_lock())
+            _drain_and_write();
+    }
+
 /* need to sync admin ops if we are sharing log between processes */
 #ifdef LOG_BACKEND_USE_SINGLE_FILE
     NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
@@ -122,26 +573,21 @@ ClearLog()
 }
 
 
+void
+ReleaseThreadLogRing()
+{
+    LogRing *r = (LogRing*)TlsGetValue(ring_tls);
+    if(r){
+        TlsSetValue(ring_tls, NULL);
+        r->owner.store(0); /* the writer still drains what's left */
+    }
+}
+
+
 void 
 TOSDB_Log_(Severity sevr, LPCSTR tag, LPCSTR description) 
 {   
-
-#ifdef LOG_BACKEND_USE_SINGLE_FILE
-    /* if we share back end logs we need to sync across processes */ 
-    NamedMutexLockGuard lock(LOG_BACKEND_MUTEX_NAME);
-#else 
-    /* if not just use a typical mutex to sync across intra-process threads  */
-    std::lock_guard<std::mutex> lock(log_file_mtx);
-#endif
-
-    /* --- CRITICAL SECTION --- */
-    std::string now = SysTimeString();
-      
-    if(log_file.is_open())   
-        _write_log(log_file, now, sevr, tag, description); 
-    else if(sevr > 0)
-        _write_err(now, tag, description);         
-  /* --- CRITICAL SECTION --- */
+    _log(sevr, tag, description, true);
 }
 
 
@@ -156,44 +602,83 @@ TOSDB_LogEx_(Severity sevr, LPCSTR tag, LPCSTR description, int error)
 void 
 TOSDB_LogRaw_(Severity sevr, LPCSTR tag, LPCSTR description) 
 {
-    std::string now = SysTimeString();
-
-    if(log_file.is_open())  
-        _write_log(log_file, now, sevr, tag, description); 
-    else if(sevr > 0)
-        _write_err(now, tag, description);     
+    /* doesn't block once the thread has its ring */
+    _log(sevr, tag, description, false);
 }
 
 
-std::string 
-SysTimeString(bool use_msec)
+void 
+TOSDB_LogLimited_(Severity sevr, 
+                  LPCSTR file, 
+                  int line, 
+                  LPCSTR tag, 
+                  LPCSTR key, 
+                  LPCSTR description)
 {
     using namespace std::chrono;
 
-    time_t now;
-    long long ms_rem = 0;
-    int madj = use_msec ? 10 : 0; // 2 + 6 + 1 + 1(pad) = 10 char
-
-    SmartBuffer<char> buf(COL_WIDTHS[0] - madj);    
-
-    auto tp = SYSTEM_CLOCK.now();  
-
-    if(use_msec){
-        auto ms = duration_cast<microseconds>(tp.time_since_epoch());
-        ms_rem = ms.count() % 1000000; 
-        /* remove the msec so we don't accidentally round up */
-        now = SYSTEM_CLOCK.to_time_t(tp - microseconds(ms_rem));  
-    }else{
-        now = SYSTEM_CLOCK.to_time_t(tp);  
+    unsigned long long nsupp;
+    LimitSite id = {file, line, _limit_key_hash(key)};
+
+    LimitShard& shard = limit_shards[ LimitSiteHash()(id) % LIMIT_NSHARDS ];
+    auto now = STEADY_CLOCK.now();
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        /* --- CRITICAL SECTION --- */
+        auto iter = shard.entries.find(id);
+        if(iter == shard.entries.end()){
+            if(shard.entries.size() >= LIMIT_MAX_ENTRIES){ 
+                /* too many keys, share one bucket per site */
+                key = nullptr;
+                id.key_hash = 0;
+                iter = shard.entries.find(id);
+            }
+            if(iter == shard.entries.end()){
+                LimitEntry e;
+                e.sevr = sevr;
+                e.tag = tag;
+                e.desc = description;
+                e.key = key ? key : "";
+                e.site = std::string(file ? file : "") + ':' + std::to_string(line);
+                e.tokens = LIMIT_BURST;
+                e.last_refill = now;
+                e.suppressed = 0;
+                iter = shard.entries.insert( std::make_pair(id, e) ).first;
+            }
+        }
+
+        LimitEntry& e = iter->second;
+        long long nrefill = duration_cast<milliseconds>(now - e.last_refill).count() 
+                            / LIMIT_REFILL_MSEC;
+        if(nrefill > 0){
+            e.tokens = (unsigned int)std::min<long long>(LIMIT_BURST, e.tokens + nrefill);
+            e.last_refill += milliseconds(nrefill * LIMIT_REFILL_MSEC);
+        }
+
+        if(!e.tokens){
+            ++e.suppressed;
+            ++limit_suppressed;
+            return;
+        }
+        --e.tokens;
+        nsupp = e.suppressed;
+        e.suppressed = 0;
+        /* --- CRITICAL SECTION --- */
     }
-  
-    ctime_s(buf.get(), COL_WIDTHS[0] - madj, &now); 
+    ++limit_emitted;
 
-    std::string tmp(buf.get());
-    tmp.pop_back();
+    std::string msg(description);
+    if(key && *key)
+        msg.append(" (").append(key).append(")");
+    if(nsupp)
+        msg.append(" - ").append(std::to_string(nsupp)).append(" similar suppressed");
 
-    if(use_msec)        
-        tmp += " [" + std::to_string(ms_rem) + ']';     
+    TOSDB_Log_(sevr, tag, msg.c_str());
+}
 
-    return tmp;
-}
\ No newline at end of file
+
+std::string 
+SysTimeString(bool use_msec)
+{
+    return _time_string(SYSTEM_CLOCK.now(), use_msec);
+}
@@ -17,6 +17,7 @@ along with this program.  If not, see http://www.gnu.org/licenses.
 
 #include "tos_databridge.h"
 #include "initializer_chain.hpp"
+#include "logging.hpp"
 
 #include <fstream>
 #include <memory>
@@ -105,8 +106,10 @@ DllMain(HINSTANCE mod, DWORD why, LPVOID res)
         CreateDirectory(TOSDB_LOG_PATH, NULL);
         break;
     } 
+    case DLL_THREAD_DETACH:
+        ReleaseThreadLogRing();
+        break;
     case DLL_THREAD_ATTACH: /* no break */
-    case DLL_THREAD_DETACH: /* no break */
     case DLL_PROCESS_DETACH:/* no break */    
     default: break;
     }
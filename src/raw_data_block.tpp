@@ -6,6 +6,18 @@ size_type RAW_DATA_BLOCK_CLASS::_block_count_ = 0;
 RAW_DATA_BLOCK_TEMPLATE
 size_type RAW_DATA_BLOCK_CLASS::_max_block_count_ = MAX_BLOCK_COUNT;
 
+RAW_DATA_BLOCK_TEMPLATE
+typename RAW_DATA_BLOCK_CLASS::_my_registry_ty RAW_DATA_BLOCK_CLASS::_registry_;
+
+RAW_DATA_BLOCK_TEMPLATE
+typename RAW_DATA_BLOCK_CLASS::_my_owners_ty RAW_DATA_BLOCK_CLASS::_owners_;
+
+RAW_DATA_BLOCK_TEMPLATE
+std::mutex RAW_DATA_BLOCK_CLASS::_registry_mtx_;
+
+RAW_DATA_BLOCK_TEMPLATE
+size_type RAW_DATA_BLOCK_CLASS::_block_serial_ = 0;
+
 
 RAW_DATA_BLOCK_TEMPLATE
 RAW_DATA_BLOCK_CLASS::RawDataBlock(str_set_type items, 
@@ -13,12 +25,21 @@ RAW_DATA_BLOCK_CLASS::RawDataBlock(str_set_type items,
                                    const size_type sz, 
                                    bool datetime) 
     :
+        _nrows(0),
+        _ncols(0),
         _item_names(items),
         _topic_enums(topics_t),
         _block_sz(sz),
+        _hot_sz(0),
+        _cold_compressed(false),
         _datetime(datetime),
-        _mtx(new std::recursive_mutex)
+        _mtx(new std::recursive_mutex),
+        _settings_mtx(new std::mutex)
     {      
+        {
+            std::lock_guard<std::mutex> lock(_registry_mtx_);
+            _cursor = '\x01' + std::to_string(++_block_serial_) + '\x01';
+        }
         _init();
         ++_block_count_;
     }
@@ -26,12 +47,19 @@ RAW_DATA_BLOCK_CLASS::RawDataBlock(str_set_type items,
 RAW_DATA_BLOCK_TEMPLATE
 RAW_DATA_BLOCK_CLASS::RawDataBlock(const size_type sz, bool datetime)
     : 
+        _nrows(0),
+        _ncols(0),
         _item_names(),
         _topic_enums(),  
         _block_sz(sz),
+        _hot_sz(0),
+        _cold_compressed(false),
         _datetime(datetime),
-        _mtx(new std::recursive_mutex)
+        _mtx(new std::recursive_mutex),
+        _settings_mtx(new std::mutex)
     {
+        std::lock_guard<std::mutex> lock(_registry_mtx_);
+        _cursor = '\x01' + std::to_string(++_block_serial_) + '\x01';
         ++_block_count_;
     }
 
@@ -41,17 +69,103 @@ RAW_DATA_BLOCK_CLASS::_init()
 {
     std::lock_guard<std::recursive_mutex> lock(*_mtx);
     /* --- CRITICAL SECTION --- */
-    for(auto & i : _item_names) {
-        auto tmp = _populate_tblock( std::unique_ptr<_my_row_ty>(new _my_row_ty) );
-        _block.insert( _my_block_ty::value_type(i, std::move(tmp)) );   
+    for(auto & t : _topic_enums)
+        _add_topic_id(t);
+
+    for(auto & i : _item_names){
+        size_type iid = _add_item_id(i);
+        for(auto & t : _topic_ids)
+            _insert_topic(iid, t.second, i, t.first);
     }
     /* --- CRITICAL SECTION --- */
 }
 
+RAW_DATA_BLOCK_TEMPLATE
+DataStreamInterface<DateTimeTy, GenericTy>*
+RAW_DATA_BLOCK_CLASS::_find_stream(const std::string& item, 
+                                   TOS_Topics::TOPICS topic) const
+{
+    auto iid = _item_ids.find(item);
+    if(iid == _item_ids.end())
+        return nullptr;
+
+    auto tid = _topic_ids.find(topic);
+    if(tid == _topic_ids.end())
+        return nullptr;
+
+    return _cell(iid->second, tid->second);
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+size_type
+RAW_DATA_BLOCK_CLASS::_add_item_id(const std::string& item)
+{
+    size_type iid;
+
+    if( !_free_item_ids.empty() ){ /* recycled rows are already empty */
+        iid = _free_item_ids.back();
+        _free_item_ids.pop_back();
+    }else{
+        iid = _nrows++;
+        _streams.resize(_nrows * _ncols);
+    }
+
+    _item_ids[item] = iid;
+    _item_order.push_back(iid);
+    return iid;
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+size_type
+RAW_DATA_BLOCK_CLASS::_add_topic_id(TOS_Topics::TOPICS topic)
+{
+    size_type tid;
+    size_type ncols;
+
+    if( !_free_topic_ids.empty() ){ /* recycled columns are already empty */
+        tid = _free_topic_ids.back();
+        _free_topic_ids.pop_back();
+    }else{ 
+        /* widen the matrix; grow by half (or at least 4) so adding topics 
+           one at a time doesn't re-layout each time */
+        tid = (size_type)_topic_ids.size();
+        if(tid >= _ncols){
+            ncols = _ncols + (_ncols / 2);
+            if(ncols < tid + 4)
+                ncols = tid + 4;
+
+            _my_matrix_ty tmp(_nrows * ncols);
+            for(size_type r = 0; r < _nrows; ++r){
+                for(size_type c = 0; c < _ncols; ++c)
+                    tmp[r * ncols + c] = std::move(_streams[r * _ncols + c]);
+            }
+            _streams.swap(tmp);
+            _ncols = ncols;
+        }
+    }
+
+    _topic_ids[topic] = tid;
+    _topic_order.push_back(tid);
+    return tid;
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+typename RAW_DATA_BLOCK_CLASS::_my_registry_key_ty
+RAW_DATA_BLOCK_CLASS::_registry_key(const std::string& item, 
+                                    TOS_Topics::TOPICS topic) const
+{
+    /* spill settings don't apply to strings */
+    bool str = (TOS_Topics::TypeBits(topic) == TOSDB_STRING_BIT);
+
+    return _my_registry_key_ty( 
+        std::make_pair(item, topic),
+        std::make_tuple(_block_sz, str ? 0 : _hot_sz, str ? false : _cold_compressed, _datetime) 
+    );
+}
+
 RAW_DATA_BLOCK_TEMPLATE 
-typename RAW_DATA_BLOCK_CLASS::_my_row_ty* 
-RAW_DATA_BLOCK_CLASS::_insert_topic( typename RAW_DATA_BLOCK_CLASS::_my_row_ty* row, 
-                                     TOS_Topics::TOPICS topic )
+DataStreamInterface<DateTimeTy, GenericTy>*
+RAW_DATA_BLOCK_CLASS::_new_stream(TOS_Topics::TOPICS topic) const
 {    
     DataStreamInterface<DateTimeTy, GenericTy> *stream; 
 
@@ -82,31 +196,310 @@ RAW_DATA_BLOCK_CLASS::_insert_topic( typename RAW_DATA_BLOCK_CLASS::_my_row_ty*
                : new DataStream<float, datetime_type, generic_type, false>(_block_sz);
     } 
 
+    if(_hot_sz && TOS_Topics::TypeBits(topic) != TOSDB_STRING_BIT){
+        try{
+            stream->cold_compressed(_cold_compressed);
+            stream->hot_size(_hot_sz);
+        }catch(const DataStreamError& e){ /* still usable, just on the heap */
+            TOSDB_LogH("RawDataBlock", e.what());
+        }
+    }
+
+    return stream;
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+DataStreamInterface<DateTimeTy, GenericTy>*
+RAW_DATA_BLOCK_CLASS::_clone_stream(TOS_Topics::TOPICS topic,
+                                    const DataStreamInterface<DateTimeTy, GenericTy>& stream) const
+{    
+    /* O.K. the stream was created by _new_stream for these type bits */
+    switch(TOS_Topics::TypeBits(topic)){ 
+    case TOSDB_STRING_BIT :
+        return _datetime 
+            ? (stream_type*)new DataStream<std::string, datetime_type, generic_type, true>(
+                  static_cast<const DataStream<std::string, datetime_type, generic_type, true>&>(stream)) 
+            : (stream_type*)new DataStream<std::string, datetime_type, generic_type, false>(
+                  static_cast<const DataStream<std::string, datetime_type, generic_type, false>&>(stream));
+    case TOSDB_INTGR_BIT :
+        return _datetime 
+            ? (stream_type*)new DataStream<long, datetime_type, generic_type, true>(
+                  static_cast<const DataStream<long, datetime_type, generic_type, true>&>(stream)) 
+            : (stream_type*)new DataStream<long, datetime_type, generic_type, false>(
+                  static_cast<const DataStream<long, datetime_type, generic_type, false>&>(stream));
+    case TOSDB_QUAD_BIT :
+        return _datetime 
+            ? (stream_type*)new DataStream<double, datetime_type, generic_type, true>(
+                  static_cast<const DataStream<double, datetime_type, generic_type, true>&>(stream)) 
+            : (stream_type*)new DataStream<double, datetime_type, generic_type, false>(
+                  static_cast<const DataStream<double, datetime_type, generic_type, false>&>(stream));
+    case TOSDB_INTGR_BIT | TOSDB_QUAD_BIT :
+        return _datetime 
+            ? (stream_type*)new DataStream<long long, datetime_type, generic_type, true>(
+                  static_cast<const DataStream<long long, datetime_type, generic_type, true>&>(stream)) 
+            : (stream_type*)new DataStream<long long, datetime_type, generic_type, false>(
+                  static_cast<const DataStream<long long, datetime_type, generic_type, false>&>(stream));
+    default :
+        return _datetime 
+            ? (stream_type*)new DataStream<float, datetime_type, generic_type, true>(
+                  static_cast<const DataStream<float, datetime_type, generic_type, true>&>(stream)) 
+            : (stream_type*)new DataStream<float, datetime_type, generic_type, false>(
+                  static_cast<const DataStream<float, datetime_type, generic_type, false>&>(stream));
+    } 
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_insert_topic(size_type item_id, 
+                                    size_type topic_id, 
+                                    const std::string& item,
+                                    TOS_Topics::TOPICS topic)
+{    
+    _my_registry_key_ty key = _registry_key(item, topic);
+    _my_stream_ptr_ty stream;
+    _my_stream_ptr_ty fresh;
+
     try{
-        row->erase(topic);
-        row->insert( 
-            _my_row_ty::value_type(
-                topic, 
-                std::unique_ptr<DataStreamInterface<DateTimeTy, GenericTy>>(stream)
-             ) 
-        );
+        {
+            std::lock_guard<std::mutex> lock(_registry_mtx_);
+            /* --- CRITICAL SECTION --- */
+            auto reg = _registry_.find(key);
+            if(reg != _registry_.end() && (stream = reg->second.lock()))
+                ++_owners_[stream.get()];
+            /* --- CRITICAL SECTION --- */
+        }
+
+        if(!stream){ 
+            /* create it w/o the registry lock; another block may beat us to it */
+            fresh.reset( _new_stream(topic) );
+
+            std::lock_guard<std::mutex> lock(_registry_mtx_);
+            /* --- CRITICAL SECTION --- */
+            std::weak_ptr<stream_type>& reg = _registry_[key];
+            stream = reg.lock();
+            if(!stream)
+                reg = stream = fresh;
+            ++_owners_[stream.get()];
+            /* --- CRITICAL SECTION --- */
+        }
+
+        _streams[item_id * _ncols + topic_id] = stream;
+        stream->add_marker(_cursor);
+        for(auto & m : _marker_names)
+            stream->add_marker(_cursor + m);
     }catch(...){
         TOSDB_LogH("RawDataBlock","problem inserting t-block");
-        if(stream)
-            delete stream;
     }
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_release_topic(size_type item_id, 
+                                     size_type topic_id, 
+                                     const std::string& item,
+                                     TOS_Topics::TOPICS topic)
+{    
+    _my_stream_ptr_ty stream;
+    bool shared;
 
-    return row;
+    stream.swap( _streams[item_id * _ncols + topic_id] );
+    if(!stream)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_registry_mtx_);
+        /* --- CRITICAL SECTION --- */
+        auto own = _owners_.find(stream.get());
+        shared = (own != _owners_.end() && --(own->second) > 0);
+        if(own != _owners_.end() && !shared)
+            _owners_.erase(own);
+
+        auto reg = _registry_.find( _registry_key(item, topic) );
+        if(reg != _registry_.end() 
+           && (reg->second.expired() || (!shared && reg->second.lock() == stream)))
+        {
+            _registry_.erase(reg);
+        }
+        /* --- CRITICAL SECTION --- */
+    }
+
+    if(shared){ /* other blocks still reading it */
+        stream->remove_marker(_cursor);
+        for(auto & m : _marker_names)
+            stream->remove_marker(_cursor + m);
+    }
 }
 
-RAW_DATA_BLOCK_TEMPLATE
-std::unique_ptr<typename RAW_DATA_BLOCK_CLASS::_my_row_ty> 
-RAW_DATA_BLOCK_CLASS::_populate_tblock(std::unique_ptr<typename RAW_DATA_BLOCK_CLASS::_my_row_ty> tblock)
+RAW_DATA_BLOCK_TEMPLATE 
+bool
+RAW_DATA_BLOCK_CLASS::_unshare(const _my_stream_ptr_ty& stream, 
+                               const std::string& item,
+                               TOS_Topics::TOPICS topic)
+{    
+    std::lock_guard<std::mutex> lock(_registry_mtx_);
+    /* --- CRITICAL SECTION --- */
+    auto own = _owners_.find(stream.get());
+    if(own != _owners_.end() && own->second > 1)
+        return true; /* the registered stream stays w/ the other blocks */
+
+    auto reg = _registry_.find( _registry_key(item, topic) );
+    if(reg != _registry_.end() && reg->second.lock() == stream)
+        _registry_.erase(reg);
+    return false;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+typename RAW_DATA_BLOCK_CLASS::_my_stream_ptr_ty
+RAW_DATA_BLOCK_CLASS::_copy_stream(TOS_Topics::TOPICS topic, 
+                                   const _my_stream_ptr_ty& stream) const
 {    
-    for(auto elem : _topic_enums)
-        _insert_topic(tblock.get(), elem);
+    _my_stream_ptr_ty copy;
 
-    return tblock;
+    {
+        typename stream_type::lock_scope stream_lock(stream.get());
+        copy.reset( _clone_stream(topic, *stream) );
+        stream->add_marker( _sync_marker() );
+    }
+    copy->retain_markers(_cursor);
+    return copy;
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_swap_in(size_type item_id, 
+                               size_type topic_id, 
+                               const _my_stream_ptr_ty& stream,
+                               const _my_stream_ptr_ty& copy)
+{    
+    {
+        std::lock_guard<std::mutex> lock(_registry_mtx_);
+        /* --- CRITICAL SECTION --- */
+        _owners_[copy.get()] = 1;
+        auto own = _owners_.find(stream.get());
+        if(own != _owners_.end() && !--(own->second)) /* others let go meanwhile */
+            _owners_.erase(own);
+        /* --- CRITICAL SECTION --- */
+    }
+
+    typename stream_type::lock_scope stream_lock(stream.get());
+    /* --- CRITICAL SECTION --- */
+    /* catch up, oldest first; the marker is at (# pushed since) - 1 */
+    for(long long i = stream->marker_position( _sync_marker() ); i >= 0; --i){
+        typename stream_type::both_ty b = stream->both_leave_marker((int)i);
+        copy->push(b.first, std::move(b.second));
+    }
+    stream->remove_marker( _sync_marker() );
+    stream->remove_marker(_cursor);
+    for(auto & m : _marker_names)
+        stream->remove_marker(_cursor + m);
+    _streams[item_id * _ncols + topic_id] = copy;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_make_exclusive(size_type item_id, 
+                                      size_type topic_id, 
+                                      const std::string& item,
+                                      TOS_Topics::TOPICS topic)
+{    
+    _my_stream_ptr_ty stream = _streams[item_id * _ncols + topic_id];
+
+    /* the copy is made w/o the registry lock */
+    if(stream && _unshare(stream, item, topic))
+        _swap_in(item_id, topic_id, stream, _copy_stream(topic, stream));
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_register_all()
+{    
+    std::vector<std::pair<_my_registry_key_ty, _my_stream_ptr_ty>> streams;
+
+    for(auto & i : _item_ids){
+        for(auto & t : _topic_ids){
+            _my_stream_ptr_ty& stream = _streams[i.second * _ncols + t.second];
+            if(stream && !stream->stats_enabled())
+                streams.push_back( std::make_pair(_registry_key(i.first, t.first), stream) );
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_registry_mtx_);
+    /* --- CRITICAL SECTION --- */
+    for(auto & s : streams){
+        std::weak_ptr<stream_type>& reg = _registry_[s.first];
+        if(reg.expired())
+            reg = s.second;
+    }
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+std::vector<typename RAW_DATA_BLOCK_CLASS::_my_change_ty>
+RAW_DATA_BLOCK_CLASS::_begin_change(bool skip_strings)
+{    
+    std::vector<_my_change_ty> changes;
+    _my_change_ty c;
+
+    for(auto & t : _topic_ids){
+        if(skip_strings && TOS_Topics::TypeBits(t.first) == TOSDB_STRING_BIT)
+            continue; /* strings stay on the heap */
+        for(auto & i : _item_ids){
+            c.stream = _streams[i.second * _ncols + t.second];
+            if(!c.stream)
+                continue;
+            c.item_id = i.second;
+            c.topic_id = t.second;
+            c.topic = t.first;
+            c.shared = _unshare(c.stream, i.first, t.first);
+            changes.push_back(c);
+        }
+    }
+
+    return changes;
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+template<typename F>
+void
+RAW_DATA_BLOCK_CLASS::_change_streams(std::vector<_my_change_ty>& changes, F apply)
+{    
+    /* copying/changing can (re)allocate a whole stream so do it one stream at 
+       a time: one the block holds alone is changed under its own lock, the 
+       extract thread/readers only ever wait on the one being changed; a 
+       shared one is copied (under its lock) and the copy changed before 
+       anyone else can see it */
+    try{
+        for(auto & c : changes){
+            if(c.shared)
+                c.copy = _copy_stream(c.topic, c.stream);
+            apply( (c.copy ? c.copy : c.stream).get() );
+        }
+    }catch(...){
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        _end_change(changes);
+        throw;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    _end_change(changes);
+}
+
+RAW_DATA_BLOCK_TEMPLATE 
+void
+RAW_DATA_BLOCK_CLASS::_end_change(std::vector<_my_change_ty>& changes)
+{    
+    for(auto & c : changes){
+        if(!c.copy)
+            continue;
+        if(_streams[c.item_id * _ncols + c.topic_id] == c.stream)
+            _swap_in(c.item_id, c.topic_id, c.stream, c.copy);
+        else /* removed from the block meanwhile */
+            c.stream->remove_marker( _sync_marker() );
+    }
+
+    changes.clear();
 }
 
 RAW_DATA_BLOCK_TEMPLATE
@@ -142,17 +535,99 @@ RAW_DATA_BLOCK_TEMPLATE
 size_type
 RAW_DATA_BLOCK_CLASS::block_size(size_type b)
 {
-    std::lock_guard<std::recursive_mutex> lock(*_mtx);
-    /* --- CRITICAL SECTION --- */
+    std::vector<_my_change_ty> changes;
+
     if(b > TOSDB_MAX_BLOCK_SZ)
         b = TOSDB_MAX_BLOCK_SZ; 
 
-    for(auto& col : _block){
-        for(auto& row : *(col.second))
-            row.second->bound_size(b);
+    std::lock_guard<std::mutex> settings_lock(*_settings_mtx);
+    {
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(b == _block_sz)
+            return _block_sz;
+
+        changes = _begin_change(false);
+        _block_sz = b; /* streams added from here on are created w/ b */
+        /* --- CRITICAL SECTION --- */
+    }
+
+    _change_streams(changes, [b](stream_type *stream){ stream->bound_size(b); });
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    _register_all();
+    return b;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+size_type
+RAW_DATA_BLOCK_CLASS::hot_size(size_type h)
+{
+    std::vector<_my_change_ty> changes;
+    size_type prev;
+
+    if(h > TOSDB_MAX_BLOCK_SZ)
+        h = TOSDB_MAX_BLOCK_SZ; 
+
+    std::lock_guard<std::mutex> settings_lock(*_settings_mtx);
+    {
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(h == _hot_sz)
+            return _hot_sz;
+
+        changes = _begin_change(true);
+        prev = _hot_sz;
+        _hot_sz = h;
+        /* --- CRITICAL SECTION --- */
+    }
+
+    try{
+        _change_streams(changes, [h](stream_type *stream){ stream->hot_size(h); });
+    }catch(const DataStreamError& e){ /* streams stay unregistered */   
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        _hot_sz = prev;
+        throw TOSDB_DataStreamError(e, "hot_size");
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    _register_all();
+    return h;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+void
+RAW_DATA_BLOCK_CLASS::cold_compressed(bool on)
+{
+    std::vector<_my_change_ty> changes;
+
+    std::lock_guard<std::mutex> settings_lock(*_settings_mtx);
+    {
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(on == _cold_compressed)
+            return;
+
+        changes = _begin_change(true);
+        _cold_compressed = on;
+        /* --- CRITICAL SECTION --- */
+    }
+
+    try{
+        _change_streams(changes, [on](stream_type *stream){ stream->cold_compressed(on); });
+    }catch(const DataStreamError& e){    
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        _cold_compressed = !on;
+        throw TOSDB_DataStreamError(e, "cold_compressed");
     }
 
-    return (_block_sz = b);
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    _register_all();
     /* --- CRITICAL SECTION --- */
 }
 
@@ -166,29 +641,30 @@ RAW_DATA_BLOCK_CLASS::insert_data(TOS_Topics::TOPICS topic,
                                   DtTy datetime) 
 {
     DataStreamInterface<DateTimeTy, GenericTy> *stream; 
-    _my_row_ty  *topics; 
         
     std::lock_guard<std::recursive_mutex> lock(*_mtx);  
     /* --- CRITICAL SECTION --- */
-    try{
-        topics = _block.at(item).get();
-        if (!topics)
-            throw std::out_of_range("item not in block");
-    }catch(const std::out_of_range& e){    
-        TOSDB_LogH("RawDataBlock", e.what());
-        throw TOSDB_DataBlockError(e.what()); 
+    auto iid = _item_ids.find(item);
+    if(iid == _item_ids.end()){
+        TOSDB_LogLimitedH("RawDataBlock", item.c_str(), "item not in block");
+        throw TOSDB_DataBlockError("item not in block"); 
     }
 
-    try{
-        stream = (topics->at(topic)).get();
-        if (!stream) 
-            throw std::out_of_range("topic not in block");
-    }catch(const std::out_of_range& e){    
-        TOSDB_LogH("RawDataBlock", e.what());
-        throw TOSDB_DataBlockError(e.what()); 
+    auto tid = _topic_ids.find(topic);
+    if(tid == _topic_ids.end() || !(stream = _cell(iid->second, tid->second))){
+        TOSDB_LogLimitedH("RawDataBlock", TOS_Topics::map[topic].c_str(), "topic not in block");
+        throw TOSDB_DataBlockError("topic not in block"); 
     } 
           
     try{      
+        if( !_stats_weights.empty() ){
+            auto w = _stats_weights.find( std::make_pair(iid->second, tid->second) );
+            if( w != _stats_weights.end() ){
+                DataStreamInterface<DateTimeTy, GenericTy> *wstream = _cell(iid->second, w->second);
+                if( wstream && !wstream->empty() )
+                    stream->stats_weight( wstream->get_leave_marker(0).as_double() );
+            }
+        }
         stream->push(val, std::move(datetime)); 
     }catch(const DataStreamError& e){    
         throw TOSDB_DataStreamError(e, "insert_data");
@@ -206,11 +682,9 @@ RAW_DATA_BLOCK_CLASS::add_item(std::string item)
         if( !(_item_names.insert(item).second) )
             return;
         
-        _block.erase(item);
-
-        auto tmp = _populate_tblock( std::unique_ptr<_my_row_ty>(new _my_row_ty) );
-
-        _block.insert( _my_block_ty::value_type(item,std::move(tmp)) );           
+        size_type iid = _add_item_id(item);
+        for(auto & t : _topic_ids)
+            _insert_topic(iid, t.second, item, t.first);
         /* --- CRITICAL SECTION --- */
     }catch(const std::exception & e){
         throw TOSDB_DataBlockError(e, "add_item");
@@ -227,16 +701,15 @@ RAW_DATA_BLOCK_CLASS::remove_item(std::string item)
         if( !(_item_names.erase(item)) )
             return;
         
-        _my_row_ty *row = _block.at(item).get();
-        if(!row)
-            return;
-
-        for(auto & elem : *row)
-            elem.second.reset();                   
+        size_type iid = _item_ids.at(item);
+        for(auto & t : _topic_ids){
+            _stats_weights.erase( std::make_pair(iid, t.second) );
+            _release_topic(iid, t.second, item, t.first);                   
+        }
 
-        _block.at(item).reset();
-        _block.erase(item);   
-                   
+        _item_ids.erase(item);
+        _free_item_ids.push_back(iid);
+        _item_order.erase( std::find(_item_order.begin(), _item_order.end(), iid) );
         /* --- CRITICAL SECTION --- */
     }catch(const std::out_of_range& e){
         TOSDB_LogH("RawDataBlock", "remove_item out_of_range exception");
@@ -256,8 +729,9 @@ RAW_DATA_BLOCK_CLASS::add_topic(TOS_Topics::TOPICS topic)
         if( !(_topic_enums.insert(topic).second) )
             return;
         
-        for(auto & elem : _block)
-            _insert_topic(elem.second.get(), topic);         
+        size_type tid = _add_topic_id(topic);
+        for(auto & i : _item_ids)
+            _insert_topic(i.second, tid, i.first, topic);         
         /* --- CRITICAL SECTION --- */
     }catch(const std::exception & e){
         throw TOSDB_DataBlockError(e, "add_topic");
@@ -274,13 +748,20 @@ RAW_DATA_BLOCK_CLASS::remove_topic(TOS_Topics::TOPICS topic)
         if( !(_topic_enums.erase(topic)) )
             return;
         
-        for(auto & elem : _block){
-            _my_row_ty *row = elem.second.get();
-            if(row){
-                (row->at(topic)).reset();
-                row->erase(topic);
-            }
-        }           
+        size_type tid = _topic_ids.at(topic);
+        for(auto & i : _item_ids)
+            _release_topic(i.second, tid, i.first, topic);
+
+        _topic_ids.erase(topic);
+        _free_topic_ids.push_back(tid);
+        _topic_order.erase( std::find(_topic_order.begin(), _topic_order.end(), tid) );
+
+        for(auto iter = _stats_weights.begin(); iter != _stats_weights.end(); ){
+            if(iter->first.second == tid || iter->second == tid)
+                iter = _stats_weights.erase(iter);
+            else
+                ++iter;
+        }
         /* --- CRITICAL SECTION --- */
     }catch(const std::out_of_range& e){
         TOSDB_LogH("RawDataBlock", "remove_topic out_of_range exception");
@@ -291,21 +772,19 @@ RAW_DATA_BLOCK_CLASS::remove_topic(TOS_Topics::TOPICS topic)
 }
 
 template<typename GenericTy, typename DateTimeTy>
-const DataStreamInterface<DateTimeTy, GenericTy>*
+typename RAW_DATA_BLOCK_CLASS::stream_view
 RAW_DATA_BLOCK_CLASS::raw_stream_ptr(std::string item, 
                                      TOS_Topics::TOPICS topic) const 
 {
-    const DataStreamInterface<DateTimeTy, GenericTy> * stream = nullptr;
+    _my_stream_ptr_ty stream;
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        _my_row_ty* row = _block.at(item).get();
-        if(row)                    
-            stream = (row->at(topic)).get();
+        auto iid = _item_ids.find(item);
+        auto tid = _topic_ids.find(topic);
+        if(iid != _item_ids.end() && tid != _topic_ids.end())
+            stream = _streams[iid->second * _ncols + tid->second];
         /* --- CRITICAL SECTION --- */
-    }catch(const std::out_of_range& e){
-        TOSDB_LogH("RawDataBlock", "raw_stream_ptr out_of_range exception");
-        throw TOSDB_DataBlockError(e, "raw_stream_ptr");
     }catch(const std::exception & e){
         throw TOSDB_DataBlockError(e, "raw_stream_ptr");
     }
@@ -313,7 +792,199 @@ RAW_DATA_BLOCK_CLASS::raw_stream_ptr(std::string item,
     if(!stream)
         throw TOSDB_DataBlockError("stream does not exist in block");  
 
-    return stream;
+    return stream_view(std::move(stream), _cursor);
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+template<typename T>
+typename RAW_DATA_BLOCK_CLASS::template TypedStreamRef<T>
+RAW_DATA_BLOCK_CLASS::typed_stream_ref(std::string item, TOS_Topics::TOPICS topic)
+{
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    auto iid = _item_ids.find(item);
+    if(iid == _item_ids.end())
+        throw TOSDB_DataBlockError("item not in block");
+
+    auto tid = _topic_ids.find(topic);
+    if(tid == _topic_ids.end())
+        throw TOSDB_DataBlockError("topic not in block");
+
+    return typed_stream_ref<T>(iid->second, tid->second, topic);
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+void
+RAW_DATA_BLOCK_CLASS::stream_ids(const std::string& item,
+                                 TOS_Topics::TOPICS topic,
+                                 size_type *item_id,
+                                 size_type *topic_id) const
+{
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    auto iid = _item_ids.find(item);
+    auto tid = _topic_ids.find(topic);
+    if(iid == _item_ids.end() || tid == _topic_ids.end() 
+       || !_cell(iid->second, tid->second))
+    {
+        throw TOSDB_DataBlockError("stream does not exist in block");
+    }
+
+    *item_id = iid->second;
+    *topic_id = tid->second;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+typename RAW_DATA_BLOCK_CLASS::stream_view
+RAW_DATA_BLOCK_CLASS::raw_stream_ptr(size_type item_id, size_type topic_id) const
+{
+    _my_stream_ptr_ty stream;
+    {
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        if(item_id < _nrows && topic_id < _ncols)
+            stream = _streams[item_id * _ncols + topic_id];
+        /* --- CRITICAL SECTION --- */
+    }
+
+    if(!stream)
+        throw TOSDB_DataBlockError("stream does not exist in block");  
+
+    return stream_view(std::move(stream), _cursor);
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+template<typename T>
+typename RAW_DATA_BLOCK_CLASS::template TypedStreamRef<T>
+RAW_DATA_BLOCK_CLASS::typed_stream_ref(size_type item_id, 
+                                       size_type topic_id, 
+                                       TOS_Topics::TOPICS topic)
+{
+    typedef typename TypedStreamRef<T>::_my_primary_ty primary_ty;
+    typedef typename TypedStreamRef<T>::_my_secondary_ty secondary_ty;
+
+    TypedStreamRef<T> ref;
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if(item_id >= _nrows || topic_id >= _ncols || !_cell(item_id, topic_id))
+        throw TOSDB_DataBlockError("stream does not exist in block");
+
+    ref._stream = _streams[item_id * _ncols + topic_id];
+    if(TOS_Topics::TypeBits(topic) != _type_bits((T*)nullptr))
+        return ref; 
+
+    stream_type *stream = ref._stream.get();
+    ref._cursor = _cursor;
+
+    /* O.K. _insert_topic creates DataStream<T,...> for these type bits */
+    if(_datetime){
+        ref._secondary = static_cast<secondary_ty*>(stream);
+        ref._primary = ref._secondary;
+    }else{
+        ref._primary = static_cast<primary_ty*>(stream);
+    }
+
+    if( !_stats_weights.empty() ){
+        auto w = _stats_weights.find( std::make_pair(item_id, topic_id) );
+        if( w != _stats_weights.end() )
+            ref._weight = _streams[item_id * _ncols + w->second];
+    }
+
+    return ref;
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+void
+RAW_DATA_BLOCK_CLASS::stream_stats(std::string item, 
+                                   TOS_Topics::TOPICS topic, 
+                                   bool enable,
+                                   TOS_Topics::TOPICS weight_topic)
+{
+    DataStreamInterface<DateTimeTy, GenericTy> *stream = nullptr;
+    size_type iid, tid, wid = 0;
+
+    if(weight_topic != TOS_Topics::TOPICS::NULL_TOPIC
+       && TOS_Topics::TypeBits(weight_topic) == TOSDB_STRING_BIT)
+    {
+        throw TOSDB_DataBlockError("stream_stats weight topic must be numeric");
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    try{
+        iid = _item_ids.at(item);
+        tid = _topic_ids.at(topic);
+        stream = _cell(iid, tid);
+        if(enable && weight_topic != TOS_Topics::TOPICS::NULL_TOPIC)
+            wid = _topic_ids.at(weight_topic); /* make sure weight stream exists */
+    }catch(const std::out_of_range& e){
+        TOSDB_LogH("RawDataBlock", "stream_stats out_of_range exception");
+        throw TOSDB_DataBlockError(e, "stream_stats");
+    }
+
+    if(!stream)
+        throw TOSDB_DataBlockError("stream does not exist in block");  
+
+    /* stats are per-block, don't enable them on a shared stream */
+    if(enable && !stream->stats_enabled() 
+       && TOS_Topics::TypeBits(topic) != TOSDB_STRING_BIT)
+    {
+        _make_exclusive(iid, tid, item, topic);
+        stream = _cell(iid, tid);
+    }
+
+    try{
+        stream->stats_enable(enable);
+    }catch(const DataStreamError& e){    
+        throw TOSDB_DataStreamError(e, "stream_stats");
+    }
+
+    _stats_weights.erase( std::make_pair(iid, tid) );
+    if(enable && weight_topic != TOS_Topics::TOPICS::NULL_TOPIC)
+        _stats_weights[ std::make_pair(iid, tid) ] = wid;
+
+    if(!enable)
+        _register_all();
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+void
+RAW_DATA_BLOCK_CLASS::add_marker(std::string name)
+{
+    if(name.empty())
+        throw TOSDB_DataBlockError("marker name can not be empty");
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( !(_marker_names.insert(name).second) )
+        throw TOSDB_DataBlockError("marker already exists");
+
+    for(auto& s : _streams){
+        if(s)
+            s->add_marker(_cursor + name);
+    }
+    /* --- CRITICAL SECTION --- */
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+void
+RAW_DATA_BLOCK_CLASS::remove_marker(std::string name)
+{
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    if( !(_marker_names.erase(name)) )
+        throw TOSDB_DataBlockError("marker does not exist");
+
+    for(auto& s : _streams){
+        if(s)
+            s->remove_marker(_cursor + name);
+    }
+    /* --- CRITICAL SECTION --- */
 }
 
 RAW_DATA_BLOCK_TEMPLATE
@@ -324,15 +995,12 @@ RAW_DATA_BLOCK_CLASS::map_of_frame_topics(std::string item) const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        _my_row_ty * row = _block.at(item).get();    
-        if(!row)
-            return map;
-            
-        for(auto & elem : *row){
+        size_type iid = _item_ids.at(item);
+        for(auto & t : _topic_ids){
             map.insert( 
                 pair_type( 
-                    TOS_Topics::map[elem.first],
-                    elem.second->get_leave_marker(0)
+                    TOS_Topics::map[t.first],
+                    _cell_at(iid, t.second)->get_leave_marker(0)
                 ) 
             );
         }        
@@ -357,9 +1025,10 @@ RAW_DATA_BLOCK_CLASS::map_of_frame_items(TOS_Topics::TOPICS topic) const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        for(auto & elem : _block){
+        size_type tid = _topic_ids.at(topic);
+        for(auto & i : _item_ids){
             map.insert( 
-                pair_type(elem.first, elem.second->at(topic)->get_leave_marker(0)) 
+                pair_type(i.first, _cell_at(i.second, tid)->get_leave_marker(0)) 
             );  
         }
         /* --- CRITICAL SECTION --- */
@@ -383,15 +1052,12 @@ RAW_DATA_BLOCK_CLASS::pair_map_of_frame_topics(std::string item) const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        _my_row_ty * row = _block.at(item).get(); 
-        if(!row)
-            return map;
-
-        for(auto & elem : *row){
+        size_type iid = _item_ids.at(item);
+        for(auto & t : _topic_ids){
             map.insert( 
                 map_datetime_type::value_type(
-                    TOS_Topics::map[elem.first],
-                    elem.second->both_leave_marker(0)
+                    TOS_Topics::map[t.first],
+                    _cell_at(iid, t.second)->both_leave_marker(0)
                 ) 
             );
         }        
@@ -416,11 +1082,12 @@ RAW_DATA_BLOCK_CLASS::pair_map_of_frame_items(TOS_Topics::TOPICS topic) const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        for(auto & elem : _block){
+        size_type tid = _topic_ids.at(topic);
+        for(auto & i : _item_ids){
             map.insert( 
                 map_datetime_type::value_type(
-                    elem.first, 
-                    elem.second->at(topic)->both_leave_marker(0)
+                    i.first, 
+                    _cell_at(i.second, tid)->both_leave_marker(0)
                 ) 
             );       
         }
@@ -445,13 +1112,13 @@ RAW_DATA_BLOCK_CLASS::matrix_of_frame() const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        for(auto & items : _block){         
+        for(auto & items : _item_ids){         
             map_type map; 
-            for(auto & tops : *items.second){
+            for(auto & tops : _topic_ids){
                 map.insert( 
                     map_type::value_type(
                         TOS_Topics::map[tops.first],
-                        tops.second->get_leave_marker(0)
+                        _cell_at(items.second, tops.second)->get_leave_marker(0)
                     ) 
                 ); 
             }
@@ -474,13 +1141,13 @@ RAW_DATA_BLOCK_CLASS::pair_matrix_of_frame() const
     try{
         std::lock_guard<std::recursive_mutex> lock(*_mtx);
         /* --- CRITICAL SECTION --- */
-        for(auto & items : _block){      
+        for(auto & items : _item_ids){      
             map_datetime_type map; 
-            for(auto & tops : *items.second){
+            for(auto & tops : _topic_ids){
                 map.insert( 
                     map_datetime_type::value_type(
                         TOS_Topics::map[tops.first],
-                        tops.second->both_leave_marker(0)
+                        _cell_at(items.second, tops.second)->both_leave_marker(0)
                     ) 
                 ); 
             }
@@ -496,3 +1163,191 @@ RAW_DATA_BLOCK_CLASS::pair_matrix_of_frame() const
     
     return matrix; 
 }
+
+RAW_DATA_BLOCK_TEMPLATE
+template<typename StoreTy, typename T>
+size_type
+RAW_DATA_BLOCK_CLASS::_front_column(size_type topic_id, 
+                                    T *dest, 
+                                    size_type n, 
+                                    typename RAW_DATA_BLOCK_CLASS::_my_datetime_dest_ty datetime, 
+                                    size_type *item_ids) const
+{
+    typedef DataStream<StoreTy, DateTimeTy, GenericTy, false> primary_ty;
+    typedef DataStream<StoreTy, DateTimeTy, GenericTy, true> secondary_ty;
+
+    size_type i;
+
+    for(i = 0; (i < n) && (i < _item_order.size()); ++i){
+        size_type iid = _item_order[i];
+        /* O.K. _new_stream creates DataStream<StoreTy,...> for these type bits */
+        const stream_type *stream = _cell_at(iid, topic_id);
+
+        if(_datetime){
+            dest[i] = (T)(static_cast<const secondary_ty*>(stream)
+                          ->secondary_ty::front_leave_marker(datetime + i));
+        }else{
+            dest[i] = (T)(static_cast<const primary_ty*>(stream)->primary_ty::front_leave_marker());
+            datetime.assign(i, DateTimeTy());
+        }
+
+        if(item_ids)
+            item_ids[i] = iid;
+    }
+
+    return i;
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+template<typename T>
+size_type
+RAW_DATA_BLOCK_CLASS::item_frame_columns(TOS_Topics::TOPICS topic, 
+                                         T *dest, 
+                                         size_type n, 
+                                         typename RAW_DATA_BLOCK_CLASS::datetime_dest_type datetime, 
+                                         size_type *item_ids) const
+{
+    size_type i;
+
+    if(!dest)
+        throw TOSDB_DataBlockError("item_frame_columns: NULL dest");
+
+    try{
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        size_type tid = _topic_ids.at(topic);
+
+        switch(TOS_Topics::TypeBits(topic)){ 
+        case TOSDB_STRING_BIT : /* no typed path, go thru generic_type */
+            for(i = 0; (i < n) && (i < _item_order.size()); ++i){
+                const stream_type *stream = _cell_at(_item_order[i], tid);
+                if(!datetime.empty()){
+                    typename stream_type::both_ty b = stream->both_leave_marker(0);
+                    dest[i] = (T)b.first;
+                    datetime.assign(i, b.second);
+                }else{
+                    dest[i] = (T)stream->get_leave_marker(0);
+                }
+                if(item_ids)
+                    item_ids[i] = _item_order[i];
+            }
+            return i;
+        case TOSDB_INTGR_BIT :
+            return _front_column<long>(tid, dest, n, datetime, item_ids);
+        case TOSDB_QUAD_BIT :
+            return _front_column<double>(tid, dest, n, datetime, item_ids);
+        case TOSDB_INTGR_BIT | TOSDB_QUAD_BIT :
+            return _front_column<long long>(tid, dest, n, datetime, item_ids);
+        default :
+            return _front_column<float>(tid, dest, n, datetime, item_ids);
+        }
+        /* --- CRITICAL SECTION --- */
+    }catch(const std::out_of_range& e){
+        TOSDB_LogH("RawDataBlock", "item_frame_columns out_of_range exception");
+        throw TOSDB_DataBlockError(e, "item_frame_columns");
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "item_frame_columns");
+    }catch(const std::exception & e){
+        throw TOSDB_DataBlockError(e, "item_frame_columns");
+    }
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+size_type
+RAW_DATA_BLOCK_CLASS::item_frame_columns(TOS_Topics::TOPICS topic, 
+                                         char **dest, 
+                                         size_type n, 
+                                         size_type str_len,
+                                         typename RAW_DATA_BLOCK_CLASS::datetime_dest_type datetime, 
+                                         size_type *item_ids) const
+{
+    typedef DataStream<std::string, DateTimeTy, GenericTy, false> primary_ty;
+    typedef DataStream<std::string, DateTimeTy, GenericTy, true> secondary_ty;
+
+    size_type i;
+    std::string str;
+
+    if(!dest || !str_len)
+        throw TOSDB_DataBlockError("item_frame_columns: NULL dest or str_len == 0");
+
+    try{
+        std::lock_guard<std::recursive_mutex> lock(*_mtx);
+        /* --- CRITICAL SECTION --- */
+        size_type tid = _topic_ids.at(topic);
+        bool is_str = (TOS_Topics::TypeBits(topic) == TOSDB_STRING_BIT);
+
+        for(i = 0; (i < n) && (i < _item_order.size()); ++i){
+            const stream_type *stream = _cell_at(_item_order[i], tid);
+
+            if(is_str){ /* O.K. _new_stream creates DataStream<std::string,...> */
+                if(_datetime){
+                    str = static_cast<const secondary_ty*>(stream)
+                              ->secondary_ty::front_leave_marker(datetime + i);
+                }else{
+                    str = static_cast<const primary_ty*>(stream)->primary_ty::front_leave_marker();
+                    datetime.assign(i, DateTimeTy());
+                }
+            }else if(!datetime.empty()){
+                typename stream_type::both_ty b = stream->both_leave_marker(0);
+                str = b.first.as_string();
+                datetime.assign(i, b.second);
+            }else{
+                str = stream->get_leave_marker(0).as_string();
+            }
+
+            strncpy_s(dest[i], str_len, str.c_str(), std::min<size_t>(str_len - 1, str.length()));
+            if(item_ids)
+                item_ids[i] = _item_order[i];
+        }
+        /* --- CRITICAL SECTION --- */
+    }catch(const std::out_of_range& e){
+        TOSDB_LogH("RawDataBlock", "item_frame_columns out_of_range exception");
+        throw TOSDB_DataBlockError(e, "item_frame_columns");
+    }catch(const DataStreamError& e){
+        throw TOSDB_DataStreamError(e, "item_frame_columns");
+    }catch(const std::exception & e){
+        throw TOSDB_DataBlockError(e, "item_frame_columns");
+    }
+
+    return i;
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+std::vector<std::pair<size_type, std::string>>
+RAW_DATA_BLOCK_CLASS::item_labels() const
+{
+    std::vector<std::pair<size_type, std::string>> labels;
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::vector<size_type> pos(_nrows); /* item id -> row */
+    for(size_type r = 0; r < _item_order.size(); ++r)
+        pos[_item_order[r]] = r;
+
+    labels.resize(_item_order.size());
+    for(auto & i : _item_ids)
+        labels[pos[i.second]] = std::make_pair(i.second, i.first);
+    /* --- CRITICAL SECTION --- */
+
+    return labels;
+}
+
+RAW_DATA_BLOCK_TEMPLATE
+std::vector<std::pair<size_type, TOS_Topics::TOPICS>>
+RAW_DATA_BLOCK_CLASS::topic_labels() const
+{
+    std::vector<std::pair<size_type, TOS_Topics::TOPICS>> labels;
+
+    std::lock_guard<std::recursive_mutex> lock(*_mtx);
+    /* --- CRITICAL SECTION --- */
+    std::vector<size_type> pos(_ncols); /* topic id -> column */
+    for(size_type c = 0; c < _topic_order.size(); ++c)
+        pos[_topic_order[c]] = c;
+
+    labels.resize(_topic_order.size());
+    for(auto & t : _topic_ids)
+        labels[pos[t.second]] = std::make_pair(t.second, t.first);
+    /* --- CRITICAL SECTION --- */
+
+    return labels;
+}
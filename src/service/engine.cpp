@@ -119,11 +119,11 @@ bool
 RunMainCommLoop(IPCSlave *pslave);
 
 bool
-ParseIPCMessage(std::string msg, 
-                unsigned int *op, 
-                TOS_Topics::TOPICS *topic, 
-                std::string *item, 
-                unsigned long *timeout);
+ParseIPCRecord(const IPCRecord& rec, 
+               unsigned int *op, 
+               TOS_Topics::TOPICS *topic, 
+               std::string *item, 
+               unsigned long *timeout);
 
 int
 HandleGoodIPCMessage(unsigned int op, 
@@ -249,7 +249,7 @@ WinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPSTR lpCmdLn, int nShowCmd)
 
     /* Start the main communciation loop that client code and service will 
        use to communicate with the back-end; this will block until:
-           1) the slave's wait_for_master call returns false(IPC ERROR), OR
+           1) the slave's recv call returns false(IPC ERROR), OR
            2) TOSDB_SIG_STOP signal is received from client/service  */
     int err = RunMainCommLoop(&slave) ? 0 : TOSDB_ERROR_IPC;
 
@@ -355,7 +355,8 @@ RunMainCommLoop(IPCSlave *pslave)
 {
     TOS_Topics::TOPICS cli_topic;
     std::string cli_item;
-    std::string ipc_msg;
+    IPCMessage ipc_msg;
+    IPCSlave::master_ty master;
     unsigned long cli_timeout; 
     unsigned int cli_op;  
     bool good_msg;
@@ -363,36 +364,36 @@ RunMainCommLoop(IPCSlave *pslave)
     
     TOSDB_Log("STARTUP", "entering RunMainCommLoop");
     while(!shutdown_flag){     
-                      
-        /* BLOCK until master is ready */ 
-        if( !pslave->wait_for_master() ){           
+        /* BLOCK until we get a request from any master (each has its own
+           persistent connection, read on its own thread by the slave);
+           requests are handled one at a time, here */ 
+        if( !pslave->recv(&ipc_msg, &master) ){       
             shutdown_flag = true;
-            TOSDB_LogH("IPC", "wait_for_master failed");            
-            return false;
-        }     
-                          
-        /* BLOCK until we get a message */ 
-        if( !pslave->recv(&ipc_msg) ){       
-            pslave->drop_master();
-            TOSDB_LogH("IPC", "recv failed");            
-            continue;          
+            TOSDB_LogH("IPC", "recv failed (slave can't accept connections)");            
+            return false;          
         }
 
-        /* parse the received msg */     
-        good_msg = ParseIPCMessage(ipc_msg, &cli_op, &cli_topic, &cli_item, &cli_timeout);
-        if(good_msg){            
-            resp = HandleGoodIPCMessage(cli_op, cli_topic, cli_item, cli_timeout);   
-        }else{
-            resp = TOSDB_ERROR_IPC_MSG;
-            TOSDB_LogH("IPC", ("failed to parse message: " + ipc_msg).c_str());            
+        IPCMessage reply(ipc_msg.request_id(), IPCMessage::FLAG_REPLY);
+
+        /* handle each record in order, one reply record for each */
+        for(size_t i = 0; i < ipc_msg.size(); ++i){
+            good_msg = ParseIPCRecord(ipc_msg[i], &cli_op, &cli_topic, &cli_item, &cli_timeout);
+            if(good_msg){            
+                resp = HandleGoodIPCMessage(cli_op, cli_topic, cli_item, cli_timeout);   
+            }else{
+                resp = TOSDB_ERROR_IPC_MSG;
+                TOSDB_LogH("IPC", ("failed to parse record #" + std::to_string(i) + " of request #"
+                                   + std::to_string(ipc_msg.request_id())).c_str());            
+            }
+            reply.add_record().add_i32(resp);
         }
                             
-        /* reply to MASTER */
-        if( !pslave->send(std::to_string(resp)) ){
+        /* reply to MASTER (over the connection it came in on) */
+        if( !pslave->send(master, reply) ){
             TOSDB_LogH("IPC", "send/reply failed in main comm loop");                       
         }                  
          
-        pslave->drop_master();
+        master.reset();
     }
 
     TOSDB_Log("SHUTDOWN", "exiting MainCommLoop");
@@ -469,35 +470,26 @@ HandleGoodIPCMessage( unsigned int op,
 
 
 bool
-ParseIPCMessage( std::string msg, 
-                 unsigned int *op, 
-                 TOS_Topics::TOPICS *topic, 
-                 std::string *item, 
-                 unsigned long *timeout )
+ParseIPCRecord( const IPCRecord& rec, 
+                unsigned int *op, 
+                TOS_Topics::TOPICS *topic, 
+                std::string *item, 
+                unsigned long *timeout )
 {  
-    size_t mlen = msg.length();
-    if(mlen > IPCBase::MAX_MESSAGE_SZ)
-    {      
-        TOSDB_LogH("IPC", ("message length (" + std::to_string(mlen) + ") > MAX_MESSAGE_SZ (" 
-                           + std::to_string(IPCBase::MAX_MESSAGE_SZ) + ')').c_str());
-        return false;
-    }
-     
-    std::vector<std::string> args;    
-    ParseArgs(args, msg);
+    uint32_t u32;
+    std::string topic_str;
 
-    size_t nargs = args.size();
-    if(nargs == 0){        
-        TOSDB_LogH("IPC", ("ParseArgs returned 0 args, msg: " + msg).c_str());
+    if(rec.size() == 0){        
+        TOSDB_LogH("IPC", "record has 0 fields");
         return false;
     }
         
-    try{ /* first, get the opcode */
-        *op = (unsigned int)std::stoul(args[0]); 
-    }catch(...){
-        TOSDB_LogH("IPC", ("failed to get 'op' arg from msg, args[0]: " + args[0]).c_str());
+    /* first, get the opcode */
+    if( !rec.get_u32(0, &u32) ){
+        TOSDB_LogH("IPC", "failed to get 'op' field (0) from record");
         return false;
     }
+    *op = u32;
 
     switch(*op){ /* break out if we just need an opcode */    
     case TOSDB_SIG_PAUSE: 
@@ -507,28 +499,37 @@ ParseIPCMessage( std::string msg,
         return true;        
     };
         
-    if(nargs != 4){ /* if we we have a stream op check we have 4 args */       
-        TOSDB_LogH("IPC", ("ParseArgs didn't return 4 args (" 
-                           + std::to_string(nargs) + "), msg: " + msg).c_str());
+    if(rec.size() != 4){ /* if we we have a stream op check we have 4 fields */       
+        TOSDB_LogH("IPC", ("stream op record doesn't have 4 fields (" 
+                           + std::to_string(rec.size()) + ")").c_str());
         return false;
     }    
     
-    try{ /* second, get the topic */
-        *topic = TOS_Topics::MAP()[args[1]];
+    /* second, get the topic */
+    if( !rec.get_string(1, &topic_str) ){
+        TOSDB_LogH("IPC", "failed to get 'topic' field (1) from record");
+        return false;
+    }
+
+    try{ 
+        *topic = TOS_Topics::MAP()[topic_str];
     }catch(...){
-        TOSDB_LogH("IPC", ("failed to get 'topic' arg from msg, args[1]: " + args[1]).c_str());
+        TOSDB_LogH("IPC", ("bad 'topic' field (1) in record: " + topic_str).c_str());
         return false;
     }
 
     /* third, the item */
-    *item = args[2];
+    if( !rec.get_string(2, item) ){
+        TOSDB_LogH("IPC", "failed to get 'item' field (2) from record");
+        return false;
+    }
     
-    try{ /* fourth, the timeout */
-        *timeout = std::stoul(args[3]);
-    }catch(...){
-        TOSDB_LogH("IPC", ("failed to get 'timeout' arg from msg, args[3]: " + args[3]).c_str());
+    /* fourth, the timeout */
+    if( !rec.get_u32(3, &u32) ){
+        TOSDB_LogH("IPC", "failed to get 'timeout' field (3) from record");
         return false;
     }
+    *timeout = u32;
 
     return true;
 }
@@ -1157,7 +1158,7 @@ WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             if(plo == 0x0000){
                 std::string sarg(std::to_string((size_t)(HWND)wParam)); 
                 ack_signals.signal(sarg + std::string(item_atom), false);                
-                TOSDB_LogH("DDE", ("NEG ACK for item: " + std::string(item_atom)).c_str());
+                TOSDB_LogLimitedH("DDE", item_atom, "NEG ACK for item");
             }else if(plo == 0x8000){
                 std::string sarg(std::to_string((size_t)(HWND)wParam));
                 ack_signals.signal(sarg + std::string(item_atom), true);   
@@ -1296,7 +1297,7 @@ HandleData(UINT msg, WPARAM wparam, LPARAM lparam)
 
     cpret = strncpy_s(cp_data, (LPCSTR)(dde_data->Value), TOSDB_STR_DATA_SZ);
     if(cpret)    
-        TOSDB_LogH("DDE", "error copying data->Value string");       
+        TOSDB_LogLimitedH("DDE", nullptr, "error copying data->Value string");       
 
     if(dde_data->fAckReq){
         /* SEND POS ACK TO SERVER - convo already destroyed if NULL */
@@ -1360,8 +1361,8 @@ HandleData(UINT msg, WPARAM wparam, LPARAM lparam)
         }     
         };
 
-    }catch(const std::out_of_range& e){      
-        TOSDB_LogH("DDE", e.what());
+    }catch(const std::out_of_range&){      
+        TOSDB_LogLimitedH("DDE", item_atom, "value out of range");
 
     }catch(const std::invalid_argument&){    
         /* Dec 20 2016 - comment out, cluttering log file */
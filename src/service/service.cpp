@@ -124,9 +124,10 @@ UpdateStatus(int status, int check_point)
 bool 
 SendMsgWaitForResponse(long msg)
 {
-    long ret;
+    int32_t ret;
     
-    std::string ipc_msg = std::to_string(msg);
+    IPCMessage ipc_msg;
+    ipc_msg.add_record().add_u32((uint32_t)msg);
 
     TOSDB_LogDebug("***IPC*** SERVICE - CHECK CONNECTED");
     if( !master->connected(TOSDB_DEF_TIMEOUT) ){
@@ -136,17 +137,16 @@ SendMsgWaitForResponse(long msg)
     
     TOSDB_LogDebug("***IPC*** SERVICE - CALL");
     if( !master->call(&ipc_msg, TOSDB_DEF_TIMEOUT) ){
-         TOSDB_LogH("IPC",("master.call failed in SendMsgWaitForResponse, msg:" + ipc_msg).c_str());
+         TOSDB_LogH("IPC",("master.call failed in SendMsgWaitForResponse, msg:" + std::to_string(msg)).c_str());
          return false;
     }
    
-    try{
-        ret = std::stol(ipc_msg);
-        return (ret == TOSDB_SIG_GOOD);
-    }catch(...){
-        TOSDB_LogH("IPC", "failed to convert return message to long in SendMsgWaitForResponse");
+    if( ipc_msg.size() != 1 || !ipc_msg[0].get_i32(0, &ret) ){
+        TOSDB_LogH("IPC", "bad reply record in SendMsgWaitForResponse");
         return false;
     }    
+
+    return (ret == TOSDB_SIG_GOOD);
 }
 
 
@@ -0,0 +1,152 @@
+/* 
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/* 
+ * compares the DataStream storage tiers (see TOSDB_SetBlockHotSize): 
+ * everything on the heap vs. spilled to a file mapping vs. spilled to 
+ * compressed blocks - memory, push, full copy and random access - for 
+ * price (double), volume (long long) and DateTimeStamp data
+ *
+ * header only, no need to link the library; from a VS command prompt:
+ *
+ *   cl /EHsc /O2 /I..\..\include bench_cold_tier.cpp
+ *   bench_cold_tier.exe [# of elems] [hot size]
+ */
+
+#include <tos_databridge.h>
+#include <data_stream.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include <random>
+
+namespace {
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+double
+ms_since(bench_clock::time_point t)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - t).count();
+}
+
+template<typename T>
+void
+bench(const char* name, const std::vector<T>& data, size_t hot_sz)
+{
+    static const char* tiers[] = {"heap", "mapped", "compressed"};
+    static const size_t NREPS = 5;
+    static const size_t NRANDOM = 100000;
+
+    size_t n = data.size();
+    std::vector<T> dest(n);
+    std::vector<T> check(n);
+    std::mt19937 rng(123);
+    bench_clock::time_point t;
+    double push_ms, copy_ms, rand_ms, mb;
+    volatile unsigned char sink = 0;
+
+    printf("\n%s (%Iu elems, %Iu hot)\n", name, n, hot_sz);
+    printf("  %-10s %10s %10s %12s %14s\n", "tier", "MB", "push ms", "copy ms", "100K rand ms");
+
+    for(int tier = 0; tier < 3; ++tier){
+        DataStreamDeque<T, std::allocator<T>> d;
+        if(tier)
+            d.spill(hot_sz, n, tier == 2);
+
+        t = bench_clock::now();
+        for(size_t i = 0; i < n; ++i)
+            d.push_front(data[i]);
+        push_ms = ms_since(t);
+
+        t = bench_clock::now();
+        for(size_t r = 0; r < NREPS; ++r)
+            d.copy(0, n, &dest[0]);
+        copy_ms = ms_since(t) / NREPS;
+
+        t = bench_clock::now();
+        for(size_t r = 0; r < NRANDOM; ++r)
+            sink ^= *(const unsigned char*)&d[rng() % n];
+        rand_ms = ms_since(t);
+
+        mb = tier ? (hot_sz * sizeof(T) + d.cold_footprint()) : (n * sizeof(T));
+        mb /= (1024 * 1024);
+
+        printf("  %-10s %10.2f %10.1f %12.2f %14.2f\n", tiers[tier], mb, push_ms, copy_ms, rand_ms);
+
+        if(!tier)
+            check = dest;
+        else if(memcmp(&check[0], &dest[0], n * sizeof(T)))
+            printf("  ** %s copy doesn't match heap copy **\n", tiers[tier]);
+    }
+}
+
+};
+
+
+int
+main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? (size_t)atol(argv[1]) : (1 << 22);
+    size_t hot_sz = (argc > 2) ? (size_t)atol(argv[2]) : 4096;
+    std::mt19937 rng(42);
+    std::vector<double> prices(n);
+    std::vector<long long> volumes(n);
+    std::vector<DateTimeStamp> stamps(n);
+    long long ticks = 10000; /* price in cents */
+    long long volume = 0;
+    DateTimeStamp dts;
+
+    memset(&dts, 0, sizeof(dts));
+    dts.ctime_struct.tm_year = 117;
+    dts.ctime_struct.tm_mday = 1;
+    dts.ctime_struct.tm_hour = 9;
+    dts.ctime_struct.tm_min = 30;
+
+    for(size_t i = 0; i < n; ++i){
+        /* prices mostly repeat or move a tick or two; built the way the
+           engine parses them from text, i.e nearest double to N.NN */
+        if(rng() % 3 == 0)
+            ticks += (int)(rng() % 5) - 2;
+        prices[i] = ticks / 100.0;
+
+        volume += (rng() % 10) * 100;
+        volumes[i] = volume;
+
+        /* irregular sub-second gaps */
+        dts.micro_second += rng() % 20000;
+        while(dts.micro_second >= 1000000){
+            dts.micro_second -= 1000000;
+            if(++dts.ctime_struct.tm_sec == 60){
+                dts.ctime_struct.tm_sec = 0;
+                if(++dts.ctime_struct.tm_min == 60){
+                    dts.ctime_struct.tm_min = 0;
+                    ++dts.ctime_struct.tm_hour;
+                }
+            }
+        }
+        stamps[i] = dts;
+    }
+
+    bench("price (double)", prices, hot_sz);
+    bench("volume (long long)", volumes, hot_sz);
+    bench("DateTimeStamp", stamps, hot_sz);
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+/*
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/*
+ * concurrent-ack stress test for SignalManager (the engine's DDE ack
+ * waiters): 'requester' threads register an id, hand it to 'acker' threads
+ * and wait for the ack, like PostItem/PostTopic and the DDE window do
+ *
+ *   unique ids - every requester has its own id and alternates the ack
+ *                value, so an ack that wakes the wrong waiter is caught
+ *   shared ids - requesters share a few ids (many items of one topic)
+ *
+ * portable build (CPP_COND_VAR), e.g on linux:
+ *
+ *   g++ -std=c++11 -O2 -pthread -DCPP_COND_VAR -I../../include
+ *       bench_signal_manager.cpp ../../src/concurrency.cpp
+ *
+ * windows build, from a VS command prompt (w/ or w/o /DCPP_COND_VAR):
+ *
+ *   cl /EHsc /O2 /I..\..\include bench_signal_manager.cpp ..\..\src\concurrency.cpp
+ *
+ *   bench_signal_manager [# requesters] [# acks per requester] [# ackers]
+ */
+
+#ifdef _WIN32
+#include <tos_databridge.h>
+#endif
+#include <concurrency.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace {
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const unsigned long WAIT_TIMEOUT_MSEC = 5000;
+const size_t NSHARED_IDS = 4;
+
+/* acks waiting to be 'sent' by the acker threads */
+class AckQueue{
+    std::deque<std::pair<std::string,bool>> _acks;
+    std::mutex _mtx;
+    std::condition_variable _cnd;
+    bool _done;
+
+public:
+    AckQueue()
+        :
+            _done(false)
+        {
+        }
+
+    void
+    push(const std::string& id, bool secondary)
+    {
+        std::lock_guard<std::mutex> lck(_mtx);
+        _acks.push_back(std::make_pair(id, secondary));
+        _cnd.notify_one();
+    }
+
+    bool
+    pop(std::pair<std::string,bool> *ack)
+    {
+        std::unique_lock<std::mutex> lck(_mtx);
+        _cnd.wait(lck, [&]{ return _done || !_acks.empty(); });
+        if(_acks.empty())
+            return false;
+        *ack = _acks.front();
+        _acks.pop_front();
+        return true;
+    }
+
+    void
+    done()
+    {
+        std::lock_guard<std::mutex> lck(_mtx);
+        _done = true;
+        _cnd.notify_all();
+    }
+};
+
+
+bool
+run(const char* name, bool shared_ids, size_t nreq, size_t nacks, size_t nackers)
+{
+    SignalManager sigs;
+    AckQueue queue;
+    std::atomic<size_t> nfail(0);
+    std::vector<std::thread> requesters;
+    std::vector<std::thread> ackers;
+
+    bench_clock::time_point beg = bench_clock::now();
+
+    for(size_t i = 0; i < nackers; ++i){
+        ackers.push_back( std::thread( [&]{
+            std::pair<std::string,bool> ack;
+            while( queue.pop(&ack) ){
+                if( !sigs.signal(ack.first, ack.second) )
+                    ++nfail;
+            }
+        }) );
+    }
+
+    for(size_t i = 0; i < nreq; ++i){
+        requesters.push_back( std::thread( [&,i]{
+            std::string id = shared_ids ? ("TOPIC_" + std::to_string(i % NSHARED_IDS))
+                                        : ("TOPIC_ITEM_" + std::to_string(i));
+            for(size_t n = 0; n < nacks; ++n){
+                /* unique ids alternate so a mixed-up wake-up shows;
+                   shared ids can't tell which ack is whose, always true */
+                bool expect = shared_ids || (n % 2 == 0);
+                sigs.set_signal_ID(id);
+                queue.push(id, expect);
+                if( sigs.wait_for(id, WAIT_TIMEOUT_MSEC) != expect )
+                    ++nfail;
+            }
+        }) );
+    }
+
+    for(auto & t : requesters)
+        t.join();
+    queue.done();
+    for(auto & t : ackers)
+        t.join();
+
+    double ms = std::chrono::duration<double, std::milli>(bench_clock::now() - beg).count();
+    double total = (double)(nreq * nacks);
+
+    printf("  %-12s %8.0f acks  %10.1f ms  %12.0f acks/sec  %6.2f usec/ack  %lu failed \n",
+           name, total, ms, total / (ms / 1000.0), (ms * 1000.0) / total,
+           (unsigned long)nfail.load());
+
+    return nfail.load() == 0;
+}
+
+}; /* namespace */
+
+
+int
+main(int argc, char* argv[])
+{
+    size_t nreq = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : 64;
+    size_t nacks = (argc > 2) ? (size_t)strtoul(argv[2], NULL, 10) : 2000;
+    size_t nackers = (argc > 3) ? (size_t)strtoul(argv[3], NULL, 10) : 4;
+
+    if(!nreq || !nacks || !nackers){
+        printf("usage: bench_signal_manager [# requesters] [# acks per requester] [# ackers] \n");
+        return 1;
+    }
+
+    printf("SignalManager: %lu requesters, %lu acks each, %lu ackers \n",
+           (unsigned long)nreq, (unsigned long)nacks, (unsigned long)nackers);
+
+    bool good = run("unique ids", false, nreq, nacks, nackers);
+    good = run("shared ids", true, nreq, nacks, nackers) && good;
+
+    printf(good ? "+ Success \n" : "- Failed \n");
+    return good ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include "tos_databridge.h"
 
 void StaticAdminTests();
@@ -6,9 +7,11 @@ int DynamicAdminTests();
 void InvalidItemTests();
 void GetTests();
 void StreamSnapshotTests();
+void StreamStatsTests();
 void FromMarkerTests();
 void FrameTests();
 void CloseTests();
+void AsyncCallback(int ret, void* arg);
 
 const char* block1_id = "test_block_1";
 static size_type block1_sz = 1000;
@@ -39,6 +42,12 @@ main(int argc, char* argv[])
     Sleep(500);
     StreamSnapshotTests();
 
+    Sleep(500);
+    StreamStatsTests();
+
+    Sleep(500);
+    FromMarkerTests();
+
     Sleep(500);
     CloseTests();
 #ifdef __cplusplus
@@ -130,8 +139,14 @@ int
 DynamicAdminTests()
 {
     int ret;
-    size_type i, tcount, icount;
+    size_type i, tcount, icount, hot_sz;
+    unsigned int is_compressed;
     char** buf1;
+    size_type* indices;
+    double* frame_col;
+    size_type frame_rows = 0;
+    volatile int async_ret;
+    LPCSTR async_items[] = {"IWM"};
 
     ret = TOSDB_Connect();
     printf("+ TOSDB_Connect() :: %i \n", ret);
@@ -153,6 +168,14 @@ DynamicAdminTests()
     printf("+ TOSDB_SetBlockSize(): %Iu \n", block1_sz*2);    
     TOSDB_GetBlockSize(block1_id, &block1_sz);
     printf("+ TOSDB_GetBlockSize(): %Iu \n", block1_sz );
+    printf("+ TOSDB_SetBlockHotSize(): %Iu, %d \n", block1_sz/2, 
+           TOSDB_SetBlockHotSize(block1_id, block1_sz/2));
+    TOSDB_GetBlockHotSize(block1_id, &hot_sz);
+    printf("+ TOSDB_GetBlockHotSize(): %Iu \n", hot_sz );
+    printf("+ TOSDB_SetBlockColdCompression(): %d \n", 
+           TOSDB_SetBlockColdCompression(block1_id, 1));
+    TOSDB_IsUsingColdCompression(block1_id, &is_compressed);
+    printf("+ TOSDB_IsUsingColdCompression(): %u \n", is_compressed );
   
     printf("+ Check For Invalid Items: \n");
     InvalidItemTests();
@@ -166,6 +189,20 @@ DynamicAdminTests()
     printf("+ TOSDB_RemoveTopic(): %s, %d \n", "BIDX", TOSDB_RemoveTopic(block1_id, "BIDX") );
     printf("+ TOSDB_AddTopic(): %s, %d \n", "BIDX", TOSDB_AddTopic(block1_id, "CUSTOM1") );
 
+    async_ret = 1; /* callback sets it to 0 or an error code */
+    printf("+ TOSDB_AddAsync(): %s, %d \n", "IWM", 
+           TOSDB_AddAsync(block1_id, async_items, 1, NULL, 0, AsyncCallback, (void*)&async_ret) );
+    for(i = 0; i < 50 && async_ret == 1; ++i)
+        Sleep(100);
+    printf("+ TOSDB_AddAsync() callback: %s, %d \n", "IWM", async_ret);
+
+    async_ret = 1; 
+    printf("+ TOSDB_RemoveItemAsync(): %s, %d \n", "IWM", 
+           TOSDB_RemoveItemAsync(block1_id, "IWM", AsyncCallback, (void*)&async_ret) );
+    for(i = 0; i < 50 && async_ret == 1; ++i)
+        Sleep(100);
+    printf("+ TOSDB_RemoveItemAsync() callback: %s, %d \n", "IWM", async_ret);
+
     tcount = 0;
     TOSDB_GetTopicCount(block1_id, &tcount);
     printf("+ TOSDB_TopicCount(): %d \n", tcount);
@@ -190,6 +227,24 @@ DynamicAdminTests()
     printf("\n");
     DeleteStrings(buf1, icount);
 
+    buf1 = NewStrings(icount, 100);
+    indices = (size_type*)malloc(icount * sizeof(size_type));
+    frame_col = (double*)malloc(icount * sizeof(double));
+    TOSDB_GetItemLabels(block1_id, buf1, icount, 100, indices);
+    printf("+ TOSDB_GetItemLabels() :: ");
+    for(i = 0; i < icount; ++i)
+      printf("%s(%Iu) ", buf1[i], indices[i]);
+    printf("\n");
+    printf("+ TOSDB_GetItemFrameColumnDoubles() :: %d :: ", 
+           TOSDB_GetItemFrameColumnDoubles(block1_id, "LAST", frame_col, icount, NULL, indices,
+                                           &frame_rows));
+    for(i = 0; i < frame_rows; ++i)
+      printf("%s(%Iu) %f ", buf1[i], indices[i], frame_col[i]);
+    printf("\n");
+    free(frame_col);
+    free(indices);
+    DeleteStrings(buf1, icount);
+
     return 0;
 }
 
@@ -200,6 +255,15 @@ GetTests()
    DateTimeStamp dts;
    double d1 = .0;
    long long ll1 = 0;
+   int ret;
+   LPCSTR many_items[3] = {"SPY", "QQQ", "XXX"};
+   LPCSTR many_topics[3] = {"LAST", "LAST", "LAST"};
+   double many_vals[3] = {.0, .0, .0};
+   int many_status[3];
+   StreamHandle sh;
+   double sh_vals[3];
+   long sh_sz = 0;
+   long long epoch_micros[3] = {0, 0, 0};
 
    TOSDB_GetDouble(block1_id,"SPY","LAST",0,&d1,NULL);
    printf("+ TOSDB_GetDouble(): %s, %s, %d, %f \n", "SPY", "LAST", 0, d1);
@@ -208,6 +272,31 @@ GetTests()
    printf("+ TOSDB_GetLongLong(): %s, %s, %d, %lld, %d:%d:%d \n", "QQQ", "VOLUME", 0, ll1,
            dts.ctime_struct.tm_hour, dts.ctime_struct.tm_min, dts.ctime_struct.tm_sec);
 
+   /* 'XXX' isn't in the block, should fail for that entry only */
+   ret = TOSDB_GetManyDoubles(block1_id,many_items,many_topics,3,many_vals,NULL,many_status);
+   printf("+ TOSDB_GetManyDoubles(): %d, %f(%d) %f(%d) (%d) \n", ret, many_vals[0], 
+          many_status[0], many_vals[1], many_status[1], many_status[2]);
+
+   ret = TOSDB_OpenStreamHandle(block1_id,"SPY","LAST",&sh);
+   printf("+ TOSDB_OpenStreamHandle(): %d, %s, %s \n", ret, "SPY", "LAST");
+   if(!ret){
+       TOSDB_GetDoubleByHandle(sh,0,&d1,NULL);
+       printf("+ TOSDB_GetDoubleByHandle(): %f \n", d1);
+       ret = TOSDB_GetNDoublesFromMarkerByHandle(sh,sh_vals,3,NULL,&sh_sz);
+       printf("+ TOSDB_GetNDoublesFromMarkerByHandle(): %d, %ld \n", ret, sh_sz);
+       ret = TOSDB_GetManyDoublesByHandle(&sh,1,sh_vals,NULL,many_status);
+       printf("+ TOSDB_GetManyDoublesByHandle(): %d, %f(%d) \n", ret, sh_vals[0], many_status[0]);
+       ret = TOSDB_CloseStreamHandle(sh);
+       printf("+ TOSDB_CloseStreamHandle(): %d \n", ret);
+       /* closed, should fail */
+       ret = TOSDB_GetDoubleByHandle(sh,0,&d1,NULL);
+       printf("+ TOSDB_GetDoubleByHandle(closed): %d \n", ret);
+   }
+
+   ret = TOSDB_GetStreamSnapshotDoublesEpochMicros(block1_id,"SPY","LAST",sh_vals,3,epoch_micros,-1,0);
+   printf("+ TOSDB_GetStreamSnapshotDoublesEpochMicros(): %d, %f, %lld \n", ret, sh_vals[0], 
+          epoch_micros[0]);
+
 #ifdef __cplusplus
    double p = TOSDB_Get<double,false>(block1_id,"SPY",TOS_Topics::TOPICS::LAST, 0);
    printf("+ TOSDB_Get<double,false>(): %s, %s, %d, %f \n", "SPY", "LAST", 0, p);
@@ -243,7 +332,39 @@ GetTests()
 void
 StreamSnapshotTests()
 {
-   
+   char packed[10 * (TOSDB_STR_DATA_SZ + 1)];
+   size_type offsets[11];
+   size_type packed_sz = 0;
+   size_type small_sz;
+   size_type i;
+   int ret;
+
+   ret = TOSDB_GetStreamSnapshotStringsPacked(block1_id,"SPY","LAST",packed,sizeof(packed),
+                                              offsets,10,NULL,-1,0,&packed_sz);
+   printf("+ TOSDB_GetStreamSnapshotStringsPacked(): %s, %s, %d, %u strings, %u bytes \n", 
+          "SPY", "LAST", ret, packed_sz, ret ? 0 : offsets[packed_sz]);
+   if(ret || packed_sz > 10 || offsets[packed_sz] > sizeof(packed)){
+       printf("  - TOSDB_GetStreamSnapshotStringsPacked() failed \n");
+   }else{
+       printf("   ");
+       for(i = 0; i < packed_sz; ++i)
+           printf("%s ", packed + offsets[i]);
+       printf("\n");
+   }
+
+   /* no room for a (non-empty) string; should stop early, not fail */
+   small_sz = 1;
+   ret = TOSDB_GetStreamSnapshotStringsPacked(block1_id,"SPY","LAST",packed,small_sz,
+                                              offsets,10,NULL,-1,0,&packed_sz);
+   printf("+ TOSDB_GetStreamSnapshotStringsPacked() (dest_sz = %u): %d, %u strings, %u bytes \n", 
+          small_sz, ret, packed_sz, ret ? 0 : offsets[packed_sz]);
+   if(ret || packed_sz != 0 || offsets[0] != 0)
+       printf("  - TOSDB_GetStreamSnapshotStringsPacked() (dest_sz too small) failed \n");
+
+   ret = TOSDB_GetStreamSnapshotStringsPacked(block1_id,"SPY","LAST",packed,sizeof(packed),
+                                              offsets,10,NULL,-1,0,NULL);
+   printf("+ TOSDB_GetStreamSnapshotStringsPacked() (NULL get_size, should fail): %d \n", ret);
+
 #ifdef __cplusplus
    auto gvec = TOSDB_GetStreamSnapshot<generic_type,true>(block1_id,"SPY",TOS_Topics::TOPICS::LAST);
    std::cout<< "TOSDB_GetStreamSnapshot<generic_type,true>(): SPY, LAST" << std::endl;
@@ -258,16 +379,87 @@ StreamSnapshotTests()
    for(auto& i : gvec2)
        std::cout<< i << ' ';
    std::cout<<std::endl;
+
+   if( gvec.second.size() > 1 ){
+       /* everything but the most recent */
+       auto dvec = TOSDB_GetStreamSnapshotBetweenDateTimes<double>(block1_id,"SPY",TOS_Topics::TOPICS::LAST,
+                                                                   gvec.second.back(), gvec.second.front());
+       std::cout<< "TOSDB_GetStreamSnapshotBetweenDateTimes<double>(): SPY, LAST" << std::endl;
+       std::cout<< "   ";
+       for(auto& i : dvec.first)
+           std::cout<< i << ' ';
+       std::cout<<std::endl;
+   }
 #endif
 }
 
-/*
+void
+StreamStatsTests()
+{
+   StreamStats stats;
+   int ret;
+
+   ret = TOSDB_EnableStreamStats(block1_id,"SPY","LAST",NULL);
+   printf("+ TOSDB_EnableStreamStats(): %s, %s, %d \n", "SPY", "LAST", ret);
+
+   ret = TOSDB_GetStreamStats(block1_id,"SPY","LAST",&stats);
+   printf("+ TOSDB_GetStreamStats(): %s, %s, %d \n", "SPY", "LAST", ret);
+   printf("    count: %u min: %f max: %f mean: %f variance: %f vwap: %f \n",
+          stats.count, stats.min, stats.max, stats.mean, stats.variance, stats.vwap);
+
+   ret = TOSDB_EnableStreamStats(block1_id,"SPY","CUSTOM1",NULL);
+   printf("+ TOSDB_EnableStreamStats() (string topic, should fail): %s, %s, %d \n", 
+          "SPY", "CUSTOM1", ret);
+
+#ifdef __cplusplus
+   TOSDB_EnableStreamStats(block1_id,"QQQ",TOS_Topics::TOPICS::LAST,TOS_Topics::TOPICS::VOLUME);
+   stats = TOSDB_GetStreamStats(block1_id,"QQQ",TOS_Topics::TOPICS::LAST);
+   printf("+ TOSDB_GetStreamStats(): %s, %s, (weight: %s) \n", "QQQ", "LAST", "VOLUME");
+   printf("    count: %u min: %f max: %f mean: %f variance: %f vwap: %f \n",
+          stats.count, stats.min, stats.max, stats.mean, stats.variance, stats.vwap);
+   TOSDB_DisableStreamStats(block1_id,"QQQ",TOS_Topics::TOPICS::LAST);
+#endif
+
+   ret = TOSDB_DisableStreamStats(block1_id,"SPY","LAST");
+   printf("+ TOSDB_DisableStreamStats(): %s, %s, %d \n", "SPY", "LAST", ret);
+}
+
 void 
 FromMarkerTests()
 {
+   double vals[10];
+   long get_size;
+   long long pos;
+   int ret;
+
+   ret = TOSDB_AddMarker(block1_id,"consumer1");
+   printf("+ TOSDB_AddMarker(): %s, %d \n", "consumer1", ret);
+
+   ret = TOSDB_AddMarker(block1_id,"consumer1");
+   printf("+ TOSDB_AddMarker() (already exists, should fail): %s, %d \n", "consumer1", ret);
 
+   Sleep(1000);
+   ret = TOSDB_GetNDoublesFromNamedMarker(block1_id,"SPY","LAST","consumer1",vals,10,NULL,&get_size);
+   printf("+ TOSDB_GetNDoublesFromNamedMarker(): %s, %s, %s, %d, %ld \n", 
+          "SPY", "LAST", "consumer1", ret, get_size);
+
+   /* the default marker shouldn't have moved */
+   ret = TOSDB_GetNDoublesFromMarker(block1_id,"SPY","LAST",vals,10,NULL,&get_size);
+   printf("+ TOSDB_GetNDoublesFromMarker(): %s, %s, %d, %ld \n", "SPY", "LAST", ret, get_size);
+
+   ret = TOSDB_GetNamedMarkerPosition(block1_id,"SPY","LAST","consumer1",&pos);
+   printf("+ TOSDB_GetNamedMarkerPosition(): %s, %s, %s, %d, %lld \n", 
+          "SPY", "LAST", "consumer1", ret, pos);
+
+   ret = TOSDB_RemoveMarker(block1_id,"consumer1");
+   printf("+ TOSDB_RemoveMarker(): %s, %d \n", "consumer1", ret);
+
+   ret = TOSDB_GetNamedMarkerPosition(block1_id,"SPY","LAST","consumer1",&pos);
+   printf("+ TOSDB_GetNamedMarkerPosition() (removed, should fail): %s, %s, %s, %d \n", 
+          "SPY", "LAST", "consumer1", ret);
 }
 
+/*
 void
 FrameTests()
 {
@@ -275,6 +467,12 @@ FrameTests()
 }
 */
 
+void
+AsyncCallback(int ret, void* arg)
+{
+    *(volatile int*)arg = ret;
+}
+
 void
 CloseTests()
 {
@@ -0,0 +1,407 @@
+/*
+Copyright (C) 2014 Jonathon Ogden   < jeog.dev@gmail.com >
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see http://www.gnu.org/licenses.
+*/
+
+/*
+ * control channel protocol over the unix domain socket transport
+ * (ipc_unix.cpp), the only way to run it off windows:
+ *
+ *   codec      - encode/decode round-trip; decode rejects bad magic/version,
+ *                truncated frames, trailing bytes, bad counts/lengths/types;
+ *                encode refuses frames/strings that are too big
+ *   transport  - a request/reply round-trip through UnixSocketServerTransport
+ *                and UnixSocketClientTransport; IPCReadFrameFD rejects a bad
+ *                header, an oversized body length (w/o waiting for the body)
+ *                and a body cut short by the peer
+ *   channel    - IPCServerChannel/IPCClientChannel with concurrent callers;
+ *                a framed but malformed request gets a FLAG_ERROR reply, an
+ *                oversized one drops the connection
+ *
+ * linux build:
+ *
+ *   g++ -std=c++11 -O2 -pthread -I../../include test_ipc_unix.cpp
+ *       ../../src/ipc_protocol.cpp ../../src/ipc_unix.cpp ../../src/ipc_channel.cpp
+ *
+ *   test_ipc_unix [socket path]
+ */
+
+#ifdef _WIN32
+#error "test_ipc_unix.cpp tests the unix domain socket transport; not for windows"
+#endif
+
+#include <ipc_protocol.hpp>
+#include <ipc_channel.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+namespace {
+
+const unsigned long CONNECT_TIMEOUT_MSEC = 2000;
+
+size_t nchecks = 0;
+size_t nfailed = 0;
+
+void
+check(bool cond, const char* what)
+{
+    ++nchecks;
+    if(!cond){
+        ++nfailed;
+        printf("  - FAILED: %s \n", what);
+    }
+}
+
+
+/* little-endian header fields, written by hand so we can build bad ones */
+void
+put_u16(std::string *out, size_t pos, uint16_t v)
+{
+    (*out)[pos] = (char)(v & 0xFF);
+    (*out)[pos + 1] = (char)((v >> 8) & 0xFF);
+}
+
+void
+put_u32(std::string *out, size_t pos, uint32_t v)
+{
+    for(int i = 0; i < 4; ++i)
+        (*out)[pos + i] = (char)((v >> (8*i)) & 0xFF);
+}
+
+
+IPCMessage
+make_request(uint32_t id, size_t nrecs)
+{
+    IPCMessage msg(id);
+    for(size_t i = 0; i < nrecs; ++i){
+        msg.add_record().add_u32((uint32_t)i)
+                        .add_string("TOPIC_" + std::to_string(i))
+                        .add_string("ITEM_" + std::to_string(id))
+                        .add_u32(1000);
+    }
+    return msg;
+}
+
+/* what the engine does: one i32 record per request record */
+IPCMessage
+make_reply(const IPCMessage& req)
+{
+    IPCMessage rep(req.request_id(), IPCMessage::FLAG_REPLY);
+    for(size_t i = 0; i < req.size(); ++i){
+        uint32_t op = 0;
+        std::string item;
+        req[i].get_u32(0, &op);
+        req[i].get_string(2, &item);
+        rep.add_record().add_i32( -(int32_t)(op + item.size()) );
+    }
+    return rep;
+}
+
+bool
+is_reply_to(const IPCMessage& rep, const IPCMessage& req)
+{
+    if(rep.request_id() != req.request_id() || rep.flags() != IPCMessage::FLAG_REPLY
+       || rep.size() != req.size())
+    {
+        return false;
+    }
+
+    IPCMessage expect = make_reply(req);
+    for(size_t i = 0; i < rep.size(); ++i){
+        int32_t r1 = 0, r2 = 1;
+        if( !rep[i].get_i32(0, &r1) || !expect[i].get_i32(0, &r2) || r1 != r2 )
+            return false;
+    }
+    return true;
+}
+
+
+void
+test_codec()
+{
+    printf("codec \n");
+
+    IPCMessage req = make_request(77, 3);
+    req.add_record().add_i32(-5).add_string("").add_string(std::string(60000, 'x'));
+
+    std::string frame;
+    check(req.encode(&frame), "encode");
+    check(IPCMessage::frame_size(frame.c_str(), frame.size()) == frame.size(), "frame_size");
+    check(IPCMessage::request_id_of(frame.c_str(), frame.size()) == 77, "request_id_of");
+
+    IPCMessage out;
+    check(IPCMessage::decode(frame.c_str(), frame.size(), &out), "decode");
+    check(out.request_id() == 77 && out.size() == 4, "decoded header");
+
+    uint32_t u = 0;
+    int32_t i = 0;
+    std::string s;
+    check(out[1].get_u32(0, &u) && u == 1, "u32 field");
+    check(out[1].get_string(1, &s) && s == "TOPIC_1", "string field");
+    check(out[3].get_i32(0, &i) && i == -5, "i32 field");
+    check(out[3].get_string(1, &s) && s.empty(), "empty string field");
+    check(out[3].get_string(2, &s) && s == std::string(60000, 'x'), "big string field");
+    check(!out[3].get_u32(0, &u), "field type mismatch");
+    check(!out[3].get_i32(3, &i), "field out of range");
+
+    /* take a good frame apart one way at a time */
+    std::string small;
+    make_request(5, 1).encode(&small);
+
+    std::string bad = small;
+    put_u32(&bad, 0, IPCMessage::MAGIC + 1);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject bad magic");
+
+    bad = small;
+    put_u16(&bad, 4, IPCMessage::VERSION + 1);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject bad version");
+
+    check(!IPCMessage::decode(small.c_str(), 0, &out), "reject empty frame");
+    check(!IPCMessage::decode(small.c_str(), IPCMessage::HEADER_SZ - 1, &out), "reject short header");
+    check(!IPCMessage::decode(small.c_str(), small.size() - 1, &out), "reject truncated body");
+
+    bad = small + '\0';
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject trailing byte");
+
+    bad = small + '\0';
+    put_u32(&bad, 16, (uint32_t)(bad.size() - IPCMessage::HEADER_SZ));
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject junk after last record");
+
+    bad = small;
+    put_u32(&bad, 12, 2);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject record count too big");
+
+    bad = small;
+    put_u32(&bad, 12, 0xFFFFFFFF);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject huge record count");
+
+    bad = small; /* first string (after nfields(2), u32 field(5) and its tag) */
+    put_u16(&bad, IPCMessage::HEADER_SZ + 8, 0xFFFF);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject string past end");
+
+    bad = small;
+    bad[IPCMessage::HEADER_SZ + 2] = (char)9;
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out), "reject unknown field type");
+
+    bad = small;
+    put_u32(&bad, 16, (uint32_t)IPCMessage::MAX_FRAME_SZ);
+    check(IPCMessage::frame_size(bad.c_str(), bad.size()) == 0, "frame_size rejects oversized body");
+
+    out = IPCMessage(1);
+    check(!IPCMessage::decode(bad.c_str(), bad.size(), &out) && out.request_id() == 1 && out.empty(),
+          "failed decode leaves msg untouched");
+
+    IPCMessage big(9);
+    big.add_record().add_string(std::string(IPCMessage::MAX_STRING_SZ + 1, 'x'));
+    check(!big.encode(&frame), "encode rejects oversized string");
+
+    IPCMessage huge(9);
+    for(int n = 0; n < 2; ++n)
+        huge.add_record().add_string(std::string(IPCMessage::MAX_STRING_SZ - 10, 'x'));
+    check(!huge.encode(&frame), "encode rejects oversized frame");
+}
+
+
+void
+test_transport(const std::string& path)
+{
+    printf("transport \n");
+
+    std::unique_ptr<UnixSocketServerTransport> server(new UnixSocketServerTransport(path));
+
+    std::thread engine( [&]{ /* answer every frame on one connection until it closes */
+        std::unique_ptr<IPCConnection> conn(server->accept());
+        if(!conn)
+            return;
+
+        std::string frame;
+        while( conn->read_frame(&frame) ){
+            IPCMessage req;
+            if( !IPCMessage::decode(frame.c_str(), frame.size(), &req) )
+                break;
+            std::string rep;
+            make_reply(req).encode(&rep);
+            conn->write_frame(rep);
+        }
+    });
+
+    UnixSocketClientTransport client(path);
+    std::unique_ptr<IPCConnection> conn(client.connect(CONNECT_TIMEOUT_MSEC));
+    check(conn != nullptr, "connect");
+
+    if(conn){
+        for(uint32_t id = 1; id <= 50; ++id){
+            IPCMessage req = make_request(id, 1 + (id % 7));
+            std::string frame;
+            IPCMessage rep;
+            bool ok = req.encode(&frame) && conn->write_frame(frame) && conn->read_frame(&frame)
+                      && IPCMessage::decode(frame.c_str(), frame.size(), &rep);
+            check(ok && is_reply_to(rep, req), "round-trip");
+        }
+        conn->close();
+    }
+
+    engine.join();
+    server.reset();
+
+    check(UnixSocketClientTransport(path).connect(100) == nullptr, "no connect once server is gone");
+
+    /* straight at the framing, on a socket pair */
+    int fds[2];
+    if( socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 ){
+        check(false, "socketpair");
+        return;
+    }
+
+    /* so a reader that waits for a body that never comes fails the test, not hangs it */
+    timeval tv = {2, 0};
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    std::string good, frame;
+    make_request(3, 2).encode(&good);
+
+    check(IPCWriteFrameFD(fds[0], good) && IPCReadFrameFD(fds[1], &frame) && frame == good,
+          "frame round-trip");
+
+    std::string bad = good.substr(0, IPCMessage::HEADER_SZ);
+    put_u32(&bad, 0, 0xDEADBEEF);
+    check(IPCWriteFrameFD(fds[0], bad) && !IPCReadFrameFD(fds[1], &frame), "reject bad magic");
+
+    bad = good.substr(0, IPCMessage::HEADER_SZ);
+    put_u32(&bad, 16, (uint32_t)IPCMessage::MAX_FRAME_SZ);
+    auto beg = std::chrono::steady_clock::now();
+    bool rejected = IPCWriteFrameFD(fds[0], bad) && !IPCReadFrameFD(fds[1], &frame);
+    check(rejected && std::chrono::steady_clock::now() - beg < std::chrono::seconds(1),
+          "reject oversized body length from the header alone");
+
+    bad = good.substr(0, good.size() - 3); /* peer goes away mid-body */
+    IPCWriteFrameFD(fds[0], bad);
+    ::close(fds[0]);
+    check(!IPCReadFrameFD(fds[1], &frame), "reject body cut short");
+    check(!IPCReadFrameFD(fds[1], &frame), "reject after peer closed");
+
+    ::close(fds[1]);
+}
+
+
+void
+test_channel(const std::string& path)
+{
+    printf("channel \n");
+
+    IPCServerChannel server(new UnixSocketServerTransport(path));
+    std::thread engine( [&]{
+        IPCMessage req;
+        IPCServerChannel::client_ty from;
+        while( server.recv(&req, &from) )
+            server.send(from, make_reply(req));
+    });
+
+    { /* concurrent callers multiplexed on one connection */
+        IPCClientChannel client(new UnixSocketClientTransport(path));
+        std::atomic<size_t> nbad(0);
+        std::vector<std::thread> callers;
+
+        for(uint32_t t = 0; t < 8; ++t){
+            callers.push_back( std::thread( [&,t]{
+                for(uint32_t n = 0; n < 200; ++n){
+                    IPCMessage msg = make_request(t * 1000 + n, 1 + (n % 5));
+                    IPCMessage req = msg;
+                    /* the channel assigns its own request ids */
+                    if( !client.call(&msg, CONNECT_TIMEOUT_MSEC) ){
+                        ++nbad;
+                        continue;
+                    }
+                    req.request_id(msg.request_id());
+                    if( !is_reply_to(msg, req) )
+                        ++nbad;
+                }
+            }) );
+        }
+        for(auto & t : callers)
+            t.join();
+
+        check(nbad.load() == 0, "concurrent calls");
+    }
+
+    { /* a raw connection sending bad frames */
+        std::unique_ptr<IPCConnection> conn(UnixSocketClientTransport(path).connect(CONNECT_TIMEOUT_MSEC));
+        check(conn != nullptr, "raw connect");
+
+        if(conn){
+            std::string frame;
+            make_request(42, 1).encode(&frame);
+            frame[IPCMessage::HEADER_SZ + 2] = (char)9; /* unknown field type */
+
+            IPCMessage rep;
+            bool ok = conn->write_frame(frame) && conn->read_frame(&frame)
+                      && IPCMessage::decode(frame.c_str(), frame.size(), &rep);
+            check(ok && rep.request_id() == 42 && rep.empty()
+                  && rep.flags() == (IPCMessage::FLAG_REPLY | IPCMessage::FLAG_ERROR),
+                  "malformed request gets FLAG_ERROR reply");
+
+            IPCMessage req = make_request(43, 2);
+            req.encode(&frame);
+            ok = conn->write_frame(frame) && conn->read_frame(&frame)
+                 && IPCMessage::decode(frame.c_str(), frame.size(), &rep);
+            check(ok && is_reply_to(rep, req), "connection still good after malformed request");
+
+            std::string bad = frame.substr(0, IPCMessage::HEADER_SZ);
+            put_u32(&bad, 0, IPCMessage::MAGIC);
+            put_u16(&bad, 4, IPCMessage::VERSION);
+            put_u32(&bad, 16, (uint32_t)IPCMessage::MAX_FRAME_SZ);
+            check(conn->write_frame(bad) && !conn->read_frame(&frame),
+                  "oversized request drops the connection");
+        }
+    }
+
+    server.stop();
+    engine.join();
+}
+
+}; /* namespace */
+
+
+int
+main(int argc, char* argv[])
+{
+    std::string path = (argc > 1) ? argv[1]
+                                  : ("/tmp/tosdb_test_ipc_" + std::to_string(getpid()));
+    try{
+        test_codec();
+        test_transport(path);
+        test_channel(path);
+    }catch(std::exception& e){
+        printf("  - exception: %s \n", e.what());
+        ++nfailed;
+    }
+
+    unlink(path.c_str());
+
+    printf("%lu checks, %lu failed \n", (unsigned long)nchecks, (unsigned long)nfailed);
+    printf(nfailed ? "- Failed \n" : "+ Success \n");
+    return nfailed ? 1 : 0;
+}